@@ -16,9 +16,11 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/threading.cpp
   ${MLAS_SRC_DIR}/sgemm.cpp
   ${MLAS_SRC_DIR}/halfgemm.cpp
+  ${MLAS_SRC_DIR}/sbgemm.cpp
   ${MLAS_SRC_DIR}/qgemm.cpp
   ${MLAS_SRC_DIR}/qdwconv.cpp
   ${MLAS_SRC_DIR}/convolve.cpp
+  ${MLAS_SRC_DIR}/convwinograd.cpp
   ${MLAS_SRC_DIR}/convsym.cpp
   ${MLAS_SRC_DIR}/pooling.cpp
   ${MLAS_SRC_DIR}/transpose.cpp
@@ -28,6 +30,12 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/logistic.cpp
   ${MLAS_SRC_DIR}/tanh.cpp
   ${MLAS_SRC_DIR}/erf.cpp
+  ${MLAS_SRC_DIR}/transcendental.h
+  ${MLAS_SRC_DIR}/transcendental.cpp
+  ${MLAS_SRC_DIR}/sparsegemm.h
+  ${MLAS_SRC_DIR}/sparsegemm.cpp
+  ${MLAS_SRC_DIR}/sgemm_small.h
+  ${MLAS_SRC_DIR}/sgemm_small.cpp
   ${MLAS_SRC_DIR}/compute.cpp
   ${MLAS_SRC_DIR}/quantize.cpp
   ${MLAS_SRC_DIR}/qgemm_kernel_default.cpp
@@ -177,6 +185,12 @@ function(setup_mlas_source_for_windows)
       ${MLAS_SRC_DIR}/dgemm.cpp
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
+      ${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/transcendental_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/transcendental_kernel_avx512f.cpp
+      ${MLAS_SRC_DIR}/sparsegemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/sgemm_small_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/sgemm_small_kernel_avx512f.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_avx2.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse.cpp
@@ -586,6 +600,10 @@ else()
           ${MLAS_SRC_DIR}/intrinsics/avx2/qladd_avx2.cpp
           ${MLAS_SRC_DIR}/intrinsics/avx2/qdwconv_avx2.cpp
           ${MLAS_SRC_DIR}/sqnbitgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/transcendental_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/sparsegemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/sgemm_small_kernel_avx2.cpp
         )
         if(CMAKE_CXX_COMPILER_VERSION GREATER_EQUAL 13.1 AND NOT(APPLE))
           set(mlas_platform_srcs_avx2
@@ -612,6 +630,8 @@ endif()
           ${MLAS_SRC_DIR}/x86_64/SpoolKernelAvx512F.S
           ${MLAS_SRC_DIR}/x86_64/TransKernelAvx512F.S
           ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+          ${MLAS_SRC_DIR}/transcendental_kernel_avx512f.cpp
+          ${MLAS_SRC_DIR}/sgemm_small_kernel_avx512f.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -659,6 +679,26 @@ endif()
             )
           set_source_files_properties(${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
           set_source_files_properties(${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+
+          check_cxx_compiler_flag("-mavx512fp16" HAS_AVX512FP16)
+          if(HAS_AVX512FP16)
+            set(mlas_platform_srcs
+              ${mlas_platform_srcs}
+              ${MLAS_SRC_DIR}/halfgemm_kernel_avx512fp16.cpp
+            )
+            set_source_files_properties(${MLAS_SRC_DIR}/halfgemm_kernel_avx512fp16.cpp PROPERTIES COMPILE_FLAGS "-mavx512fp16 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+            set_property(SOURCE ${MLAS_SRC_DIR}/platform.cpp APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AVX512FP16_INTRINSICS_SUPPORTED)
+          endif()
+
+          check_cxx_compiler_flag("-mavx512bf16" HAS_AVX512BF16)
+          if(HAS_AVX512BF16)
+            set(mlas_platform_srcs
+              ${mlas_platform_srcs}
+              ${MLAS_SRC_DIR}/sbgemm_kernel_avx512bf16.cpp
+            )
+            set_source_files_properties(${MLAS_SRC_DIR}/sbgemm_kernel_avx512bf16.cpp PROPERTIES COMPILE_FLAGS "-mavx512bf16 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+            set_property(SOURCE ${MLAS_SRC_DIR}/platform.cpp APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AVX512BF16_INTRINSICS_SUPPORTED)
+          endif()
         endif()
 
         if(ONNXRUNTIME_MLAS_MULTI_ARCH)
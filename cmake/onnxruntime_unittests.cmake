@@ -1141,6 +1141,8 @@ if (NOT onnxruntime_ENABLE_TRAINING_TORCH_INTEROP)
       ${BENCHMARK_DIR}/batchnorm.cc
       ${BENCHMARK_DIR}/batchnorm2.cc
       ${BENCHMARK_DIR}/tptest.cc
+      ${BENCHMARK_DIR}/bfc_arena.cc
+      ${BENCHMARK_DIR}/numa.cc
       ${BENCHMARK_DIR}/eigen.cc
       ${BENCHMARK_DIR}/copy.cc
       ${BENCHMARK_DIR}/gelu.cc
@@ -1274,6 +1276,7 @@ if (NOT onnxruntime_ENABLE_TRAINING_TORCH_INTEROP)
     else()
       target_link_libraries(onnxruntime_perf_test PRIVATE onnx_test_runner_common ${GETOPT_LIB_WIDE} ${onnx_test_libs})
     endif()
+    onnxruntime_add_include_to_target(onnxruntime_perf_test nlohmann_json::nlohmann_json)
     set_target_properties(onnxruntime_perf_test PROPERTIES FOLDER "ONNXRuntimeTest")
 
   endif()
@@ -37,6 +37,8 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int64_t thread_cache_max_bytes = -1;    // use -1 to allow ORT to choose the default, 0 = disabled
+  int numa_aware = -1;                    // use -1 to allow ORT to choose the default, 1 = arena per NUMA node
 };
 
 namespace onnxruntime {
@@ -130,6 +130,37 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to restore the pre-packed state of an input from buffers that the PrePack() method of an
+  // identical kernel produced for the same constant tensor in an earlier session. It is called instead of PrePack()
+  // when the session has a persistent pre-packed weights cache (see kOrtSessionOptionsPrePackCacheDir).
+  //   Status UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+  //                                    std::vector<BufferUniquePtr>& prepacked_buffers,
+  //                                    gsl::span<const size_t> prepacked_buffer_sizes,
+  //                                    /*out*/ bool& used_cached_buffers) {
+  //     used_cached_buffers = false;
+  //     if (input_idx == 1 && prepacked_buffer_sizes[0] == this.PackedSize(tensor.Shape())) {
+  //       used_cached_buffers = true;
+  //       this.shape_ = tensor.Shape();
+  //       this.buffer_ = std::move(prepacked_buffers[0]);
+  //     }
+  //     return Status::OK();
+  //   }
+  // @param tensor: The initialized constant tensor. Only its metadata should be read, so that its data does not
+  //                need to be paged in.
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffers: The buffers in the order that PrePack() stored them in PrePackedWeights. As with
+  //                           UseSharedPrePackedBuffers() the deleters are NULL.
+  // @param prepacked_buffer_sizes: The size in bytes of each buffer. The kernel must verify them.
+  // @param used_cached_buffers: Set to true if the kernel is now in the state PrePack() would have left it in after
+  //                             reporting is_packed. If false, the session falls back to calling PrePack().
+  virtual Status UseCachedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                           std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                           gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                           /*out*/ bool& used_cached_buffers) {
+    used_cached_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
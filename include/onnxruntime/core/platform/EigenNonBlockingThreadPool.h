@@ -9,7 +9,10 @@
 
 /* Modifications Copyright (c) Microsoft. */
 
+#include <algorithm>
+#include <chrono>
 #include <type_traits>
+#include <vector>
 
 #pragma once
 #include "onnxruntime_config.h"
@@ -52,6 +55,7 @@
 #include "core/common/spin_pause.h"
 #include "core/platform/ort_spin_lock.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
 
 // ORT thread pool overview
 // ------------------------
@@ -223,6 +227,7 @@ class ThreadPoolProfiler {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolProfiler);
   void Start() {}
   std::string Stop() { return "not available for minimal build"; }
+  bool Enabled() const { return false; }
   void LogStart() {}
   void LogEnd(ThreadPoolEvent) {}
   void LogEndAndStart(ThreadPoolEvent) {}
@@ -248,6 +253,7 @@ class ThreadPoolProfiler {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolProfiler);
   using Clock = std::chrono::high_resolution_clock;
   void Start();                  // called by executor to start profiling
+  bool Enabled() const { return enabled_; }
   std::string Stop();            // called by executor to stop profiling and return collected numbers
   void LogStart();               // called in main thread to record the starting time point
   void LogEnd(ThreadPoolEvent);  // called in main thread to calculate and save the time elapsed from last start point
@@ -390,6 +396,9 @@ class ThreadPoolParallelSection {
   std::atomic<bool> dispatch_started{false};
   std::atomic<bool> dispatch_done{false};
   std::atomic<bool> work_done{false};
+
+  // NUMA node whose workers the tasks of the section are pushed to, -1 for any worker
+  int numa_node = -1;
 };
 
 class ThreadPoolLoop {
@@ -722,6 +731,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
  public:
   void StartProfiling() override {
+    int64_t not_started = 0;
+    profiling_start_ticks_.compare_exchange_strong(
+        not_started, std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
     profiler_.Start();
   }
 
@@ -789,6 +801,26 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    // Group the workers by NUMA node.  The pool is only partitioned if
+    // its workers are spread over more than one node.
+    if (thread_options.numa_nodes.size() >= num_threads_) {
+      worker_numa_node_.assign(thread_options.numa_nodes.begin(), thread_options.numa_nodes.begin() + num_threads_);
+      for (auto i = 0u; i < num_threads_; i++) {
+        const int node = worker_numa_node_[i];
+        if (node >= 0) {
+          if (numa_node_workers_.size() <= static_cast<size_t>(node)) {
+            numa_node_workers_.resize(static_cast<size_t>(node) + 1);
+          }
+          numa_node_workers_[node].push_back(i);
+        }
+      }
+      if (std::count_if(numa_node_workers_.begin(), numa_node_workers_.end(),
+                        [](const InlinedVector<unsigned>& workers) { return !workers.empty(); }) <= 1) {
+        worker_numa_node_.clear();
+        numa_node_workers_.clear();
+      }
+    }
+
     // Eigen::MaxSizeVector has neither essential exception safety features
     // such as swap, nor it is movable. So we have to join threads right here
     // on exception
@@ -820,6 +852,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     int q_idx = Rand(&pt->rand) % num_threads_;
     WorkerData& td = worker_data_[q_idx];
     Queue& q = td.queue;
+    tasks_scheduled_.fetch_add(1, std::memory_order_relaxed);
     fn = q.PushBack(std::move(fn));
     if (!fn) {
       // The queue accepted the work; ensure that the thread will pick it up
@@ -857,6 +890,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     ps.work_done = false;
     ps.tasks_revoked = 0;
     ps.current_dop = 1;
+    ps.numa_node = CurrentNumaNode(pt);
     ps.active = true;
   }
 
@@ -1079,6 +1113,23 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     preferred_workers[par_idx] = ran_on_idx;
   }
 
+  // Return the queue to push the task of par_idx to.  This is the
+  // preferred worker, unless the pool is partitioned by NUMA node and
+  // the preferred worker is on another node than the one of the
+  // parallel section, in which case one of the section's workers is
+  // chosen instead.
+
+  unsigned PreferredQueue(const ThreadPoolParallelSection& ps,
+                          const InlinedVector<int>& preferred_workers,
+                          unsigned par_idx) const {
+    unsigned q_idx = preferred_workers[par_idx] % num_threads_;
+    if (ps.numa_node >= 0 && worker_numa_node_[q_idx] != ps.numa_node) {
+      const auto& node_workers = numa_node_workers_[ps.numa_node];
+      q_idx = node_workers[par_idx % node_workers.size()];
+    }
+    return q_idx;
+  }
+
   // Schedule [par_idx_start,par_idx_end) across the preferred workers
 
   void ScheduleOnPreferredWorkers(PerThread& pt,
@@ -1092,7 +1143,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       // recorded from a prior thread pool with a different number of
       // threads, hence we must cap at num_threads_.
       assert(par_idx < preferred_workers.size());
-      unsigned q_idx = preferred_workers[par_idx] % num_threads_;
+      unsigned q_idx = PreferredQueue(ps, preferred_workers, par_idx);
       assert(q_idx < num_threads_);
       WorkerData& td = worker_data_[q_idx];
       Queue& q = td.queue;
@@ -1206,7 +1257,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         };
 
         profiler_.LogStart();
-        ps.dispatch_q_idx = preferred_workers[current_dop] % num_threads_;
+        ps.dispatch_q_idx = PreferredQueue(ps, preferred_workers, current_dop);
         WorkerData& dispatch_td = worker_data_[ps.dispatch_q_idx];
         Queue& dispatch_que = dispatch_td.queue;
 
@@ -1242,6 +1293,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
                             std::ptrdiff_t block_size) override {
     ORT_ENFORCE(n <= num_threads_ + 1, "More work items than threads");
     profiler_.LogStartAndCoreAndBlock(block_size);
+    parallel_loops_.fetch_add(1, std::memory_order_relaxed);
     PerThread* pt = GetPerThread();
     assert(pt->leading_par_section && "RunInParallel, but not in parallel section");
     assert((n > 1) && "Trivial parallel section; should be avoided by caller");
@@ -1300,6 +1352,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   void RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) override {
     ORT_ENFORCE(n <= num_threads_ + 1, "More work items than threads");
     profiler_.LogStartAndCoreAndBlock(block_size);
+    parallel_loops_.fetch_add(1, std::memory_order_relaxed);
     PerThread* pt = GetPerThread();
     ThreadPoolParallelSection ps;
     StartParallelSectionInternal(*pt, ps);
@@ -1315,6 +1368,60 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return num_threads_;
   }
 
+  // Number of worker threads that are not running a task.  This is a
+  // hint: the status of the workers may change as soon as it is read.
+  unsigned NumIdleWorkers() const {
+    unsigned num_idle = 0;
+    for (unsigned i = 0; i < num_threads_; i++) {
+      if (worker_data_[i].GetStatus() != WorkerData::ThreadStatus::Active) {
+        num_idle++;
+      }
+    }
+    return num_idle;
+  }
+
+  // Record a parallel loop that a worker thread ran by itself instead
+  // of distributing it, as no other worker was idle.
+  void CountNestedLoopRunInline() {
+    nested_loops_run_inline_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void GetUtilization(ThreadPoolUtilization& utilization) const {
+    utilization.num_threads = static_cast<int>(num_threads_);
+    utilization.tasks_scheduled = tasks_scheduled_.load(std::memory_order_relaxed);
+    utilization.parallel_loops = parallel_loops_.load(std::memory_order_relaxed);
+    utilization.nested_loops_run_inline = nested_loops_run_inline_.load(std::memory_order_relaxed);
+    uint64_t busy_time_ns = 0;
+    for (unsigned i = 0; i < num_threads_; i++) {
+      const WorkerData& td = worker_data_[i];
+      utilization.tasks_run += td.tasks_run.load(std::memory_order_relaxed);
+      utilization.tasks_stolen += td.tasks_stolen.load(std::memory_order_relaxed);
+      busy_time_ns += td.busy_time_ns.load(std::memory_order_relaxed);
+    }
+    utilization.busy_time_us = busy_time_ns / 1000;
+    const int64_t profiling_start_ticks = profiling_start_ticks_.load(std::memory_order_relaxed);
+    if (profiling_start_ticks != 0) {
+      const std::chrono::steady_clock::time_point profiling_start{
+          std::chrono::steady_clock::duration(profiling_start_ticks)};
+      utilization.elapsed_time_us = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - profiling_start)
+              .count());
+    }
+  }
+
+  // Maximum degree of parallelism of a loop started by the calling
+  // thread.  When the pool is partitioned by NUMA node, this is the
+  // number of workers on the node of the calling thread, plus the
+  // calling thread itself if it is not one of them.
+  unsigned MaxLoopDegreeOfParallelism() {
+    PerThread* pt = GetPerThread();
+    const int node = CurrentNumaNode(*pt);
+    if (node < 0) {
+      return num_threads_ + 1;
+    }
+    return static_cast<unsigned>(numa_node_workers_[node].size()) + (pt->pool == this ? 0 : 1);
+  }
+
   int CurrentThreadId() const final {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
@@ -1348,6 +1455,19 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     }
   }
 
+  // NUMA node of the calling thread if the pool has workers on it, -1
+  // otherwise or if the pool is not partitioned by NUMA node.
+  int CurrentNumaNode(const PerThread& pt) const {
+    if (numa_node_workers_.empty()) {
+      return -1;
+    }
+    const int node = pt.pool == this ? worker_numa_node_[pt.thread_id] : env_.GetCurrentNumaNode();
+    if (node < 0 || static_cast<size_t>(node) >= numa_node_workers_.size() || numa_node_workers_[node].empty()) {
+      return -1;
+    }
+    return node;
+  }
+
   typedef typename Environment::EnvThread Thread;
   struct WorkerData;
 
@@ -1467,6 +1587,21 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       status = ThreadStatus::Spinning;
     }
 
+    // Count a task run by the thread.  Only the thread itself updates
+    // the counters, so no read-modify-write is needed.
+    void RecordRun(uint64_t run_time_ns, bool stolen) {
+      tasks_run.store(tasks_run.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      if (stolen) {
+        tasks_stolen.store(tasks_stolen.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      }
+      busy_time_ns.store(busy_time_ns.load(std::memory_order_relaxed) + run_time_ns, std::memory_order_relaxed);
+    }
+
+    // Utilization counters, read by GetUtilization from other threads
+    std::atomic<uint64_t> tasks_run{0};
+    std::atomic<uint64_t> tasks_stolen{0};
+    std::atomic<uint64_t> busy_time_ns{0};
+
     bool SetBlocked(std::function<bool()> should_block,
                     std::function<void()> post_block) {
       std::unique_lock<std::mutex> lk(mutex);
@@ -1501,6 +1636,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
+  // NUMA node of each worker and workers of each NUMA node, both empty
+  // if the pool is not partitioned by NUMA node
+  std::vector<int> worker_numa_node_;
+  std::vector<InlinedVector<unsigned>> numa_node_workers_;
+
+  // Utilization counters, see GetUtilization. The busy time of the
+  // threads is only measured once the profiling of the pool has been
+  // started, at the time recorded in profiling_start_ticks_ (steady clock
+  // ticks, 0 until then).
+  std::atomic<int64_t> profiling_start_ticks_{0};
+  std::atomic<uint64_t> tasks_scheduled_{0};
+  std::atomic<uint64_t> parallel_loops_{0};
+  std::atomic<uint64_t> nested_loops_run_inline_{0};
+
   // SpinLoopStatus indicates whether the main worker spinning (inner) loop should exit immediately when there is
   // no work available (kIdle) or whether it should follow the configured spin-then-block policy (kBusy).
   // This lets the ORT session layer hint to the thread pool that it should stop spinning in between
@@ -1544,11 +1693,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     while (!should_exit) {
       Task t = q.PopFront();
+      bool stolen = false;
       if (!t) {
         // Spin waiting for work.
         for (int i = 0; i < spin_count && !done_; i++) {
           if (((i + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
+            stolen = static_cast<bool>(t);
           } else {
             t = q.PopFront();
           }
@@ -1626,13 +1777,26 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
           if (!t) t = q.PopFront();
-          if (!t) t = Steal(StealAttemptKind::TRY_ALL);
+          if (!t) {
+            t = Steal(StealAttemptKind::TRY_ALL);
+            stolen = static_cast<bool>(t);
+          }
         }
       }
 
       if (t) {
         td.SetActive();
-        t();
+        if (profiler_.Enabled()) {
+          const auto run_start = std::chrono::steady_clock::now();
+          t();
+          td.RecordRun(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 std::chrono::steady_clock::now() - run_start)
+                                                 .count()),
+                       stolen);
+        } else {
+          t();
+          td.RecordRun(0, stolen);
+        }
         profiler_.LogRun(thread_id);
         td.SetSpinning();
       }
@@ -1654,6 +1818,28 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
+    // When the pool is partitioned by NUMA node, workers only steal from
+    // the workers of their own node, so that the work items of a loop stay
+    // on the node that started it.
+    const int node = CurrentNumaNode(*pt);
+    if (node >= 0) {
+      const auto& node_workers = numa_node_workers_[node];
+      const unsigned node_size = static_cast<unsigned>(node_workers.size());
+      unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? node_size : 1;
+      unsigned victim_idx = Rand(&pt->rand) % node_size;
+      for (unsigned i = 0; i < num_attempts; i++) {
+        WorkerData& victim = worker_data_[node_workers[victim_idx]];
+        if (victim.GetStatus() == WorkerData::ThreadStatus::Active) {
+          Task t = victim.queue.PopBack();
+          if (t) {
+            return t;
+          }
+        }
+        victim_idx = victim_idx + 1 == node_size ? 0 : victim_idx + 1;
+      }
+      return Task();
+    }
+
     unsigned size = num_threads_;
     unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
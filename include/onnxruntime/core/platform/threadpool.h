@@ -136,6 +136,33 @@ class ExtendedThreadPoolInterface;
 class LoopCounter;
 class ThreadPoolParallelSection;
 
+// Counters of the work done by the threads of a pool since it was created.
+struct ThreadPoolUtilization {
+  // threads created by the pool, excluding the threads that submit work to it
+  int num_threads = 0;
+  // tasks submitted with Schedule
+  uint64_t tasks_scheduled = 0;
+  // tasks run by the threads of the pool, including the work items of parallel loops
+  uint64_t tasks_run = 0;
+  // tasks that a thread of the pool took from the queue of another thread
+  uint64_t tasks_stolen = 0;
+  // parallel loops whose work was distributed over the threads of the pool
+  uint64_t parallel_loops = 0;
+  // parallel loops started by a thread of the pool that ran on that thread alone as no other thread was idle
+  uint64_t nested_loops_run_inline = 0;
+  // time the threads of the pool spent running tasks since the profiling of the pool was started, 0 if it was not
+  uint64_t busy_time_us = 0;
+  // time since the profiling of the pool was started, 0 if it was not
+  uint64_t elapsed_time_us = 0;
+
+  // Fraction of the time of the pool's threads spent running tasks.
+  double Utilization() const {
+    return num_threads > 0 && elapsed_time_us > 0
+               ? static_cast<double>(busy_time_us) / (static_cast<double>(elapsed_time_us) * num_threads)
+               : 0.0;
+  }
+};
+
 class ThreadPool {
  public:
 #ifdef _WIN32
@@ -366,6 +393,9 @@ class ThreadPool {
   static void StartProfiling(concurrency::ThreadPool* tp);
   static std::string StopProfiling(concurrency::ThreadPool* tp);
 
+  // Return the utilization counters of the pool. All zero if tp is nullptr or the pool has no threads.
+  static ThreadPoolUtilization GetUtilization(const concurrency::ThreadPool* tp);
+
  private:
   friend class LoopCounter;
 
@@ -47,8 +47,9 @@ class Environment {
     return intra_op_thread_pool_.get();
   }
 
+  // Returns the intra-op thread pool if the env was created with a single pool for intra-op and inter-op work.
   onnxruntime::concurrency::ThreadPool* GetInterOpThreadPool() const {
-    return inter_op_thread_pool_.get();
+    return use_unified_thread_pool_ ? intra_op_thread_pool_.get() : inter_op_thread_pool_.get();
   }
 
   bool EnvCreatedWithGlobalThreadPools() const {
@@ -98,6 +99,7 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> intra_op_thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
+  bool use_unified_thread_pool_{false};
   std::vector<AllocatorPtr> shared_allocators_;
 };
 }  // namespace onnxruntime
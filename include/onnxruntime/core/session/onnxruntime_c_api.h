@@ -2810,6 +2810,11 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_bytes": Maximum number of bytes of freed small (<= 64KB) chunks that each thread keeps
+   *  for reuse without taking the arena lock. Use 0 to disable the per-thread cache. Default is 0.
+   * "numa_aware": 1 = create an arena for each NUMA node of the host, whose memory is bound to the node. An allocation
+   *  is served by the arena of the node that the calling thread runs on. Has no effect on a host with a single NUMA
+   *  node or on platforms where ORT can't bind memory to a node. Default is 0.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4782,6 +4787,48 @@ struct OrtApi {
    */
   ORT_API2_STATUS(SetEpDynamicOptions, _Inout_ OrtSession* sess, _In_reads_(kv_len) const char* const* keys,
                   _In_reads_(kv_len) const char* const* values, _In_ size_t kv_len);
+
+  /// @}
+
+  /** \brief Set whether a single global thread pool runs both the intra-op and the inter-op work
+   *
+   * This will configure the global thread pool options to be used in the call to OrtApi::CreateEnvWithGlobalThreadPools.
+   * When enabled, no inter-op thread pool is created and the sessions running in the parallel execution mode
+   * schedule their nodes on the intra-op thread pool, which is sized by OrtApi::SetGlobalIntraOpNumThreads.
+   * A parallel loop started by a kernel running on a thread of the pool is only distributed over the threads
+   * that are idle, and runs on the calling thread alone if there are none.
+   *
+   * \param[in] tp_options
+   * \param[in] use_unified_thread_pool Valid values are 0 or 1.<br>
+   *   0 = Separate intra-op and inter-op thread pools (default)<br>
+   *   1 = The intra-op thread pool is also used for the inter-op work
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(SetGlobalUnifiedThreadPool, _Inout_ OrtThreadingOptions* tp_options, int use_unified_thread_pool);
+
+  /** \brief Get the statistics of the kernels run by a session
+   *
+   * The statistics are collected when the "session.enable_kernel_stats" session configuration entry is "1".
+   * They are returned as a JSON object with two arrays, "nodes" and "op_types". Each element has the "name" and
+   * "op_type" of the node (the op type for "op_types"), the number of runs "count", the "total_us", "p50_us",
+   * "p90_us" and "p99_us" latencies in microseconds, and the "output_bytes" of the outputs of the runs.
+   * Nodes of subgraphs are named after their parent node and attribute, e.g. "loop/body/add".
+   * Nodes that didn't run since the last reset are omitted.
+   *
+   * \param[in] session
+   * \param[in] reset If non-zero, the statistics returned by the next call only cover the runs after this call.
+   * \param[in] allocator
+   * \param[out] out Set to a null terminated string allocated using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(SessionGetKernelStats, _In_ OrtSession* session, int reset, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
 };
 
 /*
@@ -683,6 +683,9 @@ struct ThreadingOptions : detail::Base<OrtThreadingOptions> {
   /// \brief Wraps OrtApi::SetGlobalDenormalAsZero
   ThreadingOptions& SetGlobalDenormalAsZero();
 
+  /// \brief Wraps OrtApi::SetGlobalUnifiedThreadPool
+  ThreadingOptions& SetGlobalUnifiedThreadPool(int use_unified_thread_pool);
+
   /// \brief Wraps OrtApi::SetGlobalCustomCreateThreadFn
   ThreadingOptions& SetGlobalCustomCreateThreadFn(OrtCustomCreateThreadFn ort_custom_create_thread_fn);
 
@@ -1149,6 +1152,16 @@ struct SessionImpl : ConstSessionImpl<T> {
    */
   AllocatedStringPtr EndProfilingAllocated(OrtAllocator* allocator);  ///< Wraps OrtApi::SessionEndProfiling
 
+  /** \brief Returns the statistics of the kernels run by the session, as JSON
+   *
+   * Wraps OrtApi::SessionGetKernelStats
+   *
+   * \param reset If true, the next call only reports the kernels run after this one.
+   * \param allocator to allocate memory for the returned string
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   */
+  AllocatedStringPtr GetKernelStatsAllocated(bool reset, OrtAllocator* allocator);
+
   /** \brief Set DynamicOptions for EPs (Execution Providers)
    *
    * Wraps OrtApi::SetEpDynamicOptions
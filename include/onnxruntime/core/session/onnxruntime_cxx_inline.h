@@ -462,6 +462,11 @@ inline ThreadingOptions& ThreadingOptions::SetGlobalDenormalAsZero() {
   return *this;
 }
 
+inline ThreadingOptions& ThreadingOptions::SetGlobalUnifiedThreadPool(int use_unified_thread_pool) {
+  ThrowOnError(GetApi().SetGlobalUnifiedThreadPool(p_, use_unified_thread_pool));
+  return *this;
+}
+
 inline ThreadingOptions& ThreadingOptions::SetGlobalCustomCreateThreadFn(OrtCustomCreateThreadFn ort_custom_create_thread_fn) {
   ThrowOnError(GetApi().SetGlobalCustomCreateThreadFn(p_, ort_custom_create_thread_fn));
   return *this;
@@ -1093,6 +1098,13 @@ inline AllocatedStringPtr SessionImpl<T>::EndProfilingAllocated(OrtAllocator* al
   return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
 }
 
+template <typename T>
+inline AllocatedStringPtr SessionImpl<T>::GetKernelStatsAllocated(bool reset, OrtAllocator* allocator) {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetKernelStats(this->p_, reset ? 1 : 0, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
 template <typename T>
 inline void SessionImpl<T>::SetEpDynamicOptions(const char* const* keys, const char* const* values, size_t kv_len) {
   ThrowOnError(GetApi().SetEpDynamicOptions(this->p_, keys, values, kv_len));
@@ -67,6 +67,11 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable the fusion of the element-wise nodes left after the other Level 3 optimizations into
+// com.microsoft.FusedElementwise CPU nodes. "0": disable; "1": enable. The default is "0".
+// It is disabled by default until its speedup is measured on real models.
+static const char* const kOrtSessionOptionsEnableElementwiseFusion = "optimization.enable_elementwise_fusion";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -111,12 +116,91 @@ static const char* const kOrtSessionOptionsDisableSpecifiedOptimizers = "optimiz
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Enable or disable memory mapping of initializers whose data is in an external file. "1": enable; "0": disable.
+// The default is "1".
+// When enabled, initializers placed on CPU wrap the mapped pages of the external data file directly. No buffer is
+// planned for them, pages are only read in when first touched, and processes loading the same model share the page
+// cache. Initializers placed on other devices are always copied.
+// When disabled, the external data is copied into the initializer buffers planned for the session.
+// The number of bytes mapped and copied is logged at session creation and recorded in the profile.
+static const char* const kOrtSessionOptionsMmapExternalInitializers = "session.use_mmap_for_external_initializers";
+
+// Directory of the persistent cache of pre-packed weights. Not set by default, which disables the cache.
+// When set, the weights that kernels pre-pack at session creation are written to a file in this directory, named by a
+// hash of the model, the session configuration, the ORT version and the CPU features. Later sessions for the same
+// model memory map the file and hand its buffers to the kernels instead of pre-packing again.
+// Only kernels that can adopt cached buffers take part, currently the float MatMul and Gemm on CPU. The cache is not
+// used when pre-packing is disabled, when pre-packed initializers are saved with the model, or for weights shared
+// through a PrepackedWeightsContainer.
+static const char* const kOrtSessionOptionsPrePackCacheDir = "session.prepack_cache_dir";
+
+// Enable or disable using the intra-op thread pool to speed up session initialization. "1": enable; "0": disable.
+// The default is "0".
+// When enabled, the kernels of nodes assigned to the CPU EP are created in parallel, initializers placed on CPU are
+// deserialized in parallel, and the PrePack() calls of different CPU EP kernels run in parallel.
+// Graph transformation and partitioning are unaffected.
+// Custom op kernels assigned to the CPU EP are created and pre-packed concurrently with other kernels when this is
+// enabled, so their constructors and PrePack() must be thread-safe.
+static const char* const kOrtSessionOptionsParallelInitialization = "session.parallel_initialization";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
 static const char* const kOrtSessionOptionsConfigAllowInterOpSpinning = "session.inter_op.allow_spinning";
 static const char* const kOrtSessionOptionsConfigAllowIntraOpSpinning = "session.intra_op.allow_spinning";
 
+// Configure how the kernels are scheduled in the parallel execution mode (ExecutionMode::ORT_PARALLEL).
+// "0": default, each logic stream of the execution plan runs as a single task on the inter-op thread pool.
+// "1": experimental, a kernel is dispatched to the inter-op thread pool as soon as the nodes producing its inputs have
+//      completed, with the nodes on the longest path to the graph outputs first. Applies when no execution provider
+//      of the session uses device streams. Nodes only wait for the nodes they have graph edges from, and not for the
+//      synchronization between the logic streams of the execution plan.
+static const char* const kOrtSessionOptionsConfigDataflowExecution = "session.parallel_execution.dataflow";
+
+// Configure whether the parallel execution mode runs its inter-op work on the intra-op thread pool rather than on
+// a separate inter-op thread pool, so that the session doesn't use more threads than the intra-op pool provides.
+// Kernels running on a thread of the shared pool parallelize their work across the threads that are not busy
+// running other kernels.
+// Ignored when the session uses the thread pools of the environment or an external inter-op thread pool.
+// "0": default, create a separate inter-op thread pool.
+// "1": share the intra-op thread pool.
+static const char* const kOrtSessionOptionsConfigInterOpUseIntraOpThreadPool = "session.inter_op.use_intra_op_thread_pool";
+
+// Configure dynamic batching of the requests submitted with RunAsync.
+// Requests with the same inputs, outputs and run options, whose input shapes only differ in the batch axis, are
+// concatenated along the batch axis and run together. A batch is run once the sum of the batch dimensions of its
+// requests reaches the maximum batch size, or when its first request has waited for the maximum wait time.
+// The outputs are split along the batch axis, so every output of the model must have the batch axis.
+// Only requests whose inputs are non-string CPU tensors and that don't provide preallocated outputs are batched,
+// other requests run on their own.
+// "session.batching.max_batch_size": maximum sum of the batch dimensions of the requests run together.
+//   "0" or "1": default, batching is disabled.
+// "session.batching.max_wait_us": maximum time in microseconds a request waits for other requests. Default "1000".
+// "session.batching.batch_axis": axis of the inputs and outputs that requests are concatenated along. Default "0".
+static const char* const kOrtSessionOptionsConfigBatchingMaxBatchSize = "session.batching.max_batch_size";
+static const char* const kOrtSessionOptionsConfigBatchingMaxWaitUs = "session.batching.max_wait_us";
+static const char* const kOrtSessionOptionsConfigBatchingBatchAxis = "session.batching.batch_axis";
+
+// Configure the specialization of the session to the input shapes it is run with most often.
+// Runs are counted by the values of the symbolic dimensions of the graph inputs. Once the same values have been seen
+// in the given number of runs, a copy of the session with these dimensions fixed is created on a background thread,
+// and the later runs with these values use it. As all the shapes of the copy are known, its Shape nodes and the shape
+// computations depending on them are constant folded and its memory is planned for the static shapes.
+// Runs with other values keep using the original session.
+// Only sessions of ONNX models that run on the CPU execution provider alone are specialized.
+// Memory cost: each specialized session loads the model again. It shares the initializers of the original session
+// that its graph optimizations leave unchanged, but owns its pre-packed weights and the initializers that the original
+// session released after pre-packing them, which for models dominated by MatMul, Gemm or Conv weights is close to a
+// full copy of the weights per specialized session. A session created from model bytes also keeps a serialized copy
+// of the model until all its specialized sessions have been created.
+// "session.shape_specialization.min_runs": number of runs with the same values of the symbolic dimensions after
+//   which a specialized session is created.
+//   "0": default, shape specialization is disabled.
+// "session.shape_specialization.max_sessions": maximum number of specialized sessions. Default "1".
+static const char* const kOrtSessionOptionsConfigShapeSpecializationMinRuns = "session.shape_specialization.min_runs";
+static const char* const kOrtSessionOptionsConfigShapeSpecializationMaxSessions =
+    "session.shape_specialization.max_sessions";
+
 // Key for using model bytes directly for ORT format
 // If a session is created using an input byte array contains the ORT format model data,
 // By default we will copy the model bytes at the time of session creation to ensure the model bytes
@@ -176,6 +260,13 @@ static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "e
 // Available since version 1.11.
 static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dynamic_block_base";
 
+// Maximum number of per-input-shape memory patterns cached by a session when memory pattern optimization is enabled.
+// A memory pattern is traced from the first Run with a given combination of input shapes.
+// Later Runs with the same input shapes pre-allocate all planned activations in one buffer per device.
+// When the cache is full the least recently used pattern is evicted.
+// The value should be a positive integer. The default is "64".
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheCapacity = "session.memory_pattern_cache_capacity";
+
 // This option allows to decrease CPU usage between infrequent
 // requests and forces any TP threads spinning stop immediately when the last of
 // concurrent Run() call returns.
@@ -214,6 +305,56 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Configure NUMA-aware placement of the intra-op threads and of the CPU memory on hosts with several NUMA nodes.
+// The intra-op threads of the session are bound to NUMA nodes, and a parallel loop only runs on the threads of the
+// node of the thread that starts it. If no affinities are set, the threads are spread over the nodes in proportion to
+// their number of logical processors. With affinities, a thread belongs to the node of its first logical processor.
+// The CPU execution provider that the session adds by default creates an arena for each node, whose memory is bound
+// to the node, and serves an allocation from the arena of the node the calling thread runs on.
+// Has no effect on hosts with a single NUMA node or on platforms where ORT doesn't read the NUMA topology.
+// "0": default, not NUMA-aware.
+// "1": NUMA-aware.
+static const char* const kOrtSessionOptionsConfigNumaAware = "session.numa_aware";
+
+// Configure whether the CPU GEMM kernels keep a copy of their pre-packed weights on each NUMA node, and read the
+// copy on the node of the thread that runs them. Mostly useful together with kOrtSessionOptionsConfigNumaAware,
+// which keeps the threads of a kernel on one node. Multiplies the memory used by the pre-packed weights by the
+// number of nodes. Ignored by sessions that share their pre-packed weights with a PrepackedWeightsContainer, as
+// each of them would otherwise make its own copies of the shared weights.
+// "0": default, a single copy.
+// "1": a copy on each NUMA node.
+static const char* const kOrtSessionOptionsConfigNumaReplicateWeights = "session.numa_replicate_weights";
+
+// Configure whether the session keeps statistics of the kernels it runs: a latency histogram and the bytes of the
+// outputs of each node. Unlike profiling, the statistics don't record each run of a kernel, so they can stay enabled
+// in production. Each thread that runs kernels records into its own counters without locking.
+// The statistics are read with OrtApi::SessionGetKernelStats.
+// "0": default, no statistics.
+// "1": keep the statistics.
+static const char* const kOrtSessionOptionsConfigEnableKernelStats = "session.enable_kernel_stats";
+
+// Configure TunableOp for the CPU execution provider. The CPU MatMul and Gemm kernels then use the MLAS SGEMM slice
+// sizes recorded for each shape in the tuning results of the session, instead of the built-in ones.
+// The tuning results are read with InferenceSession::GetTuningResults (get_tuning_results in Python) and can be
+// embedded into the model metadata with onnxruntime/python/tools/offline_tuning.py, from where they are loaded, and
+// TunableOp enabled, when the session is created. The results carry the model name of the CPU they were produced on
+// and are only loaded on a CPU of the same model, so the results of several CPU models can be embedded side by side.
+// "0": default, the built-in slice sizes are used.
+// "1": the slice sizes from the tuning results are used.
+static const char* const kOrtSessionOptionsConfigCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Configure whether the CPU TunableOp benchmarks the candidate slice sizes for the shapes without a tuning result,
+// and records the fastest in the tuning results. The first run of each new shape is slower.
+// Requires kOrtSessionOptionsConfigCpuTunableOpEnable.
+// "0": default, no tuning.
+// "1": tune new shapes.
+static const char* const kOrtSessionOptionsConfigCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// Maximum time in milliseconds spent benchmarking each candidate when the CPU TunableOp tunes a shape. "0", the
+// default, only bounds the benchmark by its number of iterations.
+static const char* const kOrtSessionOptionsConfigCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -289,11 +430,25 @@ static const char* const kOrtSessionOptionsEpContextModelExternalInitializersFil
     "ep.context_model_external_initializers_file_name";
 
 // Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul.
+// It is used on ARM64 Linux with bf16 support and on x86-64 with AVX512-BF16 support.
 // Option values:
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
 // - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathBfloat16 = "mlas.enable_gemm_fastmath_bfloat16";
+
+// Same as kOrtSessionOptionsMlasGemmFastMathBfloat16. Kept for existing ARM64 users.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// The CPU MatMul kernel measures the sparsity of its constant float weight when pre-packing it, and packs the weight
+// in a block sparse or 2:4 structured sparse format of MLAS when the format skips at least this fraction of the
+// weight and is estimated to run faster than the dense SGEMM. The sparse formats skip the zero blocks of the weight
+// (the unused positions of the 2:4 groups), so an infinite or NaN input that only meets such zero weights does not
+// propagate NaN to the output, as it does with the dense SGEMM. Outputs for non-finite inputs can therefore differ.
+// Option values:
+// - A number between "0" and "1". Default is "0.7".
+// - "1": sparse formats are not used.
+static const char* const kOrtSessionOptionsMlasSparseGemmMinimumSparsity = "mlas.sparse_gemm_minimum_sparsity";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
@@ -10,10 +10,27 @@
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
 
+// Additive bias of the attention scores in float, with shape (B or 1, N or 1, S or 1, T) where T is the total
+// sequence length. The strides of the broadcast dims are 0.
+struct GQAAttentionBias {
+  const float* data = nullptr;
+  size_t batch_stride = 0;
+  size_t head_stride = 0;
+  size_t row_stride = 0;
+
+  // Returns the S x T bias of a head, or nullptr if there is no bias.
+  const float* Get(size_t batch_index, size_t head_index) const {
+    return data != nullptr ? data + batch_index * batch_stride + head_index * head_stride : nullptr;
+  }
+};
+
 class GQAAttentionBase {
  protected:
   GQAAttentionBase(const OpKernelInfo& info, bool has_local) {
@@ -34,6 +51,11 @@ class GQAAttentionBase {
     use_smooth_softmax_ = info.GetAttrOrDefault<int64_t>("smooth_softmax", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    kv_cache_bit_width_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("kv_cache_bit_width", 0));
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -43,9 +65,13 @@ class GQAAttentionBase {
   bool do_rotary_;  // whether or not to use rotary embeddings
   bool rotary_interleaved_;
   int local_window_size_;
+  int kv_cache_bit_width_;  // 8 if the past and present key and value are quantized, else 0
 
   bool use_smooth_softmax_;
 
+  bool disable_flash_;
+  int l2_cache_size_;
+
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
                         const T* K,                                 // K data with shape BxN_kvxSxH
@@ -56,6 +82,7 @@ class GQAAttentionBase {
                         Tensor* present_key,                        // present K output tensor (if separating present KV)
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
+                        const GQAAttentionBias& attention_bias,     // optional bias added to the scores
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
@@ -74,12 +101,6 @@ class GQAAttentionBase {
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
-    // Compute the attention score.
-    // TODO(fajin): type depends on kernel supportability
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
-
     const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
     T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
     const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
@@ -87,10 +108,27 @@ class GQAAttentionBase {
 
     bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
 
+    if constexpr (std::is_same<T, float>::value) {
+      if (!disable_flash_ && softcap_ == 0.0f && !use_smooth_softmax_ && l2_cache_size_ > 0 &&
+          attention_bias.data == nullptr && present_key_data != nullptr && present_value_data != nullptr) {
+        return ApplyFlashAttention(Q, K, V, output, seqlens_k->Data<int32_t>(), batch_size, sequence_length,
+                                   seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
+                                   present_key_data, past_value_data, present_value_data, past_present_share_buffer,
+                                   packed_qkv, is_prompt, tp, allocator);
+      }
+    }
+
+    // Compute the attention score.
+    // TODO(fajin): type depends on kernel supportability
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
-    ComputeAttentionProbs<T>(static_cast<float*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
-                             sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
-                             present_key_data, past_present_share_buffer, packed_qkv, is_prompt, tp, allocator);
+    ComputeAttentionProbs<T>(static_cast<float*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), attention_bias,
+                             batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
+                             past_key_data, present_key_data, past_present_share_buffer, packed_qkv, is_prompt, tp,
+                             allocator);
 
     // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
     const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
@@ -103,7 +141,374 @@ class GQAAttentionBase {
     return Status::OK();
   }
 
+  // Computes attention with the past and present key and value stored as uint8 with a zero point of 128 and one
+  // scale per KV head. The new keys and values are quantized as they are appended to the present state. Q x K' then
+  // runs as a u8s8 QGEMM of the quantized keys and the rows of Q quantized to int8, and the attention probs x V runs
+  // as a u8u8 QGEMM of the rows of the probs quantized to uint8 and the quantized values, so the decoding reads a
+  // quarter of the bytes of a float cache.
+  template <typename T>
+  Status ApplyAttentionQuantizedKV(const T* Q,                                 // Q data with shape BxNxSxH
+                                   const T* K,                                 // K data with shape BxN_kvxSxH
+                                   const T* V,                                 // V data with shape BxN_kvxSxH
+                                   const Tensor* past_key,                     // past K input tensor
+                                   const Tensor* past_value,                   // past V input tensor
+                                   Tensor* output,                             // output tensor
+                                   Tensor* present_key,                        // present K output tensor
+                                   Tensor* present_value,                      // present V output tensor
+                                   const float* k_scale,                       // scales of K with size N_kv or 1
+                                   const float* v_scale,                       // scales of V with size N_kv or 1
+                                   const bool per_head_scale,                  // whether there is a scale per head
+                                   const Tensor* seqlens_k,                    // past sequence lengths tensor
+                                   const GQAAttentionBias& attention_bias,     // optional bias added to the scores
+                                   GroupQueryAttentionParameters& parameters,  // attention parameters
+                                   AllocatorPtr allocator,                     // allocator for temporary tensors
+                                   OpKernelContext* context) const {
+    const bool is_prompt = parameters.is_first_prompt;
+    const size_t batch_size = static_cast<size_t>(parameters.batch_size);
+    const size_t sequence_length = static_cast<size_t>(parameters.sequence_length);
+    const size_t head_size = static_cast<size_t>(parameters.head_size);
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const int32_t* seqlens = seqlens_k->Data<int32_t>();
+    T* output_data = output->MutableData<T>();
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    size_t past_buffer_sequence_length = 0;
+    if (past_key != nullptr && past_value != nullptr) {
+      past_buffer_sequence_length = static_cast<size_t>(past_key->Shape().GetDims()[2]);
+    }
+    const size_t present_buffer_sequence_length = static_cast<size_t>(present_key->Shape().GetDims()[2]);
+
+    const uint8_t* past_key_data = past_key != nullptr ? past_key->Data<uint8_t>() : nullptr;
+    uint8_t* present_key_data = present_key->MutableData<uint8_t>();
+    const uint8_t* past_value_data = past_value != nullptr ? past_value->Data<uint8_t>() : nullptr;
+    uint8_t* present_value_data = present_value->MutableData<uint8_t>();
+
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_num_heads_factor = static_cast<size_t>(num_heads_ / kv_num_heads_);
+    const size_t input_chunk_length = sequence_length * head_size;                        // S x H
+    const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;        // L x H
+    const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;  // T x H
+
+    constexpr uint8_t kv_zero_point = 128;
+
+    const T* k = packed_qkv ? Q + num_heads_ * input_chunk_length : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * input_chunk_length : V;
+
+    // Append the quantized new keys and values to the present state.
+    TensorOpCost append_cost;
+    append_cost.bytes_loaded = static_cast<double>(2 * (past_buff_chunk_length + input_chunk_length * sizeof(T)));
+    append_cost.bytes_stored = static_cast<double>(2 * present_buff_chunk_length);
+    append_cost.compute_cycles = static_cast<double>(2 * input_chunk_length);
+
+    const std::ptrdiff_t append_loop_len = SafeInt<std::ptrdiff_t>(batch_size) * kv_num_heads_;
+    ThreadPool::TryParallelFor(tp, append_loop_len, append_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<float> row_fp32(std::is_same<T, float>::value ? 0 : head_size);
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const std::ptrdiff_t batch_index = i / kv_num_heads_;
+        const std::ptrdiff_t kv_head_index = i % kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(seqlens[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t past_chunk_length = past_seqlen * head_size;
+        const std::ptrdiff_t input_offset =
+            packed_qkv ? packed_batch_stride * batch_index + input_chunk_length * kv_head_index
+                       : input_chunk_length * i;
+        const std::ptrdiff_t scale_index = per_head_scale ? kv_head_index : 0;
+
+        for (int kv = 0; kv < 2; kv++) {
+          const uint8_t* past = kv == 0 ? past_key_data : past_value_data;
+          uint8_t* present = (kv == 0 ? present_key_data : present_value_data) + i * present_buff_chunk_length;
+          const T* input = (kv == 0 ? k : v) + input_offset;
+          const float scale = (kv == 0 ? k_scale : v_scale)[scale_index];
+
+          if (!past_present_share_buffer) {
+            if (past_chunk_length > 0) {
+              memcpy(present, past + i * past_buff_chunk_length, past_chunk_length);
+            }
+            memset(present + past_chunk_length, kv_zero_point, present_buff_chunk_length - past_chunk_length);
+          }
+
+          for (size_t seq = 0; seq < sequence_length; seq++) {
+            const float* row;
+            if constexpr (std::is_same<T, float>::value) {
+              row = input + seq * head_size;
+            } else {
+              MlasConvertHalfToFloatBuffer(input + seq * head_size, row_fp32.data(), head_size);
+              row = row_fp32.data();
+            }
+            MlasQuantizeLinear(row, present + past_chunk_length + seq * head_size, head_size, scale, kv_zero_point);
+          }
+        }
+      }
+    });
+
+    // Compute the attention of each head.
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length + input_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(input_chunk_length * sizeof(T));
+
+    const std::ptrdiff_t loop_len = SafeInt<std::ptrdiff_t>(batch_size) * num_heads_;
+    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = static_cast<size_t>(i) / num_heads_;
+        const size_t head_index = static_cast<size_t>(i) % num_heads_;
+        const size_t kv_head_index = head_index / kv_num_heads_factor;
+        const size_t total_seqlen = static_cast<size_t>(seqlens[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t scale_index = per_head_scale ? kv_head_index : 0;
+
+        const size_t kv_offset = (batch_index * kv_num_heads_ + kv_head_index) * present_buff_chunk_length;
+        const uint8_t* k_quant = present_key_data + kv_offset;
+        const uint8_t* v_quant = present_value_data + kv_offset;
+
+        const T* q;
+        if (packed_qkv) {
+          q = Q + packed_batch_stride * batch_index + input_chunk_length * head_index;
+        } else {
+          q = Q + input_chunk_length * i;
+        }
+
+        // The scratch buffer holds, in order, the S x T scores and probs, the S scales of Q and of the probs, the
+        // S x H rows of Q and of the output in float, the T x S and S x H products, the S x H quantized Q, the
+        // H x S transposed quantized Q and the S x T quantized probs.
+        const size_t scores_length = sequence_length * total_seqlen;
+        const size_t float_count = scores_length + 2 * sequence_length + 2 * input_chunk_length;
+        const size_t int32_count = scores_length + input_chunk_length;
+        const size_t bytes = SafeInt<size_t>(float_count + int32_count) * sizeof(float) + 2 * input_chunk_length +
+                             scores_length;
+        auto scratch = allocator->Alloc(bytes);
+        BufferUniquePtr scratch_buffer(scratch, BufferDeleter(allocator));
+
+        float* scores = static_cast<float*>(scratch);
+        float* q_scales = scores + scores_length;
+        float* probs_scales = q_scales + sequence_length;
+        float* q_fp32 = probs_scales + sequence_length;
+        float* output_fp32 = q_fp32 + input_chunk_length;
+        int32_t* qk = reinterpret_cast<int32_t*>(output_fp32 + input_chunk_length);
+        int32_t* pv = qk + scores_length;
+        int8_t* q_rows_quant = reinterpret_cast<int8_t*>(pv + input_chunk_length);
+        int8_t* q_quant = q_rows_quant + input_chunk_length;
+        uint8_t* probs_quant = reinterpret_cast<uint8_t*>(q_quant + input_chunk_length);
+
+        // Quantize each row of Q to int8 with its own scale, transposed to H x S for the QGEMM.
+        const float* q_rows;
+        if constexpr (std::is_same<T, float>::value) {
+          q_rows = q;
+        } else {
+          MlasConvertHalfToFloatBuffer(q, q_fp32, input_chunk_length);
+          q_rows = q_fp32;
+        }
+        for (size_t seq = 0; seq < sequence_length; seq++) {
+          const float* q_row = q_rows + seq * head_size;
+          int8_t* q_row_quant = q_rows_quant + seq * head_size;
+          float min_value;
+          float max_value;
+          MlasFindMinMaxElement(q_row, &min_value, &max_value, head_size);
+          const float max_abs = std::max(-min_value, max_value);
+          q_scales[seq] = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+
+          MlasQuantizeLinear(q_row, q_row_quant, head_size, q_scales[seq], static_cast<int8_t>(0));
+          for (size_t h = 0; h < head_size; h++) {
+            q_quant[h * sequence_length + seq] = q_row_quant[h];
+          }
+        }
+
+        // Compute K x Q' as a T x S product, which is Q x K' transposed.
+        MLAS_GEMM_QUANT_SHAPE_PARAMS qk_shape;
+        qk_shape.M = total_seqlen;
+        qk_shape.N = sequence_length;
+        qk_shape.K = head_size;
+        qk_shape.AIsSigned = false;
+        qk_shape.BIsSigned = true;
+
+        const uint8_t q_zero_point = 0;
+        MLAS_GEMM_QUANT_DATA_PARAMS qk_data;
+        qk_data.A = k_quant;
+        qk_data.lda = head_size;
+        qk_data.ZeroPointA = kv_zero_point;
+        qk_data.B = q_quant;
+        qk_data.ldb = sequence_length;
+        qk_data.ZeroPointB = &q_zero_point;
+        qk_data.C = qk;
+        qk_data.ldc = sequence_length;
+        MlasGemm(qk_shape, qk_data, nullptr);
+
+        for (size_t seq = 0; seq < sequence_length; seq++) {
+          const float qk_scale = alpha * k_scale[scale_index] * q_scales[seq];
+          for (size_t t = 0; t < total_seqlen; t++) {
+            scores[seq * total_seqlen + t] = static_cast<float>(qk[t * sequence_length + seq]) * qk_scale;
+          }
+        }
+
+        ComputeAttentionSoftmax(scores, sequence_length, past_seqlen, total_seqlen, total_seqlen,
+                                attention_bias.Get(batch_index, head_index), attention_bias.row_stride);
+
+        // Quantize each row of the probs to uint8 with its own scale, then compute probs x V.
+        for (size_t seq = 0; seq < sequence_length; seq++) {
+          const float* probs_row = scores + seq * total_seqlen;
+          float min_value;
+          float max_value;
+          MlasFindMinMaxElement(probs_row, &min_value, &max_value, total_seqlen);
+          probs_scales[seq] = max_value > 0.0f ? max_value / 255.0f : 1.0f;
+          MlasQuantizeLinear(probs_row, probs_quant + seq * total_seqlen, total_seqlen, probs_scales[seq],
+                             static_cast<uint8_t>(0));
+        }
+
+        MLAS_GEMM_QUANT_SHAPE_PARAMS pv_shape;
+        pv_shape.M = sequence_length;
+        pv_shape.N = head_size;
+        pv_shape.K = total_seqlen;
+        pv_shape.AIsSigned = false;
+        pv_shape.BIsSigned = false;
+
+        MLAS_GEMM_QUANT_DATA_PARAMS pv_data;
+        pv_data.A = probs_quant;
+        pv_data.lda = total_seqlen;
+        pv_data.ZeroPointA = 0;
+        pv_data.B = v_quant;
+        pv_data.ldb = head_size;
+        pv_data.ZeroPointB = &kv_zero_point;
+        pv_data.C = pv;
+        pv_data.ldc = head_size;
+        MlasGemm(pv_shape, pv_data, nullptr);
+
+        // Dequantize to the output with shape BxSxNxH.
+        for (size_t seq = 0; seq < sequence_length; seq++) {
+          const float pv_scale = v_scale[scale_index] * probs_scales[seq];
+          float* output_row = output_fp32 + seq * head_size;
+          for (size_t h = 0; h < head_size; h++) {
+            output_row[h] = static_cast<float>(pv[seq * head_size + h]) * pv_scale;
+          }
+
+          T* output_current =
+              output_data + ((batch_index * sequence_length + seq) * num_heads_ + head_index) * head_size;
+          if constexpr (std::is_same<T, float>::value) {
+            memcpy(output_current, output_row, head_size * sizeof(float));
+          } else {
+            MlasConvertFloatToHalfBuffer(output_row, output_current, head_size);
+          }
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
  private:
+  // Appends the new keys and values to the present state, then runs the fused attention kernel of MLAS on it. The
+  // kernel applies the causal mask, the local window and the sequence length of each batch block by block, so it
+  // skips the keys that no query sees and never materializes the BxNxSxT attention probs.
+  Status ApplyFlashAttention(const float* Q,                            // Q data with shape BxNxSxH
+                             const float* K,                            // K data with shape BxN_kvxSxH
+                             const float* V,                            // V data with shape BxN_kvxSxH
+                             Tensor* output,                            // output tensor with shape BxSxNxH
+                             const int32_t* seqlens_k,                  // total - 1 sequence lengths
+                             const int batch_size,                      // batch size
+                             const int sequence_length,                 // sequence length of Q (S)
+                             const int past_buffer_sequence_length,     // sequence length of past state
+                             const int present_buffer_sequence_length,  // sequence length of present state
+                             const int head_size,                       // head size of Q, K, V
+                             const float* past_key,                     // past key only
+                             float* present_key,                        // present key only
+                             const float* past_value,                   // past value only
+                             float* present_value,                      // present value only
+                             const bool past_present_share_buffer,      // whether past and present share a buffer
+                             const bool packed_qkv,                     // whether Q, K, V are packed
+                             const bool is_prompt,                      // whether it is prompt
+                             ThreadPool* tp,                            // thread pool
+                             AllocatorPtr allocator) const {            // allocator for temporary buffer
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;              // S x H
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;  // L x H
+    const size_t present_buff_chunk_length =
+        static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length *
+                                   sizeof(float);
+      memset(present_key, 0, present_bytes);
+      memset(present_value, 0, present_bytes);
+    }
+
+    const float* k = packed_qkv ? Q + num_heads_ * kv_input_chunk_length : K;
+    const float* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * kv_input_chunk_length : V;
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(float));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    const std::ptrdiff_t loop_len = static_cast<std::ptrdiff_t>(batch_size) * kv_num_heads_;
+    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const std::ptrdiff_t batch_index = i / kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(seqlens_k[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t past_chunk_length = past_seqlen * head_size;
+        const std::ptrdiff_t input_offset =
+            packed_qkv ? packed_batch_stride * batch_index + kv_input_chunk_length * (i % kv_num_heads_)
+                       : kv_input_chunk_length * i;
+        ConcatStateChunkGQA(past_key, k + input_offset, present_key, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                            past_present_share_buffer, i);
+        ConcatStateChunkGQA(past_value, v + input_offset, present_value, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                            past_present_share_buffer, i);
+      }
+    });
+
+    std::vector<int> total_sequence_lengths(batch_size);
+    for (int b = 0; b < batch_size; b++) {
+      total_sequence_lengths[b] = seqlens_k[b] + 1;
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = present_buffer_sequence_length;
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    // Same blocking as MultiHeadAttention: the blocks of Q, K, V, QK' and the output take 3/4 of the L2 cache.
+    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size));
+    args.kv_block_size = std::max(args.kv_block_size, 1);
+    args.q_block_size = std::min(args.kv_block_size, 2 * head_size);
+    args.kv_block_size = std::min(args.kv_block_size, present_buffer_sequence_length);
+    args.q_block_size = std::min(args.q_block_size, sequence_length);
+
+    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                  sizeof(float);
+    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+
+    args.query = Q;
+    args.key = present_key;
+    args.value = present_value;
+    args.output = output->MutableData<float>();
+    args.kv_num_heads = kv_num_heads_;
+    args.q_batch_stride = static_cast<size_t>(packed_batch_stride);
+    args.kv_sequence_lengths = total_sequence_lengths.data();
+    args.is_causal = true;
+    args.local_window_size = local_window_size_ > 0 ? local_window_size_ : -1;
+
+    MlasFlashAttention(&args, tp);
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -112,6 +517,7 @@ class GQAAttentionBase {
                              const T* Q,                                   // Q data. Its size is BxNxSxH
                              const T* K,                                   // k data. Its size is BxNxLxH
                              const int32_t* seqlens_k,                     // total - 1 sequence lengths tensor
+                             const GQAAttentionBias& attention_bias,       // optional bias added to the scores
                              const size_t batch_size,                      // batch size of self-attention
                              const size_t sequence_length,                 // sequence length of self-attention (S)
                              const size_t past_buffer_sequence_length,     // sequence length of past state
@@ -220,45 +626,57 @@ class GQAAttentionBase {
                                           output, static_cast<int>(present_buffer_sequence_length), nullptr);
         }
 
-        // compute Softmax
-        float* output_softmax = output;
-        for (size_t seq = 0; seq < sequence_length; seq++) {
-          size_t seq_causal_length = past_seqlen + seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > static_cast<size_t>(local_window_size_) + 1) {
-            for (size_t total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            if (softcap_ > 0.f) {
-              ComputeAttentionSoftcapInplace(output_softmax + seq_causal_length - local_window_size_ - 1,
-                                             local_window_size_ + 1, softcap_);
-            }
-            if (use_smooth_softmax_) {
-              ComputeSmoothSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                          local_window_size_ + 1, nullptr);
-            } else {
-              ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                             local_window_size_ + 1, nullptr);
-            }
-          } else {
-            if (softcap_ > 0.f) {
-              ComputeAttentionSoftcapInplace(output_softmax, static_cast<int>(seq_causal_length), softcap_);
-            }
-            if (use_smooth_softmax_) {
-              ComputeSmoothSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
-            } else {
-              ComputeAttentionSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
-            }
-          }
+        ComputeAttentionSoftmax(output, sequence_length, past_seqlen, total_seqlen, present_buffer_sequence_length,
+                                attention_bias.Get(batch_index, head_index), attention_bias.row_stride);
+      }
+    });
+  }
 
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (size_t total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
+  // Helper function to apply the causal mask, the local window, softcap, the attention bias and softmax in place to
+  // the attention scores of one head, given as S rows of total_seqlen scores with a stride of ld.
+  void ComputeAttentionSoftmax(float* output_softmax,  // scores with size SxT
+                               size_t sequence_length,  // sequence length of Q (S)
+                               size_t past_seqlen,      // number of past keys of the batch
+                               size_t total_seqlen,     // number of past and new keys of the batch
+                               size_t ld,               // stride of the rows of the scores
+                               const float* bias,       // optional bias of the scores with size SxT or 1xT
+                               size_t bias_ld) const {  // stride of the rows of the bias, 0 if broadcast
+    for (size_t seq = 0; seq < sequence_length; seq++) {
+      const size_t seq_causal_length = past_seqlen + seq + 1;
+
+      // Only the keys in [window_start, seq_causal_length) are attended.
+      size_t window_start = 0;
+      if (local_window_size_ > 0 && seq_causal_length > static_cast<size_t>(local_window_size_) + 1) {
+        window_start = seq_causal_length - local_window_size_ - 1;
+        for (size_t total_seq_id = 0; total_seq_id < window_start; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
+        }
+      }
+      float* window = output_softmax + window_start;
+      const int window_length = static_cast<int>(seq_causal_length - window_start);
 
-          output_softmax += present_buffer_sequence_length;
+      if (softcap_ > 0.f) {
+        ComputeAttentionSoftcapInplace(window, window_length, softcap_);
+      }
+      if (bias != nullptr) {
+        const float* bias_row = bias + seq * bias_ld + window_start;
+        for (int i = 0; i < window_length; i++) {
+          window[i] += bias_row[i];
         }
       }
-    });
+      if (use_smooth_softmax_) {
+        ComputeSmoothSoftmaxInplace(window, 1, window_length, nullptr);
+      } else {
+        ComputeAttentionSoftmaxInplace(window, 1, window_length, nullptr);
+      }
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (size_t total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += ld;
+    }
   }
 
   template <typename T>
@@ -22,16 +22,18 @@ namespace onnxruntime {
 namespace contrib {
 
 // These ops are internal-only, so register outside of onnx
-#define REGISTER_KERNEL_TYPED(T)                                        \
-  ONNX_OPERATOR_TYPED_KERNEL_EX(                                        \
-      GroupQueryAttention,                                              \
-      kMSDomain,                                                        \
-      1,                                                                \
-      T,                                                                \
-      kCpuExecutionProvider,                                            \
-      KernelDefBuilder()                                                \
-          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())        \
-          .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()), \
+#define REGISTER_KERNEL_TYPED(T)                                                     \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                     \
+      GroupQueryAttention,                                                           \
+      kMSDomain,                                                                     \
+      1,                                                                             \
+      T,                                                                             \
+      kCpuExecutionProvider,                                                         \
+      KernelDefBuilder()                                                             \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                     \
+          .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<T>(),              \
+                                      DataTypeImpl::GetTensorType<uint8_t>()})       \
+          .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),              \
       GroupQueryAttention<T>);
 
 REGISTER_KERNEL_TYPED(float)
@@ -39,7 +41,10 @@ REGISTER_KERNEL_TYPED(MLFloat16)
 
 template <typename T>
 GroupQueryAttention<T>::GroupQueryAttention(const OpKernelInfo& info)
-    : OpKernel(info), GQAAttentionBase(info, true) {}
+    : OpKernel(info), GQAAttentionBase(info, true) {
+  ORT_ENFORCE(kv_cache_bit_width_ == 0 || kv_cache_bit_width_ == 8,
+              "kv_cache_bit_width must be 0 or 8. Got ", kv_cache_bit_width_);
+}
 
 template <typename T>
 Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
@@ -52,6 +57,9 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen_tensor = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* k_scale = context->Input<Tensor>(9);
+  const Tensor* v_scale = context->Input<Tensor>(10);
+  const Tensor* attention_bias = context->Input<Tensor>(11);
 
   GroupQueryAttentionParameters parameters = {};
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
@@ -76,6 +84,43 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   int q_hidden_size = parameters.hidden_size;
   const bool packed_qkv = parameters.is_packed_qkv;
 
+  const bool quantized_kv_cache = kv_cache_bit_width_ == 8;
+  if (quantized_kv_cache) {
+    if (k_scale == nullptr || v_scale == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'k_scale' and 'v_scale' are required when kv_cache_bit_width is 8.");
+    }
+    if (k_scale->Shape().Size() != kv_num_heads_ && k_scale->Shape().Size() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'k_scale' is expected to have kv_num_heads or 1 elements, got ",
+                             k_scale->Shape().Size());
+    }
+    if (v_scale->Shape() != k_scale->Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'k_scale' and 'v_scale' shall have the same shape");
+    }
+    if (past_key != nullptr && (!past_key->IsDataType<uint8_t>() || !past_value->IsDataType<uint8_t>())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'past_key' and 'past_value' shall be uint8 when kv_cache_bit_width is 8.");
+    }
+  } else if (past_key != nullptr && (!past_key->IsDataType<T>() || !past_value->IsDataType<T>())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'past_key' and 'past_value' shall have the type of 'query' when kv_cache_bit_width "
+                           "is 0.");
+  }
+
+  if (attention_bias != nullptr) {
+    const auto& bias_dims = attention_bias->Shape().GetDims();
+    if (bias_dims.size() != 4 || (bias_dims[0] != batch_size && bias_dims[0] != 1) ||
+        (bias_dims[1] != num_heads_ && bias_dims[1] != 1) || (bias_dims[2] != sequence_length && bias_dims[2] != 1) ||
+        bias_dims[3] != parameters.total_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'attention_bias' is expected to have shape (batch_size or 1, num_heads or 1, "
+                             "sequence_length or 1, total_sequence_length), got ",
+                             attention_bias->Shape());
+    }
+  }
+
   std::vector<int64_t> output_shape(3);
   output_shape[0] = static_cast<int64_t>(batch_size);
   output_shape[1] = static_cast<int64_t>(sequence_length);
@@ -192,10 +237,36 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   }
 
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  // The bias is added to the float scores, so a float16 bias is converted once for all the heads.
+  GQAAttentionBias bias;
+  IAllocatorUniquePtr<float> bias_fp32;
+  if (attention_bias != nullptr) {
+    const auto& bias_dims = attention_bias->Shape().GetDims();
+    if constexpr (std::is_same<T, float>::value) {
+      bias.data = attention_bias->Data<float>();
+    } else {
+      const size_t bias_size = static_cast<size_t>(attention_bias->Shape().Size());
+      bias_fp32 = IAllocator::MakeUniquePtr<float>(allocator, bias_size);
+      MlasConvertHalfToFloatBuffer(attention_bias->Data<T>(), bias_fp32.get(), bias_size);
+      bias.data = bias_fp32.get();
+    }
+    bias.row_stride = bias_dims[2] == 1 ? 0 : static_cast<size_t>(bias_dims[3]);
+    bias.head_stride = bias_dims[1] == 1 ? 0 : static_cast<size_t>(bias_dims[2] * bias_dims[3]);
+    bias.batch_stride = bias_dims[0] == 1 ? 0 : static_cast<size_t>(bias_dims[1] * bias_dims[2] * bias_dims[3]);
+  }
+
+  if (quantized_kv_cache) {
+    return ApplyAttentionQuantizedKV(q_rotary, packed_qkv ? nullptr : k_rotary,
+                                     packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output,
+                                     present_k, present_v, k_scale->Data<float>(), v_scale->Data<float>(),
+                                     k_scale->Shape().Size() != 1, seqlens_k, bias, parameters, allocator, context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(q_rotary, packed_qkv ? nullptr : k_rotary, packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(),
                         past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+                        seqlens_k, bias, parameters, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -145,10 +145,21 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(MaybeTransposeToBNSHAndAddBias<T>(
       context, allocator, batch_size, num_heads_, kv_sequence_length, v_head_size, value, bias, v_bias_offset, V));
 
+  // Flash attention handles a causal mask when the queries and keys are the same tokens, and a key padding mask
+  // given as the number of valid keys of each batch. Batches without any valid key use the unfused path, which
+  // averages all the values.
+  const int32_t* key_sequence_lengths = nullptr;
+  bool flash_supports_mask = key_padding_mask == nullptr;
+  if (key_padding_mask != nullptr && parameters.mask_type == AttentionMaskType::MASK_1D_KEY_SEQ_LEN) {
+    key_sequence_lengths = key_padding_mask->Data<int32_t>();
+    flash_supports_mask = std::all_of(key_sequence_lengths, key_sequence_lengths + batch_size,
+                                      [](int32_t length) { return length > 0; });
+  }
+
   if (std::is_same_v<T, float> &&
       !disable_flash_ &&
-      !is_unidirectional_ &&
-      key_padding_mask == nullptr &&
+      (!is_unidirectional_ || q_sequence_length == kv_sequence_length) &&
+      flash_supports_mask &&
       attn_bias == nullptr &&
       past_key == nullptr &&
       past_value == nullptr &&
@@ -204,6 +215,8 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
     args.key = K.Get<Tensor>().Data<float>();
     args.value = V.Get<Tensor>().Data<float>();
     args.output = output->MutableData<float>();
+    args.kv_sequence_lengths = key_sequence_lengths;
+    args.is_causal = is_unidirectional_;
 
     MlasFlashAttention(&args, tp);
     return Status::OK();
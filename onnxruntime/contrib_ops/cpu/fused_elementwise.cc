@@ -0,0 +1,364 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", BuildKernelDefConstraints<float, bool>())
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of output elements evaluated at a time. The results of the steps of a tile stay in cache
+// until the following steps read them.
+constexpr std::ptrdiff_t kTileSize = 1024;
+
+struct OpInfo {
+  const char* name;
+  FusedElementwiseOp op;
+  size_t arity;
+  // Rough cost of an element used to partition the tiles across threads.
+  double cycles;
+};
+
+constexpr OpInfo kOpInfos[] = {
+    {"Add", FusedElementwiseOp::Add, 2, 1.0},
+    {"Sub", FusedElementwiseOp::Sub, 2, 1.0},
+    {"Mul", FusedElementwiseOp::Mul, 2, 1.0},
+    {"Div", FusedElementwiseOp::Div, 2, 2.0},
+    {"Max", FusedElementwiseOp::Max, 2, 1.0},
+    {"Min", FusedElementwiseOp::Min, 2, 1.0},
+    {"Relu", FusedElementwiseOp::Relu, 1, 1.0},
+    {"Sigmoid", FusedElementwiseOp::Sigmoid, 1, 8.0},
+    {"Tanh", FusedElementwiseOp::Tanh, 1, 8.0},
+    {"Exp", FusedElementwiseOp::Exp, 1, 8.0},
+    {"Log", FusedElementwiseOp::Log, 1, 8.0},
+    {"Sqrt", FusedElementwiseOp::Sqrt, 1, 2.0},
+    {"Reciprocal", FusedElementwiseOp::Reciprocal, 1, 2.0},
+    {"Neg", FusedElementwiseOp::Neg, 1, 1.0},
+    {"Abs", FusedElementwiseOp::Abs, 1, 1.0},
+    {"Where", FusedElementwiseOp::Where, 3, 1.0},
+};
+
+const OpInfo& GetOpInfo(FusedElementwiseOp op) {
+  return *std::find_if(std::begin(kOpInfos), std::end(kOpInfos), [op](const OpInfo& info) { return info.op == op; });
+}
+
+// An operand of a tile: either one value per element of the tile, or a single value broadcast over the
+// whole tile.
+struct TileValue {
+  const void* data;
+  bool is_scalar;
+};
+
+// Calls fn with an Eigen array expression of the n float values of the tile.
+template <typename Fn>
+void VisitTileValue(const TileValue& value, std::ptrdiff_t n, Fn&& fn) {
+  const float* data = static_cast<const float*>(value.data);
+  if (value.is_scalar) {
+    fn(Eigen::ArrayXf::Constant(n, *data));
+  } else {
+    fn(ConstEigenVectorArrayMap<float>(data, n));
+  }
+}
+
+template <typename Fn>
+void ComputeUnary(const TileValue& x, std::ptrdiff_t n, float* y, Fn&& fn) {
+  EigenVectorArrayMap<float> output(y, n);
+  VisitTileValue(x, n, [&](const auto& x_values) { output = fn(x_values); });
+}
+
+template <typename Fn>
+void ComputeBinary(const TileValue& a, const TileValue& b, std::ptrdiff_t n, float* y, Fn&& fn) {
+  EigenVectorArrayMap<float> output(y, n);
+  VisitTileValue(a, n, [&](const auto& a_values) {
+    VisitTileValue(b, n, [&](const auto& b_values) { output = fn(a_values, b_values); });
+  });
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  input_count_ = static_cast<int>(info.GetInputCount());
+
+  std::vector<std::string> ops;
+  ORT_THROW_IF_ERROR(info.GetAttrs<std::string>("ops", ops));
+  std::vector<int64_t> operands;
+  ORT_THROW_IF_ERROR(info.GetAttrs<int64_t>("operands", operands));
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one operator.");
+
+  size_t next_operand = 0;
+  for (const auto& name : ops) {
+    const auto* op_info = std::find_if(std::begin(kOpInfos), std::end(kOpInfos),
+                                       [&name](const OpInfo& info) { return name == info.name; });
+    ORT_ENFORCE(op_info != std::end(kOpInfos), "FusedElementwise does not support operator ", name);
+    ORT_ENFORCE(next_operand + op_info->arity <= operands.size(), "FusedElementwise is missing operands of ", name);
+
+    const int64_t value_count = static_cast<int64_t>(input_count_) + static_cast<int64_t>(steps_.size());
+    Step step{op_info->op, {}};
+    for (size_t i = 0; i < op_info->arity; ++i) {
+      const int64_t operand = operands[next_operand++];
+      ORT_ENFORCE(operand >= 0 && operand < value_count, "FusedElementwise operand ", operand,
+                  " does not refer to an input or the result of a previous operator.");
+      step.operands.push_back(operand);
+    }
+    ORT_ENFORCE(step.op != FusedElementwiseOp::Where || step.operands[0] < input_count_,
+                "The condition of a fused Where must be an input.");
+    steps_.push_back(std::move(step));
+  }
+  ORT_ENFORCE(next_operand == operands.size(), "FusedElementwise has more operands than its operators use.");
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  InlinedVector<const Tensor*> inputs(input_count_);
+  size_t output_rank = 0;
+  for (int i = 0; i < input_count_; ++i) {
+    inputs[i] = context->Input<Tensor>(i);
+    output_rank = std::max(output_rank, inputs[i]->Shape().NumDimensions());
+  }
+
+  // Only the conditions of Where are bool.
+  for (const auto& step : steps_) {
+    for (size_t j = 0; j < step.operands.size(); ++j) {
+      if (step.operands[j] < input_count_) {
+        const Tensor& input = *inputs[onnxruntime::narrow<size_t>(step.operands[j])];
+        const bool is_condition = step.op == FusedElementwiseOp::Where && j == 0;
+        ORT_RETURN_IF_NOT(is_condition ? input.IsDataType<bool>() : input.IsDataType<float>(),
+                          "FusedElementwise input ", step.operands[j], " has an unexpected type.");
+      }
+    }
+  }
+
+  // The output has the multidirectional broadcast shape of all the inputs.
+  TensorShapeVector output_dims(output_rank, 1);
+  for (const Tensor* input : inputs) {
+    const auto input_dims = input->Shape().GetDims();
+    const size_t offset = output_rank - input_dims.size();
+    for (size_t d = 0; d < input_dims.size(); ++d) {
+      int64_t& output_dim = output_dims[offset + d];
+      if (input_dims[d] == 1 || input_dims[d] == output_dim) {
+        continue;
+      }
+      if (output_dim != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise: inputs with shapes ",
+                               inputs[0]->Shape(), " and ", input->Shape(), " can not be broadcast.");
+      }
+      output_dim = input_dims[d];
+    }
+  }
+
+  Tensor& output = *context->Output(0, TensorShape(output_dims));
+  const std::ptrdiff_t output_size = onnxruntime::narrow<std::ptrdiff_t>(output.Shape().Size());
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // Coalesce the adjacent dimensions over which each input is either broadcast or not. full[d * input_count_ + i]
+  // is true if input i is not broadcast over the coalesced dimension d.
+  InlinedVector<int64_t> dims;
+  InlinedVector<bool> full;
+  InlinedVector<bool> dim_full(input_count_);
+  for (size_t d = 0; d < output_rank; ++d) {
+    if (output_dims[d] == 1) {
+      continue;
+    }
+    for (int i = 0; i < input_count_; ++i) {
+      const auto input_dims = inputs[i]->Shape().GetDims();
+      const size_t offset = output_rank - input_dims.size();
+      dim_full[i] = d >= offset && input_dims[d - offset] != 1;
+    }
+    if (!dims.empty() && std::equal(dim_full.begin(), dim_full.end(), full.end() - input_count_)) {
+      dims.back() *= output_dims[d];
+    } else {
+      dims.push_back(output_dims[d]);
+      full.insert(full.end(), dim_full.begin(), dim_full.end());
+    }
+  }
+  if (dims.empty()) {
+    dims.push_back(1);
+    full.assign(input_count_, true);
+  }
+
+  const size_t rank = dims.size();
+  InlinedVector<int64_t> strides(rank * input_count_);
+  InlinedVector<const uint8_t*> input_data(input_count_);
+  InlinedVector<size_t> element_sizes(input_count_);
+  for (int i = 0; i < input_count_; ++i) {
+    int64_t stride = 1;
+    for (size_t d = rank; d-- > 0;) {
+      const bool is_full = full[d * input_count_ + i];
+      strides[d * input_count_ + i] = is_full ? stride : 0;
+      if (is_full) {
+        stride *= dims[d];
+      }
+    }
+    input_data[i] = static_cast<const uint8_t*>(inputs[i]->DataRaw());
+    element_sizes[i] = inputs[i]->DataType()->Size();
+  }
+
+  const std::ptrdiff_t inner = onnxruntime::narrow<std::ptrdiff_t>(dims.back());
+  const std::ptrdiff_t rows = output_size / inner;
+  const std::ptrdiff_t tiles_per_row = (inner + kTileSize - 1) / kTileSize;
+  const std::ptrdiff_t tile_size = std::min(inner, kTileSize);
+  const int64_t* inner_strides = strides.data() + (rank - 1) * input_count_;
+  float* output_data = output.MutableData<float>();
+
+  double cycles = 0.0;
+  for (const auto& step : steps_) {
+    cycles += GetOpInfo(step.op).cycles;
+  }
+  const TensorOpCost cost{static_cast<double>(tile_size * sizeof(float) * input_count_),
+                          static_cast<double>(tile_size * sizeof(float)),
+                          static_cast<double>(tile_size) * cycles};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), rows * tiles_per_row, cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> scratch(steps_.size() * tile_size);
+        InlinedVector<TileValue> values(input_count_ + steps_.size());
+        InlinedVector<int64_t> offsets(input_count_);
+
+        for (std::ptrdiff_t tile = first; tile < last; ++tile) {
+          const std::ptrdiff_t row = tile / tiles_per_row;
+          const std::ptrdiff_t start = (tile % tiles_per_row) * kTileSize;
+          const std::ptrdiff_t n = std::min(kTileSize, inner - start);
+
+          for (int i = 0; i < input_count_; ++i) {
+            offsets[i] = start * inner_strides[i];
+          }
+          std::ptrdiff_t remainder = row;
+          for (size_t d = rank - 1; d-- > 0;) {
+            const int64_t index = remainder % dims[d];
+            remainder /= dims[d];
+            for (int i = 0; i < input_count_; ++i) {
+              offsets[i] += index * strides[d * input_count_ + i];
+            }
+          }
+          for (int i = 0; i < input_count_; ++i) {
+            values[i] = {input_data[i] + offsets[i] * element_sizes[i], inner_strides[i] == 0};
+          }
+
+          float* tile_output = output_data + row * inner + start;
+          for (size_t s = 0; s < steps_.size(); ++s) {
+            const auto& step = steps_[s];
+            const TileValue& x = values[onnxruntime::narrow<size_t>(step.operands[0])];
+            const TileValue* y = step.operands.size() > 1 ? &values[onnxruntime::narrow<size_t>(step.operands[1])]
+                                                          : nullptr;
+            TileValue& result = values[input_count_ + s];
+
+            if (step.op == FusedElementwiseOp::Where) {
+              const TileValue& z = values[onnxruntime::narrow<size_t>(step.operands[2])];
+              if (x.is_scalar) {
+                // The tile selects one of the operands as is.
+                result = *static_cast<const bool*>(x.data) ? *y : z;
+                continue;
+              }
+              float* result_data = (s + 1 == steps_.size()) ? tile_output : scratch.data() + s * tile_size;
+              Eigen::Map<const Eigen::Array<bool, Eigen::Dynamic, 1>> condition(static_cast<const bool*>(x.data), n);
+              EigenVectorArrayMap<float> output_values(result_data, n);
+              VisitTileValue(*y, n, [&](const auto& y_values) {
+                VisitTileValue(z, n, [&](const auto& z_values) {
+                  output_values = condition.select(y_values, z_values);
+                });
+              });
+              result = {result_data, false};
+              continue;
+            }
+
+            // An operator of values that are constant over the tile is evaluated once.
+            const bool is_scalar = x.is_scalar && (y == nullptr || y->is_scalar);
+            const std::ptrdiff_t length = is_scalar ? 1 : n;
+            float* result_data =
+                (s + 1 == steps_.size() && !is_scalar) ? tile_output : scratch.data() + s * tile_size;
+            const float* x_data = static_cast<const float*>(x.data);
+
+            switch (step.op) {
+              case FusedElementwiseOp::Add:
+                ComputeBinary(x, *y, length, result_data, [](const auto& a, const auto& b) { return a + b; });
+                break;
+              case FusedElementwiseOp::Sub:
+                ComputeBinary(x, *y, length, result_data, [](const auto& a, const auto& b) { return a - b; });
+                break;
+              case FusedElementwiseOp::Mul:
+                ComputeBinary(x, *y, length, result_data, [](const auto& a, const auto& b) { return a * b; });
+                break;
+              case FusedElementwiseOp::Div:
+                ComputeBinary(x, *y, length, result_data, [](const auto& a, const auto& b) { return a / b; });
+                break;
+              case FusedElementwiseOp::Max:
+                ComputeBinary(x, *y, length, result_data, [](const auto& a, const auto& b) {
+                  return a.template max<Eigen::PropagateNaN>(b);
+                });
+                break;
+              case FusedElementwiseOp::Min:
+                ComputeBinary(x, *y, length, result_data, [](const auto& a, const auto& b) {
+                  return a.template min<Eigen::PropagateNaN>(b);
+                });
+                break;
+              case FusedElementwiseOp::Relu:
+                ComputeUnary(x, length, result_data, [](const auto& a) { return a.max(0.0f); });
+                break;
+              case FusedElementwiseOp::Neg:
+                ComputeUnary(x, length, result_data, [](const auto& a) { return -a; });
+                break;
+              case FusedElementwiseOp::Abs:
+                ComputeUnary(x, length, result_data, [](const auto& a) { return a.abs(); });
+                break;
+              case FusedElementwiseOp::Sigmoid:
+                MlasComputeLogistic(x_data, result_data, static_cast<size_t>(length));
+                break;
+              case FusedElementwiseOp::Tanh:
+                MlasComputeTanh(x_data, result_data, static_cast<size_t>(length));
+                break;
+              case FusedElementwiseOp::Exp:
+                MlasComputeExp(x_data, result_data, static_cast<size_t>(length));
+                break;
+              case FusedElementwiseOp::Log:
+                MlasComputeLog(x_data, result_data, static_cast<size_t>(length));
+                break;
+              case FusedElementwiseOp::Sqrt:
+                MlasComputeSqrt(x_data, result_data, static_cast<size_t>(length));
+                break;
+              case FusedElementwiseOp::Reciprocal:
+                MlasComputeReciprocal(x_data, result_data, static_cast<size_t>(length));
+                break;
+              default:
+                ORT_THROW("Unexpected FusedElementwise operator.");
+            }
+            result = {result_data, is_scalar};
+          }
+
+          const TileValue& y = values.back();
+          if (y.data != tile_output) {
+            const float* y_data = static_cast<const float*>(y.data);
+            if (y.is_scalar) {
+              std::fill_n(tile_output, n, *y_data);
+            } else {
+              std::memcpy(tile_output, y_data, n * sizeof(float));
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
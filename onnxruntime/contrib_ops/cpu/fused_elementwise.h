@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+enum class FusedElementwiseOp {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Max,
+  Min,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Exp,
+  Log,
+  Sqrt,
+  Reciprocal,
+  Neg,
+  Abs,
+  Where,
+};
+
+// Evaluates a subgraph of element-wise operators, as produced by ElementwiseFusion, tile by tile so
+// that the intermediate results stay in cache.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Step {
+    FusedElementwiseOp op;
+    // Value indices of the operands: inputs first, then the results of the previous steps.
+    InlinedVector<int64_t, 3> operands;
+  };
+
+  InlinedVector<Step> steps_;
+  int input_count_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
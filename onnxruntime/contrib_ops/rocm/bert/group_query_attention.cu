@@ -31,6 +31,7 @@ namespace rocm {
       kRocmExecutionProvider,                                          \
       (*KernelDefBuilder::Create())                                    \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())       \
+          .TypeConstraint("T_CACHE", DataTypeImpl::GetTensorType<T>()) \
           .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()) \
           .MayInplace(3, 1)                                            \
           .MayInplace(4, 2)                                            \
@@ -24,6 +24,7 @@ ONNX_OPERATOR_KERNEL_EX(
     kWebGpuExecutionProvider,
     (*KernelDefBuilder::Create())
         .TypeConstraint("T", WebGpuSupportedFloatTypes())
+        .TypeConstraint("T_CACHE", WebGpuSupportedFloatTypes())
         .MayInplace(3, 1)
         .MayInplace(4, 2)
         .InputMemoryType(OrtMemTypeCPUInput, 6),
@@ -39,6 +40,11 @@ Status GroupQueryAttention::ComputeInternal(onnxruntime::webgpu::ComputeContext&
   const Tensor* total_seqlen_tensor = context.Input<Tensor>(6);
   const Tensor* cos_cache = context.Input<Tensor>(7);
   const Tensor* sin_cache = context.Input<Tensor>(8);
+  if (context.Input<Tensor>(11) != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "Input 'attention_bias' of GroupQueryAttention is not supported by the WebGPU "
+                           "execution provider.");
+  }
 
   GroupQueryAttentionParameters params;
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
@@ -4,6 +4,8 @@
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
 
+#include <cstring>
+
 #ifdef __linux__
 
 #include <unistd.h>
@@ -139,6 +141,20 @@ void CPUIDInfo::X86Init() {
       }
     }
   }
+
+  // The processor brand string is returned by extended leaves 0x80000002 to 0x80000004.
+  GetCPUID(static_cast<int>(0x80000000), data);
+  if (static_cast<uint32_t>(data[0]) >= 0x80000004) {
+    char brand[3 * sizeof(data) + 1] = {};
+    for (int i = 0; i < 3; i++) {
+      GetCPUID(static_cast<int>(0x80000002 + i), data);
+      memcpy(brand + i * sizeof(data), data, sizeof(data));
+    }
+    cpu_model_name_ = brand;
+    const auto first = cpu_model_name_.find_first_not_of(' ');
+    const auto last = cpu_model_name_.find_last_not_of(' ');
+    cpu_model_name_ = (first == std::string::npos) ? "" : cpu_model_name_.substr(first, last - first + 1);
+  }
 }
 
 #endif  // defined(CPUIDINFO_ARCH_X86)
@@ -318,6 +334,8 @@ CPUIDInfo::CPUIDInfo() {
   if (!pytorch_cpuinfo_init_) {
     LOGS_DEFAULT(WARNING) << "Failed to initialize PyTorch cpuinfo library. May cause CPU EP performance degradation "
                              "due to undetected CPU features.";
+  } else if (cpuinfo_get_packages_count() > 0) {
+    cpu_model_name_ = cpuinfo_get_package(0)->name;
   }
 #endif  // defined(CPUINFO_SUPPORTED)
 #if defined(__linux__)
@@ -92,6 +92,13 @@ class CPUIDInfo {
     return has_fp16_;
   }
 
+  /**
+   * @return CPU model name, e.g. the x86 processor brand string, or an empty string if it is unknown
+   */
+  const std::string& GetCPUModelName() const {
+    return cpu_model_name_;
+  }
+
  private:
   CPUIDInfo();
   bool has_amx_bf16_{false};
@@ -105,6 +112,8 @@ class CPUIDInfo {
   bool has_sse4_1_{false};
   bool is_hybrid_{false};
 
+  std::string cpu_model_name_;
+
   std::vector<uint32_t> core_uarchs_;  // micro-arch of each core
 
   // In ARMv8 systems, some power efficient cores has narrower
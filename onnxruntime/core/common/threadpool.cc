@@ -389,6 +389,10 @@ ThreadPool::ThreadPool(Env* env,
       thread_options_.affinities.erase(thread_options_.affinities.begin());
       assert(thread_options_.affinities.size() >= size_t(threads_to_create));
     }
+    if (!thread_options_.numa_nodes.empty()) {
+      // Same for the NUMA node of the caller thread
+      thread_options_.numa_nodes.erase(thread_options_.numa_nodes.begin());
+    }
 
     extended_eigen_threadpool_ =
         std::make_unique<ThreadPoolTempl<Env> >(name,
@@ -518,11 +522,30 @@ ThreadPool::ParallelSection::~ParallelSection() {
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
+    // With a pool partitioned by NUMA node, the loop only runs on the workers of the caller's node so that it works
+    // on the memory of that node.  As for nested loops below, the work items claim iterations dynamically.
+    n = std::min(n, extended_eigen_threadpool_->MaxLoopDegreeOfParallelism());
+    if (n <= 1) {
+      fn(0);
+      return;
+    }
     if (current_parallel_section.has_value()) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
                                                    std::move(fn),
                                                    n, block_size);
     } else {
+      if (CurrentThreadId() != -1) {
+        // A loop started from a task running on one of our own workers, such as a kernel that runs in the pool
+        // that serves both intra-op and inter-op work.  Only enlist the workers that are idle: the work items
+        // claim iterations dynamically, so the caller and any helpers complete the loop whatever their number,
+        // and pushing work to busy workers would only delay it behind their current tasks.
+        n = std::min(n, extended_eigen_threadpool_->NumIdleWorkers() + 1);
+        if (n <= 1) {
+          extended_eigen_threadpool_->CountNestedLoopRunInline();
+          fn(0);
+          return;
+        }
+      }
       underlying_threadpool_->RunInParallel(std::move(fn),
                                             n, block_size);
     }
@@ -664,6 +687,14 @@ std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+ThreadPoolUtilization ThreadPool::GetUtilization(const concurrency::ThreadPool* tp) {
+  ThreadPoolUtilization utilization;
+  if (tp && tp->extended_eigen_threadpool_) {
+    tp->extended_eigen_threadpool_->GetUtilization(utilization);
+  }
+  return utilization;
+}
+
 void ThreadPool::EnableSpinning() {
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->EnableSpinning();
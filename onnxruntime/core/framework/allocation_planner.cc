@@ -8,6 +8,7 @@
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <optional>
 #include "core/common/exceptions.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/safeint.h"
@@ -98,6 +99,7 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.buffer_slice.has_value()) out << " at offset " << elt_plan.buffer_slice->offset;
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
     } else {
@@ -226,6 +228,18 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // PlannedBufferSlice is the part of the buffer of another ml-value that an ml-value is planned to occupy.
+  struct PlannedBufferSlice {
+    OrtValueIndex buffer;
+    size_t offset;
+    TensorShape buffer_shape;
+  };
+
+  // buffer_slices_ : the ml-values that occupy a slice of another buffer, see ComputeBufferSlices().
+  InlinedHashMap<OrtValueIndex, PlannedBufferSlice> buffer_slices_;
+  // sliced_buffers_ : the ml-values whose buffer holds slices that are produced before the ml-value itself.
+  InlinedHashSet<OrtValueIndex> sliced_buffers_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -292,6 +306,8 @@ class PlannerImpl {
     auto& symplan = AllocPlan(reused_for);
     symplan.alloc_kind = alloc_kind;
     symplan.reused_buffer = original;
+    // reusing a slice of a buffer (e.g. in-place on an output of Split) reuses the same slice.
+    symplan.buffer_slice = AllocPlan(reused).buffer_slice;
   }
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
@@ -428,7 +444,10 @@ class PlannerImpl {
         bool can_strided = true;
         for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
           const KernelCreateInfo& output_node_ci = GetKernelCreateInfo(kernel_create_info_map_, it->Index());
-          if (!output_node_ci.kernel_def) {
+          // Subgraphs read implicit inputs as contiguous tensors.
+          if (!output_node_ci.kernel_def ||
+              std::find(it->ImplicitInputDefs().begin(), it->ImplicitInputDefs().end(), p_output_arg) !=
+                  it->ImplicitInputDefs().end()) {
             can_strided = false;
             break;
           }
@@ -532,6 +551,169 @@ class PlannerImpl {
     */
   }
 
+  // Returns the size in bytes of a tensor with a static shape, which is returned in `shape`.
+  std::optional<size_t> GetStaticTensorSize(const onnxruntime::NodeArg& arg, TensorShape& shape) {
+    const auto* type = arg.TypeAsProto();
+    const auto* shape_proto = context_->GetShape(arg);
+    if (!arg.Exists() || type == nullptr || !type->has_tensor_type() || shape_proto == nullptr ||
+        type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      return std::nullopt;
+    }
+
+    for (const auto& dim : shape_proto->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+        return std::nullopt;
+      }
+    }
+
+    shape = utils::GetTensorShapeFromTensorShapeProto(*shape_proto);
+    return SafeInt<size_t>(shape.Size()) * GetElementSize(arg.Type());
+  }
+
+  // Returns true if the slices of `shape` along the 'axis' attribute of `node` are contiguous, i.e. all the
+  // dimensions before the axis are 1.
+  static bool HasContiguousSlices(const Node& node, const TensorShape& shape) {
+    const auto rank = static_cast<int64_t>(shape.NumDimensions());
+    const auto& attributes = node.GetAttributes();
+    auto axis_attr = attributes.find("axis");
+    int64_t axis = axis_attr != attributes.end() ? axis_attr->second.i() : 0;
+    if (axis < 0) {
+      axis += rank;
+    }
+
+    return axis >= 0 && axis < rank && shape.SizeToDimension(static_cast<size_t>(axis)) == 1;
+  }
+
+  // Plans the inputs of Concat to be produced directly into their slice of the Concat output, and the outputs of
+  // Split to be views of their slice of the Split input, so that the kernels do not need to copy them. This is done
+  // for CPU tensors with static shapes that are concatenated or split along an axis with only dimensions of 1 before
+  // it, so that every slice is a contiguous tensor. The kernels skip copying a slice that is already in place.
+  void ComputeBufferSlices(const std::vector<NodeIndex>& execution_plan) {
+    buffer_slices_.clear();
+    sliced_buffers_.clear();
+    if (context_->IsParallelExecutionEnabled() || !context_->GetEnableMemoryReuse()) {
+      return;
+    }
+
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    auto is_graph_output = [&graph_outputs](const NodeArg* arg) {
+      return std::find(graph_outputs.begin(), graph_outputs.end(), arg) != graph_outputs.end();
+    };
+    auto is_cpu_node = [](const Node& node, std::string_view op_type) {
+      return node.OpType() == op_type && node.Domain() == kOnnxDomain &&
+             node.GetExecutionProviderType() == kCpuExecutionProvider;
+    };
+
+    for (auto node_index : execution_plan) {
+      const auto& node = *graph_viewer_.GetNode(node_index);
+      if (!is_cpu_node(node, "Concat") || !OutputHasConsumerNode(node, 0) || is_graph_output(node.OutputDefs()[0])) {
+        continue;
+      }
+
+      const auto& input_defs = node.InputDefs();
+      const auto* output = node.OutputDefs()[0];
+      TensorShape output_shape;
+      const auto output_size = GetStaticTensorSize(*output, output_shape);
+      if (!output_size.has_value() || !HasContiguousSlices(node, output_shape)) {
+        continue;
+      }
+
+      // the offset of a slice requires the sizes of all the inputs before it.
+      InlinedVector<size_t> offsets;
+      offsets.reserve(input_defs.size());
+      size_t offset = 0;
+      for (const auto* input : input_defs) {
+        TensorShape input_shape;
+        const auto input_size = GetStaticTensorSize(*input, input_shape);
+        if (!input_size.has_value()) {
+          break;
+        }
+        offsets.push_back(offset);
+        offset += *input_size;
+      }
+      if (offsets.size() != input_defs.size() || offset != *output_size) {
+        continue;
+      }
+
+      const auto output_index = Index(output->Name());
+      for (auto edge = node.InputEdgesBegin(), end = node.InputEdgesEnd(); edge != end; ++edge) {
+        const Node& producer = edge->GetNode();
+        const int src_arg_index = edge->GetSrcArgIndex();
+        const NodeArg* input = input_defs[edge->GetDstArgIndex()];
+        const auto input_index = Index(input->Name());
+
+        // the producer must be the only writer and Concat the only reader of the slice.
+        const KernelCreateInfo& ci = GetKernelCreateInfo(kernel_create_info_map_, producer.Index());
+        if (ci.kernel_def == nullptr || HasExternalOutputs(producer) || is_graph_output(input) ||
+            std::count(input_defs.begin(), input_defs.end(), input) != 1 ||
+            AllocPlan(input_index).location != AllocPlan(output_index).location) {
+          continue;
+        }
+
+        const auto alias_map = GetAliasMap(producer, ci);
+        if (ci.kernel_def->VariadicAlias().has_value() ||
+            std::any_of(alias_map.begin(), alias_map.end(),
+                        [src_arg_index](const std::pair<int, int>& pair) { return pair.second == src_arg_index; }) ||
+            std::count_if(producer.OutputEdgesBegin(), producer.OutputEdgesEnd(),
+                          [src_arg_index](const Node::EdgeEnd& output_edge) {
+                            return output_edge.GetSrcArgIndex() == src_arg_index;
+                          }) != 1) {
+          continue;
+        }
+
+        buffer_slices_.emplace(input_index, PlannedBufferSlice{output_index,
+                                                               offsets[edge->GetDstArgIndex()],
+                                                               output_shape});
+      }
+    }
+
+    // a Concat output that is itself an input of another Concat is a slice of the outermost Concat output.
+    for (auto& entry : buffer_slices_) {
+      auto& slice = entry.second;
+      for (auto parent = buffer_slices_.find(slice.buffer); parent != buffer_slices_.end();
+           parent = buffer_slices_.find(slice.buffer)) {
+        slice.buffer = parent->second.buffer;
+        slice.offset += parent->second.offset;
+        slice.buffer_shape = parent->second.buffer_shape;
+      }
+      sliced_buffers_.insert(slice.buffer);
+    }
+
+    for (auto node_index : execution_plan) {
+      const auto& node = *graph_viewer_.GetNode(node_index);
+      if (!is_cpu_node(node, "Split") ||
+          std::any_of(node.InputEdgesBegin(), node.InputEdgesEnd(), [this](const Node::EdgeEnd& edge) {
+            return edge.GetDstArgIndex() == 0 && HasExternalOutputs(edge.GetNode());
+          })) {
+        continue;
+      }
+
+      const auto* input = node.InputDefs()[0];
+      TensorShape input_shape;
+      const auto input_size = GetStaticTensorSize(*input, input_shape);
+      if (!input_size.has_value() || !HasContiguousSlices(node, input_shape)) {
+        continue;
+      }
+
+      const auto input_index = Index(input->Name());
+      size_t offset = 0;
+      for (const auto* output : node.OutputDefs()) {
+        TensorShape output_shape;
+        const auto output_size = GetStaticTensorSize(*output, output_shape);
+        if (!output_size.has_value() || offset + *output_size > *input_size) {
+          break;
+        }
+
+        // an output that is also planned as a slice of a Concat output keeps that plan.
+        const auto output_index = Index(output->Name());
+        if (AllocPlan(output_index).location == AllocPlan(input_index).location) {
+          buffer_slices_.emplace(output_index, PlannedBufferSlice{input_index, offset, input_shape});
+        }
+        offset += *output_size;
+      }
+    }
+  }
+
   static bool OutputHasConsumerNode(const Node& node, int output_idx) {
     // there will be an edge to all consumer nodes.
     // if consumed in a subgraph the edge will be to an implicit input of the node containing the subgraph.
@@ -1484,6 +1666,7 @@ class PlannerImpl {
   // Should only be used after ProcessDef()
   Status ComputeSingleStreamReusePlan(size_t stream_index) {
     auto& execution_plan = stream_nodes_[stream_index];
+    ComputeBufferSlices(execution_plan);
     // Cached graph outputs.
     const auto& graph_outputs = graph_viewer_.GetOutputs();
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
@@ -1547,6 +1730,19 @@ class PlannerImpl {
               }
             }
           }
+        } else if (auto slice = buffer_slices_.find(current); slice != buffer_slices_.end()) {
+          // the output occupies a slice of another buffer, see ComputeBufferSlices().
+          Reuse(slice->second.buffer, current, AllocKind::kReuse);
+          auto& buffer_slice = AllocPlan(current).buffer_slice;
+          if (buffer_slice.has_value()) {
+            // the buffer is itself a slice, e.g. for Split of an output of Split.
+            buffer_slice->offset += slice->second.offset;
+          } else {
+            buffer_slice = AllocPlanPerValue::BufferSlice{slice->second.offset, slice->second.buffer_shape};
+          }
+        } else if (sliced_buffers_.count(current) != 0) {
+          // slices of this output were produced into its buffer already, so it can't reuse another buffer.
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
         } else if (!context_->IsParallelExecutionEnabled() &&
                    FindReusableInput(graph_viewer_, *pnode, static_cast<int>(output_arg_def_index),
                                      &reused, &is_strided_tensor)) {
@@ -1558,7 +1754,7 @@ class PlannerImpl {
 #ifdef ENABLE_STRIDED_TENSORS
           if (is_strided_tensor) AllocPlan(current).is_strided_tensor = true;
 #else
-          ORT_ENFORCE(!is_strided_tensor, "Strided tensor is not supported in non-training build for now.");
+          ORT_ENFORCE(!is_strided_tensor, "Strided tensors are not enabled in this build.");
 #endif  // ENABLE_STRIDED_TENSORS
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
           InplaceReuse(reused, current);
@@ -1656,9 +1852,19 @@ class PlannerImpl {
         if (!node_output->Exists()) continue;
         // OrtValue index of the considered output NodeArg.
         const auto current = Index(node_output->Name());
-        if (AllocPlan(current).alloc_kind == AllocKind::kAllocate ||
-            AllocPlan(current).alloc_kind == AllocKind::kAllocatedExternally) {
-          AllocPlan(current).program_counter.AddStart(program_counter);
+        // a slice of a buffer, see ComputeBufferSlices(), is written before the buffer itself is produced, so the
+        // buffer lives from the producer of its first slice.
+        auto allocated = current;
+        if (AllocPlan(current).alloc_kind == AllocKind::kReuse && AllocPlan(current).buffer_slice.has_value()) {
+          allocated = AllocPlan(current).reused_buffer;
+        }
+        auto& allocated_plan = AllocPlan(allocated);
+        const bool is_live = allocated_plan.program_counter.Starts().size() >
+                             allocated_plan.program_counter.Ends().size();
+        if ((allocated_plan.alloc_kind == AllocKind::kAllocate ||
+             allocated_plan.alloc_kind == AllocKind::kAllocatedExternally) &&
+            !is_live) {
+          allocated_plan.program_counter.AddStart(program_counter);
         }
       }
 
@@ -13,6 +13,8 @@
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/numa_arena.h"
+#include "core/platform/env.h"
 
 namespace onnxruntime {
 using namespace common;
@@ -34,6 +36,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    size_t thread_cache_max_bytes = info.arena_cfg.thread_cache_max_bytes == -1
+                                        ? BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES
+                                        : static_cast<size_t>(info.arena_cfg.thread_cache_max_bytes);
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -63,6 +68,31 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
       ORT_THROW("StreamAwareArena should be transparent to minimal build.");
 #endif
     } else {
+      if (info.arena_cfg.numa_aware == 1) {
+        std::vector<int> numa_nodes;
+        const auto node_processors = Env::Default().GetNumaNodes();
+        for (size_t node = 0; node < node_processors.size(); ++node) {
+          if (!node_processors[node].empty()) {
+            numa_nodes.push_back(static_cast<int>(node));
+          }
+        }
+        if (numa_nodes.size() > 1) {
+          return std::make_shared<NumaArena>(
+              numa_nodes,
+              [&info]() { return info.device_alloc_factory(info.device_id); },
+              [&](std::unique_ptr<IAllocator> node_allocator) {
+                return std::make_unique<BFCArena>(std::move(node_allocator),
+                                                  max_mem,
+                                                  arena_extend_str,
+                                                  initial_chunk_size_bytes,
+                                                  max_dead_bytes_per_chunk,
+                                                  initial_growth_chunk_size_bytes,
+                                                  max_power_of_two_extend_bytes,
+                                                  thread_cache_max_bytes);
+              });
+        }
+        LOGS_DEFAULT(INFO) << "The host has a single NUMA node, creating a single arena";
+      }
       return AllocatorPtr(
           std::make_unique<BFCArena>(std::move(device_allocator),
                                      max_mem,
@@ -70,7 +100,8 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_max_bytes));
     }
   } else {
     return device_allocator;
@@ -3,22 +3,225 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <algorithm>
 #include <type_traits>
+#include <unordered_map>
 
 namespace onnxruntime {
+
+namespace {
+// Arenas that have the thread cache enabled and are still alive, by thread_cache_arena_id_.
+// Used to return the chunks cached by a thread to their arena when the thread exits.
+std::mutex& ThreadCacheArenasMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<uint64_t, BFCArena*>& ThreadCacheArenas() {
+  static std::unordered_map<uint64_t, BFCArena*> arenas;
+  return arenas;
+}
+
+uint64_t NextThreadCacheArenaId() {
+  static std::atomic<uint64_t> next_id{1};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace
+
+// Free lists of one thread for one arena.
+struct BFCArena::ThreadCache {
+  explicit ThreadCache(uint64_t id) : arena_id(id) {}
+
+  const uint64_t arena_id;
+  uint64_t generation = 0;
+  size_t cached_bytes = 0;
+  std::array<std::vector<void*>, kNumThreadCacheClasses> free_chunks;
+};
+
+// The thread caches of the current thread for all arenas it has used.
+class BFCArena::ThreadCacheList {
+ public:
+  ThreadCacheList() = default;
+
+  ~ThreadCacheList() {
+    std::lock_guard<std::mutex> guard(ThreadCacheArenasMutex());
+    auto& arenas = ThreadCacheArenas();
+    for (auto& cache : caches_) {
+      auto it = arenas.find(cache->arena_id);
+      if (it != arenas.end()) {
+        it->second->ReturnThreadCacheChunks(*cache);
+      }
+    }
+  }
+
+  ThreadCache& Get(uint64_t arena_id) {
+    if (last_ != nullptr && last_->arena_id == arena_id) {
+      return *last_;
+    }
+
+    for (auto& cache : caches_) {
+      if (cache->arena_id == arena_id) {
+        last_ = cache.get();
+        return *last_;
+      }
+    }
+
+    // First use of this arena on this thread. Drop the caches of arenas that no longer exist. The pointers they hold
+    // were released with the arena's memory.
+    {
+      std::lock_guard<std::mutex> guard(ThreadCacheArenasMutex());
+      const auto& arenas = ThreadCacheArenas();
+      caches_.erase(std::remove_if(caches_.begin(), caches_.end(),
+                                   [&arenas](const std::unique_ptr<ThreadCache>& cache) {
+                                     return arenas.find(cache->arena_id) == arenas.end();
+                                   }),
+                    caches_.end());
+    }
+
+    caches_.push_back(std::make_unique<ThreadCache>(arena_id));
+    last_ = caches_.back().get();
+    return *last_;
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadCacheList);
+
+  std::vector<std::unique_ptr<ThreadCache>> caches_;
+  ThreadCache* last_ = nullptr;
+};
+
+// Open addressing hash table from the address of a chunk handed out for a thread cache size class to that class.
+//
+// Insert() and Erase() are only called with lock_ held. Find() is lock free, and is only called for a pointer that
+// is owned by the caller, i.e. allocated and not yet freed, so its entry cannot be modified concurrently.
+// The size class is packed in the top byte of the slot together with the pointer so a slot is always read
+// consistently. A concurrent Rebuild() can make Find() miss an entry, in which case the caller takes the locked path.
+class BFCArena::CacheableChunkTable {
+ public:
+  explicit CacheableChunkTable(size_t log2_capacity)
+      : log2_capacity_(log2_capacity),
+        mask_((size_t{1} << log2_capacity) - 1),
+        slots_(std::make_unique<std::atomic<uint64_t>[]>(size_t{1} << log2_capacity)) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      slots_[i].store(kEmpty, std::memory_order_relaxed);
+    }
+  }
+
+  bool Insert(const void* p, int size_class) {
+    const uint64_t address = reinterpret_cast<uint64_t>(p);
+    if ((address & ~kAddressMask) != 0) {
+      return false;
+    }
+
+    if ((num_entries_ + num_tombstones_ + 1) * 4 > (mask_ + 1) * 3) {
+      if ((num_entries_ + 1) * 2 > (mask_ + 1)) {
+        return false;
+      }
+      Rebuild();
+    }
+
+    const uint64_t entry = (static_cast<uint64_t>(size_class + 1) << kClassShift) | address;
+    for (size_t i = Hash(address);; i = (i + 1) & mask_) {
+      const uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot == kEmpty || slot == kTombstone) {
+        if (slot == kTombstone) {
+          --num_tombstones_;
+        }
+        slots_[i].store(entry, std::memory_order_release);
+        ++num_entries_;
+        return true;
+      }
+    }
+  }
+
+  void Erase(const void* p) {
+    const uint64_t address = reinterpret_cast<uint64_t>(p);
+    for (size_t i = Hash(address);; i = (i + 1) & mask_) {
+      const uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot == kEmpty) {
+        return;
+      }
+      if (slot != kTombstone && (slot & kAddressMask) == address) {
+        slots_[i].store(kTombstone, std::memory_order_release);
+        --num_entries_;
+        ++num_tombstones_;
+        return;
+      }
+    }
+  }
+
+  int Find(const void* p) const {
+    const uint64_t address = reinterpret_cast<uint64_t>(p);
+    for (size_t i = Hash(address), probes = 0; probes <= mask_; i = (i + 1) & mask_, ++probes) {
+      const uint64_t slot = slots_[i].load(std::memory_order_acquire);
+      if (slot == kEmpty) {
+        return -1;
+      }
+      if (slot != kTombstone && (slot & kAddressMask) == address) {
+        return static_cast<int>(slot >> kClassShift) - 1;
+      }
+    }
+    return -1;
+  }
+
+ private:
+  // User space addresses fit in 56 bits on all supported 64-bit platforms.
+  static constexpr int kClassShift = 56;
+  static constexpr uint64_t kAddressMask = (uint64_t{1} << kClassShift) - 1;
+  static constexpr uint64_t kEmpty = 0;
+  static constexpr uint64_t kTombstone = 1;
+
+  size_t Hash(uint64_t address) const {
+    return static_cast<size_t>(((address >> kMinAllocationBits) * 0x9E3779B97F4A7C15ull) >> (64 - log2_capacity_));
+  }
+
+  void Rebuild() {
+    std::vector<uint64_t> entries;
+    entries.reserve(num_entries_);
+    for (size_t i = 0; i <= mask_; ++i) {
+      const uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot != kEmpty && slot != kTombstone) {
+        entries.push_back(slot);
+      }
+      slots_[i].store(kEmpty, std::memory_order_release);
+    }
+
+    for (uint64_t entry : entries) {
+      for (size_t i = Hash(entry & kAddressMask);; i = (i + 1) & mask_) {
+        if (slots_[i].load(std::memory_order_relaxed) == kEmpty) {
+          slots_[i].store(entry, std::memory_order_release);
+          break;
+        }
+      }
+    }
+
+    num_tombstones_ = 0;
+  }
+
+  const size_t log2_capacity_;
+  const size_t mask_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t num_entries_ = 0;
+  size_t num_tombstones_ = 0;
+};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   size_t thread_cache_max_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
                                resource_allocator->Info().id,
                                resource_allocator->Info().mem_type)),
       arena_type_(ArenaType::BaseArena),
+      // the chunk table packs the size class into the upper bits of a 64-bit pointer
+      thread_cache_max_bytes_(sizeof(void*) == 8 ? thread_cache_max_bytes : 0),
+      thread_cache_arena_id_(thread_cache_max_bytes_ > 0 ? NextThreadCacheArenaId() : 0),
       device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
@@ -32,7 +235,8 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_max_bytes: " << thread_cache_max_bytes_;
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -75,9 +279,21 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_max_bytes_ > 0) {
+    cacheable_chunks_ = std::make_unique<CacheableChunkTable>(14);
+    std::lock_guard<std::mutex> guard(ThreadCacheArenasMutex());
+    ThreadCacheArenas().emplace(thread_cache_arena_id_, this);
+  }
 }
 
 BFCArena::~BFCArena() {
+  if (thread_cache_max_bytes_ > 0) {
+    // Chunks still held by thread caches are released with the regions below.
+    std::lock_guard<std::mutex> guard(ThreadCacheArenasMutex());
+    ThreadCacheArenas().erase(thread_cache_arena_id_);
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -269,9 +485,119 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_max_bytes_ > 0 && size > 0) {
+    size_t class_bytes = 0;
+    const int size_class = ThreadCacheSizeClass(RoundedBytes(size), class_bytes);
+    if (size_class >= 0) {
+      return AllocateWithThreadCache(size_class, class_bytes);
+    }
+  }
+
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+int BFCArena::ThreadCacheSizeClass(size_t rounded_bytes, size_t& class_bytes) {
+  if (rounded_bytes > kMaxThreadCacheableBytes) {
+    return -1;
+  }
+
+  // Round up to a multiple of a quarter of the bin size so there is at most 25% internal fragmentation.
+  BinNum bin_num = BinNumForSize(rounded_bytes);
+  size_t step = std::max(kMinAllocationSize, BinNumToSize(bin_num) / kThreadCacheClassesPerBin);
+  class_bytes = (rounded_bytes + step - 1) / step * step;
+  if (class_bytes > kMaxThreadCacheableBytes) {
+    return -1;
+  }
+
+  // Rounding up may have moved the request to the first class of the next bin.
+  bin_num = BinNumForSize(class_bytes);
+  step = std::max(kMinAllocationSize, BinNumToSize(bin_num) / kThreadCacheClassesPerBin);
+  return bin_num * kThreadCacheClassesPerBin + static_cast<int>((class_bytes - BinNumToSize(bin_num)) / step);
+}
+
+size_t BFCArena::ThreadCacheClassBytes(int size_class) {
+  const BinNum bin_num = size_class / kThreadCacheClassesPerBin;
+  const size_t step = std::max(kMinAllocationSize, BinNumToSize(bin_num) / kThreadCacheClassesPerBin);
+  return BinNumToSize(bin_num) + (size_class % kThreadCacheClassesPerBin) * step;
+}
+
+BFCArena::ThreadCache& BFCArena::GetThreadCache() {
+  static thread_local ThreadCacheList thread_caches;
+  ThreadCache& cache = thread_caches.Get(thread_cache_arena_id_);
+
+  const uint64_t generation = thread_cache_generation_.load(std::memory_order_relaxed);
+  if (cache.generation != generation) {
+    ReturnThreadCacheChunks(cache);
+    cache.generation = generation;
+  }
+
+  return cache;
+}
+
+void* BFCArena::AllocateWithThreadCache(int size_class, size_t class_bytes) {
+  ThreadCache& cache = GetThreadCache();
+  auto& free_chunks = cache.free_chunks[size_class];
+  if (!free_chunks.empty()) {
+    void* p = free_chunks.back();
+    free_chunks.pop_back();
+    cache.cached_bytes -= class_bytes;
+    return p;
+  }
+
+  return AllocateRawInternal(class_bytes, false, nullptr, false, nullptr, size_class);
+}
+
+bool BFCArena::FreeToThreadCache(void* p) {
+  const int size_class = cacheable_chunks_->Find(p);
+  if (size_class < 0) {
+    return false;
+  }
+
+  ThreadCache& cache = GetThreadCache();
+  auto& free_chunks = cache.free_chunks[size_class];
+  const size_t class_bytes = ThreadCacheClassBytes(size_class);
+  if (free_chunks.size() >= kMaxThreadCacheChunksPerClass ||
+      cache.cached_bytes + class_bytes > thread_cache_max_bytes_) {
+    // Return the older half of this class together with p in one locked batch.
+    ReturnThreadCacheChunks(cache, size_class, (free_chunks.size() + 1) / 2, p);
+    return true;
+  }
+
+  if (free_chunks.capacity() == 0) {
+    free_chunks.reserve(kMaxThreadCacheChunksPerClass);
+  }
+
+  free_chunks.push_back(p);
+  cache.cached_bytes += class_bytes;
+  return true;
+}
+
+void BFCArena::ReturnThreadCacheChunks(ThreadCache& cache, int size_class, size_t count, void* extra) {
+  std::lock_guard<std::mutex> lock(lock_);
+
+  auto return_chunks = [this, &cache](int c, size_t n) {
+    auto& free_chunks = cache.free_chunks[c];
+    n = std::min(n, free_chunks.size());
+    for (size_t i = 0; i < n; ++i) {
+      DeallocateRawInternal(free_chunks[i]);
+    }
+    free_chunks.erase(free_chunks.begin(), free_chunks.begin() + n);
+    cache.cached_bytes -= n * ThreadCacheClassBytes(c);
+  };
+
+  if (size_class < 0) {
+    for (int c = 0; c < kNumThreadCacheClasses; ++c) {
+      return_chunks(c, cache.free_chunks[c].size());
+    }
+  } else {
+    return_chunks(size_class, count);
+  }
+
+  if (extra != nullptr) {
+    DeallocateRawInternal(extra);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -312,7 +638,8 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                                     bool dump_log_on_failure,
                                     Stream* stream,
                                     bool enable_cross_stream_reusing,
-                                    WaitNotificationFn wait_fn) {
+                                    WaitNotificationFn wait_fn,
+                                    int thread_cache_size_class) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
@@ -334,6 +661,13 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                              enable_cross_stream_reusing,
                              wait_fn);
 
+  // Chunks of exactly the size class can be recycled through the thread caches.
+  auto register_cacheable_chunk = [&](const Chunk& c) {
+    if (thread_cache_size_class >= 0 && c.size == rounded_bytes && c.stream == nullptr) {
+      cacheable_chunks_->Insert(c.ptr, thread_cache_size_class);
+    }
+  };
+
   if (chunk != nullptr) {
     // if it is on default stream (the new allocate chunk), assign to current stream
     if (chunk->stream == nullptr) {
@@ -341,6 +675,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (stream)
         chunk->stream_timestamp = stream->GetCurrentTimestamp();
     }
+    register_cacheable_chunk(*chunk);
     return chunk->ptr;
   }
 
@@ -356,6 +691,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (chunk->stream == nullptr && stream) {
         chunk->stream = stream;
       }
+      register_cacheable_chunk(*chunk);
       return chunk->ptr;
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -496,6 +832,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_max_bytes_ > 0 && FreeToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<std::mutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -509,6 +850,12 @@ void BFCArena::Free(void* p) {
 }
 
 Status BFCArena::Shrink() {
+  if (thread_cache_max_bytes_ > 0) {
+    // Every thread returns its cached chunks on its next call into the arena. Do it now for the calling thread.
+    thread_cache_generation_.fetch_add(1, std::memory_order_relaxed);
+    GetThreadCache();
+  }
+
   std::lock_guard<std::mutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
@@ -578,6 +925,10 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
 
+  if (cacheable_chunks_) {
+    cacheable_chunks_->Erase(ptr);
+  }
+
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
 }
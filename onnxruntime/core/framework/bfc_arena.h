@@ -16,9 +16,11 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
@@ -61,6 +63,8 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  // The per-thread cache of small chunks is disabled by default.
+  static const size_t DEFAULT_THREAD_CACHE_MAX_BYTES = 0;
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +77,8 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           size_t thread_cache_max_bytes = DEFAULT_THREAD_CACHE_MAX_BYTES);
 
   ~BFCArena() override;
 
@@ -87,6 +92,8 @@ class BFCArena : public IAllocator {
 
   // Frees all allocation regions in which no chunk is in use.
   // Does not free any reserved chunks.
+  // Chunks held in the thread cache of another thread are still in use until that thread next calls into the arena,
+  // so the regions containing them are not freed by this call.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
   // future allocation sizes are determined by the arena growth strategy
@@ -112,7 +119,8 @@ class BFCArena : public IAllocator {
                             bool dump_log_on_failure,
                             Stream* stream,
                             bool enable_cross_stream_reusing,
-                            WaitNotificationFn wait_fn);
+                            WaitNotificationFn wait_fn,
+                            int thread_cache_size_class = -1);
 #ifdef ORT_ENABLE_STREAM
   // for any chunk that associated with target stream, reset it to default (nullptr in stream, timestamp 0)
   // perform coalesce if coalesce_flag is true
@@ -429,6 +437,46 @@ class BFCArena : public IAllocator {
   // Computes and returns a BinDebugInfo for each Bin.
   std::array<BinDebugInfo, kNumBins> get_bin_debug_info();
 
+  // Per-thread cache of recently freed small chunks.
+  //
+  // Alloc() requests of up to kMaxThreadCacheableBytes are rounded up to one of a few size classes per bin. Chunks
+  // that were handed out for a size class are recorded in cacheable_chunks_ and, when freed, are pushed onto a
+  // free list of the freeing thread instead of going back to the bins. Later allocations of the same size class on
+  // that thread pop the free list. Neither path takes lock_; a cache miss or overflow falls through to the regular
+  // locked path.
+  //
+  // Chunks in a thread cache remain in use as far as the bins and stats_ are concerned. They are returned to the
+  // arena when the cache overflows, when the thread exits, or after Shrink() is called.
+  struct ThreadCache;
+  class ThreadCacheList;
+  class CacheableChunkTable;
+
+  static constexpr size_t kMaxThreadCacheableBytes = 64 * 1024;
+  static constexpr int kThreadCacheClassesPerBin = 4;
+  // Bins 0 to 8 cover rounded sizes up to kMaxThreadCacheableBytes.
+  static constexpr int kNumThreadCacheClasses = 9 * kThreadCacheClassesPerBin;
+  static constexpr size_t kMaxThreadCacheChunksPerClass = 64;
+
+  // Returns the size class for an allocation of `rounded_bytes`, or -1 if it should not use the thread cache.
+  // `class_bytes` is set to the size of the chunks in that class.
+  int ThreadCacheSizeClass(size_t rounded_bytes, size_t& class_bytes);
+  size_t ThreadCacheClassBytes(int size_class);
+
+  ThreadCache& GetThreadCache();
+  void* AllocateWithThreadCache(int size_class, size_t class_bytes);
+  bool FreeToThreadCache(void* p);
+
+  // Returns chunks from `cache` to the bins. Takes lock_.
+  // If size_class is -1 all the chunks are returned, otherwise the first `count` chunks of the class.
+  void ReturnThreadCacheChunks(ThreadCache& cache, int size_class = -1, size_t count = 0, void* extra = nullptr);
+
+  const size_t thread_cache_max_bytes_;
+  // Unique per instance so stale thread caches of a destroyed arena can never match a new one.
+  const uint64_t thread_cache_arena_id_;
+  // Incremented by Shrink() to make every thread return its cached chunks on its next call.
+  std::atomic<uint64_t> thread_cache_generation_{0};
+  std::unique_ptr<CacheableChunkTable> cacheable_chunks_;
+
   // Structures immutable after construction
   size_t memory_limit_ = 0;
   ArenaExtendStrategy arena_extend_strategy_ = ArenaExtendStrategy::kNextPowerOfTwo;
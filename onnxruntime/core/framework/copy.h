@@ -310,4 +310,35 @@ Status DispatchStridedCopy(concurrency::ThreadPool* thread_pool,
                     : Status::OK();
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Produces `dst` as a view of `src`. The view has the shape of `dst`, and its element offset and strides are relative
+// to the data of `src`. If the allocation planner placed `dst` in the buffer of `src`, which kernels allow with
+// KernelDefBuilder::MayStridedOutput, `dst` becomes the strided view, else the view is copied to `dst`.
+template <typename EnabledDataTypes>
+Status StridedViewOrCopy(concurrency::ThreadPool* thread_pool,
+                         const Tensor& src,
+                         std::ptrdiff_t view_offset,
+                         const TensorShapeVector& view_strides,
+                         Tensor& dst) {
+  const TensorShape shape = dst.Shape();
+  if (shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  if (dst.DataRaw() == src.DataRaw()) {
+    dst.SetByteOffset(dst.ByteOffset() + view_offset * static_cast<std::ptrdiff_t>(src.DataType()->Size()));
+    dst.SetShapeAndStrides(shape, view_strides);
+    return Status::OK();
+  }
+
+  // StridedCopy needs at least one dimension.
+  if (shape.NumDimensions() == 0) {
+    return DispatchStridedCopy<EnabledDataTypes>(thread_pool, dst, 0, {1}, TensorShape({1}), src, view_offset, {1});
+  }
+
+  return DispatchStridedCopy<EnabledDataTypes>(thread_pool, dst, 0, StridesForTensor(dst), shape,
+                                               src, view_offset, view_strides);
+}
+#endif  // ENABLE_STRIDED_TENSORS
+
 }  // namespace onnxruntime
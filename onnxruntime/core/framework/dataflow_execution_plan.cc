@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/dataflow_execution_plan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/sequential_executor.h"
+#include "core/framework/session_options.h"
+#include "core/framework/stream_execution_context.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+std::unique_ptr<DataflowExecutionPlan> DataflowExecutionPlan::Create(const GraphViewer& graph_viewer,
+                                                                     ExecutionOrder execution_order,
+                                                                     const SequentialExecutionPlan& execution_plan) {
+  std::unique_ptr<DataflowExecutionPlan> plan(new DataflowExecutionPlan());
+  auto& nodes = plan->nodes_;
+
+  const auto& node_order = graph_viewer.GetNodesInTopologicalOrder(execution_order);
+  InlinedHashMap<NodeIndex, size_t> node_positions;
+  node_positions.reserve(node_order.size());
+  nodes.reserve(node_order.size());
+  for (const NodeIndex node_index : node_order) {
+    node_positions.emplace(node_index, nodes.size());
+    nodes.push_back(NodeInfo{node_index, 0, 0, 0, {}});
+  }
+
+  for (size_t stream_index = 0; stream_index < execution_plan.execution_plan.size(); ++stream_index) {
+    for (const auto& step : execution_plan.execution_plan[stream_index]->steps_) {
+      auto it = node_positions.find(step->GetNodeIndex());
+      if (it != node_positions.end()) {
+        nodes[it->second].stream_index = stream_index;
+      }
+    }
+  }
+
+  // edges from producers to consumers. a node may consume several outputs of the same producer, or the same output
+  // through both explicit and implicit inputs, so only count distinct producers.
+  InlinedHashSet<size_t> producers;
+  for (size_t position = 0; position < nodes.size(); ++position) {
+    const Node* node = graph_viewer.GetNode(nodes[position].node_index);
+    producers.clear();
+    for (auto edge = node->InputEdgesBegin(), end = node->InputEdgesEnd(); edge != end; ++edge) {
+      auto it = node_positions.find(edge->GetNode().Index());
+      if (it != node_positions.end() && producers.insert(it->second).second) {
+        nodes[it->second].consumers.push_back(position);
+      }
+    }
+    nodes[position].num_dependencies = static_cast<int32_t>(producers.size());
+  }
+
+  // consumers come later in the topological order, so compute the critical path lengths backwards
+  for (size_t position = nodes.size(); position-- > 0;) {
+    size_t longest_downstream_path = 0;
+    for (const size_t consumer : nodes[position].consumers) {
+      longest_downstream_path = std::max(longest_downstream_path, nodes[consumer].priority);
+    }
+    nodes[position].priority = longest_downstream_path + 1;
+  }
+
+  // ties are broken by the execution order to keep the dispatch order deterministic
+  auto higher_priority = [&nodes](size_t lhs, size_t rhs) {
+    return nodes[lhs].priority != nodes[rhs].priority ? nodes[lhs].priority > nodes[rhs].priority : lhs < rhs;
+  };
+
+  for (size_t position = 0; position < nodes.size(); ++position) {
+    auto& consumers = nodes[position].consumers;
+    std::sort(consumers.begin(), consumers.end(), higher_priority);
+    if (nodes[position].num_dependencies == 0) {
+      plan->roots_.push_back(position);
+    }
+  }
+  std::sort(plan->roots_.begin(), plan->roots_.end(), higher_priority);
+
+  return plan;
+}
+
+namespace {
+
+struct DataflowRun {
+  const DataflowExecutionPlan& plan;
+  StreamExecutionContext& ctx;
+  concurrency::ThreadPool* thread_pool;
+  SessionScope& session_scope;
+  const bool& terminate_flag;
+  std::unique_ptr<std::atomic<int32_t>[]> remaining_dependencies;
+};
+
+void RunFrom(DataflowRun& run, size_t position);
+
+void ScheduleFrom(DataflowRun& run, size_t position) {
+  // increase the task count before scheduling so WaitAll can't return early
+  run.ctx.AddTask();
+  concurrency::ThreadPool::Schedule(run.thread_pool, [&run, position]() {
+    RunFrom(run, position);
+  });
+}
+
+// Run the node at `position`, then keep running the highest priority consumer that it made ready on this thread and
+// hand the other ready consumers to the thread pool, where idle threads steal them.
+void RunFrom(DataflowRun& run, size_t position) {
+  constexpr size_t kNoNode = std::numeric_limits<size_t>::max();
+  auto& ctx = run.ctx;
+  const auto& nodes = run.plan.Nodes();
+
+  while (position != kNoNode) {
+    if (!ctx.TaskStatus().IsOK()) {
+      break;
+    }
+    if (run.terminate_flag) {
+      Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      ctx.SetStatus(status_made);
+      break;
+    }
+
+    const auto& node = nodes[position];
+    Status status;
+    ORT_TRY {
+      status = ExecuteKernel(ctx, node.node_index, node.stream_index, run.terminate_flag, run.session_scope);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    if (!status.IsOK()) {
+      ctx.SetStatus(status);
+      break;
+    }
+
+    // consumers are sorted by priority so the first one that is ready is the one to continue with
+    position = kNoNode;
+    for (const size_t consumer : node.consumers) {
+      if (run.remaining_dependencies[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (position == kNoNode) {
+          position = consumer;
+        } else {
+          ScheduleFrom(run, consumer);
+        }
+      }
+    }
+  }
+
+  ctx.CompleteTask();
+}
+
+}  // namespace
+
+void RunDataflowPlan(const DataflowExecutionPlan& plan,
+                     StreamExecutionContext& ctx,
+                     concurrency::ThreadPool* thread_pool,
+                     SessionScope& session_scope,
+                     const bool& terminate_flag) {
+  const auto& nodes = plan.Nodes();
+  DataflowRun run{plan, ctx, thread_pool, session_scope, terminate_flag,
+                  std::make_unique<std::atomic<int32_t>[]>(nodes.size())};
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    run.remaining_dependencies[i].store(nodes[i].num_dependencies, std::memory_order_relaxed);
+  }
+
+  const auto& roots = plan.Roots();
+  if (roots.empty()) {
+    ctx.CompleteTask();
+  } else {
+    for (size_t i = 1; i < roots.size(); ++i) {
+      ScheduleFrom(run, roots[i]);
+    }
+    RunFrom(run, roots[0]);
+  }
+
+  // `run` is referenced by the scheduled tasks
+  ctx.WaitAll();
+}
+
+}  // namespace onnxruntime
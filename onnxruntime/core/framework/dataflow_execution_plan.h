@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class SessionScope;
+class StreamExecutionContext;
+struct SequentialExecutionPlan;
+enum class ExecutionOrder;
+
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+ * Node dependencies of a graph, used to run its kernels in dataflow order in the parallel execution mode.
+ *
+ * Rather than following the fixed partition of the nodes into the logic streams of the SequentialExecutionPlan,
+ * a node is dispatched to the thread pool as soon as all the nodes producing its inputs have completed. The pool
+ * balances the work across its threads by work stealing.
+ *
+ * Each node has a priority, the length of the longest path from the node to a graph output, so that among the nodes
+ * that become ready together the ones on the critical path run first.
+ *
+ * Only applicable when no execution provider of the graph uses device streams, as the plan ignores the
+ * synchronization steps of the logic streams.
+ */
+class DataflowExecutionPlan {
+ public:
+  struct NodeInfo {
+    NodeIndex node_index;
+    // logic stream the node is assigned to in the SequentialExecutionPlan
+    size_t stream_index;
+    // number of distinct nodes in the graph that produce an input of this node
+    int32_t num_dependencies;
+    // longest path from this node to a sink, in nodes
+    size_t priority;
+    // positions in nodes() of the consumer nodes, in decreasing priority order
+    InlinedVector<size_t> consumers;
+  };
+
+  static std::unique_ptr<DataflowExecutionPlan> Create(const GraphViewer& graph_viewer,
+                                                       ExecutionOrder execution_order,
+                                                       const SequentialExecutionPlan& execution_plan);
+
+  // nodes in execution order
+  const std::vector<NodeInfo>& Nodes() const noexcept { return nodes_; }
+
+  // positions in Nodes() of the nodes without dependencies, in decreasing priority order
+  const InlinedVector<size_t>& Roots() const noexcept { return roots_; }
+
+ private:
+  DataflowExecutionPlan() = default;
+
+  std::vector<NodeInfo> nodes_;
+  InlinedVector<size_t> roots_;
+};
+
+// Run all the kernels in the plan, scheduling the ready ones on `thread_pool` and blocking until all complete.
+// The calling thread takes part in the execution. The task count of `ctx` must be initialized to 1.
+void RunDataflowPlan(const DataflowExecutionPlan& plan,
+                     StreamExecutionContext& ctx,
+                     concurrency::ThreadPool* thread_pool,
+                     SessionScope& session_scope,
+                     const bool& terminate_flag);
+
+}  // namespace onnxruntime
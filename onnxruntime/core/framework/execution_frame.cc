@@ -406,7 +406,11 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      cached_mem_pattern_ = session_state.GetCachedMemoryPattern(feeds, feed_mlvalue_idxs);
+      if (cached_mem_pattern_) {
+        mem_patterns_ = &cached_mem_pattern_->mem_patterns;
+        inferred_shapes_ = &cached_mem_pattern_->inferred_shapes;
+      }
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
@@ -620,7 +624,8 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
 Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_value, int ort_value_index_reuse,
                                                               MLDataType element_type, const OrtDevice& location,
                                                               const TensorShape& shape,
-                                                              bool is_strided_tensor) {
+                                                              bool is_strided_tensor,
+                                                              std::optional<size_t> buffer_slice_offset) {
   OrtValue& ort_value_reuse = GetMutableMLValue(ort_value_index_reuse);
 
   auto* reuse_tensor = ort_value_reuse.GetMutable<Tensor>();
@@ -630,7 +635,15 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
 #ifndef ENABLE_STRIDED_TENSORS
   ORT_ENFORCE(!is_strided_tensor);
 #endif  // ENABLE_STRIDED_TENSORS
-  if (!is_strided_tensor) {
+  if (!is_strided_tensor && buffer_slice_offset.has_value()) {
+    // the slice only has to fit in the buffer, e.g. an input of Concat in the Concat output.
+    const size_t required_size = Tensor::CalculateTensorStorageSize(element_type, shape);
+    if (*buffer_slice_offset + required_size > reuse_tensor->SizeInBytes()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Buffer slice of shape ", shape, " at offset ", *buffer_slice_offset,
+                             " does not fit in the re-used buffer of shape ", reuse_tensor->Shape(),
+                             ". Validate the static shapes in the model.");
+    }
+  } else if (!is_strided_tensor) {
     auto buffer_num_elements = reuse_tensor->Shape().Size();
     auto required_num_elements = shape.Size();
 
@@ -657,6 +670,9 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
   }
 
   void* reuse_buffer = reuse_tensor->MutableDataRaw();
+  if (buffer_slice_offset.has_value()) {
+    reuse_buffer = static_cast<char*>(reuse_buffer) + *buffer_slice_offset;
+  }
 
   return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_buffer, element_type, location, shape);
 }
@@ -759,15 +775,24 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
       }
       case AllocKind::kReuse: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
+        const auto& buffer_slice = per_alloc_plan.buffer_slice;
 
-        ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index, shape));
+        // a slice can be produced before the value that owns the buffer (e.g. the inputs of Concat before the Concat
+        // output), in which case the buffer is allocated with its own shape.
+        ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(
+            reuse_mlvalue_index, buffer_slice.has_value() ? &buffer_slice->buffer_shape : shape));
 
         bool is_strided_tensor = false;
 #ifdef ENABLE_STRIDED_TENSORS
         is_strided_tensor = per_alloc_plan.is_strided_tensor;
 #endif  // ENABLE_STRIDED_TENSORS
+        std::optional<size_t> buffer_slice_offset;
+        if (buffer_slice.has_value()) {
+          buffer_slice_offset = buffer_slice->offset;
+        }
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
-            ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, is_strided_tensor));
+            ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, is_strided_tensor,
+            buffer_slice_offset));
         break;
       }
       case AllocKind::kShare: {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <mutex>
+#include <optional>
 #include <vector>
 
 #include "core/common/common.h"
@@ -14,6 +15,7 @@
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/sequential_execution_plan.h"
+#include "core/framework/memory_pattern_cache.h"
 #include "core/framework/tensor.h"
 #include "core/graph/graph_viewer.h"
 
@@ -157,7 +159,8 @@ class ExecutionFrame final : public IExecutionFrame {
 
   Status AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_value, int ort_value_index_reuse, MLDataType element_type,
                                                 const OrtDevice& location, const TensorShape& shape,
-                                                bool is_strided_tensor = false);
+                                                bool is_strided_tensor = false,
+                                                std::optional<size_t> buffer_slice_offset = std::nullopt);
 
   // thread-safe
   Status GeneratePatterns(MemoryPatternGroup& out);
@@ -228,6 +231,10 @@ class ExecutionFrame final : public IExecutionFrame {
   // map of index to custom allocator
   InlinedHashMap<int, IExecutor::CustomAllocator> custom_allocators_;
 
+  // Cached memory pattern for these input shapes. Holding the reference keeps mem_patterns_ and inferred_shapes_
+  // valid even if the pattern is evicted from the session's cache during this run.
+  std::shared_ptr<const CachedMemoryPattern> cached_mem_pattern_;
+
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
@@ -0,0 +1,312 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_stats.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/graph/graph_viewer.h"
+#include "nlohmann/json.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace onnxruntime {
+
+namespace {
+// The KernelStats instances that are alive, by id.
+std::mutex& LiveKernelStatsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<uint64_t, KernelStats*>& LiveKernelStats() {
+  static std::unordered_map<uint64_t, KernelStats*> instances;
+  return instances;
+}
+
+uint64_t NextKernelStatsId() {
+  static std::atomic<uint64_t> next_id{1};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Returns floor(log2(n)), n must not be 0.
+int Log2FloorNonZero(uint64_t n) {
+#if defined(__GNUC__)
+  return 63 ^ __builtin_clzll(n);
+#elif defined(_MSC_VER) && defined(_WIN64)
+  unsigned long index;
+  _BitScanReverse64(&index, n);
+  return static_cast<int>(index);
+#else
+  int r = -1;
+  while (n > 0) {
+    r++;
+    n >>= 1;
+  }
+  return r;
+#endif
+}
+}  // namespace
+
+// The counters of the current thread for all the KernelStats instances it has recorded into.
+class KernelStats::ThreadCountersList {
+ public:
+  ~ThreadCountersList() {
+    // The thread exits: hand its counters back to the instances that are still alive.
+    std::lock_guard<std::mutex> guard(LiveKernelStatsMutex());
+    const auto& live = LiveKernelStats();
+    for (const auto& entry : entries_) {
+      auto it = live.find(entry.first);
+      if (it != live.end()) {
+        it->second->ReleaseThreadCounters(entry.second);
+      }
+    }
+  }
+
+  NodeCounters* Get(uint64_t id) {
+    if (last_id_ == id) {
+      return last_counters_;
+    }
+    for (const auto& entry : entries_) {
+      if (entry.first == id) {
+        last_id_ = entry.first;
+        last_counters_ = entry.second;
+        return last_counters_;
+      }
+    }
+    return nullptr;
+  }
+
+  void Add(uint64_t id, NodeCounters* counters) {
+    // Drop the entries of the instances that no longer exist. Their counters were released with them.
+    {
+      std::lock_guard<std::mutex> guard(LiveKernelStatsMutex());
+      const auto& live = LiveKernelStats();
+      entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                    [&live](const std::pair<uint64_t, NodeCounters*>& entry) {
+                                      return live.find(entry.first) == live.end();
+                                    }),
+                     entries_.end());
+    }
+    entries_.emplace_back(id, counters);
+    last_id_ = id;
+    last_counters_ = counters;
+  }
+
+ private:
+  std::vector<std::pair<uint64_t, NodeCounters*>> entries_;
+  uint64_t last_id_ = 0;
+  NodeCounters* last_counters_ = nullptr;
+};
+
+KernelStats::KernelStats() : id_(NextKernelStatsId()) {
+  std::lock_guard<std::mutex> guard(LiveKernelStatsMutex());
+  LiveKernelStats().emplace(id_, this);
+}
+
+KernelStats::~KernelStats() {
+  std::lock_guard<std::mutex> guard(LiveKernelStatsMutex());
+  LiveKernelStats().erase(id_);
+}
+
+size_t KernelStats::AddGraph(const GraphViewer& graph_viewer, const std::string& name_prefix) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ORT_ENFORCE(thread_counters_.empty() && exited_totals_.empty(),
+              "Graphs must be added before any kernel statistics are recorded.");
+  const size_t first_slot = nodes_.size();
+  nodes_.resize(first_slot + graph_viewer.MaxNodeIndex());
+  for (const auto& node : graph_viewer.Nodes()) {
+    auto& info = nodes_[first_slot + node.Index()];
+    info.name = name_prefix + (node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name());
+    info.op_type = node.OpType();
+  }
+  return first_slot;
+}
+
+KernelStats::NodeCounters* KernelStats::GetThreadCounters() {
+  static thread_local ThreadCountersList thread_counters;
+  NodeCounters* counters = thread_counters.Get(id_);
+  if (counters == nullptr) {
+    counters = CreateThreadCounters();
+    thread_counters.Add(id_, counters);
+  }
+  return counters;
+}
+
+KernelStats::NodeCounters* KernelStats::CreateThreadCounters() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  thread_counters_.push_back(std::make_unique<NodeCounters[]>(nodes_.size()));
+  return thread_counters_.back().get();
+}
+
+void KernelStats::ReleaseThreadCounters(const NodeCounters* counters) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(thread_counters_.begin(), thread_counters_.end(),
+                         [counters](const std::unique_ptr<NodeCounters[]>& entry) {
+                           return entry.get() == counters;
+                         });
+  if (it == thread_counters_.end()) {
+    return;
+  }
+  exited_totals_.resize(nodes_.size());
+  AddCounters(counters, exited_totals_);
+  thread_counters_.erase(it);
+}
+
+void KernelStats::AddCounters(const NodeCounters* counters, std::vector<Summary>& totals) const {
+  for (size_t slot = 0; slot < nodes_.size(); ++slot) {
+    auto& total = totals[slot];
+    for (int b = 0; b < kNumBuckets; ++b) {
+      total.buckets[b] += counters[slot].buckets[b].load(std::memory_order_relaxed);
+    }
+    total.total_ns += counters[slot].total_ns.load(std::memory_order_relaxed);
+    total.output_bytes += counters[slot].output_bytes.load(std::memory_order_relaxed);
+  }
+}
+
+size_t KernelStats::NumThreadCounters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return thread_counters_.size();
+}
+
+int KernelStats::BucketIndex(uint64_t ns) {
+  if (ns < (uint64_t{1} << kMinOctave)) {
+    return 0;
+  }
+  const int octave = Log2FloorNonZero(ns);
+  if (octave >= kMaxOctave) {
+    return kNumBuckets - 1;
+  }
+  const int sub_bucket = static_cast<int>((ns >> (octave - kSubBucketBits)) & (kSubBuckets - 1));
+  return 1 + (octave - kMinOctave) * kSubBuckets + sub_bucket;
+}
+
+uint64_t KernelStats::BucketLowerBound(int bucket) {
+  if (bucket <= 0) {
+    return 0;
+  }
+  if (bucket >= kNumBuckets - 1) {
+    return uint64_t{1} << kMaxOctave;
+  }
+  const int octave = kMinOctave + (bucket - 1) / kSubBuckets;
+  const uint64_t sub_bucket = static_cast<uint64_t>((bucket - 1) % kSubBuckets);
+  return (kSubBuckets + sub_bucket) << (octave - kSubBucketBits);
+}
+
+uint64_t KernelStats::Percentile(const std::array<uint64_t, kNumBuckets>& buckets, uint64_t count, double q) {
+  if (count == 0) {
+    return 0;
+  }
+  // 1-based rank of the value at quantile q
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+  uint64_t seen = 0;
+  for (int b = 0; b < kNumBuckets; ++b) {
+    if (buckets[b] == 0) {
+      continue;
+    }
+    if (seen + buckets[b] >= rank) {
+      const uint64_t lower = BucketLowerBound(b);
+      if (b == kNumBuckets - 1) {
+        return lower;
+      }
+      const uint64_t width = BucketLowerBound(b + 1) - lower;
+      const double fraction = static_cast<double>(rank - seen) / static_cast<double>(buckets[b]);
+      return lower + static_cast<uint64_t>(fraction * static_cast<double>(width));
+    }
+    seen += buckets[b];
+  }
+  return BucketLowerBound(kNumBuckets - 1);
+}
+
+void KernelStats::GetSummaries(std::vector<Summary>& nodes, std::vector<Summary>& op_types, bool reset) {
+  nodes.clear();
+  op_types.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Summary> totals(exited_totals_);
+  totals.resize(nodes_.size());
+  for (const auto& counters : thread_counters_) {
+    AddCounters(counters.get(), totals);
+  }
+
+  // The counters only grow: statistics since the last reset are the difference with the totals at that time.
+  baseline_.resize(nodes_.size());
+  std::unordered_map<std::string, size_t> op_type_index;
+  for (size_t slot = 0; slot < nodes_.size(); ++slot) {
+    const auto& total = totals[slot];
+    const auto& base = baseline_[slot];
+    Summary summary;
+    for (int b = 0; b < kNumBuckets; ++b) {
+      summary.buckets[b] = total.buckets[b] - base.buckets[b];
+      summary.count += summary.buckets[b];
+    }
+    if (summary.count == 0) {
+      continue;
+    }
+    summary.name = nodes_[slot].name;
+    summary.op_type = nodes_[slot].op_type;
+    summary.total_ns = total.total_ns - base.total_ns;
+    summary.output_bytes = total.output_bytes - base.output_bytes;
+
+    auto it = op_type_index.emplace(summary.op_type, op_types.size()).first;
+    if (it->second == op_types.size()) {
+      op_types.emplace_back();
+      op_types.back().name = summary.op_type;
+      op_types.back().op_type = summary.op_type;
+    }
+    auto& op_type = op_types[it->second];
+    for (int b = 0; b < kNumBuckets; ++b) {
+      op_type.buckets[b] += summary.buckets[b];
+    }
+    op_type.count += summary.count;
+    op_type.total_ns += summary.total_ns;
+    op_type.output_bytes += summary.output_bytes;
+
+    nodes.push_back(std::move(summary));
+  }
+
+  for (auto* summaries : {&nodes, &op_types}) {
+    for (auto& summary : *summaries) {
+      summary.p50_ns = Percentile(summary.buckets, summary.count, 0.5);
+      summary.p90_ns = Percentile(summary.buckets, summary.count, 0.9);
+      summary.p99_ns = Percentile(summary.buckets, summary.count, 0.99);
+    }
+  }
+
+  if (reset) {
+    baseline_ = std::move(totals);
+  }
+}
+
+std::string KernelStats::ToJson(bool reset) {
+  std::vector<Summary> nodes;
+  std::vector<Summary> op_types;
+  GetSummaries(nodes, op_types, reset);
+
+  auto to_json = [](const std::vector<Summary>& summaries) {
+    json array = json::array();
+    for (const auto& summary : summaries) {
+      array.push_back({{"name", summary.name},
+                       {"op_type", summary.op_type},
+                       {"count", summary.count},
+                       {"total_us", summary.total_ns / 1000.0},
+                       {"p50_us", summary.p50_ns / 1000.0},
+                       {"p90_us", summary.p90_ns / 1000.0},
+                       {"p99_us", summary.p99_ns / 1000.0},
+                       {"output_bytes", summary.output_bytes}});
+    }
+    return array;
+  };
+
+  json result;
+  result["nodes"] = to_json(nodes);
+  result["op_types"] = to_json(op_types);
+  return result.dump();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+/**
+ * Always-on statistics of the kernels a session runs: a latency histogram and the bytes of the outputs of each node.
+ *
+ * Each thread that runs kernels records into its own set of counters, which only that thread writes, so recording
+ * takes neither a lock nor an atomic read-modify-write. Readers sum the counters of all the threads. When a thread
+ * exits, its counters are added to the totals of the exited threads and released.
+ *
+ * The latency histogram has 4 buckets per power of two between 256 ns and 2^34 ns (~17 s), plus a bucket for each
+ * side of that range. Percentiles are interpolated within their bucket, so they are within ~19% of the exact value.
+ * The counters take sizeof(NodeCounters) bytes per node per running thread that ran the session.
+ */
+class KernelStats {
+ public:
+  static constexpr int kSubBucketBits = 2;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMinOctave = 8;
+  static constexpr int kMaxOctave = 34;
+  static constexpr int kNumBuckets = (kMaxOctave - kMinOctave) * kSubBuckets + 2;
+
+  // Statistics of a node, or of all the nodes of an op type.
+  struct Summary {
+    std::string name;
+    std::string op_type;
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t output_bytes = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    std::array<uint64_t, kNumBuckets> buckets{};
+  };
+
+  KernelStats();
+  ~KernelStats();
+
+  /**
+   * Registers the nodes of a graph. Must be called for every graph before any statistics are recorded.
+   * @param graph_viewer The graph.
+   * @param name_prefix Prefix of the names of the nodes in the statistics, to tell apart the nodes of subgraphs.
+   * @returns The slot of the node with index 0. The slot of a node is that value plus its index.
+   */
+  size_t AddGraph(const GraphViewer& graph_viewer, const std::string& name_prefix);
+
+  // Records a run of the kernel of a node.
+  void Record(size_t slot, uint64_t latency_ns, uint64_t output_bytes) {
+    NodeCounters& counters = GetThreadCounters()[slot];
+    // The calling thread is the only writer of its counters: plain load and store, relaxed so readers don't tear.
+    auto add = [](std::atomic<uint64_t>& counter, uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    add(counters.buckets[BucketIndex(latency_ns)], 1);
+    add(counters.total_ns, latency_ns);
+    add(counters.output_bytes, output_bytes);
+  }
+
+  /**
+   * Gets the statistics since the creation of the object or the last reset.
+   * @param nodes The statistics of each node that ran.
+   * @param op_types The statistics of each op type, summed over its nodes.
+   * @param reset Whether to start the next statistics from now.
+   */
+  void GetSummaries(std::vector<Summary>& nodes, std::vector<Summary>& op_types, bool reset);
+
+  // Number of threads whose counters are held, i.e. that recorded statistics and are still running.
+  size_t NumThreadCounters() const;
+
+  // Same as GetSummaries, formatted as a JSON object with "nodes" and "op_types" arrays. Latencies are in microseconds.
+  std::string ToJson(bool reset);
+
+  static int BucketIndex(uint64_t ns);
+  static uint64_t BucketLowerBound(int bucket);
+
+  // Value at quantile q (0..1) of a histogram, interpolated within its bucket.
+  static uint64_t Percentile(const std::array<uint64_t, kNumBuckets>& buckets, uint64_t count, double q);
+
+ private:
+  struct NodeCounters {
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets{};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> output_bytes{0};
+  };
+
+  struct NodeInfo {
+    std::string name;
+    std::string op_type;
+  };
+
+  class ThreadCountersList;
+
+  NodeCounters* GetThreadCounters();
+  NodeCounters* CreateThreadCounters();
+  // Adds the counters of an exiting thread to exited_totals_ and releases them.
+  void ReleaseThreadCounters(const NodeCounters* counters);
+  // Adds counters to totals, which has a summary per slot.
+  void AddCounters(const NodeCounters* counters, std::vector<Summary>& totals) const;
+
+  // Identifies this object in the per-thread lists of counters.
+  const uint64_t id_;
+
+  mutable std::mutex mutex_;
+  std::vector<NodeInfo> nodes_;
+  // Counters of each running thread that recorded statistics, indexed by slot.
+  std::vector<std::unique_ptr<NodeCounters[]>> thread_counters_;
+  // Sums of the counters of the threads that exited.
+  std::vector<Summary> exited_totals_;
+  // Sums of the counters at the last reset.
+  std::vector<Summary> baseline_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelStats);
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_pattern_cache.h"
+
+#include "core/common/hash_combine.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+MemoryPatternCache::Key MemoryPatternCache::MakeKey(gsl::span<const OrtValue> tensor_inputs) {
+  Key key;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    key.push_back(static_cast<int64_t>(dims.size()));
+    key.insert(key.end(), dims.begin(), dims.end());
+  }
+  return key;
+}
+
+size_t MemoryPatternCache::KeyHash::operator()(const Key& key) const noexcept {
+  size_t seed = key.size();
+  for (auto v : key) {
+    HashCombine(v, seed);
+  }
+  return seed;
+}
+
+std::shared_ptr<const CachedMemoryPattern> MemoryPatternCache::Find(const Key& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<const CachedMemoryPattern> MemoryPatternCache::Insert(
+    const Key& key, std::shared_ptr<const CachedMemoryPattern> pattern) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Another Run with the same shapes got here first. Keep the existing pattern as it may already be in use.
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  lru_.emplace_front(key, std::move(pattern));
+  index_.emplace(key, lru_.begin());
+
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return lru_.front().second;
+}
+
+size_t MemoryPatternCache::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+}  // namespace onnxruntime
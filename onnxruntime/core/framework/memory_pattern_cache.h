@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+/**
+ * The memory pattern of one combination of feed shapes.
+ *
+ * mem_patterns is used by the ExecutionFrame to pre-allocate one buffer per device and place every planned
+ * activation at a fixed offset in it. inferred_shapes holds the shapes, keyed by OrtValue index, that were resolved
+ * from the symbolic dimensions of the graph when the pattern was generated from the feed shapes (training builds
+ * only), and is surfaced to kernels via OpKernelContext::TryGetInferred*Shape.
+ *
+ * An entry is immutable once it is published to the cache. ExecutionFrame holds a shared reference for the duration
+ * of a Run, so an entry that is evicted while in use stays valid until that Run completes.
+ */
+struct CachedMemoryPattern {
+  MemoryPatternGroup mem_patterns;
+  InlinedHashMap<int, TensorShape> inferred_shapes;
+};
+
+/**
+ * Bounded LRU cache of CachedMemoryPattern instances keyed by the exact shapes of all the feeds.
+ * All methods are thread-safe.
+ */
+class MemoryPatternCache {
+ public:
+  // Rank followed by the dims of each feed, so that e.g. {[2, 3]} and {[3, 2]} or {[6]} never share an entry.
+  using Key = InlinedVector<int64_t>;
+
+  static constexpr size_t kDefaultCapacity = 64;
+
+  explicit MemoryPatternCache(size_t capacity = kDefaultCapacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+  // All the values must contain tensors.
+  static Key MakeKey(gsl::span<const OrtValue> tensor_inputs);
+
+  // Returns nullptr if there is no entry for the key. A hit makes the entry the most recently used one.
+  std::shared_ptr<const CachedMemoryPattern> Find(const Key& key) const;
+
+  // Adds the pattern if there is no entry for the key yet, evicting the least recently used entries to stay within
+  // capacity. Returns the pattern that is cached for the key after the call.
+  std::shared_ptr<const CachedMemoryPattern> Insert(const Key& key,
+                                                    std::shared_ptr<const CachedMemoryPattern> pattern) const;
+
+  size_t Size() const;
+  size_t Capacity() const noexcept { return capacity_; }
+
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+  };
+
+  Stats GetStats() const noexcept {
+    return {hits_.load(std::memory_order_relaxed),
+            misses_.load(std::memory_order_relaxed),
+            evictions_.load(std::memory_order_relaxed)};
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  using Entry = std::pair<Key, std::shared_ptr<const CachedMemoryPattern>>;
+  using EntryList = std::list<Entry>;
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  // most recently used entry at the front
+  mutable EntryList lru_;
+  mutable std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+
+  mutable std::atomic<uint64_t> hits_{0};
+  mutable std::atomic<uint64_t> misses_{0};
+  mutable std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace onnxruntime
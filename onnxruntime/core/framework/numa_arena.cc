@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/numa_arena.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "core/common/logging/logging.h"
+#include "core/common/safeint.h"
+#include "core/framework/allocator_stats.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+// Provides the memory of the arena of a NUMA node and records the regions it hands out in the owning NumaArena.
+class NumaArena::NodeAllocator : public IAllocator {
+ public:
+  NodeAllocator(std::unique_ptr<IAllocator> device_allocator, int numa_node, NumaArena& owner)
+      : IAllocator(device_allocator->Info()),
+        device_allocator_(std::move(device_allocator)),
+        numa_node_(numa_node),
+        owner_(owner) {}
+
+  void* Alloc(size_t size) override {
+    void* p = device_allocator_->Alloc(size);
+    if (p == nullptr) {
+      return nullptr;
+    }
+    // Bind before the arena touches the memory, so that the pages are allocated on the node in the first place.
+    auto status = Env::Default().BindMemoryToNumaNode(p, size, numa_node_);
+    if (!status.IsOK() && !bind_failure_logged_.exchange(true)) {
+      LOGS_DEFAULT(WARNING) << "The arena of NUMA node " << numa_node_
+                            << " could not bind its memory to the node: " << status.ErrorMessage();
+    }
+    owner_.AddRegion(p, size, numa_node_);
+    return p;
+  }
+
+  void Free(void* p) override {
+    if (p == nullptr) {
+      return;
+    }
+    owner_.RemoveRegion(p);
+    device_allocator_->Free(p);
+  }
+
+ private:
+  std::unique_ptr<IAllocator> device_allocator_;
+  const int numa_node_;
+  NumaArena& owner_;
+  std::atomic<bool> bind_failure_logged_{false};
+};
+
+static OrtMemoryInfo NumaArenaMemoryInfo(const OrtMemoryInfo& device_info) {
+  return OrtMemoryInfo(device_info.name, OrtAllocatorType::OrtDeviceAllocator, device_info.device, device_info.id,
+                       device_info.mem_type);
+}
+
+NumaArena::NumaArena(const std::vector<int>& numa_nodes,
+                     const DeviceAllocatorFactory& device_allocator_factory,
+                     const ArenaFactory& arena_factory)
+    : IAllocator(NumaArenaMemoryInfo(device_allocator_factory()->Info())),
+      tag_size_(std::max(sizeof(int), MlasGetPreferredBufferAlignment())) {
+  ORT_ENFORCE(!numa_nodes.empty(), "NumaArena requires at least one NUMA node");
+  default_numa_node_ = numa_nodes.front();
+  for (int numa_node : numa_nodes) {
+    ORT_ENFORCE(numa_node >= 0, "Invalid NUMA node: ", numa_node);
+    if (arenas_.size() <= static_cast<size_t>(numa_node)) {
+      arenas_.resize(static_cast<size_t>(numa_node) + 1);
+    }
+    ORT_ENFORCE(!arenas_[numa_node], "Duplicate NUMA node: ", numa_node);
+    arenas_[numa_node] = arena_factory(
+        std::make_unique<NodeAllocator>(device_allocator_factory(), numa_node, *this));
+  }
+}
+
+NumaArena::~NumaArena() {
+  // The arenas free their regions through the node allocators, which update regions_.
+  arenas_.clear();
+}
+
+int NumaArena::NumaNodeOfCallingThread() const {
+  const int numa_node = Env::Default().GetCurrentNumaNode();
+  if (numa_node >= 0 && static_cast<size_t>(numa_node) < arenas_.size() && arenas_[numa_node]) {
+    return numa_node;
+  }
+  return default_numa_node_;
+}
+
+void* NumaArena::TagBuffer(void* p, int numa_node) const {
+  if (p == nullptr) {
+    return nullptr;
+  }
+  *static_cast<int*>(p) = numa_node;
+  return static_cast<char*>(p) + tag_size_;
+}
+
+void* NumaArena::Alloc(size_t size) {
+  const int numa_node = NumaNodeOfCallingThread();
+  return TagBuffer(arenas_[numa_node]->Alloc(SafeInt<size_t>(size) + tag_size_), numa_node);
+}
+
+void* NumaArena::Reserve(size_t size) {
+  const int numa_node = NumaNodeOfCallingThread();
+  return TagBuffer(arenas_[numa_node]->Reserve(SafeInt<size_t>(size) + tag_size_), numa_node);
+}
+
+void NumaArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+  char* buffer = static_cast<char*>(p) - tag_size_;
+  const int numa_node = *reinterpret_cast<const int*>(buffer);
+  ORT_ENFORCE(numa_node >= 0 && static_cast<size_t>(numa_node) < arenas_.size() && arenas_[numa_node],
+              "NumaArena::Free called with a pointer it did not allocate: ", p);
+  arenas_[numa_node]->Free(buffer);
+}
+
+void NumaArena::GetStats(AllocatorStats* stats) {
+  stats->Clear();
+  for (auto& arena : arenas_) {
+    if (!arena) {
+      continue;
+    }
+    AllocatorStats arena_stats;
+    arena->GetStats(&arena_stats);
+    stats->num_allocs += arena_stats.num_allocs;
+    stats->num_reserves += arena_stats.num_reserves;
+    stats->num_arena_extensions += arena_stats.num_arena_extensions;
+    stats->num_arena_shrinkages += arena_stats.num_arena_shrinkages;
+    stats->bytes_in_use += arena_stats.bytes_in_use;
+    stats->total_allocated_bytes += arena_stats.total_allocated_bytes;
+    stats->max_bytes_in_use += arena_stats.max_bytes_in_use;
+    stats->max_alloc_size = std::max(stats->max_alloc_size, arena_stats.max_alloc_size);
+    stats->bytes_limit += arena_stats.bytes_limit;
+  }
+}
+
+int NumaArena::NumaNodeOf(const void* p) const {
+  const char* ptr = static_cast<const char*>(p);
+  std::lock_guard<std::mutex> lock(regions_mutex_);
+  auto it = regions_.upper_bound(ptr);
+  if (it == regions_.begin()) {
+    return -1;
+  }
+  --it;
+  if (ptr >= it->first + it->second.first) {
+    return -1;
+  }
+  return it->second.second;
+}
+
+void NumaArena::AddRegion(void* p, size_t size, int numa_node) {
+  std::lock_guard<std::mutex> lock(regions_mutex_);
+  regions_[static_cast<const char*>(p)] = {size, numa_node};
+}
+
+void NumaArena::RemoveRegion(void* p) {
+  std::lock_guard<std::mutex> lock(regions_mutex_);
+  regions_.erase(static_cast<const char*>(p));
+}
+
+}  // namespace onnxruntime
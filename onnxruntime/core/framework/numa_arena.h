@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+/**
+ * An arena for each NUMA node of the host.
+ *
+ * Alloc() is served by the arena of the node that the calling thread runs on, and the memory of each arena is bound
+ * to its node. Combined with an intra-op thread pool partitioned by NUMA node, the tensors a kernel produces are
+ * placed on the node whose threads compute and consume them. Free() returns a buffer to the arena it came from,
+ * whichever thread calls it.
+ *
+ * Each buffer is preceded by a tag with the node of its arena, so that Free() finds the arena without a lookup or a
+ * lock. The tag takes the preferred buffer alignment of MLAS, which the returned buffers keep.
+ *
+ * The allocator reports the OrtDeviceAllocator type: the code that handles OrtArenaAllocator allocators assumes they
+ * are BFCArena instances.
+ */
+class NumaArena : public IAllocator {
+ public:
+  // Creates the arena of a node on top of the allocator of the node's memory.
+  using ArenaFactory = std::function<std::unique_ptr<IAllocator>(std::unique_ptr<IAllocator> node_allocator)>;
+  using DeviceAllocatorFactory = std::function<std::unique_ptr<IAllocator>()>;
+
+  /**
+   * @param numa_nodes Ids of the NUMA nodes to create an arena for. Must not be empty.
+   * @param device_allocator_factory Creates the allocator that provides the memory of a node's arena.
+   * @param arena_factory Creates the arena of a node.
+   */
+  NumaArena(const std::vector<int>& numa_nodes,
+            const DeviceAllocatorFactory& device_allocator_factory,
+            const ArenaFactory& arena_factory);
+
+  ~NumaArena() override;
+
+  void* Alloc(size_t size) override;
+
+  void Free(void* p) override;
+
+  void* Reserve(size_t size) override;
+
+  // Sums the statistics of the arenas of all the nodes.
+  void GetStats(AllocatorStats* stats) override;
+
+  // NUMA node of the arena that allocated p, -1 if p wasn't allocated by this allocator.
+  // Unlike Free(), it looks up the regions of the arenas under a lock.
+  int NumaNodeOf(const void* p) const;
+
+ private:
+  class NodeAllocator;
+
+  int NumaNodeOfCallingThread() const;
+
+  // Writes the tag of a buffer that the arena of numa_node returned, and returns the buffer for the caller.
+  void* TagBuffer(void* p, int numa_node) const;
+
+  void AddRegion(void* p, size_t size, int numa_node);
+  void RemoveRegion(void* p);
+
+  // Arena of each NUMA node, indexed by node id. Null for the nodes without an arena.
+  std::vector<std::unique_ptr<IAllocator>> arenas_;
+  // Arena used by the threads that don't run on a node with an arena.
+  int default_numa_node_;
+  // Size of the tag in front of each buffer.
+  const size_t tag_size_;
+
+  // Start address of each region of memory the arenas obtained from their node allocators, with its size and node.
+  // Only used by NumaNodeOf().
+  mutable std::mutex regions_mutex_;
+  std::map<const char*, std::pair<size_t, int>> regions_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumaArena);
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,426 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepack_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "onnxruntime_config.h"
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/config_options.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor_external_data_info.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'O', 'R', 'T', 'P', 'R', 'E', 'P', 'K'};
+constexpr const char* kFileExtension = ".ortprepack";
+
+// Session configuration entries that select the kernels, and with them the layout of the pre-packed weights, with
+// their defaults. They are hashed with their effective values so that the key also changes with the defaults.
+constexpr std::pair<const char*, const char*> kLayoutConfigs[] = {
+    {kOrtSessionOptionsMlasSparseGemmMinimumSparsity, "0.7"},
+    {kOrtSessionOptionsMlasGemmFastMathBfloat16, "0"},
+    {kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0"},
+    {kOrtSessionOptionsConfigNumaReplicateWeights, "0"},
+};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t reserved;
+  uint64_t model_hash;
+  uint64_t platform_hash;
+  uint64_t index_offset;
+  uint64_t index_size;
+  uint64_t num_entries;
+};
+
+// Chained 128-bit MurmurHash3 that accepts input of any length.
+class Hasher {
+ public:
+  void Add(const void* data, size_t len) {
+    // MurmurHash3 takes an int length so feed large inputs in chunks
+    constexpr size_t kMaxChunk = size_t{1} << 30;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    do {
+      const size_t chunk = std::min(len, kMaxChunk);
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk), hash_[0], &hash_);
+      bytes += chunk;
+      len -= chunk;
+    } while (len > 0);
+  }
+
+  void Add(std::string_view str) {
+    AddValue(str.size());
+    Add(str.data(), str.size());
+  }
+
+  template <typename T>
+  void AddValue(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Add(&value, sizeof(T));
+  }
+
+  uint64_t Get() const { return (uint64_t{hash_[1]} << 32) | hash_[0]; }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+void HashInitializer(Hasher& hasher, const ONNX_NAMESPACE::TensorProto& proto, const std::filesystem::path& model_dir) {
+  hasher.AddValue(proto.data_type());
+  hasher.AddValue(proto.dims_size());
+  for (const auto dim : proto.dims()) {
+    hasher.AddValue(dim);
+  }
+
+  if (utils::HasExternalDataInMemory(proto)) {
+    // the address in the external data entries differs between processes so hash the data itself
+    std::unique_ptr<ExternalDataInfo> external_data_info;
+    if (ExternalDataInfo::Create(proto.external_data(), external_data_info).IsOK()) {
+      hasher.Add(reinterpret_cast<const void*>(static_cast<uintptr_t>(external_data_info->GetOffset())),
+                 external_data_info->GetLength());
+    }
+  } else if (utils::HasExternalData(proto)) {
+    for (const auto& entry : proto.external_data()) {
+      hasher.Add(entry.key());
+      hasher.Add(entry.value());
+      if (entry.key() == "location") {
+        // identify the file content by size and modification time to avoid reading potentially large files
+        std::error_code ec;
+        const auto file_path = model_dir / ToPathString(entry.value());
+        const auto file_size = std::filesystem::file_size(file_path, ec);
+        hasher.AddValue(ec ? uintmax_t{0} : file_size);
+        const auto write_time = std::filesystem::last_write_time(file_path, ec);
+        hasher.AddValue(ec ? int64_t{0} : static_cast<int64_t>(write_time.time_since_epoch().count()));
+      }
+    }
+  } else if (utils::HasRawData(proto)) {
+    hasher.Add(proto.raw_data().data(), proto.raw_data().size());
+  } else {
+    hasher.Add(proto.SerializeAsString());
+  }
+}
+
+size_t AlignUp(size_t value) {
+  return (value + PrepackCache::kBufferAlignment - 1) / PrepackCache::kBufferAlignment *
+         PrepackCache::kBufferAlignment;
+}
+
+std::string ToHexString(uint64_t value) {
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(value));
+  return buf;
+}
+
+}  // namespace
+
+Status PrepackCache::Open(const Env& env, const std::filesystem::path& cache_dir, uint64_t model_hash,
+                          std::unique_ptr<PrepackCache>& cache) {
+  if (!env.FolderExists(cache_dir.native())) {
+    ORT_RETURN_IF_ERROR(env.CreateFolder(cache_dir.native()));
+  }
+
+  auto file_name = ToHexString(model_hash) + "-" + ToHexString(GetPlatformHash()) + kFileExtension;
+  cache.reset(new PrepackCache(env, cache_dir / file_name, model_hash));
+  return cache->Load();
+}
+
+uint64_t PrepackCache::ComputeModelHash(const GraphViewer& graph_viewer, const std::filesystem::path& model_path,
+                                        const ConfigOptions& config_options) {
+  Hasher hasher;
+
+  for (const NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node* node = graph_viewer.GetNode(node_index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    hasher.AddValue(node->Index());
+    hasher.Add(node->OpType());
+    hasher.Add(node->Domain());
+    hasher.AddValue(node->SinceVersion());
+    hasher.Add(node->Name());
+    hasher.Add(node->GetExecutionProviderType());
+    for (const auto* def : node->InputDefs()) {
+      hasher.Add(def->Name());
+    }
+    for (const auto* def : node->OutputDefs()) {
+      hasher.Add(def->Name());
+    }
+
+    // NodeAttributes is unordered so sort by name for a stable hash
+    std::map<std::string_view, const ONNX_NAMESPACE::AttributeProto*> attributes;
+    for (const auto& [name, attribute] : node->GetAttributes()) {
+      attributes.emplace(name, &attribute);
+    }
+    for (const auto& [name, attribute] : attributes) {
+      hasher.Add(name);
+      hasher.Add(attribute->SerializeAsString());
+    }
+  }
+
+  const auto model_dir = model_path.parent_path();
+  std::map<std::string_view, const ONNX_NAMESPACE::TensorProto*> initializers;
+  for (const auto& [name, proto] : graph_viewer.GetAllInitializedTensors()) {
+    initializers.emplace(name, proto);
+  }
+  for (const auto& [name, proto] : initializers) {
+    hasher.Add(name);
+    HashInitializer(hasher, *proto, model_dir);
+  }
+
+  std::map<std::string_view, std::string_view> configurations(config_options.configurations.begin(),
+                                                              config_options.configurations.end());
+  for (const auto& [key, value] : configurations) {
+    hasher.Add(key);
+    hasher.Add(value);
+  }
+
+  for (const auto& [key, default_value] : kLayoutConfigs) {
+    hasher.Add(config_options.GetConfigOrDefault(key, default_value));
+  }
+
+  return hasher.Get();
+}
+
+uint64_t PrepackCache::GetPlatformHash() {
+  Hasher hasher;
+  hasher.Add(std::string_view{ORT_VERSION});
+  hasher.AddValue(kFormatVersion);
+  hasher.AddValue(static_cast<uint32_t>(MLAS_PACKED_FORMAT_VERSION));
+  hasher.AddValue(sizeof(void*));
+
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  const bool cpu_features[] = {
+      cpuid_info.HasSSE3(),
+      cpuid_info.HasSSE4_1(),
+      cpuid_info.HasAVX(),
+      cpuid_info.HasAVX2(),
+      cpuid_info.HasAVX512f(),
+      cpuid_info.HasAVX512Skylake(),
+      cpuid_info.HasAVX512_BF16(),
+      cpuid_info.HasAMX_BF16(),
+      cpuid_info.HasF16C(),
+      cpuid_info.HasFp16VectorAcceleration(),
+      cpuid_info.HasArmNeonDot(),
+      cpuid_info.HasArmNeon_I8MM(),
+      cpuid_info.HasArmSVE_I8MM(),
+      cpuid_info.HasArmNeon_BF16(),
+  };
+  hasher.Add(cpu_features, sizeof(cpu_features));
+
+  return hasher.Get();
+}
+
+std::string PrepackCache::MakeKey(const Node& node, int input_idx) {
+  const auto& input_defs = node.InputDefs();
+  std::string key = node.OpType();
+  key += ':';
+  key += std::to_string(node.Index());
+  key += ':';
+  key += std::to_string(input_idx);
+  if (static_cast<size_t>(input_idx) < input_defs.size()) {
+    key += ':';
+    key += input_defs[input_idx]->Name();
+  }
+  return key;
+}
+
+const PrePackedWeights* PrepackCache::Find(const std::string& key) const {
+  auto it = cached_.find(key);
+  return it != cached_.end() ? &it->second : nullptr;
+}
+
+void PrepackCache::Add(const std::string& key, const PrePackedWeights& weights) {
+  if (cached_.count(key) == 0) {
+    added_.insert_or_assign(key, weights.CreateReferringCopy());
+  }
+}
+
+Status PrepackCache::Load() {
+  if (!env_.FileExists(file_path_.native())) {
+    return Status::OK();
+  }
+
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env_.GetFileLength(file_path_.c_str(), file_length));
+
+  auto invalid_file = [this](const char* reason) {
+    LOGS_DEFAULT(WARNING) << "Ignoring pre-packed weights cache file " << file_path_ << ": " << reason;
+    cached_.clear();
+    mapped_file_.reset();
+    return Status::OK();
+  };
+
+  if (file_length < sizeof(FileHeader)) {
+    return invalid_file("file is truncated");
+  }
+
+  ORT_RETURN_IF_ERROR(env_.MapFileIntoMemory(file_path_.c_str(), 0, file_length, mapped_file_));
+  const char* base = mapped_file_.get();
+
+  FileHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 || header.format_version != kFormatVersion) {
+    return invalid_file("unknown file format");
+  }
+  if (header.model_hash != model_hash_ || header.platform_hash != GetPlatformHash()) {
+    return invalid_file("file was written for a different model or platform");
+  }
+  if (header.index_offset < sizeof(FileHeader) || header.index_offset > file_length ||
+      header.index_size != file_length - header.index_offset) {
+    return invalid_file("index is out of bounds");
+  }
+
+  const char* cursor = base + header.index_offset;
+  const char* const index_end = cursor + header.index_size;
+  auto read = [&cursor, index_end](void* dst, size_t size) {
+    if (static_cast<size_t>(index_end - cursor) < size) {
+      return false;
+    }
+    memcpy(dst, cursor, size);
+    cursor += size;
+    return true;
+  };
+
+  for (uint64_t entry = 0; entry < header.num_entries; ++entry) {
+    uint32_t key_length = 0;
+    if (!read(&key_length, sizeof(key_length)) || static_cast<size_t>(index_end - cursor) < key_length) {
+      return invalid_file("index is truncated");
+    }
+    std::string key(cursor, key_length);
+    cursor += key_length;
+
+    uint32_t num_buffers = 0;
+    if (!read(&num_buffers, sizeof(num_buffers))) {
+      return invalid_file("index is truncated");
+    }
+
+    PrePackedWeights weights;
+    for (uint32_t i = 0; i < num_buffers; ++i) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      if (!read(&offset, sizeof(offset)) || !read(&size, sizeof(size))) {
+        return invalid_file("index is truncated");
+      }
+      if (offset % kBufferAlignment != 0 || offset < sizeof(FileHeader) || offset > header.index_offset ||
+          size > header.index_offset - offset) {
+        return invalid_file("buffer is out of bounds");
+      }
+
+      // buffers are owned by the mapping
+      void* buffer = size == 0 ? nullptr : const_cast<char*>(base) + offset;
+      weights.buffers_.emplace_back(buffer, [](void*) {});
+      weights.buffer_sizes_.push_back(static_cast<size_t>(size));
+    }
+
+    cached_.insert_or_assign(std::move(key), std::move(weights));
+  }
+
+  if (cursor != index_end) {
+    return invalid_file("index has trailing data");
+  }
+
+  return Status::OK();
+}
+
+Status PrepackCache::Save() {
+  if (added_.empty()) {
+    return Status::OK();
+  }
+
+  auto temp_path = file_path_;
+  temp_path += ToPathString("." + std::to_string(env_.GetSelfPid()) + ".tmp");
+
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file.good(), "Failed to open pre-packed weights cache file for writing: ", temp_path);
+
+    static const char padding[kBufferAlignment] = {};
+    std::string index;
+    uint64_t num_entries = 0;
+    uint64_t offset = AlignUp(sizeof(FileHeader));
+
+    auto append_index = [&index](const void* data, size_t size) {
+      index.append(static_cast<const char*>(data), size);
+    };
+
+    file.seekp(static_cast<std::streamoff>(offset));
+
+    for (const auto* entries : {&cached_, &added_}) {
+      for (const auto& [key, weights] : *entries) {
+        const auto key_length = static_cast<uint32_t>(key.size());
+        const auto num_buffers = static_cast<uint32_t>(weights.buffers_.size());
+        append_index(&key_length, sizeof(key_length));
+        append_index(key.data(), key.size());
+        append_index(&num_buffers, sizeof(num_buffers));
+
+        for (size_t i = 0; i < weights.buffers_.size(); ++i) {
+          const uint64_t size = weights.buffer_sizes_[i];
+          const void* buffer = weights.buffers_[i].get();
+          const uint64_t buffer_size = buffer != nullptr ? size : 0;
+          append_index(&offset, sizeof(offset));
+          append_index(&buffer_size, sizeof(buffer_size));
+
+          if (buffer_size != 0) {
+            file.write(static_cast<const char*>(buffer), static_cast<std::streamsize>(buffer_size));
+            const size_t aligned_size = AlignUp(buffer_size);
+            file.write(padding, static_cast<std::streamsize>(aligned_size - buffer_size));
+            offset += aligned_size;
+          }
+        }
+
+        ++num_entries;
+      }
+    }
+
+    FileHeader header{};
+    memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.format_version = kFormatVersion;
+    header.model_hash = model_hash_;
+    header.platform_hash = GetPlatformHash();
+    header.index_offset = offset;
+    header.index_size = index.size();
+    header.num_entries = num_entries;
+
+    file.write(index.data(), static_cast<std::streamsize>(index.size()));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (file.fail()) {
+      std::error_code ec;
+      std::filesystem::remove(temp_path, ec);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write pre-packed weights cache file: ", temp_path);
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, file_path_, ec);
+  if (ec) {
+    const auto message = ec.message();
+    std::filesystem::remove(temp_path, ec);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace pre-packed weights cache file ", file_path_,
+                           ": ", message);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class ConfigOptions;
+class GraphViewer;
+class Node;
+
+/**
+ * Persistent cache of the pre-packed weights that OpKernel::PrePack produces for the constant initializers of a model.
+ *
+ * The cache for a model is a single file in a user supplied directory. Its name is derived from a hash of the model
+ * content and a fingerprint of the platform, which covers the ORT version, the MLAS packed format version
+ * (MLAS_PACKED_FORMAT_VERSION), the cache format version and the CPU features that MLAS selects its kernels by.
+ * A file that was written for a different model or platform is therefore never opened, and one that fails validation
+ * is ignored and replaced on the next Save().
+ *
+ * The file is memory mapped when the cache is opened. The buffers returned by Find() point into the mapping and stay
+ * valid for the lifetime of the PrepackCache instance.
+ *
+ * File layout (native endianness):
+ *   FileHeader
+ *   pre-packed buffers, each aligned to kBufferAlignment
+ *   index: for each entry, key length (uint32), key, buffer count (uint32), then (offset, size) (uint64) per buffer
+ */
+class PrepackCache {
+ public:
+  static constexpr uint32_t kFormatVersion = 1;
+  static constexpr size_t kBufferAlignment = 64;
+
+  // Opens the cache for the model with the given hash in `cache_dir`, creating the directory if needed.
+  // A missing or invalid cache file results in an empty cache.
+  static Status Open(const Env& env, const std::filesystem::path& cache_dir, uint64_t model_hash,
+                     std::unique_ptr<PrepackCache>& cache);
+
+  // Hash of everything that determines what PrePack produces for a graph: the nodes with their attributes and
+  // assigned execution providers, the initializers and the session configuration entries. The entries that select
+  // the kernels, such as the sparse GEMM threshold and the bfloat16 fastmath mode, are hashed with their effective
+  // values, defaults included.
+  // Initializer data in an external file is identified by its location, size and modification time rather than
+  // by reading it.
+  static uint64_t ComputeModelHash(const GraphViewer& graph_viewer, const std::filesystem::path& model_path,
+                                   const ConfigOptions& config_options);
+
+  // Hash of the ORT version, MLAS packed format version, cache format version and CPU features.
+  static uint64_t GetPlatformHash();
+
+  // Key of the pre-packed weights for input `input_idx` of `node`.
+  static std::string MakeKey(const Node& node, int input_idx);
+
+  // Returns nullptr if the cache file has no entry for the key.
+  const PrePackedWeights* Find(const std::string& key) const;
+
+  // Records the weights to be written by the next Save(). They are referred to, not copied, so the buffers must
+  // stay alive until Save() returns. Keys that are already in the cache file are ignored.
+  void Add(const std::string& key, const PrePackedWeights& weights);
+
+  // Writes a new cache file containing the existing and added entries if any entries were added.
+  // The file is written under a temporary name and renamed so that concurrent readers never see a partial file.
+  Status Save();
+
+  size_t NumCachedEntries() const noexcept { return cached_.size(); }
+  size_t NumAddedEntries() const noexcept { return added_.size(); }
+  const std::filesystem::path& FilePath() const noexcept { return file_path_; }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackCache);
+
+ private:
+  PrepackCache(const Env& env, std::filesystem::path file_path, uint64_t model_hash)
+      : env_(env), file_path_(std::move(file_path)), model_hash_(model_hash) {}
+
+  // Maps the cache file and builds cached_ from its index. Leaves the cache empty if the file is not valid.
+  Status Load();
+
+  const Env& env_;
+  const std::filesystem::path file_path_;
+  const uint64_t model_hash_;
+
+  Env::MappedMemoryPtr mapped_file_;
+  // entries of the mapped file, with non-owning buffers
+  std::unordered_map<std::string, PrePackedWeights> cached_;
+  // entries to write, with non-owning buffers
+  std::unordered_map<std::string, PrePackedWeights> added_;
+};
+
+}  // namespace onnxruntime
@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <optional>
+
 #include "core/graph/basic_types.h"
 #include "core/common/inlined_containers.h"
 #include "core/framework/alloc_kind.h"
 #include "core/framework/data_types.h"
 #include "core/framework/execution_plan_base.h"
+#include "core/framework/tensor_shape.h"
 #include "core/graph/graph.h"
 
 namespace onnxruntime {
@@ -46,6 +49,16 @@ struct AllocPlanPerValue {
   // if alloc_kind is kAllocate, it will only allocate required buffer size (like ConstantOfShape).
   bool is_strided_tensor{false};
 #endif
+  // buffer_slice is set if alloc_kind is kReuse and this OrtValue only occupies part of the reused buffer,
+  // like an input of Concat that is produced directly into the Concat output, or an output of Split that is a
+  // view of the Split input.
+  struct BufferSlice {
+    // offset in bytes of this OrtValue in the reused buffer.
+    size_t offset{0};
+    // static shape of the reused buffer, used to allocate it if the slice is produced first.
+    TensorShape buffer_shape;
+  };
+  std::optional<BufferSlice> buffer_slice;
 
   class ProgramCounter {
    public:
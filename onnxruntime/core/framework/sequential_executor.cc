@@ -10,7 +10,9 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/dataflow_execution_plan.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/kernel_stats.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -285,7 +287,8 @@ class KernelScope {
       : session_scope_(session_scope),
         session_state_(session_scope_.session_state_),
         kernel_context_(kernel_context),
-        kernel_(kernel)
+        kernel_(kernel),
+        kernel_stats_(session_state_.GetKernelStats())
 #ifdef CONCURRENCY_VISUALIZER
         ,
         span_(session_scope_.series_, "%s.%d", kernel_.Node().OpType().c_str(), kernel_.Node().Index())
@@ -351,11 +354,30 @@ class KernelScope {
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
     }
+
+    if (kernel_stats_ != nullptr) {
+      kernel_stats_begin_time_ = std::chrono::steady_clock::now();
+    }
   }
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
 
   ~KernelScope() {
+    if (kernel_stats_ != nullptr) {
+      const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - kernel_stats_begin_time_);
+      uint64_t output_bytes = 0;
+      for (int i = 0, end = kernel_context_.OutputCount(); i < end; i++) {
+        const OrtValue* p_output = kernel_context_.GetOutputMLValue(i);
+        if (p_output != nullptr && p_output->IsTensor() && p_output->IsAllocated()) {
+          output_bytes += p_output->Get<Tensor>().SizeInBytes();
+        }
+      }
+      kernel_stats_->Record(session_state_.GetKernelStatsFirstSlot() + kernel_.Node().Index(),
+                            static_cast<uint64_t>(latency.count()),
+                            output_bytes);
+    }
+
 #ifdef ENABLE_NVTX_PROFILE
     node_compute_range_.End();
 #endif
@@ -409,6 +431,9 @@ class KernelScope {
   OpKernelContextInternal& kernel_context_;
   const OpKernel& kernel_;
 
+  KernelStats* const kernel_stats_;
+  std::chrono::steady_clock::time_point kernel_stats_begin_time_;
+
   size_t input_activation_sizes_{};
   size_t input_parameter_sizes_{};
   size_t total_output_sizes_{};
@@ -534,6 +559,15 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       valid_streams++;
   }
 
+  // in multi-threads mode, dispatch the kernels in dataflow order instead of running each stream as a task.
+  // the dataflow run starts as a single task on the current thread.
+  const bool use_dataflow_plan = !single_thread_mode && !only_execute_path_to_fetches &&
+                                 session_state.GetInterOpThreadPool() != nullptr;
+  const auto* dataflow_plan = use_dataflow_plan ? session_state.GetDataflowExecutionPlan() : nullptr;
+  if (dataflow_plan) {
+    valid_streams = 1;
+  }
+
   // prepare the execution context, notifications got initialized.
 #ifdef ORT_ENABLE_STREAM
   StreamExecutionContext ctx(session_state,
@@ -572,16 +606,20 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
-      });
+  if (dataflow_plan) {
+    RunDataflowPlan(*dataflow_plan, ctx, tp, session_scope, terminate_flag);
+  } else {
+    for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
     }
   }
 
@@ -600,7 +638,7 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
     if (all_tensors) {
       MemoryPatternGroup mem_patterns;
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternCache(feeds, std::move(mem_patterns)));
     }
   }
 
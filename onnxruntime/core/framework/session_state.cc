@@ -6,13 +6,17 @@
 #include <sstream>
 
 #include <mutex>
+#include <optional>
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/kernel_stats.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/prepack_cache.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/session_state_utils.h"
 #include "core/framework/utils.h"
@@ -90,6 +94,19 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+
+  size_t mem_pattern_cache_capacity = MemoryPatternCache::kDefaultCapacity;
+  const std::string mem_pattern_cache_capacity_str =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheCapacity, "");
+  if (!mem_pattern_cache_capacity_str.empty() &&
+      (!TryParseStringWithClassicLocale(mem_pattern_cache_capacity_str, mem_pattern_cache_capacity) ||
+       mem_pattern_cache_capacity == 0)) {
+    LOGS(logger_, WARNING) << "Invalid value for " << kOrtSessionOptionsConfigMemoryPatternCacheCapacity << ": '"
+                           << mem_pattern_cache_capacity_str << "'. Using the default of "
+                           << MemoryPatternCache::kDefaultCapacity << ".";
+    mem_pattern_cache_capacity = MemoryPatternCache::kDefaultCapacity;
+  }
+  mem_pattern_cache_.emplace(mem_pattern_cache_capacity);
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -218,7 +235,8 @@ const KernelCreateInfo& SessionState::GetNodeKernelCreateInfo(NodeIndex node_ind
   return *entry->second;
 }
 
-Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager) {
+Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager,
+                                   concurrency::ThreadPool* thread_pool) {
   const auto& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
     size_t max_nodeid = 0;
@@ -227,7 +245,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) -> Status {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -236,7 +255,39 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    // Constructing a CPU EP kernel only reads the node and the session state, so with a thread pool those kernels
+    // are created in parallel. Kernels of other EPs may use device state and are created on this thread.
+    const bool create_in_parallel = concurrency::ThreadPool::DegreeOfParallelism(thread_pool) > 1;
+    InlinedVector<const Node*> cpu_nodes;
+    for (const auto& node : nodes) {
+      if (create_in_parallel && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        cpu_nodes.push_back(&node);
+      } else {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
+    }
+
+    if (!cpu_nodes.empty()) {
+      std::vector<Status> statuses(cpu_nodes.size());
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          thread_pool, static_cast<std::ptrdiff_t>(cpu_nodes.size()), [&](std::ptrdiff_t i) {
+            ORT_TRY {
+              statuses[i] = create_kernel(*cpu_nodes[i]);
+            }
+            ORT_CATCH(const std::exception& ex) {
+              ORT_HANDLE_EXCEPTION([&]() {
+                statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create kernel for node ",
+                                              cpu_nodes[i]->Name(), ": ", ex.what());
+              });
+            }
+          });
+
+      for (const auto& status : statuses) {
+        ORT_RETURN_IF_ERROR(status);
+      }
     }
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
@@ -276,6 +327,22 @@ void SessionState::PruneRemovableAttributes() {
   }
 }
 
+void SessionState::SetKernelStats(KernelStats& kernel_stats, const std::string& name_prefix) {
+  kernel_stats_ = &kernel_stats;
+  kernel_stats_first_slot_ = kernel_stats.AddGraph(*graph_viewer_, name_prefix);
+
+  for (auto& node_to_map_pair : subgraph_session_states_) {
+    const Node* node = graph_viewer_->GetNode(node_to_map_pair.first);
+    const std::string node_name = node != nullptr && !node->Name().empty()
+                                      ? node->Name()
+                                      : MakeString("node_", node_to_map_pair.first);
+    for (auto& attr_name_to_session_state : node_to_map_pair.second) {
+      attr_name_to_session_state.second->SetKernelStats(
+          kernel_stats, MakeString(name_prefix, node_name, "/", attr_name_to_session_state.first, "/"));
+    }
+  }
+}
+
 const SequentialExecutionPlan* SessionState::GetExecutionPlan() const {
   if (!p_seq_exec_plan_.has_value()) {
     return nullptr;
@@ -393,6 +460,50 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+static Status KernelUseCachedPrePackedBuffers(OpKernel& kernel, const Tensor& tensor, int input_idx,
+                                              const PrePackedWeights& prepacked_weights,
+                                              /*out*/ bool& used_cached_buffers) {
+  std::vector<BufferUniquePtr> cached_prepacked_buffers;
+  cached_prepacked_buffers.reserve(prepacked_weights.buffers_.size());
+
+  for (const auto& prepacked_buffer : prepacked_weights.buffers_) {
+    // the buffers are owned by the pre-packed weights cache or by the graph
+    cached_prepacked_buffers.emplace_back(prepacked_buffer.get(), BufferDeleter(nullptr));
+  }
+
+  return kernel.UseCachedPrePackedBuffers(tensor, input_idx, cached_prepacked_buffers,
+                                          prepacked_weights.buffer_sizes_, used_cached_buffers);
+}
+
+namespace {
+// Outcome of pre-packing a constant initializer input of a kernel.
+struct PrePackResult {
+  bool is_packed = false;
+  // the kernel restored its pre-packed state from the persistent cache instead of calling PrePack()
+  bool used_prepack_cache = false;
+  PrePackedWeights weights;
+};
+}  // namespace
+
+// Restores the pre-packed state of the kernel input from prepack_cache if it has an entry the kernel accepts and
+// calls PrePack() otherwise.
+static Status PrePackKernelInput(OpKernel& kernel, const Node& node, int input_idx, const Tensor& tensor,
+                                 const AllocatorPtr& alloc, const PrepackCache* prepack_cache,
+                                 PrePackResult& result) {
+  if (prepack_cache != nullptr) {
+    if (const auto* cached_weights = prepack_cache->Find(PrepackCache::MakeKey(node, input_idx))) {
+      ORT_RETURN_IF_ERROR(KernelUseCachedPrePackedBuffers(kernel, tensor, input_idx, *cached_weights,
+                                                          result.used_prepack_cache));
+      if (result.used_prepack_cache) {
+        result.is_packed = true;
+        return Status::OK();
+      }
+    }
+  }
+
+  return kernel.PrePack(tensor, input_idx, alloc, result.is_packed, &result.weights);
+}
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -405,8 +516,79 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(
     InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
-    const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+    const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map,
+    concurrency::ThreadPool* thread_pool) {
+  size_t prepack_cache_hits = 0;
+
+  // PrePack() only reads the constant initializer and updates the state of its own kernel. When a thread pool is
+  // provided, the kernels of nodes assigned to the CPU EP pre-pack their inputs in parallel ahead of the loop below,
+  // which consumes the results in node order. Inputs that come from an outer scope are pre-packed by the loop.
+  // Indexed by node index and input index.
+  std::vector<std::vector<std::optional<PrePackResult>>> precomputed_prepacks;
+  auto prepack_in_parallel = [this, &initializers_to_share_map, thread_pool, &precomputed_prepacks](
+                                 bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
+    InlinedVector<const Node*> cpu_nodes;
+    for (const auto& node : GetGraphViewer().Nodes()) {
+      if (node.GetExecutionProviderType() == kCpuExecutionProvider && GetKernel(node.Index()) != nullptr) {
+        cpu_nodes.push_back(&node);
+      }
+    }
+
+    AllocatorPtr allocator_for_caching;
+    if (should_cache_prepacked_weights_for_shared_initializers) {
+      allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+      ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+    }
+
+    precomputed_prepacks.resize(session_kernels_.size());
+    std::vector<Status> statuses(cpu_nodes.size());
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(cpu_nodes.size()), [&](std::ptrdiff_t i) {
+          const Node& node = *cpu_nodes[i];
+          OpKernel& kernel = *GetMutableKernel(node.Index());
+          auto& results = precomputed_prepacks[node.Index()];
+          results.resize(node.InputDefs().size());
+
+          ORT_TRY {
+            int input_idx = 0;
+            for (const auto* input_def : node.InputDefs()) {
+              int ort_value_idx;
+              if (input_def->Exists() && GetOrtValueNameIdxMap().GetIdx(input_def->Name(), ort_value_idx).IsOK()) {
+                auto tensor_it = constant_initialized_tensors_.find(ort_value_idx);
+                if (tensor_it != constant_initialized_tensors_.end()) {
+                  // same choice of allocator and cache as the loop below
+                  const bool use_container = allocator_for_caching != nullptr &&
+                                             initializers_to_share_map.count(input_def->Name()) != 0;
+                  const AllocatorPtr alloc =
+                      use_container ? allocator_for_caching
+                                    : GetAllocator(kernel.Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                  statuses[i] = PrePackKernelInput(kernel, node, input_idx, tensor_it->second.Get<Tensor>(), alloc,
+                                                   use_container ? nullptr : prepack_cache_.get(),
+                                                   results[input_idx].emplace());
+                  if (!statuses[i].IsOK()) {
+                    return;
+                  }
+                }
+              }
+              input_idx++;
+            }
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PrePack failed for node ", node.Name(), ": ",
+                                            ex.what());
+            });
+          }
+        });
+
+    for (const auto& status : statuses) {
+      ORT_RETURN_IF_ERROR(status);
+    }
+    return Status::OK();
+  };
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     &prepack_cache_hits, &precomputed_prepacks](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -427,6 +609,19 @@ Status SessionState::PrepackConstantInitializedTensors(
                 bool is_packed = false;
                 const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
 
+                auto prepack = [&](const AllocatorPtr& alloc, const PrepackCache* prepack_cache,
+                                   PrePackResult& result) -> Status {
+                  if (st == this && node.Index() < precomputed_prepacks.size()) {
+                    auto& results = precomputed_prepacks[node.Index()];
+                    if (static_cast<size_t>(input_idx) < results.size() && results[input_idx].has_value()) {
+                      result = std::move(*results[input_idx]);
+                      return Status::OK();
+                    }
+                  }
+                  return PrePackKernelInput(*kernel, node, input_idx, const_initialized_tensor, alloc, prepack_cache,
+                                            result);
+                };
+
                 auto iter = initializers_to_share_map.find(input_name);
                 bool is_shared_initializer = (iter != initializers_to_share_map.end());
 
@@ -438,16 +633,16 @@ Status SessionState::PrepackConstantInitializedTensors(
                   AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
                   ORT_ENFORCE(allocator_for_caching.get() != nullptr);
 
-                  PrePackedWeights weights_to_be_filled_in;
+                  PrePackResult prepack_result;
                   // The reason we invoke PrePack() before looking into the container for any pre-packed weight
                   // cached by another instance of the same op_type (for the same constant initializer) is because
                   // to truly know if we can use a cached pre-packed weight, we would have to compare the cached
                   // pre-packed  weight with the pre-packed weight generated by this instance of the same op_type
                   // because other static properties of the node like node attributes could play a role in the
                   // pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
+                  ORT_RETURN_IF_ERROR(prepack(allocator_for_caching, nullptr, prepack_result));
+                  is_packed = prepack_result.is_packed;
+                  PrePackedWeights weights_to_be_filled_in = std::move(prepack_result.weights);
 
                   if (is_packed) {
                     // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight
@@ -535,17 +730,24 @@ Status SessionState::PrepackConstantInitializedTensors(
                   // within this session. Or if the weight is not present on disk,
                   // we store the newly minted pre-packed data.
 
+                  // The persistent cache is keyed by node and input rather than by content, as the model hash
+                  // already covers everything that PrePack() depends on. A hit skips PrePack() altogether.
+                  PrepackCache* prepack_cache = st == this ? prepack_cache_.get() : nullptr;
+
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
-                  PrePackedWeights weights_to_be_filled_in;
+                  PrePackResult prepack_result;
                   // The reason we invoke PrePack() before looking into the container for any pre-packed weight
                   // cached by another instance of the same op_type (for the same constant initializer) is because
                   // to truly know if we can use a cached pre-packed weight, we would have to compare the cached
                   // pre-packed weight with the pre-packed weight generated by this instance of the same op_type because
                   // other static properties of the node like node attributes could play a role in the pre-packed
                   // weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, session_cpu_alloc,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
+                  ORT_RETURN_IF_ERROR(prepack(session_cpu_alloc, prepack_cache, prepack_result));
+                  is_packed = prepack_result.is_packed;
+                  PrePackedWeights weights_to_be_filled_in = std::move(prepack_result.weights);
+                  if (prepack_result.used_prepack_cache) {
+                    ++prepack_cache_hits;
+                  }
 
                   // Some kernels (matmul_nbits and non-CPU related kernels) do not share their pre-packed results
                   // even though they set is_packed = true so we leave it up to them.
@@ -570,9 +772,22 @@ Status SessionState::PrepackConstantInitializedTensors(
                       assert(weights_to_use != nullptr);
                     }
 
-                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                        *weights_to_use,
-                                                                        node.Name()));
+                    // Only persist the weights of kernels that are able to restore their state from them
+                    bool used_cached_buffers = false;
+                    if (prepack_cache != nullptr) {
+                      ORT_RETURN_IF_ERROR(KernelUseCachedPrePackedBuffers(*kernel, const_initialized_tensor,
+                                                                          input_idx, *weights_to_use,
+                                                                          used_cached_buffers));
+                      if (used_cached_buffers) {
+                        prepack_cache->Add(PrepackCache::MakeKey(node, input_idx), *weights_to_use);
+                      }
+                    }
+
+                    if (!used_cached_buffers) {
+                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                          *weights_to_use,
+                                                                          node.Name()));
+                    }
                   }
                 }
 
@@ -610,19 +825,29 @@ Status SessionState::PrepackConstantInitializedTensors(
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
     std::lock_guard<std::mutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
+    if (concurrency::ThreadPool::DegreeOfParallelism(thread_pool) > 1) {
+      ORT_RETURN_IF_ERROR(prepack_in_parallel(true));
+    }
+    ORT_RETURN_IF_ERROR(prepacked_constant_weights(true));
   } else {
-    return prepacked_constant_weights(false);
+    if (concurrency::ThreadPool::DegreeOfParallelism(thread_pool) > 1) {
+      ORT_RETURN_IF_ERROR(prepack_in_parallel(false));
+    }
+    ORT_RETURN_IF_ERROR(prepacked_constant_weights(false));
   }
-}
 
-static int64_t
-CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+  if (prepack_cache_ != nullptr) {
+    LOGS(logger_, INFO) << "Pre-packed weights cache " << prepack_cache_->FilePath() << ": " << prepack_cache_hits
+                        << " hits, " << prepack_cache_->NumAddedEntries() << " new entries";
+
+    // failing to write the cache only costs the next session the pre-packing time
+    auto status = prepack_cache_->Save();
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to save the pre-packed weights cache: " << status.ErrorMessage();
+    }
   }
-  return key;
+
+  return Status::OK();
 }
 
 #ifdef ENABLE_TRAINING
@@ -793,6 +1018,7 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
   }
   // TODO: add check for single stream
   // Allocate all other activations.
+  InlinedHashSet<int> planned_values;
   for (auto& step_index : execution_order) {
     int node_index = node_index_info.GetNodeOffset(step_index);
     auto* node = graph_viewer_->GetNode(step_index);
@@ -800,12 +1026,22 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
                        static_cast<int>(node->ImplicitInputDefs().size());
     // allocate output
     for (int i = 0, end = static_cast<int>(node->OutputDefs().size()); i < end; ++i) {
-      const auto ml_value_idx = node_index_info.GetMLValueIndex(output_start + i);
+      auto ml_value_idx = node_index_info.GetMLValueIndex(output_start + i);
       if (ml_value_idx == NodeIndexInfo::kInvalidEntry ||
           (std::find(exe_plan->activation_allocation_order.begin(),
                      exe_plan->activation_allocation_order.end(), ml_value_idx) !=
            exe_plan->activation_allocation_order.end()))
         continue;
+
+      // a slice of a buffer can be produced before the value that owns the buffer (like the inputs of Concat),
+      // in which case the buffer is allocated with the first slice.
+      const auto& value_plan = exe_plan->allocation_plan[ml_value_idx];
+      if (value_plan.alloc_kind == AllocKind::kReuse && value_plan.buffer_slice.has_value()) {
+        ml_value_idx = value_plan.reused_buffer;
+      }
+      if (!planned_values.insert(ml_value_idx).second)
+        continue;
+
       const auto* ml_type = exe_plan->allocation_plan[ml_value_idx].value_type;
       if (!ml_type->IsTensorType())
         continue;
@@ -859,38 +1095,25 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
-    gsl::span<const OrtValue> tensor_inputs,
-    gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
-  out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<std::mutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-#ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
-    }
-#else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
-#endif
-    return nullptr;
+std::shared_ptr<const CachedMemoryPattern> SessionState::GetCachedMemoryPattern(
+    gsl::span<const OrtValue> tensor_inputs, gsl::span<const int> feed_mlvalue_idxs) const {
+  const auto key = MemoryPatternCache::MakeKey(tensor_inputs);
+  auto pattern = mem_pattern_cache_->Find(key);
+  if (pattern) {
+    return pattern;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+#ifdef ENABLE_TRAINING
+  auto generated_pattern = std::make_shared<CachedMemoryPattern>();
+  if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, generated_pattern->mem_patterns,
+                                generated_pattern->inferred_shapes)
+          .IsOK()) {
+    return mem_pattern_cache_->Insert(key, std::move(generated_pattern));
   }
-  return &it->second;
+#else
+  ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
+#endif
+  return nullptr;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -939,13 +1162,13 @@ void SessionState::ResolveMemoryPatternFlag() {
   }
 }
 
-Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
-                                                   MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+Status SessionState::UpdateMemoryPatternCache(gsl::span<const OrtValue> tensor_inputs,
+                                              MemoryPatternGroup mem_patterns) const {
+  auto pattern = std::make_shared<CachedMemoryPattern>();
+  pattern->mem_patterns = std::move(mem_patterns);
 
-  std::lock_guard<std::mutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  // Do not update if present, as the existing pattern may be in use by a concurrent Run
+  mem_pattern_cache_->Insert(MemoryPatternCache::MakeKey(tensor_inputs), std::move(pattern));
   return Status::OK();
 }
 
@@ -1541,6 +1764,30 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   // For inference it is enabled by default, but users can choose to disable it via session options.
   const bool disable_prepacking =
       session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0") == "1";
+
+  // The intra-op thread pool is idle during initialization and can be used to speed up its independent parts.
+  concurrency::ThreadPool* const initialization_thread_pool =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsParallelInitialization, "0") == "1"
+          ? thread_pool_
+          : nullptr;
+
+  // The persistent pre-packed weights cache covers the main graph. Its key hashes the initializers, so it has to be
+  // computed while they are still in the graph.
+  const std::string prepack_cache_dir =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsPrePackCacheDir, "");
+  if (!prepack_cache_dir.empty() && !disable_prepacking && !save_prepacked_initializers && parent_node == nullptr) {
+    const uint64_t model_hash = PrepackCache::ComputeModelHash(*graph_viewer_, graph_location,
+                                                               session_options.config_options);
+    auto status = PrepackCache::Open(Env::Default(), ToPathString(prepack_cache_dir), model_hash, prepack_cache_);
+    if (status.IsOK()) {
+      LOGS(logger_, INFO) << "Opened pre-packed weights cache " << prepack_cache_->FilePath() << " with "
+                          << prepack_cache_->NumCachedEntries() << " entries";
+    } else {
+      LOGS(logger_, WARNING) << "Pre-packed weights cache is disabled: " << status.ErrorMessage();
+      prepack_cache_.reset();
+    }
+  }
+
   // Memory pattern tracer allocates all initializers on a single contiguous
   // buffer. This has the effect of reducing memory fragmentation.
   // Further more, in training scenarios NCCL kernels require initializers to be allocated
@@ -1594,6 +1841,26 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  // subgraphs always run on the thread that executes their parent node
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL && parent_node == nullptr &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDataflowExecution, "0") == "1") {
+#ifdef ORT_ENABLE_STREAM
+    const bool use_dataflow_plan = !has_device_stream_enabled_ep_;
+#else
+    const bool use_dataflow_plan = true;
+#endif
+    if (use_dataflow_plan) {
+      dataflow_plan_ = DataflowExecutionPlan::Create(*graph_viewer_, session_options.execution_order,
+                                                     *p_seq_exec_plan_);
+    }
+  }
+
+  TimePoint save_initializers_tp;
+  if (profiler_.IsEnabled()) {
+    save_initializers_tp = profiler_.Start();
+  }
+
+  session_state_utils::ExternalInitializerLoadStats external_initializer_load_stats;
   ORT_RETURN_IF_ERROR(session_state_utils::SaveInitializedTensors(
       Env::Default(), graph_location, *graph_viewer_,
       GetAllocator(OrtDevice()),
@@ -1607,7 +1874,17 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
         return Status::OK();
       },
       logger_, data_transfer_mgr_, external_data_loader_mgr_, *p_seq_exec_plan_, session_options,
-      memory_profile_func, name_to_buffered_tensor_, graph_.GetPrepacked()));
+      memory_profile_func, name_to_buffered_tensor_, graph_.GetPrepacked(), &external_initializer_load_stats,
+      initialization_thread_pool));
+
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "initializers_load", save_initializers_tp,
+        {{"external_mapped_count", std::to_string(external_initializer_load_stats.num_mapped)},
+         {"external_mapped_bytes", std::to_string(external_initializer_load_stats.mapped_bytes)},
+         {"external_copied_count", std::to_string(external_initializer_load_stats.num_copied)},
+         {"external_copied_bytes", std::to_string(external_initializer_load_stats.copied_bytes)}});
+  }
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1621,11 +1898,31 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
-  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
+  TimePoint create_kernels_tp;
+  if (profiler_.IsEnabled()) {
+    create_kernels_tp = profiler_.Start();
+  }
+
+  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager, initialization_thread_pool));
+
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "kernels_creation", create_kernels_tp);
+  }
 
   if (!disable_prepacking) {
+    TimePoint prepack_tp;
+    if (profiler_.IsEnabled()) {
+      prepack_tp = profiler_.Start();
+    }
+
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
-                                                          session_options.initializers_to_share_map));
+                                                          session_options.initializers_to_share_map,
+                                                          initialization_thread_pool));
+
+    if (profiler_.IsEnabled()) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "prepacking", prepack_tp,
+                                      {{"num_prepacks", std::to_string(number_of_prepacks_counter_)}});
+    }
   }
 
   ORT_RETURN_IF_ERROR(
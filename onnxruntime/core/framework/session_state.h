@@ -20,15 +20,18 @@
 #include "core/framework/allocation_planner.h"
 #include "core/framework/callback.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/dataflow_execution_plan.h"
 #include "core/framework/external_data_loader_manager.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
+#include "core/framework/prepack_cache.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/memory_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -60,6 +63,7 @@ class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 class DeviceStreamCollection;
+class KernelStats;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
 #endif
@@ -217,26 +221,44 @@ class SessionState {
 #endif
 
   /**
-  Get cached memory pattern based on input shapes
-  Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  Get the statistics the kernels of this session state record into. nullptr if they are not collected.
+  The slot of a node in the statistics is GetKernelStatsFirstSlot() plus the index of the node.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
-      gsl::span<const OrtValue> tensor_inputs,
-      gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+  KernelStats* GetKernelStats() const noexcept { return kernel_stats_; }
+  size_t GetKernelStatsFirstSlot() const noexcept { return kernel_stats_first_slot_; }
+
+  /**
+  Collect the statistics of the kernels of this session state and of its subgraph session states in kernel_stats.
+  Must be called before the session runs. name_prefix is prepended to the names of the nodes in the statistics.
+  */
+  void SetKernelStats(KernelStats& kernel_stats, const std::string& name_prefix = "");
 
   /**
-  Set generated memory pattern with a given input shapes.
+  Get the cached memory pattern for the shapes of the given inputs.
+  Must be called only when all values contain tensors.
+  Returns nullptr if no pattern has been generated for these shapes yet. In training builds a pattern, and the
+  tensor shapes it was computed from, is generated from the symbolic dimensions in the graph on the first request
+  for a set of shapes.
+  The returned pattern stays valid for as long as the caller holds on to it, even if it is evicted from the cache.
+  */
+  std::shared_ptr<const CachedMemoryPattern> GetCachedMemoryPattern(gsl::span<const OrtValue> tensor_inputs,
+                                                                    gsl::span<const int> feed_mlvalue_idxs) const;
+
+  /**
+  Set the memory pattern traced from a run with the given input shapes.
   Const as it's an internal cache update only.
   All inputs must represent Tensors
   */
-  Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
-                                       MemoryPatternGroup mem_patterns) const;
+  Status UpdateMemoryPatternCache(gsl::span<const OrtValue> tensor_inputs, MemoryPatternGroup mem_patterns) const;
+
+  const MemoryPatternCache& GetMemoryPatternCache() const noexcept { return *mem_pattern_cache_; }
+
+  /**
+  Get the plan to run the kernels in dataflow order in the parallel execution mode.
+  nullptr if the session doesn't use the parallel execution mode, the dataflow scheduling is disabled or an
+  execution provider uses device streams.
+  */
+  const DataflowExecutionPlan* GetDataflowExecutionPlan() const noexcept { return dataflow_plan_.get(); }
 
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
@@ -382,7 +404,9 @@ class SessionState {
   void CreateGraphInfo(bool save_prepacked_on);
 
   // create kernels using info in kernel_create_info_map_
-  Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
+  // CPU EP kernels are created in parallel on thread_pool if it is not null.
+  Status CreateKernels(const KernelRegistryManager& custom_registry_manager,
+                       concurrency::ThreadPool* thread_pool = nullptr);
 
   // remove TensorProto versions of initializers from Graph instance
   // (replaced byOrtValue instances in initialized_tensors_)
@@ -391,9 +415,11 @@ class SessionState {
   /**
    * Prepack the constant initialized tensors for better performance.
    * The original constant initialized tensors will be removed to save memory.
+   * If thread_pool is not null, CPU EP kernels pre-pack in parallel on it.
    */
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
-                                           const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
+                                           const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map,
+                                           concurrency::ThreadPool* thread_pool = nullptr);
 
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
@@ -429,6 +455,10 @@ class SessionState {
   // fused_funcs_mgr_ must live longer than the session_kernels_, becaues a kernel could be created from this manager
   FuncManager fused_funcs_mgr_;
 
+  // Persistent cache of pre-packed weights. Only set for the main graph when a cache directory is configured.
+  // Kernels may point into its mapped file so it must live longer than the session_kernels_.
+  std::unique_ptr<PrepackCache> prepack_cache_;
+
   // cache of the constructed kernels to avoid spending construction time per executor
   std::vector<std::unique_ptr<OpKernel>> session_kernels_;
   Graph& graph_;
@@ -494,6 +524,7 @@ class SessionState {
   InlinedHashMap<int, OrtCallback> deleter_for_initialized_tensors_;
   InlinedVector<BufferUniquePtr> weights_buffers_;
   std::optional<SequentialExecutionPlan> p_seq_exec_plan_;
+  std::unique_ptr<DataflowExecutionPlan> dataflow_plan_;
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
@@ -502,21 +533,15 @@ class SessionState {
   MemoryProfiler* memory_profiler_;
 #endif
 
+  KernelStats* kernel_stats_ = nullptr;
+  size_t kernel_stats_first_slot_ = 0;
+
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable std::mutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // LRU cache of the memory patterns generated per combination of input shapes.
+  // Capacity is set from kOrtSessionOptionsConfigMemoryPatternCacheCapacity in the constructor.
+  std::optional<MemoryPatternCache> mem_pattern_cache_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -28,6 +28,7 @@
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 #include "core/framework/memory_info.h"
 #endif
@@ -73,6 +74,7 @@ static common::Status ExtDataTensorProtoToTensor(const Env& env,
                                                  const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                                  Tensor& tensor, OrtCallback& ext_data_deleter,
                                                  PrepackedWeightsForGraph& prepacked_for_graph,
+                                                 utils::ExternalDataSource& ext_data_source,
                                                  Tensor* buffered_tensor = nullptr) {
   ORT_ENFORCE(utils::HasExternalData(tensor_proto));
 
@@ -80,7 +82,7 @@ static common::Status ExtDataTensorProtoToTensor(const Env& env,
   SafeInt<size_t> ext_data_len = 0;
   ORT_RETURN_IF_ERROR(utils::GetExtDataFromTensorProto(env, proto_path.c_str(), tensor_proto,
                                                        ext_data_buf, ext_data_len, ext_data_deleter,
-                                                       buffered_tensor, &prepacked_for_graph));
+                                                       buffered_tensor, &prepacked_for_graph, &ext_data_source));
 
   // NB: creating a do-nothing allocator per tensor is wasteful; can perhaps be
   // avoided if the Tensor class implements the do-nothing behavior when given a
@@ -92,6 +94,31 @@ static common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+// Returns true if the initializer wraps its external data in place on CPU rather than having a buffer allocated for
+// it. That is the case for data that is already in memory, and for data in a file if memory mapping is enabled.
+static bool UsesExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtDevice& location,
+                                    bool use_mmap_for_external_data) {
+  return utils::HasExternalData(tensor_proto) && location.Type() == OrtDevice::CPU &&
+         (use_mmap_for_external_data || utils::HasExternalDataInMemory(tensor_proto));
+}
+
+static void UpdateExternalInitializerLoadStats(utils::ExternalDataSource ext_data_source, size_t num_bytes,
+                                               ExternalInitializerLoadStats& stats) {
+  switch (ext_data_source) {
+    case utils::ExternalDataSource::kMappedFile:
+      ++stats.num_mapped;
+      stats.mapped_bytes += num_bytes;
+      break;
+    case utils::ExternalDataSource::kCopiedFile:
+      ++stats.num_copied;
+      stats.copied_bytes += num_bytes;
+      break;
+    default:
+      // data supplied in memory is neither mapped nor copied by us
+      break;
+  }
+}
+
 // If tensor_proto's external file path is kTensorProtoMemoryAddressTag, and
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
@@ -102,6 +129,8 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
                                              const ExternalDataLoaderManager& external_data_loader_mgr,
                                              PrepackedWeightsForGraph& prepacked_for_graph,
+                                             bool use_mmap_for_external_data,
+                                             ExternalInitializerLoadStats& external_initializer_load_stats,
                                              bool use_device_allocator_for_initializers = false,
                                              Tensor* buffered_tensor = nullptr) {
   if (bool(alloc) == (m != nullptr)) {
@@ -120,7 +149,12 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   auto& memory_info = (alloc != nullptr) ? alloc->Info() : m->GetAllocInfo();
   auto device_type = memory_info.device.Type();
 
-  if (utils::HasExternalData(tensor_proto)) {
+  // external data in a file that is not mapped is copied into the initializer buffer, the same way as internal data
+  const bool copy_external_data_on_cpu = utils::HasExternalData(tensor_proto) && device_type == OrtDevice::CPU &&
+                                         !UsesExternalDataInPlace(tensor_proto, memory_info.device,
+                                                                  use_mmap_for_external_data);
+
+  if (utils::HasExternalData(tensor_proto) && !copy_external_data_on_cpu) {
     auto external_data_loader = external_data_loader_mgr.GetExternalDataLoader(memory_info);
     if (external_data_loader) {
       // if custom external data loader is used, always allocate memory on device - p_tensor
@@ -128,6 +162,8 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 
       ORT_RETURN_IF_ERROR(utils::LoadExtDataToTensorFromTensorProto(env, proto_path, tensor_proto,
                                                                     *external_data_loader, *p_tensor));
+      UpdateExternalInitializerLoadStats(utils::ExternalDataSource::kCopiedFile, p_tensor->SizeInBytes(),
+                                         external_initializer_load_stats);
 
       Tensor::InitOrtValue(std::move(*p_tensor), ort_value);
       return common::Status::OK();
@@ -139,9 +175,11 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       // utilize the mmap'd buffer directly by calling ExtDataTensorProtoToTensor. If we called
       // TensorProtoToTensor it would copy the data, causing unnecessary overhead
       OrtCallback ext_data_deleter;
+      utils::ExternalDataSource ext_data_source;
       ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_tensor,
                                                      ext_data_deleter, prepacked_for_graph,
-                                                     buffered_tensor));
+                                                     ext_data_source, buffered_tensor));
+      UpdateExternalInitializerLoadStats(ext_data_source, p_tensor->SizeInBytes(), external_initializer_load_stats);
 
       ExtDataValueDeleter deleter{ext_data_deleter, p_tensor.get()};
       MLDataType ml_tensor_type = DataTypeImpl::GetType<Tensor>();
@@ -164,10 +202,14 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 
       OrtCallback ext_data_deleter;
       std::optional<ScopedOrtCallbackInvoker> scoped_ort_callback_invoker;
+      utils::ExternalDataSource ext_data_source;
       ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_deserialize_tensor,
                                                      ext_data_deleter, prepacked_for_graph,
-                                                     buffered_tensor));
+                                                     ext_data_source, buffered_tensor));
       scoped_ort_callback_invoker.emplace(ext_data_deleter);
+      // the data ends up in a device buffer whether or not the file was mapped to stage it
+      UpdateExternalInitializerLoadStats(utils::ExternalDataSource::kCopiedFile, p_deserialize_tensor->SizeInBytes(),
+                                         external_initializer_load_stats);
       // TODO!! Need a temp buffer allocator for non-escape buffers that maybe too big for stack allocation.
 
       return CopyTensorFromCPUToDevice(data_transfer_mgr, p_deserialize_tensor, p_tensor, ort_value);
@@ -179,6 +221,10 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
     if (device_type == OrtDevice::CPU) {
       // deserialize directly to CPU tensor
       ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_tensor));
+      if (copy_external_data_on_cpu) {
+        UpdateExternalInitializerLoadStats(utils::ExternalDataSource::kCopiedFile, p_tensor->SizeInBytes(),
+                                           external_initializer_load_stats);
+      }
       auto ml_tensor = DataTypeImpl::GetType<Tensor>();
       ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
       return common::Status::OK();
@@ -276,10 +322,16 @@ common::Status SaveInitializedTensors(
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
     std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
-    PrepackedWeightsForGraph& prepacked_for_graph) {
+    PrepackedWeightsForGraph& prepacked_for_graph,
+    ExternalInitializerLoadStats* external_initializer_load_stats,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
+  const bool use_mmap_for_external_data =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMmapExternalInitializers, "1") == "1";
+  ExternalInitializerLoadStats load_stats;
+
   // Determine if an intializer was supplied by the user for the purpose of sharing and if it requires a cross-device
   // copy. In case a cross-device copy is required, sharing cannot be accomplished since we allocate our own buffer
   // for the destination device which cannot be shared between sessions.
@@ -335,7 +387,8 @@ common::Status SaveInitializedTensors(
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
     ORT_ENFORCE(entry != initialized_tensors_to_allocate.end(),
                 "OrtValue index: ", ort_value_index, " from initializer_allocation_order not found among initialized tensors");
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU)) {
+    if (!UsesExternalDataInPlace(*entry->second, exec_plan.GetLocation(ort_value_index),
+                                 use_mmap_for_external_data)) {
       // can not trace string tensor
       ORT_ENFORCE(entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING, "Can not trace string tensor");
       ORT_RETURN_IF_ERROR(planner.Trace(entry->first, entry->second));
@@ -352,6 +405,10 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    if (UsesExternalDataInPlace(*entry.second, exec_plan.GetLocation(entry.first), use_mmap_for_external_data)) {
+      // a planned buffer would be reserved but never used
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -371,6 +428,47 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
+  auto save_initialized_tensor = [&](int ort_value_index, const std::string& name, const OrtValue& ort_value) {
+    // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
+    // so we need to output this message prior to calling save_tensor_func
+    VLOGS(logger, 1) << "Adding weight with name : " << name << " with index: " << ort_value_index;
+
+    // any outer scope value is shadowed by a local value and can't override it.
+    // due to that check_outer_scope is false
+    const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
+#if !defined(DISABLE_SPARSE_TENSORS)
+    const bool sparse = graph.GetGraph().IsSparseInitializer(name);
+    return save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse);
+#else
+    return save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false);
+#endif
+  };
+
+  auto deserialize_failed = [](const std::string& name, const Status& st) {
+    std::ostringstream oss;
+    oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
+    return Status(st.Category(), st.Code(), oss.str());
+  };
+
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+
+  // Deserializing an initializer into a CPU buffer only reads its TensorProto and writes its own buffer, so when a
+  // thread pool is provided these are deferred and run in parallel after the loop below. Initializers that wrap
+  // external data in place are cheap and update prepacked_for_graph, and the others need a data transfer, so they
+  // stay on this thread.
+  struct DeferredInitializer {
+    int ort_value_index = -1;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    std::optional<MemBuffer> m;
+    AllocatorPtr alloc;
+    OrtValue ort_value;
+    ExternalInitializerLoadStats load_stats;
+    Status status;
+  };
+  std::vector<DeferredInitializer> deferred_initializers;
+  const bool defer_cpu_initializers = concurrency::ThreadPool::DegreeOfParallelism(thread_pool) > 1;
+
   // 3. create weight tensors based on weights buffer
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
@@ -393,8 +491,6 @@ common::Status SaveInitializedTensors(
       AllocatorPtr alloc;
       // TODO: if the tensor need be copied, does it have enough room?
       ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
       Tensor* p_tensor = nullptr;
       if (auto iter = buffered_tensors.find(name);
@@ -403,30 +499,68 @@ common::Status SaveInitializedTensors(
         buffered_tensors.erase(iter);
       }
 
+      if (defer_cpu_initializers && p_tensor == nullptr) {
+        const OrtDevice& device = m.has_value() ? m->GetAllocInfo().device : alloc->Info().device;
+        if (device.Type() == OrtDevice::CPU &&
+            !UsesExternalDataInPlace(tensor_proto, device, use_mmap_for_external_data)) {
+          auto& deferred = deferred_initializers.emplace_back();
+          deferred.ort_value_index = ort_value_index;
+          deferred.tensor_proto = &tensor_proto;
+          deferred.m = std::move(m);
+          deferred.alloc = std::move(alloc);
+          continue;
+        }
+      }
+
       Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
                                          default_cpu_alloc, ort_value, data_transfer_mgr, external_data_loader_mgr,
-                                         prepacked_for_graph,
+                                         prepacked_for_graph, use_mmap_for_external_data, load_stats,
                                          use_device_allocator_for_initializers, p_tensor);
       if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
+        return deserialize_failed(name, st);
       }
     }
 
-    // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
-    // so we need to output this message prior to calling save_tensor_func
-    VLOGS(logger, 1) << "Adding weight with name : " << name << " with index: " << ort_value_index;
+    ORT_RETURN_IF_ERROR(save_initialized_tensor(ort_value_index, name, ort_value));
+  }
 
-    // any outer scope value is shadowed by a local value and can't override it.
-    // due to that check_outer_scope is false
-    const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
-#if !defined(DISABLE_SPARSE_TENSORS)
-    const bool sparse = graph.GetGraph().IsSparseInitializer(name);
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse));
-#else
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false));
-#endif
+  if (!deferred_initializers.empty()) {
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(deferred_initializers.size()),
+        [&](std::ptrdiff_t i) {
+          auto& initializer = deferred_initializers[i];
+          ORT_TRY {
+            initializer.status = DeserializeTensorProto(
+                env, graph_loc, *initializer.tensor_proto, initializer.m.has_value() ? &*initializer.m : nullptr,
+                initializer.alloc, default_cpu_alloc, initializer.ort_value, data_transfer_mgr,
+                external_data_loader_mgr, prepacked_for_graph, use_mmap_for_external_data, initializer.load_stats,
+                use_device_allocator_for_initializers);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              initializer.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+            });
+          }
+        });
+
+    for (auto& initializer : deferred_initializers) {
+      const std::string& name = initializer.tensor_proto->name();
+      if (!initializer.status.IsOK()) {
+        return deserialize_failed(name, initializer.status);
+      }
+      load_stats += initializer.load_stats;
+      ORT_RETURN_IF_ERROR(save_initialized_tensor(initializer.ort_value_index, name, initializer.ort_value));
+    }
+  }
+
+  if (load_stats.num_mapped + load_stats.num_copied > 0) {
+    LOGS(logger, INFO) << "[Memory] SessionStateInitializer mapped " << load_stats.mapped_bytes << " bytes for "
+                       << load_stats.num_mapped << " external initializers and copied " << load_stats.copied_bytes
+                       << " bytes for " << load_stats.num_copied << " external initializers";
+  }
+
+  if (external_initializer_load_stats != nullptr) {
+    *external_initializer_load_stats = load_stats;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
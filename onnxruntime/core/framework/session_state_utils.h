@@ -34,11 +34,31 @@ namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace session_state_utils {
 using SaveTensorFunction = std::function<Status(const std::string& name, int idx, const OrtValue& value,
                                                 const OrtCallback& d, bool constant, bool sparse)>;
 using MemoryProfileFunction = std::function<void(ITensorAllocator& planner)>;
 
+// How the data of the initializers stored in external files was loaded.
+struct ExternalInitializerLoadStats {
+  size_t num_mapped = 0;
+  size_t mapped_bytes = 0;  // used in place from the mapped external data file
+  size_t num_copied = 0;
+  size_t copied_bytes = 0;  // copied into a CPU or device buffer
+
+  ExternalInitializerLoadStats& operator+=(const ExternalInitializerLoadStats& other) {
+    num_mapped += other.num_mapped;
+    mapped_bytes += other.mapped_bytes;
+    num_copied += other.num_copied;
+    copied_bytes += other.copied_bytes;
+    return *this;
+  }
+};
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_memory_info,
@@ -52,7 +72,10 @@ common::Status SaveInitializedTensors(
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
     std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
-    PrepackedWeightsForGraph& prepacked_for_graph);
+    PrepackedWeightsForGraph& prepacked_for_graph,
+    ExternalInitializerLoadStats* external_initializer_load_stats = nullptr,
+    // if not null, the initializers deserialized into a CPU buffer are deserialized in parallel on it
+    concurrency::ThreadPool* thread_pool = nullptr);
 
 common::Status AllocateTensor(
     const onnxruntime::MemBuffer* m,
@@ -15,6 +15,7 @@
 #include <gsl/gsl>
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
+#include "core/common/path_string.h"
 #include "core/common/span_utils.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/endian_utils.h"
@@ -961,7 +962,7 @@ static void DeleteCharArray(void* param) noexcept {
 
 #if !defined(__wasm__)
 static Status GetFileContent(const Env& env, const std::filesystem::path& file_path, FileOffsetType offset,
-                             size_t length, void*& raw_buffer, OrtCallback& deleter) {
+                             size_t length, void*& raw_buffer, OrtCallback& deleter, bool* is_mapped = nullptr) {
   // query length if it is 0
   if (length == 0) {
     // The return type of std::filesystem::file_size is uintmax_t which could be bigger than size_t
@@ -975,6 +976,9 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
     if (status.IsOK()) {
       deleter = mapped_memory.get_deleter().callback;
       raw_buffer = mapped_memory.release();
+      if (is_mapped != nullptr) {
+        *is_mapped = true;
+      }
       return Status::OK();
     }
   }
@@ -986,15 +990,28 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
 
   deleter = OrtCallback{DeleteCharArray, buffer.get()};
   raw_buffer = buffer.release();
+  if (is_mapped != nullptr) {
+    *is_mapped = false;
+  }
   return Status::OK();
 }
 #endif
 
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  for (const auto& entry : tensor_proto.external_data()) {
+    if (entry.key() == "location") {
+      return ToPathString(entry.value()) == kTensorProtoMemoryAddressTag;
+    }
+  }
+  return false;
+}
+
 Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                  const ONNX_NAMESPACE::TensorProto& tensor_proto, void*& ext_data_buf,
                                  SafeInt<size_t>& ext_data_len, OrtCallback& ext_data_deleter,
                                  Tensor* buffered_tensor,
-                                 PrepackedWeightsForGraph* prepacked_info) {
+                                 PrepackedWeightsForGraph* prepacked_info,
+                                 ExternalDataSource* ext_data_source) {
   ORT_ENFORCE(utils::HasExternalData(tensor_proto));
   std::basic_string<ORTCHAR_T> tensor_proto_dir;
   if (!model_path.empty()) {
@@ -1021,6 +1038,9 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
     } else {
       ext_data_deleter = OrtCallback{nullptr, nullptr};
     }
+    if (ext_data_source != nullptr) {
+      *ext_data_source = ExternalDataSource::kMemoryAddress;
+    }
   } else {
 #if defined(__wasm__)
     ORT_RETURN_IF(file_offset < 0 || file_offset + raw_data_safe_len >= 4294967296,
@@ -1039,6 +1059,9 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
                                                     ext_data_len,
                                                     ExternalDataLoadType::CPU,
                                                     ext_data_buf));
+    if (ext_data_source != nullptr) {
+      *ext_data_source = ExternalDataSource::kCopiedFile;
+    }
 #else
     // The GetFileContent function doesn't report error if the requested data range is invalid. Therefore we need to
     // manually check file size first.
@@ -1050,9 +1073,13 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
                   "External initializer: ", tensor_proto.name(), " offset: ", file_offset,
                   " size to read: ", static_cast<size_t>(raw_data_safe_len), " given file_length: ", file_length,
                   " are out of bounds or can not be read in full.");
+    bool is_mapped = false;
     ORT_RETURN_IF_ERROR(GetFileContent(env, external_data_file_path.c_str(), file_offset, raw_data_safe_len,
-                                       ext_data_buf, ext_data_deleter));
+                                       ext_data_buf, ext_data_deleter, &is_mapped));
     ext_data_len = raw_data_safe_len;
+    if (ext_data_source != nullptr) {
+      *ext_data_source = is_mapped ? ExternalDataSource::kMappedFile : ExternalDataSource::kCopiedFile;
+    }
 
     if (prepacked_info != nullptr && !prepacked_infos->empty()) {
       for (const auto& [key, blobs] : *prepacked_infos) {
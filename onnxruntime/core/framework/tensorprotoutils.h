@@ -164,18 +164,30 @@ address of the memory containing the data.
 */
 constexpr const ORTCHAR_T* kTensorProtoMemoryAddressTag = ORT_TSTR("*/_ORT_MEM_ADDR_/*");
 
+// Where the buffer returned by GetExtDataFromTensorProto came from.
+enum class ExternalDataSource {
+  kMemoryAddress,  // existing buffer referenced via kTensorProtoMemoryAddressTag
+  kMappedFile,     // pages of the external data file mapped into memory
+  kCopiedFile,     // external data file read into a heap buffer
+};
+
+// Returns true if tensor_proto's external data location is kTensorProtoMemoryAddressTag.
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
 // Given a tensor proto with external data obtain a pointer to the data and its length.
 // The ext_data_deleter argument is updated with a callback that owns/releases the data.
 // If tensor_proto's external file path is kTensorProtoMemoryAddressTag, and
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
 // should release the buffer when tensor_proto is released.
+// If ext_data_source is not null it is set to where the returned buffer came from.
 common::Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                          const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                          void*& ext_data_buf, SafeInt<size_t>& ext_data_len,
                                          OrtCallback& ext_data_deleter,
                                          Tensor* buffered_tensor = nullptr,
-                                         PrepackedWeightsForGraph* prepacked_for_graph = nullptr);
+                                         PrepackedWeightsForGraph* prepacked_for_graph = nullptr,
+                                         ExternalDataSource* ext_data_source = nullptr);
 
 // Given a tensor proto with external data obtain a tensor using the specified custom external data loader.
 common::Status LoadExtDataToTensorFromTensorProto(const Env& env, const std::filesystem::path& model_path,
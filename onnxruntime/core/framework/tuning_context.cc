@@ -0,0 +1,9 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// The CPU execution provider is linked into the framework, so the framework provides the TuningContext implementation
+// for it. Execution providers built as shared libraries include tuning_context_impl.h in one of their own translation
+// units instead.
+#define TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context_impl.h"
+#undef TUNING_CONTEXT_IMPL
@@ -320,6 +320,12 @@ void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext&
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
   constexpr int use_max_past_present_buffer = -1;
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
+
+  // The quantized present key and value are uint8 instead of the type of query.
+  if (ctx.getNumOutputs() > 1 && getAttribute(ctx, "kv_cache_bit_width", 0) == 8) {
+    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::UINT8);
+    updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::UINT8);
+  }
 }
 
 void SparseAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
@@ -1049,6 +1055,8 @@ Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
 Supports continuous decoding for batch_size == 1 for CPU and CUDA.
+Supports a key and value cache quantized to 8 bits for CPU. With kv_cache_bit_width set to 8, the past and present
+key and value are uint8 with a zero point of 128, and k_scale and v_scale give their scales per kv head.
 
 )DOC";
 
@@ -1082,6 +1090,12 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
               "Use a smooth factor in softmax.",
               AttributeProto::INT,
               static_cast<int64_t>(-1))
+        .Attr("kv_cache_bit_width",
+              "Bit width of the quantized past and present key and value. 0 (default) means that they are not "
+              "quantized and have type T. 8 means that they are uint8 with a zero point of 128 and the scales in "
+              "k_scale and v_scale.",
+              AttributeProto::INT,
+              static_cast<int64_t>(0))
         .Input(0,
                "query",
                "Query with shape (batch_size, sequence_length, hidden_size), or packed QKV with shape"
@@ -1101,13 +1115,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1128,6 +1142,25 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "k_scale",
+               "Scale of the quantized past and present key with shape (kv_num_heads) or (1). Required when "
+               "kv_cache_bit_width is 8.",
+               "tensor(float)",
+               OpSchema::Optional)
+        .Input(10,
+               "v_scale",
+               "Scale of the quantized past and present value with shape (kv_num_heads) or (1). Required when "
+               "kv_cache_bit_width is 8.",
+               "tensor(float)",
+               OpSchema::Optional)
+        .Input(11,
+               "attention_bias",
+               "Additive bias of QxK' with shape (batch_size or 1, num_heads or 1, sequence_length or 1, "
+               "total_sequence_length), applied on top of the causal mask, like the padding of the keys of a "
+               "left-padded batch. Only supported by the CPU execution provider.",
+               "T",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1137,14 +1170,16 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(uint8)"},
+                        "Constrain the key and value cache to float tensors, or uint8 tensors when quantized.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
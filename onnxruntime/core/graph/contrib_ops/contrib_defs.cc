@@ -631,6 +631,46 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a subgraph of element-wise operators with multidirectional (Numpy-style) broadcasting
+in a single pass over the output.
+
+The subgraph is described by the attributes `ops` and `operands`. The operators are evaluated in order and
+each produces one value. The operands of all operators are listed in `operands`: an index i below the
+number of inputs refers to input i, and an index num_inputs + j refers to the result of operator j.
+The output is the result of the last operator.
+
+Supported operators and their number of operands are: Add, Sub, Mul, Div, Max, Min (2), Relu, Sigmoid,
+Tanh, Exp, Log, Sqrt, Reciprocal, Neg, Abs (1) and Where (3). The first operand of Where must be a
+bool input. All other operands are float.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The element-wise operators in evaluation order.", AttributeProto::STRINGS)
+        .Attr("operands", "The value indices of the operands of all operators.", AttributeProto::INTS)
+        .Input(0, "inputs", "The inputs of the subgraph.", "T1", OpSchema::Variadic, false)
+        .Output(0, "Y", "The result of the last operator with the broadcast shape of all inputs.", "T")
+        .TypeConstraint("T1", {"tensor(float)", "tensor(bool)"},
+                        "Constrain inputs to float tensors and bool conditions.")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain output to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::FLOAT);
+          const size_t num_inputs = ctx.getNumInputs();
+          if (hasNInputShapes(ctx, static_cast<int>(num_inputs))) {
+            std::vector<const ONNX_NAMESPACE::TensorShapeProto*> shapes;
+            for (size_t i = 0; i < num_inputs; ++i) {
+              shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+            }
+            multidirectionalBroadcastShapeInference(
+                shapes, *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+          }
+        }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
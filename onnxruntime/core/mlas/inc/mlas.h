@@ -95,6 +95,24 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Bfloat16 GEMM (SBGEMM) is available on Linux ARM64 and on AMD64, where the
+// kernel is selected at runtime.
+//
+
+#if (defined(__aarch64__) && defined(__linux__)) || defined(MLAS_TARGET_AMD64)
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
+//
+// Version of the layouts that the packing routines (MlasGemmPackB,
+// MlasConvPrepare, the sparse and quantized packing routines, ...) produce.
+// Packed buffers may be persisted across processes, so this must be bumped
+// with any change to the layout or to the kernel selection that determines it.
+//
+
+#define MLAS_PACKED_FORMAT_VERSION 1
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -162,6 +180,8 @@ enum MLAS_ACTIVATION_KIND {
     MlasLogisticActivation,
     MlasClipActivation,
     MlasHardSigmoidActivation,
+    MlasGeluActivation,
+    MlasSiluActivation,
     MlasActivationKindCount,
 };
 
@@ -200,6 +220,36 @@ MlasActivation(
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Element-wise operations applied to each output tile of a single
+ * precision GEMM before the tile leaves the cache:
+ *
+ *      C := Activation(C + Bias) + Residual
+ *
+ * where C is the result of alpha * op(A) * op(B) + beta * C, Bias is a row
+ * vector broadcast across the rows of C and Residual is a matrix with the
+ * shape of C. The residual is added after the activation, which matches the
+ * skip connection of a transformer block.
+ */
+struct MLAS_SGEMM_EPILOGUE {
+    const float* Bias = nullptr;     /**< Supplies the optional bias vector with N elements */
+    const float* Residual = nullptr; /**< Supplies the optional residual matrix, must not overlap C */
+    size_t ldr = 0;                  /**< Supplies the first dimension of the residual matrix */
+    MLAS_ACTIVATION Activation{MlasIdentityActivation, {{0.0f}}}; /**< Supplies the activation */
+};
+
+/**
+ * @brief Slice sizes used by a single precision GEMM to step through matrix B.
+ *
+ * The built-in sizes suit a generic cache hierarchy. The best sizes for a
+ * large GEMM depend on the cache sizes of the processor and are found by
+ * benchmarking candidates for the shapes that are actually run.
+ */
+struct MLAS_SGEMM_BLOCKING {
+    size_t StrideN; /**< Supplies the columns of matrix B per slice, a non-zero multiple of 16 */
+    size_t StrideK; /**< Supplies the rows of matrix B per slice, ignored if B is pre-packed */
+};
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -213,6 +263,8 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr; /**< Optional epilogue applied to the output tiles */
+    const MLAS_SGEMM_BLOCKING* Blocking = nullptr; /**< Optional slice sizes, else the built-in sizes */
 };
 
 /**
@@ -697,6 +749,153 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Sparse single precision matrix/matrix multiply operation (SGEMM) routines.
+//
+// Matrix B is packed into one of the sparse formats below, which store only
+// the non-zero parts of B. The packed size depends on the sparsity of B, so
+// MlasSparseSgemmPackBSize requires the contents of B as well as its shape.
+//
+
+enum MLAS_SPARSE_SGEMM_FORMAT {
+    MlasSparseSgemmBlock1x8,      // 1 (K) x 8 (N) blocks containing a non-zero element
+    MlasSparseSgemmBlock4x8,      // 4 (K) x 8 (N) blocks containing a non-zero element
+    MlasSparseSgemmStructured2x4, // at most 2 non-zero elements in each 4 consecutive elements along K
+};
+
+/**
+ * @brief Sparsity of matrix B as seen by the sparse SGEMM formats
+ */
+struct MLAS_SPARSE_SGEMM_ANALYSIS {
+    float ZeroFraction = 0.0f;         /**< Fraction of the elements of B that are zero */
+    float ZeroBlockFraction1x8 = 0.0f; /**< Fraction of the 1x8 blocks of B that are zero */
+    float ZeroBlockFraction4x8 = 0.0f; /**< Fraction of the 4x8 blocks of B that are zero */
+    bool Structured2x4 = false;        /**< Whether B has at most 2 non-zeros in each 4 elements along K */
+};
+
+/**
+ * @brief Supply matrices data information to sparse single precision gemm functions
+ */
+struct MLAS_SPARSE_SGEMM_DATA_PARAMS {
+    const float* A = nullptr;      /**< Supplies the address of matrix A, not transposed */
+    size_t lda = 0;                /**< Supplies the first dimension of matrix A. */
+    const void* PackedB = nullptr; /**< Supplies the matrix B packed by MlasSparseSgemmPackB */
+    float* C = nullptr;            /**< Supplies the address of matrix C */
+    size_t ldc = 0;                /**< Supplies the first dimension of matrix C. */
+    float alpha = 1.0f;            /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
+    float beta = 0.0f;             /**< Supplies the scalar beta multiplier (see SGEMM definition) */
+};
+
+/**
+ * @brief Measures the sparsity of matrix B for the sparse SGEMM formats
+ *
+ * @param TransB    Supplies the transpose operation for matrix B.
+ * @param N         Supplies the number of columns of matrix B.
+ * @param K         Supplies the number of rows of matrix B.
+ * @param B         Supplies the address of matrix B.
+ * @param ldb       Supplies the first dimension of matrix B.
+ * @param Analysis  Returns the sparsity of matrix B.
+ */
+void
+MLASCALL
+MlasSparseSgemmAnalyzeB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    MLAS_SPARSE_SGEMM_ANALYSIS* Analysis
+    );
+
+/**
+ * @brief Selects the sparse format that runs fastest for matrix B
+ *
+ * @param Analysis         Supplies the sparsity of matrix B from MlasSparseSgemmAnalyzeB.
+ * @param MinimumSparsity  Supplies the fraction of matrix B that a sparse format
+ *                         must skip to be selected.
+ * @param Format           Returns the selected format.
+ * @return true if a sparse format is expected to run faster than the dense
+ *         SGEMM, else false.
+ */
+bool
+MLASCALL
+MlasSparseSgemmSelectFormat(
+    const MLAS_SPARSE_SGEMM_ANALYSIS* Analysis,
+    float MinimumSparsity,
+    MLAS_SPARSE_SGEMM_FORMAT* Format
+    );
+
+/**
+ * @brief Returns the length in bytes of matrix B packed in a sparse format
+ *
+ * @param Format    Supplies the sparse format. MlasSparseSgemmStructured2x4
+ *                  requires a matrix B with the Structured2x4 property.
+ * @param TransB    Supplies the transpose operation for matrix B.
+ * @param N         Supplies the number of columns of matrix B.
+ * @param K         Supplies the number of rows of matrix B.
+ * @param B         Supplies the address of matrix B.
+ * @param ldb       Supplies the first dimension of matrix B.
+ * @return Size of the packed buffer, or 0 if B cannot be packed in the format.
+ */
+size_t
+MLASCALL
+MlasSparseSgemmPackBSize(
+    MLAS_SPARSE_SGEMM_FORMAT Format,
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+/**
+ * @brief Packs matrix B in a sparse format
+ *
+ * @param Format    Supplies the sparse format.
+ * @param TransB    Supplies the transpose operation for matrix B.
+ * @param N         Supplies the number of columns of matrix B.
+ * @param K         Supplies the number of rows of matrix B.
+ * @param B         Supplies the address of matrix B.
+ * @param ldb       Supplies the first dimension of matrix B.
+ * @param PackedB   Supplies the buffer of MlasSparseSgemmPackBSize bytes that
+ *                  receives the packed matrix B.
+ */
+void
+MLASCALL
+MlasSparseSgemmPackB(
+    MLAS_SPARSE_SGEMM_FORMAT Format,
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief Batched single precision matrix/matrix multiply operation with a
+ *        sparse matrix B: C = alpha * A * B + beta * C
+ *
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+ *                   of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+ *                   base library threading support should be used.
+ */
+void
+MLASCALL
+MlasSparseSgemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SPARSE_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -755,6 +954,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -787,6 +987,13 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileBlockSize;
+            // Optionally set by the caller after MlasConvPrepare to the filter
+            // packed by MlasConvWinogradPackFilter. Else MlasConv transforms
+            // the filter on each call, into the end of the working buffer.
+            const float* PackedFilter;
+        } Winograd;
     } u;
 };
 
@@ -820,6 +1027,42 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+/**
+ * @brief Returns the size in bytes of the transformed filter of a convolution
+ *        that MlasConvPrepare runs with the Winograd F(4x4,3x3) algorithm, or
+ *        0 if it never selects that algorithm for such a filter.
+ *
+ * The choice only depends on the filter and its attributes, so the filter can
+ * be packed before the shape of the input is known.
+ */
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape
+    );
+
+/**
+ * @brief Transforms a GroupCount x FilterCount x InputChannels x 3 x 3 filter
+ *        for the Winograd F(4x4,3x3) algorithm. Pass the result to MlasConv
+ *        through MLAS_CONV_PARAMETERS::u::Winograd::PackedFilter.
+ */
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -1026,6 +1269,91 @@ MlasComputeTanh(
     size_t N
     );
 
+//
+// Transcendental routines.
+//
+// The maximum errors measured against a double precision reference are:
+//
+//     Sin, Cos        2.0 ulp (2.5 ulp on targets without fused multiply-add)
+//     Log             3.5 ulp
+//     Sqrt            correctly rounded
+//     Reciprocal      correctly rounded
+//     Softplus        5.5 ulp
+//     Mish            5.0 ulp for normal results, 64 * 2^-149 absolute for
+//                     denormal results
+//     Pow             2.0 ulp for normal results
+//
+// Special values follow the C99 conventions of the corresponding libm
+// routines. The output buffer may be the same as an input buffer.
+//
+
+void
+MLASCALL
+MlasComputeSin(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeCos(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeReciprocal(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftplus(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeMish(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool BroadcastBase,
+    bool BroadcastExponent
+    );
+
 //
 // Transpose routines.
 //
@@ -1564,6 +1892,13 @@ MlasGemm(
 bool MLASCALL
 MlasFp16AccelerationSupported();
 
+/**
+ * @brief Whether MlasHalfGemmBatch has an optimized kernel for the current CPU,
+ *        rather than the portable C++ implementation.
+*/
+bool MLASCALL
+MlasHalfGemmAccelerated();
+
 /**
  * @brief Interface for half gemm post processors.
  *
@@ -1766,7 +2101,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -1978,6 +2313,31 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+
+    //
+    // Optional masking and layout parameters. The defaults give dense attention
+    // where every query attends to every key.
+    //
+
+    // Number of heads of key and value. Query head h uses key/value head
+    // h / (num_heads / kv_num_heads), as in grouped-query attention. 0 means
+    // num_heads.
+    int kv_num_heads = 0;
+    // Elements between the batches of query. 0 means
+    // num_heads * q_sequence_length * qk_head_size.
+    size_t q_batch_stride = 0;
+    // Number of valid keys of each batch, for key padding. kv_sequence_length
+    // is then the capacity of the key and value buffers. nullptr means all
+    // kv_sequence_length keys are valid.
+    const int* kv_sequence_lengths = nullptr;
+    // Whether query i of batch b only attends to the keys up to its position
+    // i + max(0, kv_sequence_lengths[b] - q_sequence_length), that is, the
+    // queries are the last tokens of the sequence. Blocks of keys that no query
+    // of a block can see are skipped.
+    bool is_causal = false;
+    // When is_causal, also restricts the query at position p to the keys from
+    // p - local_window_size. Negative means no window.
+    int local_window_size = -1;
 };
 
 /**
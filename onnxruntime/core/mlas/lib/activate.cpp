@@ -406,6 +406,100 @@ Return Value:
     }
 }
 
+void
+MlasActivationErfLogisticKernel(
+    MLAS_ACTIVATION_KIND ActivationKind,
+    float* Buffer,
+    size_t M,
+    size_t N,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the Gelu or Silu activation to the output matrix.
+
+    Gelu is computed as 0.5 * x * (1 + erf(x / sqrt(2))) and Silu as
+    x * logistic(x). The erf and logistic functions are computed by the
+    vectorized buffer routines, so each row of the output matrix is processed
+    in chunks that fit a local buffer.
+
+Arguments:
+
+    ActivationKind - Supplies the activation, MlasGeluActivation or
+        MlasSiluActivation.
+
+    Buffer - Supplies the output matrix.
+
+    M - Supplies the number of rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t ChunkSize = 128;
+    MLAS_DECLSPEC_ALIGN(float Temp[ChunkSize], 64);
+
+    const MLAS_FLOAT32X4 HalfBroadcast = MlasBroadcastFloat32x4(0.5f);
+    const MLAS_FLOAT32X4 OneBroadcast = MlasBroadcastFloat32x4(1.0f);
+    const MLAS_FLOAT32X4 RSqrt2Broadcast = MlasBroadcastFloat32x4(0.70710678118654752440f);
+
+    while (M-- > 0) {
+
+        for (size_t n = 0; n < N; n += ChunkSize) {
+
+            float* buffer = Buffer + n;
+            const size_t Count = std::min(N - n, ChunkSize);
+            size_t i;
+
+            if (ActivationKind == MlasGeluActivation) {
+
+                for (i = 0; i + 4 <= Count; i += 4) {
+                    MlasStoreFloat32x4(&Temp[i], MlasMultiplyFloat32x4(MlasLoadFloat32x4(buffer + i), RSqrt2Broadcast));
+                }
+
+                for (; i < Count; i++) {
+                    Temp[i] = buffer[i] * 0.70710678118654752440f;
+                }
+
+                MlasComputeErf(Temp, Temp, Count);
+
+                for (i = 0; i + 4 <= Count; i += 4) {
+                    MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(buffer + i), HalfBroadcast);
+                    Vector = MlasMultiplyFloat32x4(Vector, MlasAddFloat32x4(MlasLoadFloat32x4(&Temp[i]), OneBroadcast));
+                    MlasStoreFloat32x4(buffer + i, Vector);
+                }
+
+                for (; i < Count; i++) {
+                    buffer[i] = buffer[i] * 0.5f * (1.0f + Temp[i]);
+                }
+
+            } else {
+
+                MlasComputeLogistic(buffer, Temp, Count);
+
+                for (i = 0; i + 4 <= Count; i += 4) {
+                    MlasStoreFloat32x4(buffer + i,
+                        MlasMultiplyFloat32x4(MlasLoadFloat32x4(buffer + i), MlasLoadFloat32x4(&Temp[i])));
+                }
+
+                for (; i < Count; i++) {
+                    buffer[i] = buffer[i] * Temp[i];
+                }
+            }
+        }
+
+        Buffer += ldc;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -512,6 +606,290 @@ Return Value:
             break;
         }
 
+        case MlasGeluActivation:
+        case MlasSiluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            if (N == ldc) {
+                MlasActivationErfLogisticKernel(Activation->ActivationKind, Buffer, 1, M * N, ldc);
+            } else {
+                MlasActivationErfLogisticKernel(Activation->ActivationKind, Buffer, M, N, ldc);
+            }
+
+            break;
+        }
+
+        case MlasActivationKindCount:
+        {
+            MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
+            break;
+        }
+    }
+}
+
+//
+// Templates for the GEMM epilogue.
+//
+
+template<MLAS_ACTIVATION_KIND ActivationKind, bool AddBias, bool AddResidual>
+void
+MlasSgemmEpilogueKernel(
+    const MLAS_ACTIVATION* Activation,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const float* Residual,
+    size_t ldr,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine steps over a tile of the output matrix and adds the column
+    bias vector, applies the activation and adds the residual matrix in a
+    single pass.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    C - Supplies the address of the output tile.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+    Bias - Supplies the bias vector for the columns of the tile.
+
+    Residual - Supplies the address of the residual tile.
+
+    ldr - Supplies the first dimension of the residual matrix.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_ACTIVATION_FUNCTION<ActivationKind> ActivationFunction(Activation);
+
+    while (CountM-- > 0) {
+
+        size_t n = 0;
+
+        for (; n + 4 <= CountN; n += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(C + n);
+
+            if (AddBias) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + n));
+            }
+
+            Vector = ActivationFunction.Activate(Vector);
+
+            if (AddResidual) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Residual + n));
+            }
+
+            MlasStoreFloat32x4(C + n, Vector);
+        }
+
+        for (; n < CountN; n++) {
+
+            float Scalar = C[n];
+
+            if (AddBias) {
+                Scalar += Bias[n];
+            }
+
+            Scalar = ActivationFunction.Activate(Scalar);
+
+            if (AddResidual) {
+                Scalar += Residual[n];
+            }
+
+            C[n] = Scalar;
+        }
+
+        C += ldc;
+
+        if (AddResidual) {
+            Residual += ldr;
+        }
+    }
+}
+
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasSgemmEpilogueKernel(
+    const MLAS_ACTIVATION* Activation,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const float* Residual,
+    size_t ldr,
+    size_t CountM,
+    size_t CountN
+    )
+{
+    if (Bias != nullptr) {
+        if (Residual != nullptr) {
+            MlasSgemmEpilogueKernel<ActivationKind, true, true>(
+                Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+        } else {
+            MlasSgemmEpilogueKernel<ActivationKind, true, false>(
+                Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+        }
+    } else {
+        if (Residual != nullptr) {
+            MlasSgemmEpilogueKernel<ActivationKind, false, true>(
+                Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+        } else {
+            MlasSgemmEpilogueKernel<ActivationKind, false, false>(
+                Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+        }
+    }
+}
+
+template<>
+void
+MlasSgemmEpilogueKernel<MlasIdentityActivation, false, false>(
+    const MLAS_ACTIVATION* Activation,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const float* Residual,
+    size_t ldr,
+    size_t CountM,
+    size_t CountN
+    )
+{
+    //
+    // No operation.
+    //
+
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+    MLAS_UNREFERENCED_PARAMETER(C);
+    MLAS_UNREFERENCED_PARAMETER(ldc);
+    MLAS_UNREFERENCED_PARAMETER(Bias);
+    MLAS_UNREFERENCED_PARAMETER(Residual);
+    MLAS_UNREFERENCED_PARAMETER(ldr);
+    MLAS_UNREFERENCED_PARAMETER(CountM);
+    MLAS_UNREFERENCED_PARAMETER(CountN);
+}
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue of a single precision GEMM operation to
+    a tile of the output matrix. The routine is called by the GEMM driver as
+    soon as the final values of the tile have been computed, so the tile is
+    still in the cache.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue parameters.
+
+    C - Supplies the address of the output tile.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+    StartM - Supplies the row of the tile relative to the epilogue's bias
+        vector and residual matrix.
+
+    StartN - Supplies the column of the tile relative to the epilogue's bias
+        vector and residual matrix.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_ACTIVATION* Activation = &Epilogue->Activation;
+    const float* Bias = Epilogue->Bias;
+    const float* Residual = Epilogue->Residual;
+    const size_t ldr = Epilogue->ldr;
+
+    if (Bias != nullptr) {
+        Bias += StartN;
+    }
+
+    if (Residual != nullptr) {
+        Residual += StartM * ldr + StartN;
+    }
+
+    switch (Activation->ActivationKind) {
+
+        case MlasIdentityActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasIdentityActivation>(Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+            break;
+        }
+
+        case MlasReluActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasReluActivation>(Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+            break;
+        }
+
+        case MlasLeakyReluActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasLeakyReluActivation>(Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+            break;
+        }
+
+        case MlasClipActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasClipActivation>(Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+            break;
+        }
+
+        case MlasHardSigmoidActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasHardSigmoidActivation>(Activation, C, ldc, Bias, Residual, ldr, CountM, CountN);
+            break;
+        }
+
+        case MlasTanhActivation:
+        case MlasLogisticActivation:
+        case MlasGeluActivation:
+        case MlasSiluActivation:
+        {
+            //
+            // These activations are computed by the vectorized buffer routines,
+            // so the bias and residual are added in separate passes over the
+            // tile.
+            //
+
+            MlasSgemmEpilogueKernel<MlasIdentityActivation>(Activation, C, ldc, Bias, nullptr, ldr, CountM, CountN);
+            MlasActivation(Activation, C, nullptr, CountM, CountN, ldc);
+            MlasSgemmEpilogueKernel<MlasIdentityActivation>(Activation, C, ldc, nullptr, Residual, ldr, CountM, CountN);
+            break;
+        }
+
         case MlasActivationKindCount:
         {
             MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
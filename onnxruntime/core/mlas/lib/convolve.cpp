@@ -874,6 +874,16 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // The Winograd algorithm schedules blocks of tiles of all the batches and
+    // groups across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -1002,6 +1012,15 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Handled above for all the batches and groups.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1211,6 +1230,18 @@ Return Value:
         }
     }
 
+    //
+    // Use the Winograd algorithm for 3x3 convolutions with enough channels.
+    //
+
+    if (MlasConvWinogradIsSupported(Dimensions, InputChannels, FilterCount, Parameters->KernelShape,
+                                    Parameters->DilationShape, Parameters->StrideShape)) {
+
+        MlasConvWinogradPrepare(Parameters, WorkingBufferSize, ThreadPool);
+
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
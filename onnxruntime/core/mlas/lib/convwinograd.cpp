@@ -0,0 +1,721 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convwinograd.cpp
+
+Abstract:
+
+    This module implements the Winograd F(4x4,3x3) algorithm for 2D 3x3
+    convolutions with unit stride and dilation.
+
+    Each 4x4 tile of the output is computed from a 6x6 tile of the input as
+
+        Y = A' * [(G * g * G') (.) (B' * d * B)] * A
+
+    where (.) is the element wise product. Summed over the input channels, the
+    element wise products become 36 GEMMs of FilterCount x InputChannels
+    transformed filters by InputChannels x Tiles transformed inputs, which do
+    36 multiplies per 4x4 output tile and input channel instead of 144.
+
+    The filter is transformed once by MlasConvWinogradPackFilter, else by
+    MlasConv into the end of its working buffer on each call. The tiles of
+    the output are split in blocks: each thread transforms the input tiles of a
+    block, runs the 36 GEMMs of the block and transforms their results to the
+    output, so the whole working set of a block stays in the cache of the
+    thread.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the size of a tile of the output and of the input.
+//
+
+#define MLAS_WINOGRAD_OUTPUT_TILE_SIZE 4
+#define MLAS_WINOGRAD_INPUT_TILE_SIZE 6
+#define MLAS_WINOGRAD_TRANSFORM_SIZE (MLAS_WINOGRAD_INPUT_TILE_SIZE * MLAS_WINOGRAD_INPUT_TILE_SIZE)
+#define MLAS_WINOGRAD_OUTPUT_TILE_ELEMENTS (MLAS_WINOGRAD_OUTPUT_TILE_SIZE * MLAS_WINOGRAD_OUTPUT_TILE_SIZE)
+
+//
+// Define the minimum number of input and output channels for which the
+// transforms are cheap compared to the GEMMs they save.
+//
+
+#define MLAS_WINOGRAD_MINIMUM_CHANNELS 32
+
+//
+// Define the target number of working buffer elements per thread and the
+// minimum number of tiles in a block, so that the GEMMs of a block are not too
+// narrow.
+//
+
+#define MLAS_WINOGRAD_WORKING_BUFFER_SIZE_PER_THREAD (256 * 1024)
+#define MLAS_WINOGRAD_MINIMUM_TILE_BLOCK_SIZE 16
+
+struct MLAS_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* PackedFilter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    ptrdiff_t TargetThreadCount;
+};
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradTileCount(
+    size_t OutputSize
+    )
+{
+    return (OutputSize + MLAS_WINOGRAD_OUTPUT_TILE_SIZE - 1) / MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradWorkingBufferSizePerThread(
+    size_t InputChannels,
+    size_t FilterCount,
+    size_t TileBlockSize
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of working buffer elements of a thread:
+    the transformed input tiles, the results of the GEMMs and the output
+    tiles of a block.
+
+--*/
+{
+    return (MLAS_WINOGRAD_TRANSFORM_SIZE * (InputChannels + FilterCount) +
+            MLAS_WINOGRAD_OUTPUT_TILE_ELEMENTS * FilterCount) * TileBlockSize;
+}
+
+bool
+MlasConvWinogradIsSupported(
+    size_t Dimensions,
+    size_t InputChannels,
+    size_t FilterCount,
+    const size_t* KernelShape,
+    const size_t* DilationShape,
+    const size_t* StrideShape
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether the Winograd algorithm should be used for a
+    convolution. The choice does not depend on the shape of the input, so that
+    filters can be packed ahead of time.
+
+--*/
+{
+    if (Dimensions != 2) {
+        return false;
+    }
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        if (KernelShape[dim] != 3 || DilationShape[dim] != 1 || StrideShape[dim] != 1) {
+            return false;
+        }
+    }
+
+    return InputChannels >= MLAS_WINOGRAD_MINIMUM_CHANNELS && FilterCount >= MLAS_WINOGRAD_MINIMUM_CHANNELS;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape
+    )
+{
+    if (Dimensions != 2) {
+        return 0;
+    }
+
+    size_t Kernel[2];
+    size_t Dilation[2];
+    size_t Stride[2];
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        Kernel[dim] = size_t(KernelShape[dim]);
+        Dilation[dim] = size_t(DilationShape[dim]);
+        Stride[dim] = size_t(StrideShape[dim]);
+    }
+
+    if (!MlasConvWinogradIsSupported(Dimensions, InputChannels, FilterCount, Kernel, Dilation, Stride)) {
+        return 0;
+    }
+
+    return GroupCount * MLAS_WINOGRAD_TRANSFORM_SIZE * FilterCount * InputChannels * sizeof(float);
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 kernels of a filter to U = G * g * G'.
+
+    The packed filter of each group holds 36 row major FilterCount x
+    InputChannels matrices, one for each element of U.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor.
+
+    PackedFilter - Supplies the buffer of MlasConvWinogradPackFilterSize
+        bytes that receives the transformed filter.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    MlasTrySimpleParallel(ThreadPool, ptrdiff_t(GroupCount * FilterCount), [&](ptrdiff_t tid) {
+
+        const size_t group = size_t(tid) / FilterCount;
+        const size_t f = size_t(tid) % FilterCount;
+
+        const float* g = Filter + (group * FilterCount + f) * InputChannels * 9;
+        float* u = PackedFilter + group * MLAS_WINOGRAD_TRANSFORM_SIZE * MatrixSize + f * InputChannels;
+
+        for (size_t c = 0; c < InputChannels; c++, g += 9) {
+
+            //
+            // Apply G to the columns of the kernel, then to the rows of the
+            // result.
+            //
+            //  G = [  1/4     0     0  ]
+            //      [ -1/6  -1/6  -1/6  ]
+            //      [ -1/6   1/6  -1/6  ]
+            //      [ 1/24  1/12   1/6  ]
+            //      [ 1/24 -1/12   1/6  ]
+            //      [    0     0     1  ]
+            //
+
+            float Gg[6][3];
+
+            for (size_t j = 0; j < 3; j++) {
+                const float g0 = g[j];
+                const float g1 = g[3 + j];
+                const float g2 = g[6 + j];
+                Gg[0][j] = g0 * (1.0f / 4.0f);
+                Gg[1][j] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+                Gg[2][j] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+                Gg[3][j] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+                Gg[4][j] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+                Gg[5][j] = g2;
+            }
+
+            for (size_t i = 0; i < 6; i++) {
+                const float g0 = Gg[i][0];
+                const float g1 = Gg[i][1];
+                const float g2 = Gg[i][2];
+                float* ui = u + i * 6 * MatrixSize + c;
+                ui[0 * MatrixSize] = g0 * (1.0f / 4.0f);
+                ui[1 * MatrixSize] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+                ui[2 * MatrixSize] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+                ui[3 * MatrixSize] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+                ui[4 * MatrixSize] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+                ui[5 * MatrixSize] = g2;
+            }
+        }
+    });
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradInputTransform1D(
+    const float* d,
+    size_t StrideD,
+    float* r,
+    size_t StrideR
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies 6 values by B':
+
+        B' = [ 4  0 -5  0  1  0 ]
+             [ 0 -4 -4  1  1  0 ]
+             [ 0  4 -4 -1  1  0 ]
+             [ 0 -2 -1  2  1  0 ]
+             [ 0  2 -1 -2  1  0 ]
+             [ 0  4  0 -5  0  1 ]
+
+--*/
+{
+    const float d0 = d[0 * StrideD];
+    const float d1 = d[1 * StrideD];
+    const float d2 = d[2 * StrideD];
+    const float d3 = d[3 * StrideD];
+    const float d4 = d[4 * StrideD];
+    const float d5 = d[5 * StrideD];
+
+    const float t0 = d4 - 4.0f * d2;
+    const float t1 = d3 - 4.0f * d1;
+    const float t2 = d4 - d2;
+    const float t3 = 2.0f * (d3 - d1);
+
+    r[0 * StrideR] = 4.0f * d0 - 5.0f * d2 + d4;
+    r[1 * StrideR] = t0 + t1;
+    r[2 * StrideR] = t0 - t1;
+    r[3 * StrideR] = t2 + t3;
+    r[4 * StrideR] = t2 - t3;
+    r[5 * StrideR] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradOutputTransform1D(
+    const float* m,
+    size_t StrideM,
+    float* r,
+    size_t StrideR
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies 6 values by A':
+
+        A' = [ 1  1  1  1  1  0 ]
+             [ 0  1 -1  2 -2  0 ]
+             [ 0  1  1  4  4  0 ]
+             [ 0  1 -1  8 -8  1 ]
+
+--*/
+{
+    const float m0 = m[0 * StrideM];
+    const float m1 = m[1 * StrideM];
+    const float m2 = m[2 * StrideM];
+    const float m3 = m[3 * StrideM];
+    const float m4 = m[4 * StrideM];
+    const float m5 = m[5 * StrideM];
+
+    const float s12 = m1 + m2;
+    const float d12 = m1 - m2;
+    const float s34 = m3 + m4;
+    const float d34 = m3 - m4;
+
+    r[0 * StrideR] = m0 + s12 + s34;
+    r[1 * StrideR] = d12 + 2.0f * d34;
+    r[2 * StrideR] = s12 + 4.0f * s34;
+    r[3 * StrideR] = d12 + 8.0f * d34 + m5;
+}
+
+void
+MlasConvWinogradInputTransform(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    size_t TileStart,
+    size_t TileCount,
+    size_t TileBlockSize,
+    float* TransformedInput
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 6x6 input tiles of a block of output tiles to
+    V = B' * d * B, stored as 36 row major InputChannels x TileBlockSize
+    matrices.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TilesWidth = MlasConvWinogradTileCount(Parameters->OutputShape[1]);
+    const size_t MatrixSize = InputChannels * TileBlockSize;
+
+    for (size_t t = 0; t < TileCount; t++) {
+
+        const size_t TileIndex = TileStart + t;
+        const size_t ih0 = (TileIndex / TilesWidth) * MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+        const size_t iw0 = (TileIndex % TilesWidth) * MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+
+        //
+        // Check whether the input tile is inside the padded input. Unsigned
+        // arithmetic makes positions in the leading padding wrap to large values.
+        //
+
+        const bool Interior = ih0 >= PaddingTop && ih0 - PaddingTop + MLAS_WINOGRAD_INPUT_TILE_SIZE <= InputHeight &&
+                              iw0 >= PaddingLeft && iw0 - PaddingLeft + MLAS_WINOGRAD_INPUT_TILE_SIZE <= InputWidth;
+
+        const float* input = Input;
+
+        for (size_t c = 0; c < InputChannels; c++, input += InputSize) {
+
+            float d[6][6];
+
+            if (Interior) {
+                const float* row = input + (ih0 - PaddingTop) * InputWidth + (iw0 - PaddingLeft);
+                for (size_t i = 0; i < 6; i++, row += InputWidth) {
+                    for (size_t j = 0; j < 6; j++) {
+                        d[i][j] = row[j];
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < 6; i++) {
+                    const size_t ih = ih0 + i - PaddingTop;
+                    for (size_t j = 0; j < 6; j++) {
+                        const size_t iw = iw0 + j - PaddingLeft;
+                        d[i][j] = (ih < InputHeight && iw < InputWidth) ? input[ih * InputWidth + iw] : 0.0f;
+                    }
+                }
+            }
+
+            float Bd[6][6];
+
+            for (size_t j = 0; j < 6; j++) {
+                MlasConvWinogradInputTransform1D(&d[0][j], 6, &Bd[0][j], 6);
+            }
+
+            float* v = TransformedInput + c * TileBlockSize + t;
+
+            for (size_t i = 0; i < 6; i++) {
+                MlasConvWinogradInputTransform1D(&Bd[i][0], 1, v + i * 6 * MatrixSize, MatrixSize);
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradOutputTransform(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Bias,
+    const float* TransformedOutput,
+    size_t TileStart,
+    size_t TileCount,
+    size_t TileBlockSize,
+    float* OutputTiles,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the results of the GEMMs of a block to the 4x4
+    output tiles Y = A' * m * A, applies the bias and the activation and
+    stores the part of the tiles that is inside the output.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TilesWidth = MlasConvWinogradTileCount(OutputWidth);
+    const size_t MatrixSize = FilterCount * TileBlockSize;
+    const size_t OutputTilesStride = TileBlockSize * MLAS_WINOGRAD_OUTPUT_TILE_ELEMENTS;
+    const float Beta = Parameters->Beta;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        const float* m = TransformedOutput + f * TileBlockSize;
+        float* y = OutputTiles + f * OutputTilesStride;
+        const float* output = Output + f * OutputSize;
+
+        for (size_t t = 0; t < TileCount; t++, y += MLAS_WINOGRAD_OUTPUT_TILE_ELEMENTS) {
+
+            float mt[6][6];
+
+            for (size_t i = 0; i < MLAS_WINOGRAD_TRANSFORM_SIZE; i++) {
+                mt[i / 6][i % 6] = m[i * MatrixSize + t];
+            }
+
+            float Am[4][6];
+
+            for (size_t j = 0; j < 6; j++) {
+                MlasConvWinogradOutputTransform1D(&mt[0][j], 6, &Am[0][j], 6);
+            }
+
+            for (size_t i = 0; i < 4; i++) {
+                MlasConvWinogradOutputTransform1D(&Am[i][0], 1, y + i * 4, 1);
+            }
+
+            //
+            // Accumulate the existing output before the activation, as the
+            // other algorithms do through the beta of their GEMM.
+            //
+
+            if (Beta != 0.0f) {
+                const size_t TileIndex = TileStart + t;
+                const size_t oh0 = (TileIndex / TilesWidth) * MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+                const size_t ow0 = (TileIndex % TilesWidth) * MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+                for (size_t i = 0; i < 4 && oh0 + i < OutputHeight; i++) {
+                    for (size_t j = 0; j < 4 && ow0 + j < OutputWidth; j++) {
+                        y[i * 4 + j] += Beta * output[(oh0 + i) * OutputWidth + ow0 + j];
+                    }
+                }
+            }
+        }
+    }
+
+    MlasActivation(Parameters->Activation, OutputTiles, Bias, FilterCount,
+        TileCount * MLAS_WINOGRAD_OUTPUT_TILE_ELEMENTS, OutputTilesStride);
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        const float* y = OutputTiles + f * OutputTilesStride;
+        float* output = Output + f * OutputSize;
+
+        for (size_t t = 0; t < TileCount; t++, y += MLAS_WINOGRAD_OUTPUT_TILE_ELEMENTS) {
+
+            const size_t TileIndex = TileStart + t;
+            const size_t oh0 = (TileIndex / TilesWidth) * MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+            const size_t ow0 = (TileIndex % TilesWidth) * MLAS_WINOGRAD_OUTPUT_TILE_SIZE;
+            const size_t Rows = std::min(size_t(MLAS_WINOGRAD_OUTPUT_TILE_SIZE), OutputHeight - oh0);
+            const size_t Columns = std::min(size_t(MLAS_WINOGRAD_OUTPUT_TILE_SIZE), OutputWidth - ow0);
+
+            for (size_t i = 0; i < Rows; i++) {
+                std::copy_n(y + i * 4, Columns, output + (oh0 + i) * OutputWidth + ow0);
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to compute the blocks of
+    output tiles of a Winograd convolution assigned to the thread.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_WINOGRAD_WORK_BLOCK* WorkBlock = (const MLAS_WINOGRAD_WORK_BLOCK*)Context;
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TileCount = MlasConvWinogradTileCount(Parameters->OutputShape[0]) *
+                             MlasConvWinogradTileCount(Parameters->OutputShape[1]);
+    const size_t BlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+
+    const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * Parameters->OutputSize;
+    const size_t PackedFilterGroupSize = MLAS_WINOGRAD_TRANSFORM_SIZE * FilterCount * InputChannels;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, Parameters->BatchCount * GroupCount * BlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    float* TransformedInput = WorkBlock->WorkingBuffer +
+        Index * MlasConvWinogradWorkingBufferSizePerThread(InputChannels, FilterCount, TileBlockSize);
+    float* TransformedOutput = TransformedInput + MLAS_WINOGRAD_TRANSFORM_SIZE * InputChannels * TileBlockSize;
+    float* OutputTiles = TransformedOutput + MLAS_WINOGRAD_TRANSFORM_SIZE * FilterCount * TileBlockSize;
+
+    for (size_t WorkEnd = WorkIndex + WorkRemaining; WorkIndex < WorkEnd; WorkIndex++) {
+
+        const size_t bg = WorkIndex / BlockCount;
+        const size_t group = bg % GroupCount;
+        const size_t TileStart = (WorkIndex % BlockCount) * TileBlockSize;
+        const size_t TileCountThisBlock = std::min(TileBlockSize, TileCount - TileStart);
+
+        const float* Input = WorkBlock->Input + bg * InputGroupSize;
+        const float* PackedFilter = WorkBlock->PackedFilter + group * PackedFilterGroupSize;
+        const float* Bias = WorkBlock->Bias != nullptr ? WorkBlock->Bias + group * FilterCount : nullptr;
+        float* Output = WorkBlock->Output + bg * OutputGroupSize;
+
+        MlasConvWinogradInputTransform(Parameters, Input, TileStart, TileCountThisBlock, TileBlockSize,
+            TransformedInput);
+
+        for (size_t i = 0; i < MLAS_WINOGRAD_TRANSFORM_SIZE; i++) {
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCountThisBlock, InputChannels, 1.0f,
+                PackedFilter + i * FilterCount * InputChannels, InputChannels,
+                TransformedInput + i * InputChannels * TileBlockSize, TileBlockSize, 0.0f,
+                TransformedOutput + i * FilterCount * TileBlockSize, TileBlockSize);
+        }
+
+        MlasConvWinogradOutputTransform(Parameters, Bias, TransformedOutput, TileStart, TileCountThisBlock,
+            TileBlockSize, OutputTiles, Output);
+    }
+}
+
+void
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the Winograd algorithm for a convolution and sizes
+    its blocks of output tiles and its working buffer. The working buffer ends
+    with room for the transformed filter, which is used when the caller does
+    not supply the packed filter.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileCount = MlasConvWinogradTileCount(Parameters->OutputShape[0]) *
+                             MlasConvWinogradTileCount(Parameters->OutputShape[1]);
+    const size_t TotalTileCount = Parameters->BatchCount * Parameters->GroupCount * TileCount;
+
+    ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    //
+    // Size the blocks to fit the working buffer of a thread, but give every
+    // thread some tiles.
+    //
+
+    size_t TileBlockSize = MLAS_WINOGRAD_WORKING_BUFFER_SIZE_PER_THREAD /
+                           MlasConvWinogradWorkingBufferSizePerThread(InputChannels, FilterCount, 1);
+    TileBlockSize = std::max(TileBlockSize, size_t(MLAS_WINOGRAD_MINIMUM_TILE_BLOCK_SIZE));
+    TileBlockSize = std::min(TileBlockSize, (TotalTileCount + TargetThreadCount - 1) / TargetThreadCount);
+    TileBlockSize = std::max(std::min(TileBlockSize, TileCount), size_t(1));
+
+    const size_t BlockCount = Parameters->BatchCount * Parameters->GroupCount *
+                              ((TileCount + TileBlockSize - 1) / TileBlockSize);
+
+    if (size_t(TargetThreadCount) > BlockCount) {
+        TargetThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = TargetThreadCount;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+    Parameters->u.Winograd.PackedFilter = nullptr;
+
+    *WorkingBufferSize = size_t(TargetThreadCount) *
+                         MlasConvWinogradWorkingBufferSizePerThread(InputChannels, FilterCount, TileBlockSize) +
+                         Parameters->GroupCount * MLAS_WINOGRAD_TRANSFORM_SIZE * FilterCount * InputChannels;
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation with the Winograd
+    algorithm for all the batches and groups.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor. Unused if the parameters supply the
+        packed filter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* PackedFilter = Parameters->u.Winograd.PackedFilter;
+
+    if (PackedFilter == nullptr) {
+
+        //
+        // Transform the filter into the end of the working buffer, after the
+        // buffers of the threads.
+        //
+
+        float* TransformedFilter = WorkingBuffer + size_t(Parameters->ThreadCount) *
+            MlasConvWinogradWorkingBufferSizePerThread(Parameters->InputChannels, Parameters->FilterCount,
+                Parameters->u.Winograd.TileBlockSize);
+
+        MlasConvWinogradPackFilter(Parameters->GroupCount, Parameters->InputChannels, Parameters->FilterCount,
+            Filter, TransformedFilter, ThreadPool);
+
+        PackedFilter = TransformedFilter;
+    }
+
+    MLAS_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.PackedFilter = PackedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, WorkBlock.TargetThreadCount, ThreadPool);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <numeric>
 
 #include "mlasi.h"
@@ -24,6 +25,10 @@ MlasFlashAttentionThreaded(
     const float* key = args->key;
     const float* value = args->value;
     float* output = args->output;
+    ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    ptrdiff_t q_batch_stride = args->q_batch_stride > 0 ? static_cast<ptrdiff_t>(args->q_batch_stride)
+                                                        : num_heads * q_sequence_length * qk_head_size;
+    ptrdiff_t local_window_size = args->is_causal ? static_cast<ptrdiff_t>(args->local_window_size) : -1;
 
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
@@ -50,6 +55,37 @@ MlasFlashAttentionThreaded(
         batch_idx /= q_chunk_count;
         ptrdiff_t head_idx = batch_idx % num_heads;
         batch_idx /= num_heads;
+        ptrdiff_t kv_head_idx = batch_idx * kv_num_heads + head_idx / (num_heads / kv_num_heads);
+
+        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+        float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
+
+        ptrdiff_t kv_length = kv_sequence_length;
+        if (args->kv_sequence_lengths != nullptr) {
+            kv_length = std::clamp(static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx]),
+                                   ptrdiff_t{0}, kv_sequence_length);
+        }
+
+        //
+        // Only the keys in [kv_begin, kv_end) are visible to a query of this block.
+        // q_position is the position of the first query of the block among the keys.
+        //
+        ptrdiff_t q_position = q_idx + std::max(ptrdiff_t{0}, kv_length - q_sequence_length);
+        ptrdiff_t kv_begin = 0;
+        ptrdiff_t kv_end = kv_length;
+        if (args->is_causal) {
+            kv_end = std::min(kv_end, q_position + row_size_q_valid);
+        }
+        if (local_window_size >= 0) {
+            kv_begin = std::max(kv_begin, q_position - local_window_size);
+        }
+        if (kv_begin >= kv_end) {
+            for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+                std::fill_n(output_row, v_head_size, 0.0f);
+                output_row += num_heads * v_head_size;
+            }
+            continue;
+        }
 
         char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
         float* l = reinterpret_cast<float*>(buffer_current_thread);
@@ -61,7 +97,7 @@ MlasFlashAttentionThreaded(
         float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        for (ptrdiff_t ir = kv_begin; ir < kv_end; ir += kv_block_size) {
             /*
                 S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
@@ -71,13 +107,14 @@ MlasFlashAttentionThreaded(
                 l = exp(diff) * l + rowsum(S)
                 O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const float* inputQ =
+                query + batch_idx * q_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size;
+            const float* inputK = key + (kv_head_idx * kv_sequence_length + ir) * qk_head_size;
+            const float* inputV = value + (kv_head_idx * kv_sequence_length + ir) * v_head_size;
+            bool is_first_block = (ir == kv_begin);
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_q_capped = static_cast<size_t>(row_size_q_valid);
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -96,10 +133,34 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
+                //
+                // Columns outside [col_begin, col_end) are masked out for this row.
+                //
+                ptrdiff_t col_begin = 0;
+                ptrdiff_t col_end = static_cast<ptrdiff_t>(row_size_kv_capped);
+                if (args->is_causal) {
+                    col_end = std::min(col_end, q_position + irow + 1 - ir);
+                }
+                if (local_window_size >= 0) {
+                    col_begin = std::max(col_begin, q_position + irow - local_window_size - ir);
+                }
+                if (col_begin >= col_end) {
+                    // No visible key in this block: the row adds nothing to the output.
+                    std::fill_n(p, row_size_kv_capped, 0.0f);
+                    if (is_first_block) {
+                        l[irow] = 0.0f;
+                    }
+                    continue;
+                }
+                std::fill(p, p + col_begin, 0.0f);
+                std::fill(p + col_end, p + row_size_kv_capped, 0.0f);
+                size_t row_size_kv_valid = static_cast<size_t>(col_end - col_begin);
+                p += col_begin;
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_valid);
 #else
-                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_valid);
 #endif
                 float m_diff = m[irow];
                 m[irow] = std::max(m[irow], rowmax);  // new m
@@ -107,13 +168,13 @@ MlasFlashAttentionThreaded(
                 m_diff -= m[irow];  // old - new (less than 0)
 
 #if defined(MLAS_TARGET_AMD64)
-                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_valid, &negmax);
 #else
-                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_valid, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
+                // Note: for the first block, there is actually no need to calculate exp_diff
+                if (!is_first_block) {
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
 
@@ -122,7 +183,7 @@ MlasFlashAttentionThreaded(
                     }
                 } else {
                     l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
+                    // For the first block, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -135,17 +196,17 @@ MlasFlashAttentionThreaded(
                      row_size_kv_capped,
                      inputV,
                      static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     is_first_block ? 0.0f : 1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
         }
 
-        float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
         // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+            // A row without any visible key outputs zeros.
+            float inv_l = l[irow] > 0.0f ? 1.0f / l[irow] : 0.0f;
             for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
+                output_row[icol] = temp_output[irow * v_head_size + icol] * inv_l;
             }
             output_row += num_heads * v_head_size;
         }
@@ -32,6 +32,18 @@ MlasFp16AccelerationSupported()
 #endif
 }
 
+bool MLASCALL
+MlasHalfGemmAccelerated()
+{
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+    return MlasFp16AccelerationSupported();
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().HalfGemmDispatch != nullptr;
+#else
+    return false;
+#endif
+}
+
 
 void
 MLASCALL
@@ -0,0 +1,394 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM operation for processors
+    without native fp16 arithmetic.
+
+    The fp16 inputs are converted to fp32 with F16C while matrix B is packed
+    and matrix A is tiled, and the products are computed by the platform
+    single precision GEMM kernel (FMA3 or AVX512F). The accumulation is done
+    in fp32 and rounded to fp16 once when the output is stored.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#include <immintrin.h>
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{128, 128, 128};
+};
+
+MLAS_FORCEINLINE
+__m256
+MlasHalfGemmLoadFloat8(
+    const _mlas_fp16_* Source
+    )
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source)));
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasHalfGemmLoadFloat8(
+    const float* Source
+    )
+{
+    return _mm256_loadu_ps(Source);
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmStoreHalf8(
+    _mlas_fp16_* Destination,
+    __m256 Vector
+    )
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination), _mm256_cvtps_ph(Vector, _MM_FROUND_TO_NEAREST_INT));
+}
+
+template <typename InputType>
+void
+MlasHalfGemmConvertCopyPackB(
+    float* D,
+    const InputType* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts elements of matrix B to fp32 and copies them to the
+    packed buffer in the layout of MlasSgemmCopyPackB: columns of 16 elements
+    are made contiguous, and the remaining columns are zero-padded to 16.
+
+Arguments:
+
+    D - Supplies the address of the packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN >= 16) {
+
+        const InputType* b = B;
+
+        for (size_t k = 0; k < CountK; k++) {
+            _mm256_storeu_ps(D, MlasHalfGemmLoadFloat8(b));
+            _mm256_storeu_ps(D + 8, MlasHalfGemmLoadFloat8(b + 8));
+            D += 16;
+            b += ldb;
+        }
+
+        B += 16;
+        CountN -= 16;
+    }
+
+    if (CountN > 0) {
+
+        InputType Row[16];
+
+        for (size_t k = 0; k < CountK; k++) {
+            std::fill_n(Row, 16, InputType(0));
+            std::copy_n(B, CountN, Row);
+            _mm256_storeu_ps(D, MlasHalfGemmLoadFloat8(Row));
+            _mm256_storeu_ps(D + 8, MlasHalfGemmLoadFloat8(Row + 8));
+            D += 16;
+            B += ldb;
+        }
+    }
+}
+
+void
+MlasHalfGemmConvertTileA(
+    float* D,
+    const _mlas_fp16_* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a tile of fp16 matrix A to a row major fp32 buffer
+    with CountK elements per row.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m++) {
+
+        const _mlas_fp16_* a = A + m * lda;
+        size_t k = 0;
+
+        for (; k + 8 <= CountK; k += 8) {
+            _mm256_storeu_ps(D + k, MlasHalfGemmLoadFloat8(a + k));
+        }
+
+        for (; k < CountK; k++) {
+            D[k] = _cvtsh_ss(a[k]);
+        }
+
+        D += CountK;
+    }
+}
+
+void
+MlasHalfGemmStoreOutput(
+    _mlas_fp16_* C,
+    size_t ldc,
+    const float* Accumulators,
+    size_t ldacc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the bias to the fp32 accumulators and stores them to the
+    fp16 output.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m++) {
+
+        size_t n = 0;
+
+        for (; n + 8 <= CountN; n += 8) {
+            __m256 Vector = _mm256_loadu_ps(Accumulators + n);
+            if (Bias != nullptr) {
+                Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Bias + n));
+            }
+            MlasHalfGemmStoreHalf8(C + n, Vector);
+        }
+
+        for (; n < CountN; n++) {
+            const float Value = Accumulators[n] + (Bias != nullptr ? Bias[n] : 0.0f);
+            C[n] = _cvtss_sh(Value, _MM_FROUND_TO_NEAREST_INT);
+        }
+
+        C += ldc;
+        Accumulators += ldacc;
+    }
+}
+
+void
+MlasHalfGemmOperationAvx2(
+    const size_t N,
+    const size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    const size_t RangeStartM,
+    const size_t RangeCountM,
+    const size_t RangeStartN,
+    const size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of the output of the half precision GEMM
+    operation with the single precision GEMM kernel.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    Data - Supplies the parameters of the operation.
+
+    RangeStartM, RangeCountM - Supplies the rows of matrix C to compute.
+
+    RangeStartN, RangeCountN - Supplies the columns of matrix C to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr MLAS_HALF_GEMM_STRIDES Strides = MLAS_HALF_GEMM_KERNEL_AVX2::Strides;
+    constexpr size_t PanelASize = UpAlignSize(Strides.M * Strides.K * sizeof(float));
+    constexpr size_t PanelBSize = UpAlignSize(Strides.N * Strides.K * sizeof(float));
+    constexpr size_t AccumulatorSize = UpAlignSize(Strides.M * Strides.N * sizeof(float));
+    constexpr size_t BiasSize = UpAlignSize(Strides.N * sizeof(float));
+    MlasThreadedBufAlloc(PanelASize + PanelBSize + AccumulatorSize + BiasSize);
+
+    uint8_t* p = ThreadedBufHolder.get();
+    float* PanelA = reinterpret_cast<float*>(p);
+    p += PanelASize;
+    float* PanelB = reinterpret_cast<float*>(p);
+    p += PanelBSize;
+    float* Accumulators = reinterpret_cast<float*>(p);
+    p += AccumulatorSize;
+    float* BiasPanel = reinterpret_cast<float*>(p);
+
+    //
+    // A prepacked matrix B is a row major fp16 matrix, see MlasHalfGemmConvertPackBAvx2.
+    //
+
+    const bool BIsfp32 = Data->BIsfp32 && Data->ldb != 0;
+    const size_t ldb = (Data->ldb == 0) ? N : Data->ldb;
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+    const auto* Bias = reinterpret_cast<const _mlas_fp16_*>(Data->Bias);
+    auto* C = reinterpret_cast<_mlas_fp16_*>(Data->C);
+
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernel = GetMlasPlatform().GemmFloatKernel;
+
+    //
+    // Step through each slice of matrix C along the M dimension, then along the
+    // N dimension. The fp32 accumulators of a slice are kept across the whole K
+    // dimension.
+    //
+
+    size_t CountM;
+    for (size_t m = 0; m < RangeCountM; m += CountM) {
+        CountM = std::min(RangeCountM - m, Strides.M);
+        const size_t StartM = RangeStartM + m;
+
+        size_t CountN;
+        for (size_t n = 0; n < RangeCountN; n += CountN) {
+            CountN = std::min(RangeCountN - n, Strides.N);
+            const size_t StartN = RangeStartN + n;
+
+            if (K == 0) {
+                std::fill_n(Accumulators, Strides.M * Strides.N, 0.0f);
+            }
+
+            size_t CountK;
+            for (size_t k = 0; k < K; k += CountK) {
+                CountK = std::min(K - k, Strides.K);
+
+                //
+                // Convert and pack a panel of matrix B.
+                //
+
+                if (BIsfp32) {
+                    MlasHalfGemmConvertCopyPackB(
+                        PanelB, reinterpret_cast<const float*>(Data->B) + k * ldb + StartN, ldb, CountN, CountK);
+                } else {
+                    MlasHalfGemmConvertCopyPackB(
+                        PanelB, reinterpret_cast<const _mlas_fp16_*>(Data->B) + k * ldb + StartN, ldb, CountN,
+                        CountK);
+                }
+
+                //
+                // Convert a tile of matrix A, unless it is already fp32.
+                //
+
+                const float* a;
+                size_t ld_a;
+                if (Data->AIsfp32) {
+                    a = reinterpret_cast<const float*>(Data->A) + StartM * lda + k;
+                    ld_a = lda;
+                } else {
+                    MlasHalfGemmConvertTileA(
+                        PanelA, reinterpret_cast<const _mlas_fp16_*>(Data->A) + StartM * lda + k, lda, CountM, CountK);
+                    a = PanelA;
+                    ld_a = CountK;
+                }
+
+                float* c = Accumulators;
+                size_t RowsRemaining = CountM;
+                while (RowsRemaining > 0) {
+                    size_t RowsHandled = GemmFloatKernel(
+                        a, PanelB, c, CountK, RowsRemaining, CountN, ld_a, Strides.N, 1.0f, k == 0);
+                    c += Strides.N * RowsHandled;
+                    a += ld_a * RowsHandled;
+                    RowsRemaining -= RowsHandled;
+                }
+            }
+
+            //
+            // Add the bias and round the accumulators to the fp16 output.
+            //
+
+            const float* BiasFloat = nullptr;
+            if (Bias != nullptr) {
+                for (size_t i = 0; i < CountN; i++) {
+                    BiasPanel[i] = _cvtsh_ss(Bias[StartN + i]);
+                }
+                BiasFloat = BiasPanel;
+            }
+
+            MlasHalfGemmStoreOutput(
+                C + StartM * ldc + StartN, ldc, Accumulators, Strides.N, BiasFloat, CountM, CountN);
+
+            if (Data->OutputProcessor != nullptr) {
+                Data->OutputProcessor->Process(Data->C, StartM, StartN, CountM, CountN, ldc);
+            }
+        }
+    }
+}
+
+void
+MlasHalfGemmConvertPackBAvx2(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts fp32 matrix B to a row major fp16 matrix with CountN
+    elements per row, the layout MlasHalfGemmOperationAvx2 expects of a
+    prepacked matrix B.
+
+--*/
+{
+    for (size_t k = 0; k < CountK; k++) {
+
+        const float* b = B + k * ldb;
+        size_t n = 0;
+
+        for (; n + 8 <= CountN; n += 8) {
+            MlasHalfGemmStoreHalf8(D + n, _mm256_loadu_ps(b + n));
+        }
+
+        for (; n < CountN; n++) {
+            D[n] = _cvtss_sh(b[n], _MM_FROUND_TO_NEAREST_INT);
+        }
+
+        D += CountN;
+    }
+}
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperationAvx2,
+    nullptr,
+    MlasHalfGemmConvertPackBAvx2,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::Strides.M,
+    0
+};
@@ -0,0 +1,280 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM kernel for processors that
+    support AVX512-FP16 arithmetic.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#include <cstring>
+#include <immintrin.h>
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = true;  // copy panels of B to stay in cache
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+MLAS_FORCEINLINE
+__mmask16
+MlasHalfGemmMask16(
+    size_t Count
+    )
+{
+    return __mmask16(0xFFFF >> (16 - Count));
+}
+
+MLAS_FORCEINLINE
+__mmask32
+MlasHalfGemmMask32(
+    size_t Count
+    )
+{
+    return __mmask32(0xFFFFFFFFu >> (32 - Count));
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+void
+MlasHalfGemmConvertFloat2HalfAvx512(
+    _mlas_fp16_* D,
+    const float* S,
+    size_t lds,
+    size_t CountRow,
+    size_t CountCol
+    )
+{
+    for (size_t r = 0; r < CountRow; r++) {
+        for (size_t c = 0; c < CountCol; c += 16) {
+            const __mmask16 Mask = MlasHalfGemmMask16(std::min(CountCol - c, size_t(16)));
+            const __m512 Vector = _mm512_maskz_loadu_ps(Mask, S + c);
+            _mm256_mask_storeu_epi16(D + c, Mask, _mm512_cvtps_ph(Vector, _MM_FROUND_TO_NEAREST_INT));
+        }
+        S += lds;
+        D += CountCol;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmCopyPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    for (size_t k = 0; k < CountK; k++) {
+        std::copy_n(B, CountN, D);
+        B += ldb;
+        D += CountN;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    MlasHalfGemmConvertFloat2HalfAvx512(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    MlasHalfGemmConvertFloat2HalfAvx512(D, B, ldb, CountK, CountN);
+}
+
+template <size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Block(
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    __mmask32 LastMask,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows and up to VectorCount x 32 columns of
+    matrix C. The columns of the last vector are selected by LastMask.
+
+--*/
+{
+    __mmask32 Masks[VectorCount];
+    for (size_t v = 0; v < VectorCount; v++) {
+        Masks[v] = (v + 1 == VectorCount) ? LastMask : __mmask32(0xFFFFFFFF);
+    }
+
+    __m512h Accumulators[RowCount][VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        const __m512h BiasVector = (Bias != nullptr)
+            ? _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Masks[v], Bias + v * 32))
+            : _mm512_setzero_ph();
+        for (size_t r = 0; r < RowCount; r++) {
+            if (ZeroMode) {
+                Accumulators[r][v] = BiasVector;
+            } else {
+                const __m512h CVector = _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Masks[v], C + r * ldc + v * 32));
+                Accumulators[r][v] = _mm512_add_ph(CVector, BiasVector);
+            }
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        __m512h BVectors[VectorCount];
+        for (size_t v = 0; v < VectorCount; v++) {
+            BVectors[v] = _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Masks[v], B + v * 32));
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            _Float16 AValue;
+            std::memcpy(&AValue, A + r * lda + k, sizeof(AValue));
+            const __m512h AVector = _mm512_set1_ph(AValue);
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[r][v] = _mm512_fmadd_ph(AVector, BVectors[v], Accumulators[r][v]);
+            }
+        }
+
+        B += ldb;
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            _mm512_mask_storeu_epi16(C + r * ldc + v * 32, Masks[v], _mm512_castph_si512(Accumulators[r][v]));
+        }
+    }
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    //
+    // Step through the columns 64 at a time, then handle the remaining
+    // columns with a single, possibly partial, vector.
+    //
+
+    while (CountN > 32) {
+        const size_t CountInBlock = std::min(CountN, size_t(64));
+        MlasHalfGemmKernelAvx512Fp16Block<RowCount, 2>(
+            CountK, C, ldc, Bias, A, lda, B, ldb, MlasHalfGemmMask32(CountInBlock - 32), ZeroMode);
+        C += CountInBlock;
+        B += CountInBlock;
+        if (Bias != nullptr) {
+            Bias += CountInBlock;
+        }
+        CountN -= CountInBlock;
+    }
+
+    if (CountN > 0) {
+        MlasHalfGemmKernelAvx512Fp16Block<RowCount, 1>(
+            CountK, C, ldc, Bias, A, lda, B, ldb, MlasHalfGemmMask32(CountN), ZeroMode);
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx512Fp16Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx512Fp16Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx512Fp16Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx512Fp16Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx512Fp16Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 6:
+            MlasHalfGemmKernelAvx512Fp16Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 7:
+            MlasHalfGemmKernelAvx512Fp16Rows<7>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx512Fp16Rows<8>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0
+};
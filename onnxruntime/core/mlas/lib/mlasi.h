@@ -949,7 +949,7 @@ extern "C" {
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 #define MLAS_HGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -971,7 +971,33 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr,
+    const MLAS_SGEMM_BLOCKING* Blocking = nullptr
+    );
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    );
+
+bool
+MLASCALL
+MlasSgemmSmallBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
     );
 
 //
@@ -1065,6 +1091,51 @@ extern const MLAS_ROPE_DISPATCH MlasRopeDispatchNeon;
 struct MLAS_HGEMM_DISPATCH;
 extern const MLAS_HGEMM_DISPATCH MlasHGemmDispatchNeon;
 
+//
+// Half precision GEMM (MlasHalfGemmBatch) dispatch structure.
+//
+struct MLAS_HALFGEMM_DISPATCH;
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16;
+#endif
+
+//
+// Transcendental function (MlasComputeSin and related routines) dispatch
+// structure.
+//
+struct MLAS_TRANSCENDENTAL_DISPATCH;
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_TRANSCENDENTAL_DISPATCH MlasTranscendentalDispatchAvx2;
+extern const MLAS_TRANSCENDENTAL_DISPATCH MlasTranscendentalDispatchAvx512F;
+#endif
+
+//
+// Small matrix single precision GEMM (MlasSgemmSmallBatch) dispatch
+// structure.
+//
+struct MLAS_SGEMM_SMALL_DISPATCH;
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx2;
+extern const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx512F;
+#endif
+
+//
+// Sparse single precision GEMM (MlasSparseSgemmBatch) dispatch structure.
+//
+struct MLAS_SPARSE_SGEMM_DISPATCH;
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_SPARSE_SGEMM_DISPATCH MlasSparseSgemmDispatchAvx2;
+#endif
+
+//
+// Bfloat16 precision GEMM (MlasSBGemmBatch) dispatch structure.
+//
+struct MLAS_SBGEMM_DISPATCH;
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+#endif
+
 
 //
 // Quantized depthwise convolution kernels.
@@ -1228,6 +1299,13 @@ struct MLAS_PLATFORM {
 
     const MLAS_ROPE_DISPATCH* RopeDispatch{nullptr};
     const MLAS_HGEMM_DISPATCH* HGemmDispatch{nullptr};
+    const MLAS_TRANSCENDENTAL_DISPATCH* TranscendentalDispatch{nullptr};
+    const MLAS_SPARSE_SGEMM_DISPATCH* SparseSgemmDispatch{nullptr};
+    const MLAS_SGEMM_SMALL_DISPATCH* SgemmSmallDispatch{nullptr};
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+#endif
 };
 
 inline
@@ -1378,6 +1456,38 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd F(4x4,3x3) convolution, see convwinograd.cpp.
+//
+
+bool
+MlasConvWinogradIsSupported(
+    size_t Dimensions,
+    size_t InputChannels,
+    size_t FilterCount,
+    const size_t* KernelShape,
+    const size_t* DilationShape,
+    const size_t* StrideShape
+    );
+
+void
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
@@ -1703,6 +1813,24 @@ MlasShiftLeftInt32x4(MLAS_INT32X4 Vector)
 #endif
 }
 
+template<unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasShiftRightInt32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vshrq_n_s32(Vector, ShiftCount);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_srai_epi32(Vector, ShiftCount);
+#elif defined(MLAS_WASM_SIMD_INTRINSICS)
+    return wasm_i32x4_shr(Vector, ShiftCount);
+#elif defined(MLAS_LSX_INTRINSICS)
+    return __lsx_vsrai_w(Vector, ShiftCount);
+#else
+    return Vector >> ShiftCount;
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_INT32X4
 MlasMaximumInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
@@ -2150,6 +2278,31 @@ MlasDivideFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasSqrtFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vsqrtq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 0)), Vector, 0);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 1)), Vector, 1);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 2)), Vector, 2);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 3)), Vector, 3);
+    return Vector;
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_sqrt_ps(Vector);
+#elif defined(MLAS_WASM_SIMD_INTRINSICS)
+    return wasm_f32x4_sqrt(Vector);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return vec_sqrt(Vector);
+#elif defined(MLAS_LSX_INTRINSICS)
+    return __lsx_vfsqrt_s(Vector);
+#else
+    return MLAS_FLOAT32X4{std::sqrt(Vector[0]), std::sqrt(Vector[1]), std::sqrt(Vector[2]), std::sqrt(Vector[3])};
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasGreaterThanFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
@@ -2169,6 +2322,25 @@ MlasGreaterThanFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasEqualFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_f32_u32(vceqq_f32(Vector1, Vector2));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cmpeq_ps(Vector1, Vector2);
+#elif defined(MLAS_WASM_SIMD_INTRINSICS)
+    return wasm_f32x4_eq(Vector1, Vector2);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return MLAS_FLOAT32X4(vec_cmpeq(Vector1, Vector2));
+#elif defined(MLAS_LSX_INTRINSICS)
+    return (MLAS_FLOAT32X4)__lsx_vfcmp_ceq_s(Vector1, Vector2);
+#else
+    return Vector1 == Vector2;
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasAndFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
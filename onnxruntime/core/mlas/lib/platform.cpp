@@ -401,7 +401,18 @@ Return Value:
                 this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
                 this->CastF16ToF32Kernel = &MlasCastF16ToF32KernelAvx2;
                 this->CastF32ToF16Kernel = &MlasCastF32ToF16KernelAvx2;
+                this->TranscendentalDispatch = &MlasTranscendentalDispatchAvx2;
+                this->SparseSgemmDispatch = &MlasSparseSgemmDispatchAvx2;
+                this->SgemmSmallDispatch = &MlasSgemmSmallDispatchAvx2;
 
+                //
+                // Check if the processor supports F16C, which the half precision
+                // GEMM uses to convert its inputs for the single precision kernels.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                }
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -454,6 +465,8 @@ Return Value:
                     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
+                    this->TranscendentalDispatch = &MlasTranscendentalDispatchAvx512F;
+                    this->SgemmSmallDispatch = &MlasSgemmSmallDispatchAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
 
@@ -484,6 +497,26 @@ Return Value:
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
                             this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
                         }
+
+#if defined(MLAS_AVX512FP16_INTRINSICS_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512-FP16.
+                        //
+
+                        if ((Cpuid7[3] & 0x800000) != 0) {
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
+#endif
+
+#if defined(MLAS_AVX512BF16_INTRINSICS_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512-BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
+                        }
+#endif
                     }
                 }
 
@@ -0,0 +1,360 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements the bfloat16 precision GEMM kernel for processors
+    that support AVX512-BF16.
+
+    Matrix B is converted to bf16 and packed in panels of 16 columns, with
+    the elements of two consecutive rows interleaved so that each 32-bit lane
+    holds the pair consumed by one VDPBF16PS lane. Rows of matrix A are
+    converted to bf16 pairs in a local buffer and broadcast to the kernel.
+    The accumulation is done in fp32.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+#include <immintrin.h>
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+static_assert(MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN == 16, "a packed panel holds one vector of columns");
+
+//
+// Number of elements of matrix A converted to bf16 at a time.
+//
+constexpr size_t MLAS_SBGEMM_AVX512BF16_A_STRIDEK = 256;
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmMask16(
+    size_t Count
+    )
+{
+    return __mmask16(0xFFFF >> (16 - Count));
+}
+
+void
+MlasSBGemmConvertCopyPackBAvx512Bf16(
+    bfloat16_t* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts elements of matrix B to bf16 and copies them to the
+    packed buffer. Columns are grouped in panels of 16, and each pair of rows
+    of a panel is interleaved. The remaining columns and an odd last row are
+    padded with zeros.
+
+Arguments:
+
+    D - Supplies the address of the packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    alignas(64) static constexpr uint16_t InterleaveIndex[32] = {
+        0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23,
+        8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31,
+    };
+    const __m512i Index = _mm512_load_si512(InterleaveIndex);
+
+    for (size_t n = 0; n < CountN; n += 16) {
+
+        const __mmask16 Mask = MlasSBGemmMask16(std::min(CountN - n, size_t(16)));
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k += 2) {
+            const __m512 Row0 = _mm512_maskz_loadu_ps(Mask, b);
+            const __m512 Row1 = (k + 1 < CountK) ? _mm512_maskz_loadu_ps(Mask, b + ldb) : _mm512_setzero_ps();
+            const __m512i Rows = (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0);
+            _mm512_storeu_si512(D, _mm512_permutexvar_epi16(Index, Rows));
+            D += 32;
+            b += 2 * ldb;
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    //
+    // The non-packed driver sizes its panel buffer for a single slice along
+    // the K dimension, so the slice is packed as one block.
+    //
+
+    MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B, ldb, CountN, CountK);
+}
+
+void
+MlasSBGemmConvertPackBAvx512Bf16(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    //
+    // Pack the matrix in blocks of Strides.K rows, in the layout that
+    // MlasSBGemmPackedOperation steps through.
+    //
+
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN;
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    size_t K_block_size;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB += AlignedN * K_block_size;
+    }
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertA(
+    uint32_t* D,
+    const float* A,
+    size_t lda,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts RowCount rows of matrix A to bf16. Each 32-bit
+    element of the output holds a pair of consecutive elements of a row, and
+    an odd last element is paired with zero. The rows of the output are
+    MLAS_SBGEMM_AVX512BF16_A_STRIDEK elements apart.
+
+--*/
+{
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t k = 0; k < CountK; k += 32) {
+            const size_t Count = std::min(CountK - k, size_t(32));
+            const __mmask16 MaskLow = MlasSBGemmMask16(std::min(Count, size_t(16)));
+            const __mmask16 MaskHigh = (Count > 16) ? MlasSBGemmMask16(Count - 16) : __mmask16(0);
+            const __m512 Low = _mm512_maskz_loadu_ps(MaskLow, A + k);
+            const __m512 High = _mm512_maskz_loadu_ps(MaskHigh, A + k + 16);
+            _mm512_storeu_si512(D + k / 2, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+        }
+        A += lda;
+        D += MLAS_SBGEMM_AVX512BF16_A_STRIDEK / 2;
+    }
+}
+
+template <size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelAvx512Bf16Block(
+    size_t CountKPairs,
+    const uint32_t* A,
+    const bfloat16_t* B,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    __mmask16 LastMask,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows and up to VectorCount x 16 columns of
+    matrix C. The columns of the last vector are selected by LastMask.
+
+--*/
+{
+    __mmask16 Masks[VectorCount];
+    for (size_t v = 0; v < VectorCount; v++) {
+        Masks[v] = (v + 1 == VectorCount) ? LastMask : __mmask16(0xFFFF);
+    }
+
+    __m512 Accumulators[RowCount][VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        const __m512 BiasVector =
+            (Bias != nullptr) ? _mm512_maskz_loadu_ps(Masks[v], Bias + v * 16) : _mm512_setzero_ps();
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r][v] = ZeroMode ? BiasVector : _mm512_maskz_loadu_ps(Masks[v], C + r * ldc + v * 16);
+        }
+    }
+
+    for (size_t p = 0; p < CountKPairs; p++) {
+
+        __m512bh BVectors[VectorCount];
+        for (size_t v = 0; v < VectorCount; v++) {
+            BVectors[v] = (__m512bh)_mm512_loadu_si512(B + v * PanelStride + p * 32);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m512bh AVector =
+                (__m512bh)_mm512_set1_epi32(int(A[r * (MLAS_SBGEMM_AVX512BF16_A_STRIDEK / 2) + p]));
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[r][v] = _mm512_dpbf16_ps(Accumulators[r][v], AVector, BVectors[v]);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            _mm512_mask_storeu_ps(C + r * ldc + v * 16, Masks[v], Accumulators[r][v]);
+        }
+    }
+}
+
+template <size_t RowCount>
+void
+MlasSBGemmKernelAvx512Bf16Rows(
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+    )
+{
+    alignas(64) uint32_t PanelA[RowCount * MLAS_SBGEMM_AVX512BF16_A_STRIDEK / 2];
+
+    const size_t PanelStride = ((CountK + 1) & ~size_t(1)) * 16;
+
+    //
+    // Step through matrix A along the K dimension, converting a slice of the
+    // rows to bf16 at a time. Slices after the first accumulate into C.
+    //
+
+    size_t StrideK;
+    for (size_t k = 0; k < CountK; k += StrideK) {
+        StrideK = std::min(CountK - k, MLAS_SBGEMM_AVX512BF16_A_STRIDEK);
+        const size_t CountKPairs = (StrideK + 1) / 2;
+
+        MlasSBGemmConvertA<RowCount>(PanelA, A + k, lda, StrideK);
+
+        //
+        // Step through the columns 32 at a time, then handle the remaining
+        // columns with a single, possibly partial, vector.
+        //
+
+        const bfloat16_t* b = B + k * 16;
+        float* c = C;
+        const float* bias = (k == 0) ? Bias : nullptr;
+        const bool zero = ZeroMode && (k == 0);
+        size_t n = CountN;
+
+        while (n > 16) {
+            const size_t CountInBlock = std::min(n, size_t(32));
+            MlasSBGemmKernelAvx512Bf16Block<RowCount, 2>(
+                CountKPairs, PanelA, b, PanelStride, c, ldc, bias, MlasSBGemmMask16(CountInBlock - 16), zero);
+            b += 2 * PanelStride;
+            c += CountInBlock;
+            if (bias != nullptr) {
+                bias += CountInBlock;
+            }
+            n -= CountInBlock;
+        }
+
+        if (n > 0) {
+            MlasSBGemmKernelAvx512Bf16Block<RowCount, 1>(
+                CountKPairs, PanelA, b, PanelStride, c, ldc, bias, MlasSBGemmMask16(n), zero);
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    const size_t CountM,
+    const size_t CountN,
+    const size_t CountK,
+    const float* A,
+    const size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+
+    for (size_t m = 0; m < CountM; m += KernelMaxM) {
+        const float* a = A + m * lda;
+        float* c = C + m * ldc;
+
+        switch (std::min(CountM - m, KernelMaxM)) {
+            case 1:
+                MlasSBGemmKernelAvx512Bf16Rows<1>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            case 2:
+                MlasSBGemmKernelAvx512Bf16Rows<2>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            case 3:
+                MlasSBGemmKernelAvx512Bf16Rows<3>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            case 4:
+                MlasSBGemmKernelAvx512Bf16Rows<4>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            case 5:
+                MlasSBGemmKernelAvx512Bf16Rows<5>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            case 6:
+                MlasSBGemmKernelAvx512Bf16Rows<6>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            case 7:
+                MlasSBGemmKernelAvx512Bf16Rows<7>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+            default:
+                MlasSBGemmKernelAvx512Bf16Rows<8>(CountN, CountK, a, lda, B, c, ldc, Bias, ZeroMode);
+                break;
+        }
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackBAvx512Bf16,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0
+};
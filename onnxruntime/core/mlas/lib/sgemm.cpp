@@ -1015,7 +1015,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1051,6 +1054,15 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Epilogue - Supplies the optional epilogue to apply to the rows of the
+        output matrix as they are produced. This is only supplied for the
+        final slice along the K dimension.
+
+    StartM - Supplies the row of the output matrix relative to the epilogue.
+
+    StartN - Supplies the column of the output matrix relative to the
+        epilogue.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,6 +1083,11 @@ Return Value:
         }
 #endif
 
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, RowsHandled, CountN);
+            StartM += RowsHandled;
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1110,9 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    const MLAS_SGEMM_BLOCKING* Blocking
     )
 /*++
 
@@ -1131,14 +1150,22 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the optional epilogue to apply to matrix C.
+
+    Blocking - Supplies the optional slice sizes for matrix B, else the
+        built-in sizes are adjusted to the shape of the operation.
+
 Return Value:
 
     None.
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
-    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+    float PanelABuffer[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+    MLAS_DECLSPEC_ALIGN(float PanelBBuffer[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    float* PanelA = PanelABuffer;
+    float* PanelB = PanelBBuffer;
 
     //
     // Handle the special case of K equals zero. Apply the beta multiplier to
@@ -1147,6 +1174,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, M, N);
+        }
         return;
     }
 
@@ -1171,6 +1201,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, 1, N);
+            }
             return;
         }
 
@@ -1178,6 +1211,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, 1, N);
+            }
             return;
         }
 
@@ -1207,6 +1243,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, M, 1);
+            }
             return;
         }
 
@@ -1225,7 +1264,29 @@ Return Value:
     size_t StrideN = MLAS_SGEMM_STRIDEN;
     size_t StrideK = MLAS_SGEMM_STRIDEK;
 
-    if (N >= K) {
+    if (Blocking != nullptr) {
+
+        //
+        // Use the supplied slice sizes as is. Panels that do not fit the
+        // local buffers are allocated from the thread local buffer.
+        //
+
+        StrideN = Blocking->StrideN;
+        StrideK = Blocking->StrideK;
+
+        const size_t PanelBSize = StrideN * StrideK;
+        const size_t PanelASize = (TransA == CblasNoTrans) ? 0 : MLAS_SGEMM_TRANSA_ROWS * StrideK;
+
+        if (PanelBSize > MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK ||
+            PanelASize > MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK) {
+
+            MlasThreadedBufAlloc(UpAlignSize((PanelBSize + PanelASize) * sizeof(float)));
+
+            PanelB = reinterpret_cast<float*>(ThreadedBufHolder.get());
+            PanelA = PanelB + PanelBSize;
+        }
+
+    } else if (N >= K) {
 
         while (StrideK / 2 >= K) {
             StrideN *= 2;
@@ -1269,6 +1330,13 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            //
+            // The epilogue is applied while computing the final slice along
+            // the K dimension, as the rows of the output matrix are produced.
+            //
+
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1287,7 +1355,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, 0, n);
 
             } else {
 
@@ -1311,7 +1380,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha,
+                        ZeroMode, SliceEpilogue, M - RowsRemaining - RowsTransposed, n);
                 }
             }
 
@@ -1334,7 +1404,9 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    const MLAS_SGEMM_BLOCKING* Blocking
     )
 /*++
 
@@ -1374,6 +1446,11 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the optional epilogue to apply to matrix C.
+
+    Blocking - Supplies the optional slice sizes for matrix B. The K slice
+        size is fixed by the packed layout, so only the N slice size is used.
+
 Return Value:
 
     None.
@@ -1382,6 +1459,8 @@ Return Value:
 {
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
 
+    const size_t StrideN = (Blocking != nullptr) ? Blocking->StrideN : MLAS_SGEMM_PACKED_STRIDEN;
+
     //
     // Step through each slice of matrix B along the N dimension.
     //
@@ -1392,7 +1471,7 @@ Return Value:
 
         const size_t SliceStartN = RangeStartN + n;
 
-        CountN = std::min(RangeCountN - n, size_t(MLAS_SGEMM_PACKED_STRIDEN));
+        CountN = std::min(RangeCountN - n, StrideN);
 
         //
         // Multiply the output matrix by beta as needed.
@@ -1420,9 +1499,11 @@ Return Value:
             const float* pb = (const float*)PackedB + AlignedN * k + CountK * SliceStartN;
             float* c = C + n;
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode, SliceEpilogue, 0, n);
 
             } else {
 
@@ -1446,12 +1527,17 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha,
+                        ZeroMode, SliceEpilogue, M - RowsRemaining - RowsTransposed, n);
                 }
             }
 
             ZeroMode = false;
         }
+
+        if (K == 0 && Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C + n, ldc, 0, n, M, CountN);
+        }
     }
 }
 
@@ -1538,11 +1624,34 @@ Return Value:
     const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
     float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
 
+    //
+    // Offset the epilogue to the partitioned range of matrix C.
+    //
+
+    MLAS_SGEMM_EPILOGUE RangeEpilogue;
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr;
+
+    if (DataParams->Epilogue != nullptr) {
+
+        RangeEpilogue = *DataParams->Epilogue;
+
+        if (RangeEpilogue.Bias != nullptr) {
+            RangeEpilogue.Bias += RangeStartN;
+        }
+
+        if (RangeEpilogue.Residual != nullptr) {
+            RangeEpilogue.Residual += RangeStartM * RangeEpilogue.ldr + RangeStartN;
+        }
+
+        Epilogue = &RangeEpilogue;
+    }
+
     if (DataParams->BIsPacked) {
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc, Epilogue,
+            DataParams->Blocking);
 
     } else {
 
@@ -1551,7 +1660,8 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc, Epilogue,
+            DataParams->Blocking);
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -1573,6 +1683,15 @@ MlasGemmBatch(
     )
 {
 
+    //
+    // Use the small matrix kernels if the matrices are small enough that
+    // packing matrix B would cost as much as the multiplication.
+    //
+
+    if (MlasSgemmSmallBatch(TransA, TransB, M, N, K, Data, BatchSize, ThreadPool)) {
+        return;
+    }
+
     //
     // Compute the number of target threads given the complexity of the SGEMM
     // operation. Small requests should run using the single threaded path.
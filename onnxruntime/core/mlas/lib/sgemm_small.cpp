@@ -0,0 +1,184 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small.cpp
+
+Abstract:
+
+    This module implements the batched single precision matrix/matrix
+    multiply operation for small matrices.
+
+    The kernels in sgemm_small.h are instantiated here with the portable
+    MLAS_FLOAT32X4 policy. Processors with AVX2 or AVX512F use the kernels
+    from sgemm_small_kernel_avx2.cpp and sgemm_small_kernel_avx512f.cpp.
+
+--*/
+
+#include "sgemm_small.h"
+
+struct MLAS_SGEMM_SMALL_VECTOR_FLOAT32X4 {
+    typedef MLAS_FLOAT32X4 FloatType;
+
+    static constexpr size_t VectorLength = 4;
+    static constexpr size_t RowTile = 4;
+
+    static FloatType Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { MlasStoreFloat32x4(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+    static FloatType Zero() { return MlasZeroFloat32x4(); }
+    static FloatType Multiply(FloatType a, FloatType b) { return MlasMultiplyFloat32x4(a, b); }
+
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c)
+    {
+#if defined(MLAS_NEON64_INTRINSICS)
+        return vfmaq_f32(c, a, b);
+#else
+        return MlasMultiplyAddFloat32x4(a, b, c);
+#endif
+    }
+};
+
+static const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchDefault = {
+    MlasSgemmSmallKernel<MLAS_SGEMM_SMALL_VECTOR_FLOAT32X4>,
+};
+
+MLAS_FORCEINLINE
+const MLAS_SGEMM_SMALL_DISPATCH&
+MlasGetSgemmSmallDispatch(
+    void
+    )
+{
+    const MLAS_SGEMM_SMALL_DISPATCH* Dispatch = GetMlasPlatform().SgemmSmallDispatch;
+
+    return (Dispatch != nullptr) ? *Dispatch : MlasSgemmSmallDispatchDefault;
+}
+
+bool
+MLASCALL
+MlasSgemmSmallBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the batched single precision matrix/matrix
+    multiply operation (SGEMM) if the matrices are small enough for the small
+    matrix kernels.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies the data and layout of the operations.
+
+    BatchSize - Supplies the number of operations.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the operations were computed, else false if the caller
+    should use the general SGEMM.
+
+--*/
+{
+    if (M > MLAS_SGEMM_SMALL_MAXIMUM || N > MLAS_SGEMM_SMALL_MAXIMUM || K > MLAS_SGEMM_SMALL_MAXIMUM) {
+        return false;
+    }
+
+    //
+    // A single row is handled by the matrix/vector kernels of the general
+    // SGEMM. Tiny matrices are faster with the general SGEMM, see
+    // MLAS_SGEMM_SMALL_MINIMUM_COMPLEXITY.
+    //
+
+    if (M == 1 || M * N * K < MLAS_SGEMM_SMALL_MINIMUM_COMPLEXITY) {
+        return false;
+    }
+
+    //
+    // The kernels were only measured faster than the general SGEMM without
+    // transposes. With a transposed matrix B they were at parity at best.
+    //
+
+    if (TransA != CblasNoTrans || TransB != CblasNoTrans) {
+        return false;
+    }
+
+    //
+    // Packed matrices and explicit slice sizes are handled by the general
+    // SGEMM.
+    //
+
+    for (size_t b = 0; b < BatchSize; b++) {
+        if (Data[b].BIsPacked || Data[b].Blocking != nullptr) {
+            return false;
+        }
+    }
+
+    const MLAS_SGEMM_SMALL_DISPATCH::Kernel_Fn* Kernel = MlasGetSgemmSmallDispatch().Kernel;
+
+    //
+    // Partition the batch across the threads. The operations are not split
+    // themselves, so leave batches with fewer operations than the threads
+    // they warrant to the general SGEMM, which splits each operation.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > BatchSize) {
+        return false;
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t BatchStart;
+        size_t BatchCount;
+
+        MlasPartitionWork(tid, TargetThreadCount, BatchSize, &BatchStart, &BatchCount);
+
+        for (size_t b = BatchStart; b < BatchStart + BatchCount; b++) {
+
+            const MLAS_SGEMM_DATA_PARAMS* DataParams = &Data[b];
+
+            Kernel(TransA, TransB, M, N, K, DataParams->alpha, DataParams->A, DataParams->lda, DataParams->B,
+                DataParams->ldb, DataParams->beta, DataParams->C, DataParams->ldc);
+
+            if (DataParams->Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(DataParams->Epilogue, DataParams->C, DataParams->ldc, 0, 0, M, N);
+            }
+        }
+    });
+
+    return true;
+}
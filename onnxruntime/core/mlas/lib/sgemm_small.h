@@ -0,0 +1,500 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small.h
+
+Abstract:
+
+    This module contains the kernels of the single precision matrix/matrix
+    multiply operation for small matrices.
+
+    The kernels read matrix A and matrix B where they are, instead of packing
+    them into panels as the general SGEMM does. For matrices of at most
+    MLAS_SGEMM_SMALL_MAXIMUM rows and columns the packing is a large part of
+    the cost of the multiplication, so batches of such matrices, as produced
+    by Einsum and by attention with small heads, run faster.
+
+    The kernels are templates over a vector policy V that supplies:
+
+        FloatType       - the vector type
+        VectorLength    - the number of floats in FloatType
+        RowTile         - the number of rows of matrix C computed at once
+        Load, Store, Broadcast, Zero, Multiply, MultiplyAdd
+
+    Each instruction set instantiates the kernels with its own policy.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <algorithm>
+
+//
+// Define the maximum number of rows and columns of matrix A, matrix B and
+// matrix C for the small matrix kernels. Larger matrices were measured to be
+// at parity or slower than with the general SGEMM, which packs matrix B.
+//
+
+#define MLAS_SGEMM_SMALL_MAXIMUM                    32
+
+//
+// Define the minimum number of multiply/add operations of a single matrix for
+// the small matrix kernels. Smaller matrices are dominated by the copy of
+// matrix B and are left to the general SGEMM.
+//
+
+#define MLAS_SGEMM_SMALL_MINIMUM_COMPLEXITY         (16 * 16 * 16)
+
+//
+// Small matrix SGEMM dispatch structure.
+//
+
+struct MLAS_SGEMM_SMALL_DISPATCH {
+
+    typedef
+    void
+    (MLASCALL Kernel_Fn)(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        size_t ldc
+        );
+
+    Kernel_Fn* Kernel;
+};
+
+//
+// The accumulators of a tile only stay in registers if the loops over the
+// rows of the tile are unrolled, which the compilers do not do reliably by
+// themselves. Each step of the loop calls IterationType::Iteration<Row>.
+//
+
+template<size_t Count, size_t Row = 0>
+struct MlasSgemmSmallUnroll
+{
+    template<typename IterationType, typename... IterationArgs>
+    MLAS_FORCEINLINE
+    static
+    void
+    Loop(
+        IterationArgs&&... Arguments
+        )
+    {
+        if constexpr (Row < Count) {
+            IterationType::template Iteration<Row>(Arguments...);
+            MlasSgemmSmallUnroll<Count, Row + 1>::template Loop<IterationType>(Arguments...);
+        }
+    }
+};
+
+template<typename V, size_t Vectors>
+struct MlasSgemmSmallZeroRow
+{
+    template<size_t Row, typename AccumulatorType>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        AccumulatorType& Accumulators
+        )
+    {
+        for (size_t i = 0; i < Vectors; i++) {
+            Accumulators[Row][i] = V::Zero();
+        }
+    }
+};
+
+template<typename V, size_t Vectors>
+struct MlasSgemmSmallMultiplyAddRow
+{
+    template<size_t Row, typename AccumulatorType>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        AccumulatorType& Accumulators,
+        const typename V::FloatType* BVector,
+        const float* A,
+        size_t StrideAM
+        )
+    {
+        const typename V::FloatType ABroadcast = V::Broadcast(A[Row * StrideAM]);
+
+        for (size_t i = 0; i < Vectors; i++) {
+            Accumulators[Row][i] = V::MultiplyAdd(ABroadcast, BVector[i], Accumulators[Row][i]);
+        }
+    }
+};
+
+template<typename V, size_t Vectors>
+struct MlasSgemmSmallStoreRow
+{
+    template<size_t Row, typename AccumulatorType>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        AccumulatorType& Accumulators,
+        float* C,
+        size_t ldc,
+        size_t CountN,
+        float alpha,
+        float beta
+        )
+    {
+        constexpr size_t TileWidth = Vectors * V::VectorLength;
+
+        float* c = C + Row * ldc;
+
+        //
+        // Partial tiles are stored through a buffer.
+        //
+
+        float Buffer[TileWidth];
+        float* Output = (CountN == TileWidth) ? c : Buffer;
+
+        if (beta != 0.0f && Output == Buffer) {
+            std::copy_n(c, CountN, Buffer);
+        }
+
+        for (size_t i = 0; i < Vectors; i++) {
+
+            typename V::FloatType Vector = V::Multiply(Accumulators[Row][i], V::Broadcast(alpha));
+
+            if (beta != 0.0f) {
+                Vector = V::MultiplyAdd(V::Load(Output + i * V::VectorLength), V::Broadcast(beta), Vector);
+            }
+
+            V::Store(Output + i * V::VectorLength, Vector);
+        }
+
+        if (Output == Buffer) {
+            std::copy_n(Buffer, CountN, c);
+        }
+    }
+};
+
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallTransposeB(
+    const float* B,
+    size_t ldb,
+    size_t N,
+    size_t K,
+    float* Buffer,
+    size_t ldbuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine copies the transpose of matrix B to a buffer.
+
+Arguments:
+
+    B - Supplies the address of the N x K matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    N - Supplies the number of rows of matrix B.
+
+    K - Supplies the number of columns of matrix B.
+
+    Buffer - Supplies the address of the K x N buffer.
+
+    ldbuffer - Supplies the first dimension of the buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        const float* b = B + n * ldb;
+        size_t k = 0;
+
+        for (; k + 4 <= K; k += 4) {
+
+            MLAS_FLOAT32X4 b0 = MlasLoadFloat32x4(b + 0 * ldb + k);
+            MLAS_FLOAT32X4 b1 = MlasLoadFloat32x4(b + 1 * ldb + k);
+            MLAS_FLOAT32X4 b2 = MlasLoadFloat32x4(b + 2 * ldb + k);
+            MLAS_FLOAT32X4 b3 = MlasLoadFloat32x4(b + 3 * ldb + k);
+
+            MLAS_FLOAT32X4 t0 = MlasInterleaveLowFloat32x4(b0, b2);
+            MLAS_FLOAT32X4 t1 = MlasInterleaveHighFloat32x4(b0, b2);
+            MLAS_FLOAT32X4 t2 = MlasInterleaveLowFloat32x4(b1, b3);
+            MLAS_FLOAT32X4 t3 = MlasInterleaveHighFloat32x4(b1, b3);
+
+            float* d = Buffer + k * ldbuffer + n;
+
+            MlasStoreFloat32x4(d + 0 * ldbuffer, MlasInterleaveLowFloat32x4(t0, t2));
+            MlasStoreFloat32x4(d + 1 * ldbuffer, MlasInterleaveHighFloat32x4(t0, t2));
+            MlasStoreFloat32x4(d + 2 * ldbuffer, MlasInterleaveLowFloat32x4(t1, t3));
+            MlasStoreFloat32x4(d + 3 * ldbuffer, MlasInterleaveHighFloat32x4(t1, t3));
+        }
+
+        for (; k < K; k++) {
+            for (size_t nn = 0; nn < 4; nn++) {
+                Buffer[k * ldbuffer + n + nn] = b[nn * ldb + k];
+            }
+        }
+    }
+
+    for (; n < N; n++) {
+        for (size_t k = 0; k < K; k++) {
+            Buffer[k * ldbuffer + n] = B[n * ldb + k];
+        }
+    }
+}
+
+template<typename V, size_t Rows, size_t Vectors>
+void
+MlasSgemmSmallTile(
+    const float* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const float* B,
+    size_t ldb,
+    size_t K,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Rows rows and Vectors vectors of columns of matrix
+    C.
+
+Arguments:
+
+    A - Supplies the address of the rows of matrix A.
+
+    StrideAM - Supplies the distance between the rows of matrix A.
+
+    StrideAK - Supplies the distance between the columns of matrix A.
+
+    B - Supplies the address of the columns of matrix B. Rows of matrix B
+        have at least Vectors * VectorLength readable columns.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    C - Supplies the address of the tile of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of the tile, at most
+        Vectors * VectorLength.
+
+    alpha - Supplies the scalar multiplier of the product.
+
+    beta - Supplies the scalar multiplier of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typename V::FloatType Accumulators[Rows][Vectors];
+
+    MlasSgemmSmallUnroll<Rows>::template Loop<MlasSgemmSmallZeroRow<V, Vectors>>(Accumulators);
+
+    for (size_t k = 0; k < K; k++) {
+
+        typename V::FloatType BVector[Vectors];
+
+        for (size_t i = 0; i < Vectors; i++) {
+            BVector[i] = V::Load(B + k * ldb + i * V::VectorLength);
+        }
+
+        MlasSgemmSmallUnroll<Rows>::template Loop<MlasSgemmSmallMultiplyAddRow<V, Vectors>>(Accumulators, BVector,
+            A + k * StrideAK, StrideAM);
+    }
+
+    MlasSgemmSmallUnroll<Rows>::template Loop<MlasSgemmSmallStoreRow<V, Vectors>>(Accumulators, C, ldc, CountN,
+        alpha, beta);
+}
+
+template<typename V, size_t Vectors, size_t Rows = V::RowTile>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallRows(
+    size_t CountM,
+    const float* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const float* B,
+    size_t ldb,
+    size_t K,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine calls MlasSgemmSmallTile for CountM rows, at most RowTile.
+
+--*/
+{
+    if constexpr (Rows > 1) {
+        if (CountM < Rows) {
+            MlasSgemmSmallRows<V, Vectors, Rows - 1>(CountM, A, StrideAM, StrideAK, B, ldb, K, C, ldc, CountN,
+                alpha, beta);
+            return;
+        }
+    }
+
+    MlasSgemmSmallTile<V, Rows, Vectors>(A, StrideAM, StrideAK, B, ldb, K, C, ldc, CountN, alpha, beta);
+}
+
+template<typename V>
+void
+MLASCALL
+MlasSgemmSmallKernel(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation for matrices of at most MLAS_SGEMM_SMALL_MAXIMUM rows and
+    columns.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier of the product.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar multiplier of matrix C.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = V::VectorLength;
+    constexpr size_t PaddedMaximum = (MLAS_SGEMM_SMALL_MAXIMUM + VectorLength - 1) / VectorLength * VectorLength;
+
+    //
+    // The tiles load whole vectors from the rows of matrix B. Copy matrix B
+    // to a local buffer if it is transposed or if the last vector of a row
+    // would read past the end of matrix B.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float BBuffer[MLAS_SGEMM_SMALL_MAXIMUM * PaddedMaximum], 64);
+
+    if (TransB != CblasNoTrans || N % VectorLength != 0) {
+
+        const size_t PaddedN = (N + VectorLength - 1) / VectorLength * VectorLength;
+
+        if (TransB == CblasNoTrans) {
+            for (size_t k = 0; k < K; k++) {
+                std::copy_n(B + k * ldb, N, BBuffer + k * PaddedN);
+            }
+        } else {
+            MlasSgemmSmallTransposeB(B, ldb, N, K, BBuffer, PaddedN);
+        }
+
+        for (size_t k = 0; k < K; k++) {
+            std::fill(BBuffer + k * PaddedN + N, BBuffer + (k + 1) * PaddedN, 0.0f);
+        }
+
+        B = BBuffer;
+        ldb = PaddedN;
+    }
+
+    const size_t StrideAM = (TransA == CblasNoTrans) ? lda : 1;
+    const size_t StrideAK = (TransA == CblasNoTrans) ? 1 : lda;
+
+    //
+    // Step through the columns of matrix C two vectors at a time, then one
+    // vector at a time for the last columns.
+    //
+
+    for (size_t n = 0; n < N;) {
+
+        const size_t CountN = std::min(N - n, 2 * VectorLength);
+
+        for (size_t m = 0; m < M; m += V::RowTile) {
+
+            const size_t CountM = std::min(M - m, size_t(V::RowTile));
+            const float* a = A + m * StrideAM;
+            float* c = C + m * ldc + n;
+
+            if (CountN > VectorLength) {
+                MlasSgemmSmallRows<V, 2>(CountM, a, StrideAM, StrideAK, B + n, ldb, K, c, ldc, CountN, alpha, beta);
+            } else {
+                MlasSgemmSmallRows<V, 1>(CountM, a, StrideAM, StrideAK, B + n, ldb, K, c, ldc, CountN, alpha, beta);
+            }
+        }
+
+        n += CountN;
+    }
+}
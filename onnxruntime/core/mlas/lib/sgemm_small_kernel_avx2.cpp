@@ -0,0 +1,36 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the small matrix single precision matrix/matrix
+    multiply kernels for processors supporting AVX2 and FMA3.
+
+--*/
+
+#include "sgemm_small.h"
+
+struct MLAS_SGEMM_SMALL_VECTOR_AVX2 {
+    typedef __m256 FloatType;
+
+    static constexpr size_t VectorLength = 8;
+    static constexpr size_t RowTile = 6;
+
+    static FloatType Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { _mm256_storeu_ps(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return _mm256_set1_ps(Value); }
+    static FloatType Zero() { return _mm256_setzero_ps(); }
+    static FloatType Multiply(FloatType a, FloatType b) { return _mm256_mul_ps(a, b); }
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx2 = {
+    MlasSgemmSmallKernel<MLAS_SGEMM_SMALL_VECTOR_AVX2>,
+};
@@ -0,0 +1,36 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the small matrix single precision matrix/matrix
+    multiply kernels for processors supporting AVX512F.
+
+--*/
+
+#include "sgemm_small.h"
+
+struct MLAS_SGEMM_SMALL_VECTOR_AVX512F {
+    typedef __m512 FloatType;
+
+    static constexpr size_t VectorLength = 16;
+    static constexpr size_t RowTile = 12;
+
+    static FloatType Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { _mm512_storeu_ps(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return _mm512_set1_ps(Value); }
+    static FloatType Zero() { return _mm512_setzero_ps(); }
+    static FloatType Multiply(FloatType a, FloatType b) { return _mm512_mul_ps(a, b); }
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx512F = {
+    MlasSgemmSmallKernel<MLAS_SGEMM_SMALL_VECTOR_AVX512F>,
+};
@@ -0,0 +1,741 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.cpp
+
+Abstract:
+
+    This module implements the sparse single precision matrix/matrix multiply
+    operation (MlasSparseSgemmBatch) and the packing of its matrix B.
+
+    The kernels in sparsegemm.h are instantiated here with the portable
+    MLAS_FLOAT32X4 policy. Processors with AVX2 use the kernels from
+    sparsegemm_kernel_avx2.cpp.
+
+--*/
+
+#include "sparsegemm.h"
+
+#include <limits>
+
+//
+// Define the cost of the sparse formats relative to the dense SGEMM for the
+// same number of multiply-adds, as measured with AVX2 for matrices of 64 rows
+// and more. The panels of the sparse formats are one vector wide and read an
+// index for every block, while the dense kernel computes two vectors for
+// every broadcast. Matrices of few rows favor the sparse formats, but the
+// number of rows is not known when matrix B is packed.
+//
+
+#define MLAS_SPARSE_SGEMM_BLOCK1X8_COST             4.5f
+#define MLAS_SPARSE_SGEMM_BLOCK4X8_COST             5.5f
+#define MLAS_SPARSE_SGEMM_STRUCTURED2X4_COST        4.5f
+
+struct MLAS_SPARSE_SGEMM_VECTOR_FLOAT32X4 {
+    typedef MLAS_FLOAT32X4 FloatType;
+
+    static constexpr size_t VectorLength = 4;
+    static constexpr size_t RowTile = 4;
+
+    static FloatType Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { MlasStoreFloat32x4(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+    static FloatType Zero() { return MlasZeroFloat32x4(); }
+    static FloatType Add(FloatType a, FloatType b) { return MlasAddFloat32x4(a, b); }
+    static FloatType Multiply(FloatType a, FloatType b) { return MlasMultiplyFloat32x4(a, b); }
+
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c)
+    {
+#if defined(MLAS_NEON64_INTRINSICS)
+        return vfmaq_f32(c, a, b);
+#else
+        return MlasMultiplyAddFloat32x4(a, b, c);
+#endif
+    }
+
+    //
+    // The base instruction sets have no variable lane permute, so the 2:4
+    // positions are decoded to scalars and the elements of matrix A gathered
+    // through a buffer.
+    //
+
+    typedef const float* QuadType;
+
+    struct IndexType {
+        uint8_t Lane[VectorLength];
+    };
+
+    static QuadType LoadQuad(const float* A) { return A; }
+
+    static void LoadIndices(const uint8_t* Indices, IndexType& Index0, IndexType& Index1)
+    {
+        for (size_t i = 0; i < VectorLength; i++) {
+            Index0.Lane[i] = Indices[i] & 3;
+            Index1.Lane[i] = Indices[i] >> 2;
+        }
+    }
+
+    static FloatType Select(QuadType Quad, const IndexType& Index)
+    {
+        float Buffer[VectorLength];
+
+        for (size_t i = 0; i < VectorLength; i++) {
+            Buffer[i] = Quad[Index.Lane[i]];
+        }
+
+        return MlasLoadFloat32x4(Buffer);
+    }
+};
+
+using MLAS_SPARSE_SGEMM_VECTOR = MLAS_SPARSE_SGEMM_VECTOR_FLOAT32X4;
+
+static const MLAS_SPARSE_SGEMM_DISPATCH MlasSparseSgemmDispatchDefault = {
+    MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_VECTOR, 1>,
+    MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_VECTOR, 4>,
+    MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_VECTOR, 0>,
+};
+
+MLAS_FORCEINLINE
+const MLAS_SPARSE_SGEMM_DISPATCH&
+MlasGetSparseSgemmDispatch(
+    void
+    )
+{
+    const MLAS_SPARSE_SGEMM_DISPATCH* Dispatch = GetMlasPlatform().SparseSgemmDispatch;
+
+    return (Dispatch != nullptr) ? *Dispatch : MlasSparseSgemmDispatchDefault;
+}
+
+//
+// Accessor for the elements of an optionally transposed matrix B.
+//
+
+struct MLAS_SPARSE_SGEMM_SOURCE {
+    const float* B;
+    size_t ldb;
+    bool Transposed;
+
+    float operator()(size_t k, size_t n) const
+    {
+        return Transposed ? B[n * ldb + k] : B[k * ldb + n];
+    }
+
+    bool IsZeroBlock(size_t RowStart, size_t RowEnd, size_t ColumnStart, size_t ColumnEnd) const
+    {
+        for (size_t k = RowStart; k < RowEnd; k++) {
+            for (size_t n = ColumnStart; n < ColumnEnd; n++) {
+                if ((*this)(k, n) != 0.0f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+static
+size_t
+MlasSparseSgemmFormatBlockK(
+    MLAS_SPARSE_SGEMM_FORMAT Format
+    )
+{
+    switch (Format) {
+        case MlasSparseSgemmBlock1x8:
+            return 1;
+        case MlasSparseSgemmBlock4x8:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+static
+size_t
+MlasSparseSgemmAlignOffset(
+    size_t Offset,
+    size_t Alignment
+    )
+{
+    return (Offset + Alignment - 1) / Alignment * Alignment;
+}
+
+static
+size_t
+MlasSparseSgemmLayout(
+    MLAS_SPARSE_SGEMM_FORMAT Format,
+    const MLAS_SPARSE_SGEMM_SOURCE& Source,
+    size_t N,
+    size_t K,
+    MLAS_SPARSE_SGEMM_PACKED_HEADER* Header
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the header of a packed sparse matrix B.
+
+Arguments:
+
+    Format - Supplies the sparse format.
+
+    Source - Supplies matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    Header - Returns the header of the packed matrix.
+
+Return Value:
+
+    Returns the size of the packed matrix in bytes, or 0 if matrix B cannot
+    be packed in the format.
+
+--*/
+{
+    if (N == 0 || K == 0 || K > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_SPARSE_SGEMM_PANEL_WIDTH);
+    const size_t BlockK = MlasSparseSgemmFormatBlockK(Format);
+
+    *Header = MLAS_SPARSE_SGEMM_PACKED_HEADER{};
+    Header->Format = uint32_t(Format);
+    Header->BlockK = uint32_t(BlockK);
+    Header->N = N;
+    Header->K = K;
+    Header->PanelCount = PanelCount;
+
+    if (Format == MlasSparseSgemmStructured2x4) {
+
+        for (size_t n = 0; n < N; n++) {
+            for (size_t k = 0; k < K; k += 4) {
+                size_t NonZeroCount = 0;
+                for (size_t q = k; q < std::min(k + 4, K); q++) {
+                    NonZeroCount += (Source(q, n) != 0.0f);
+                }
+                if (NonZeroCount > 2) {
+                    return 0;
+                }
+            }
+        }
+
+        const size_t GroupCount = MlasDivRoundup(K, 4);
+
+        Header->IndexOffset = sizeof(MLAS_SPARSE_SGEMM_PACKED_HEADER);
+        Header->ValueOffset = MlasSparseSgemmAlignOffset(
+            Header->IndexOffset + PanelCount * GroupCount * MLAS_SPARSE_SGEMM_PANEL_WIDTH,
+            MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT);
+
+        return Header->ValueOffset + PanelCount * GroupCount * 2 * MLAS_SPARSE_SGEMM_PANEL_WIDTH * sizeof(float);
+    }
+
+    if (K < BlockK) {
+        return 0;
+    }
+
+    size_t BlockCount = 0;
+
+    for (size_t Panel = 0; Panel < PanelCount; Panel++) {
+        const size_t ColumnStart = Panel * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+        const size_t ColumnEnd = std::min(ColumnStart + MLAS_SPARSE_SGEMM_PANEL_WIDTH, N);
+        for (size_t k = 0; k < K; k += BlockK) {
+            BlockCount += !Source.IsZeroBlock(k, std::min(k + BlockK, K), ColumnStart, ColumnEnd);
+        }
+    }
+
+    if (BlockCount > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    Header->BlockCount = BlockCount;
+    Header->PanelBlockStartOffset = sizeof(MLAS_SPARSE_SGEMM_PACKED_HEADER);
+    Header->BlockRowOffset = Header->PanelBlockStartOffset + (PanelCount + 1) * sizeof(uint32_t);
+    Header->ValueOffset = MlasSparseSgemmAlignOffset(Header->BlockRowOffset + BlockCount * sizeof(uint32_t),
+        MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT);
+
+    return Header->ValueOffset + BlockCount * BlockK * MLAS_SPARSE_SGEMM_PANEL_WIDTH * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSparseSgemmAnalyzeB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    MLAS_SPARSE_SGEMM_ANALYSIS* Analysis
+    )
+/*++
+
+Routine Description:
+
+    This routine measures the sparsity of matrix B for the sparse formats.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    Analysis - Returns the sparsity of matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    *Analysis = MLAS_SPARSE_SGEMM_ANALYSIS{};
+
+    if (N == 0 || K == 0) {
+        return;
+    }
+
+    const MLAS_SPARSE_SGEMM_SOURCE Source{B, ldb, TransB == CblasTrans};
+
+    size_t ZeroCount = 0;
+    bool Structured2x4 = true;
+
+    for (size_t n = 0; n < N; n++) {
+        for (size_t k = 0; k < K; k += 4) {
+            size_t NonZeroCount = 0;
+            for (size_t q = k; q < std::min(k + 4, K); q++) {
+                NonZeroCount += (Source(q, n) != 0.0f);
+            }
+            ZeroCount += std::min(k + 4, K) - k - NonZeroCount;
+            Structured2x4 = Structured2x4 && (NonZeroCount <= 2);
+        }
+    }
+
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_SPARSE_SGEMM_PANEL_WIDTH);
+    size_t ZeroBlockCount1x8 = 0;
+    size_t ZeroBlockCount4x8 = 0;
+
+    for (size_t Panel = 0; Panel < PanelCount; Panel++) {
+
+        const size_t ColumnStart = Panel * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+        const size_t ColumnEnd = std::min(ColumnStart + MLAS_SPARSE_SGEMM_PANEL_WIDTH, N);
+
+        for (size_t k = 0; k < K; k += 4) {
+
+            bool ZeroBlock4x8 = true;
+
+            for (size_t q = k; q < std::min(k + 4, K); q++) {
+                const bool ZeroBlock1x8 = Source.IsZeroBlock(q, q + 1, ColumnStart, ColumnEnd);
+                ZeroBlockCount1x8 += ZeroBlock1x8;
+                ZeroBlock4x8 = ZeroBlock4x8 && ZeroBlock1x8;
+            }
+
+            ZeroBlockCount4x8 += ZeroBlock4x8;
+        }
+    }
+
+    Analysis->ZeroFraction = float(double(ZeroCount) / (double(N) * double(K)));
+    Analysis->ZeroBlockFraction1x8 = float(double(ZeroBlockCount1x8) / (double(PanelCount) * double(K)));
+    Analysis->ZeroBlockFraction4x8 =
+        float(double(ZeroBlockCount4x8) / (double(PanelCount) * double(MlasDivRoundup(K, 4))));
+    Analysis->Structured2x4 = Structured2x4;
+}
+
+bool
+MLASCALL
+MlasSparseSgemmSelectFormat(
+    const MLAS_SPARSE_SGEMM_ANALYSIS* Analysis,
+    float MinimumSparsity,
+    MLAS_SPARSE_SGEMM_FORMAT* Format
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the sparse format with the lowest estimated cost for
+    matrix B.
+
+Arguments:
+
+    Analysis - Supplies the sparsity of matrix B.
+
+    MinimumSparsity - Supplies the fraction of matrix B that a sparse format
+        must skip to be selected.
+
+    Format - Returns the selected format.
+
+Return Value:
+
+    Returns true if a sparse format is estimated to run faster than the dense
+    SGEMM, else false.
+
+--*/
+{
+    struct {
+        MLAS_SPARSE_SGEMM_FORMAT Format;
+        float Sparsity;
+        float Cost;
+        bool Supported;
+    } Candidates[] = {
+        {MlasSparseSgemmBlock1x8, Analysis->ZeroBlockFraction1x8, MLAS_SPARSE_SGEMM_BLOCK1X8_COST, true},
+        {MlasSparseSgemmBlock4x8, Analysis->ZeroBlockFraction4x8, MLAS_SPARSE_SGEMM_BLOCK4X8_COST, true},
+        {MlasSparseSgemmStructured2x4, 0.5f, MLAS_SPARSE_SGEMM_STRUCTURED2X4_COST, Analysis->Structured2x4},
+    };
+
+    //
+    // The dense SGEMM has a cost of 1.
+    //
+
+    float BestCost = 1.0f;
+    bool Selected = false;
+
+    for (const auto& Candidate : Candidates) {
+
+        if (!Candidate.Supported || Candidate.Sparsity < MinimumSparsity) {
+            continue;
+        }
+
+        const float Cost = (1.0f - Candidate.Sparsity) * Candidate.Cost;
+
+        if (Cost < BestCost) {
+            BestCost = Cost;
+            *Format = Candidate.Format;
+            Selected = true;
+        }
+    }
+
+    return Selected;
+}
+
+size_t
+MLASCALL
+MlasSparseSgemmPackBSize(
+    MLAS_SPARSE_SGEMM_FORMAT Format,
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes of matrix B packed in a sparse
+    format.
+
+Arguments:
+
+    Format - Supplies the sparse format.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed matrix, or 0 if matrix B cannot be
+    packed in the format.
+
+--*/
+{
+    MLAS_SPARSE_SGEMM_PACKED_HEADER Header;
+
+    return MlasSparseSgemmLayout(Format, MLAS_SPARSE_SGEMM_SOURCE{B, ldb, TransB == CblasTrans}, N, K, &Header);
+}
+
+void
+MLASCALL
+MlasSparseSgemmPackB(
+    MLAS_SPARSE_SGEMM_FORMAT Format,
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B in a sparse format.
+
+Arguments:
+
+    Format - Supplies the sparse format.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the buffer of MlasSparseSgemmPackBSize bytes that
+        receives the packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SPARSE_SGEMM_SOURCE Source{B, ldb, TransB == CblasTrans};
+
+    MLAS_SPARSE_SGEMM_PACKED_HEADER Header;
+    const size_t PackedBSize = MlasSparseSgemmLayout(Format, Source, N, K, &Header);
+
+    if (PackedBSize == 0) {
+        MLAS_THROW_EX(std::invalid_argument, "Matrix B cannot be packed in the sparse format");
+    }
+
+    //
+    // Zero the padding between the arrays so that the packed buffer has the
+    // same contents for the same matrix.
+    //
+
+    uint8_t* Base = static_cast<uint8_t*>(PackedB);
+    std::fill_n(Base, PackedBSize, uint8_t(0));
+    std::copy_n(reinterpret_cast<const uint8_t*>(&Header), sizeof(Header), Base);
+
+    float* Values = reinterpret_cast<float*>(Base + Header.ValueOffset);
+
+    if (Format == MlasSparseSgemmStructured2x4) {
+
+        const size_t GroupCount = MlasDivRoundup(K, 4);
+        uint8_t* Indices = Base + Header.IndexOffset;
+
+        for (size_t Panel = 0; Panel < Header.PanelCount; Panel++) {
+
+            for (size_t g = 0; g < GroupCount; g++) {
+
+                for (size_t c = 0; c < MLAS_SPARSE_SGEMM_PANEL_WIDTH; c++) {
+
+                    const size_t n = Panel * MLAS_SPARSE_SGEMM_PANEL_WIDTH + c;
+
+                    //
+                    // Use the first non-zero elements of the group, followed
+                    // by zero elements at distinct positions for columns with
+                    // fewer than 2 non-zero elements and for the padding.
+                    //
+
+                    uint8_t Position[2] = {0, 1};
+                    float Value[2] = {0.0f, 0.0f};
+                    size_t Count = 0;
+
+                    if (n < N) {
+                        for (size_t q = 0; q < 4 && g * 4 + q < K; q++) {
+                            const float v = Source(g * 4 + q, n);
+                            if (v != 0.0f) {
+                                Position[Count] = uint8_t(q);
+                                Value[Count] = v;
+                                Count++;
+                            }
+                        }
+                    }
+
+                    if (Count == 1) {
+                        Position[1] = (Position[0] == 0) ? 1 : 0;
+                    }
+
+                    Indices[g * MLAS_SPARSE_SGEMM_PANEL_WIDTH + c] = uint8_t(Position[0] | (Position[1] << 2));
+                    Values[(g * 2 + 0) * MLAS_SPARSE_SGEMM_PANEL_WIDTH + c] = Value[0];
+                    Values[(g * 2 + 1) * MLAS_SPARSE_SGEMM_PANEL_WIDTH + c] = Value[1];
+                }
+            }
+
+            Indices += GroupCount * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+            Values += GroupCount * 2 * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+        }
+
+        return;
+    }
+
+    const size_t BlockK = Header.BlockK;
+    uint32_t* PanelBlockStart = reinterpret_cast<uint32_t*>(Base + Header.PanelBlockStartOffset);
+    uint32_t* BlockRow = reinterpret_cast<uint32_t*>(Base + Header.BlockRowOffset);
+    size_t BlockCount = 0;
+
+    for (size_t Panel = 0; Panel < Header.PanelCount; Panel++) {
+
+        const size_t ColumnStart = Panel * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+        const size_t ColumnEnd = std::min(ColumnStart + MLAS_SPARSE_SGEMM_PANEL_WIDTH, N);
+
+        PanelBlockStart[Panel] = uint32_t(BlockCount);
+
+        for (size_t k = 0; k < K; k += BlockK) {
+
+            const size_t RowEnd = std::min(k + BlockK, K);
+
+            if (Source.IsZeroBlock(k, RowEnd, ColumnStart, ColumnEnd)) {
+                continue;
+            }
+
+            //
+            // Move the last block of a matrix with K not a multiple of BlockK
+            // back so that the kernel reads no element after the end of a row
+            // of matrix A. The rows that overlap the previous block stay zero.
+            //
+
+            const size_t BlockStart = std::min(k, K - BlockK);
+            float* BlockValues = Values + BlockCount * BlockK * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+
+            for (size_t q = k; q < RowEnd; q++) {
+                for (size_t n = ColumnStart; n < ColumnEnd; n++) {
+                    BlockValues[(q - BlockStart) * MLAS_SPARSE_SGEMM_PANEL_WIDTH + (n - ColumnStart)] = Source(q, n);
+                }
+            }
+
+            BlockRow[BlockCount] = uint32_t(BlockStart);
+            BlockCount++;
+        }
+    }
+
+    PanelBlockStart[Header.PanelCount] = uint32_t(BlockCount);
+}
+
+void
+MLASCALL
+MlasSparseSgemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SPARSE_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the batched single precision matrix/matrix
+    multiply operation with sparse matrices B.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies the parameters of each multiplication.
+
+    BatchSize - Supplies the number of multiplications.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    const auto* Header = static_cast<const MLAS_SPARSE_SGEMM_PACKED_HEADER*>(Data[0].PackedB);
+
+    if (Header->N != N || Header->K != K) {
+        MLAS_THROW_EX(std::invalid_argument, "Packed sparse matrix B does not match the GEMM shape");
+    }
+
+    //
+    // Compute the number of target threads given the number of multiply-adds
+    // that are not skipped.
+    //
+
+    double Density = 0.5;
+
+    if (Header->Format != MlasSparseSgemmStructured2x4) {
+        Density = double(Header->BlockCount) * double(Header->BlockK) / (double(Header->PanelCount) * double(K));
+    }
+
+    const double Complexity = double(M) * double(N) * double(K) * Density;
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment each multiplication across the panels of matrix B first, so
+    // that each thread reads a separate part of matrix B, and then across the
+    // rows of matrix A.
+    //
+
+    const size_t PanelCount = Header->PanelCount;
+    const ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
+    ptrdiff_t ThreadCountN = std::min(ThreadsPerGemm, ptrdiff_t(PanelCount));
+    ptrdiff_t ThreadCountM = std::min(ThreadsPerGemm / ThreadCountN, ptrdiff_t(M));
+
+    MLAS_SPARSE_SGEMM_DISPATCH::Kernel_Fn* Kernel;
+
+    switch (MLAS_SPARSE_SGEMM_FORMAT(Header->Format)) {
+        case MlasSparseSgemmBlock1x8:
+            Kernel = MlasGetSparseSgemmDispatch().Block1x8;
+            break;
+        case MlasSparseSgemmBlock4x8:
+            Kernel = MlasGetSparseSgemmDispatch().Block4x8;
+            break;
+        case MlasSparseSgemmStructured2x4:
+            Kernel = MlasGetSparseSgemmDispatch().Structured2x4;
+            break;
+        default:
+            MLAS_THROW_EX(std::invalid_argument, "Unknown sparse matrix B format");
+    }
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadCountM * ThreadCountN * ptrdiff_t(BatchSize),
+        [&](ptrdiff_t tid)
+    {
+        const ptrdiff_t ThreadsPerGemmUsed = ThreadCountM * ThreadCountN;
+        const MLAS_SPARSE_SGEMM_DATA_PARAMS& DataParams = Data[tid / ThreadsPerGemmUsed];
+        const ptrdiff_t ThreadIdx = tid % ThreadsPerGemmUsed;
+
+        size_t RangeStartM;
+        size_t RangeCountM;
+        size_t RangeStartN;
+        size_t RangeCountN;
+
+        MlasPartitionWork(ThreadIdx / ThreadCountN, ThreadCountM, M, &RangeStartM, &RangeCountM);
+        MlasPartitionWork(ThreadIdx % ThreadCountN, ThreadCountN, PanelCount, &RangeStartN, &RangeCountN);
+
+        Kernel(DataParams.A + RangeStartM * DataParams.lda, DataParams.lda,
+            static_cast<const MLAS_SPARSE_SGEMM_PACKED_HEADER*>(DataParams.PackedB), RangeStartN,
+            RangeStartN + RangeCountN, DataParams.C + RangeStartM * DataParams.ldc, DataParams.ldc, RangeCountM,
+            DataParams.alpha, DataParams.beta);
+    });
+}
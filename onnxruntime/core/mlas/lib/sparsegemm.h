@@ -0,0 +1,561 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.h
+
+Abstract:
+
+    This module includes the packed matrix layout, the dispatch structure and
+    the kernels for the sparse single precision matrix/matrix multiply
+    operation (MlasSparseSgemmBatch).
+
+    Matrix B is split into panels of 8 columns. A block sparse matrix stores
+    the non-zero 1x8 or 4x8 blocks of each panel with their starting row. A
+    2:4 structured sparse matrix stores, for each group of 4 rows of a panel,
+    the 2 values of each column that may be non-zero and their positions in
+    the group.
+
+    The kernels are written once against a vector policy class, like the
+    transcendental kernels. sparsegemm.cpp instantiates them with the portable
+    MLAS_FLOAT32X4 policy and sparsegemm_kernel_avx2.cpp with a 256-bit
+    policy. A vector policy provides:
+
+        FloatType, VectorLength, RowTile
+        Load, Store, Broadcast, Zero, Add, Multiply, MultiplyAdd
+        QuadType, IndexType, LoadQuad, LoadIndices, Select
+
+    LoadQuad loads 4 consecutive elements of a row of matrix A, LoadIndices
+    decodes the positions of the 2:4 values of VectorLength columns and Select
+    picks the element of the quad at the position of each lane.
+
+    The kernels copy tiles of RowTile rows of matrix A to a buffer that stays
+    in the cache while the panels of matrix B are multiplied with it. The
+    sparse panels read matrix A at scattered rows, which would otherwise miss
+    the cache for most of the reads.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <algorithm>
+
+//
+// Define the number of columns in a panel of a packed sparse matrix B.
+//
+
+#define MLAS_SPARSE_SGEMM_PANEL_WIDTH               8
+
+//
+// Define the size of matrix A in bytes that is kept in the cache while the
+// panels of matrix B are multiplied with it.
+//
+
+#define MLAS_SPARSE_SGEMM_A_CACHE_SIZE              (size_t(128) * size_t(1024))
+
+//
+// Header of a packed sparse matrix B. The arrays follow the header at the
+// byte offsets given here:
+//
+//     Block formats:
+//         uint32_t PanelBlockStart[PanelCount + 1]   first block of each panel
+//         uint32_t BlockRow[BlockCount]              starting row of each block
+//         float Values[BlockCount][BlockK][8]
+//
+//     2:4 structured format:
+//         uint8_t Indices[PanelCount][GroupCount][8] position0 | position1 << 2
+//         float Values[PanelCount][GroupCount][2][8]
+//
+// The starting row of a 4x8 block is at most K - 4, so the last block of a
+// panel may overlap the previous one. The rows of the overlap are zero in the
+// last block.
+//
+
+struct MLAS_SPARSE_SGEMM_PACKED_HEADER {
+    uint32_t Format;
+    uint32_t BlockK;
+    size_t N;
+    size_t K;
+    size_t PanelCount;
+    size_t BlockCount;
+    size_t PanelBlockStartOffset;
+    size_t BlockRowOffset;
+    size_t IndexOffset;
+    size_t ValueOffset;
+};
+
+struct MLAS_SPARSE_SGEMM_DISPATCH {
+    typedef void(Kernel_Fn)(
+        const float* A,
+        size_t lda,
+        const MLAS_SPARSE_SGEMM_PACKED_HEADER* PackedB,
+        size_t PanelStart,
+        size_t PanelEnd,
+        float* C,
+        size_t ldc,
+        size_t CountM,
+        float alpha,
+        float beta
+    );
+
+    Kernel_Fn* Block1x8 = nullptr;
+    Kernel_Fn* Block4x8 = nullptr;
+    Kernel_Fn* Structured2x4 = nullptr;
+};
+
+template<typename V, size_t Rows>
+MLAS_FORCEINLINE
+void
+MlasSparseSgemmStorePanel(
+    typename V::FloatType Accumulators[Rows][MLAS_SPARSE_SGEMM_PANEL_WIDTH / V::VectorLength],
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine stores alpha times the accumulators of a panel, plus beta
+    times the existing contents of matrix C when beta is non-zero.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators of each row of the panel.
+
+    C - Supplies the address of the panel of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of the panel in matrix C.
+
+    alpha - Supplies the scalar multiplier of the accumulators.
+
+    beta - Supplies the scalar multiplier of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t Vectors = MLAS_SPARSE_SGEMM_PANEL_WIDTH / V::VectorLength;
+
+    const typename V::FloatType AlphaBroadcast = V::Broadcast(alpha);
+    const typename V::FloatType BetaBroadcast = V::Broadcast(beta);
+
+    for (size_t r = 0; r < Rows; r++) {
+
+        float* c = C + r * ldc;
+        float Buffer[MLAS_SPARSE_SGEMM_PANEL_WIDTH];
+
+        //
+        // A partial panel goes through a buffer so that the columns of matrix
+        // C after the panel are neither read nor written.
+        //
+
+        float* Output = (CountN == MLAS_SPARSE_SGEMM_PANEL_WIDTH) ? c : Buffer;
+
+        if (beta != 0.0f && Output == Buffer) {
+            std::copy_n(c, CountN, Buffer);
+        }
+
+        for (size_t i = 0; i < Vectors; i++) {
+
+            typename V::FloatType Result = V::Multiply(Accumulators[r][i], AlphaBroadcast);
+
+            if (beta != 0.0f) {
+                Result = V::MultiplyAdd(V::Load(Output + i * V::VectorLength), BetaBroadcast, Result);
+            }
+
+            V::Store(Output + i * V::VectorLength, Result);
+        }
+
+        if (Output == Buffer) {
+            std::copy_n(Buffer, CountN, c);
+        }
+    }
+}
+
+template<typename V, size_t BlockK, size_t Rows>
+MLAS_FORCEINLINE
+void
+MlasSparseSgemmBlockPanel(
+    const float* PackedA,
+    const uint32_t* BlockRow,
+    const float* Values,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies Rows rows of matrix A with a panel of a block
+    sparse matrix B.
+
+Arguments:
+
+    PackedA - Supplies the rows of matrix A, with element (k, r) at
+        PackedA[k * V::RowTile + r].
+
+    BlockRow - Supplies the starting row of each block of the panel.
+
+    Values - Supplies the values of the blocks of the panel.
+
+    BlockCount - Supplies the number of blocks of the panel.
+
+    C - Supplies the address of the panel of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of the panel in matrix C.
+
+    alpha - Supplies the scalar multiplier of the product.
+
+    beta - Supplies the scalar multiplier of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t Vectors = MLAS_SPARSE_SGEMM_PANEL_WIDTH / V::VectorLength;
+    constexpr size_t BlockSize = BlockK * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+
+    //
+    // Few rows give few independent multiply-add chains, so alternate the
+    // blocks between two sets of accumulators to hide the latency.
+    //
+
+    constexpr size_t Sets = (Rows * Vectors <= 4) ? 2 : 1;
+
+    typename V::FloatType Accumulators[Sets][Rows][Vectors];
+
+    for (size_t s = 0; s < Sets; s++) {
+        for (size_t r = 0; r < Rows; r++) {
+            for (size_t i = 0; i < Vectors; i++) {
+                Accumulators[s][r][i] = V::Zero();
+            }
+        }
+    }
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const size_t s = (Sets == 2) ? (b & 1) : 0;
+        const float* a = PackedA + BlockRow[b] * V::RowTile;
+        const float* v = Values + b * BlockSize;
+
+        for (size_t kk = 0; kk < BlockK; kk++) {
+
+            typename V::FloatType BlockVector[Vectors];
+
+            for (size_t i = 0; i < Vectors; i++) {
+                BlockVector[i] = V::Load(v + kk * MLAS_SPARSE_SGEMM_PANEL_WIDTH + i * V::VectorLength);
+            }
+
+            for (size_t r = 0; r < Rows; r++) {
+
+                const typename V::FloatType ABroadcast = V::Broadcast(a[kk * V::RowTile + r]);
+
+                for (size_t i = 0; i < Vectors; i++) {
+                    Accumulators[s][r][i] = V::MultiplyAdd(ABroadcast, BlockVector[i], Accumulators[s][r][i]);
+                }
+            }
+        }
+    }
+
+    if constexpr (Sets == 2) {
+        for (size_t r = 0; r < Rows; r++) {
+            for (size_t i = 0; i < Vectors; i++) {
+                Accumulators[0][r][i] = V::Add(Accumulators[0][r][i], Accumulators[1][r][i]);
+            }
+        }
+    }
+
+    MlasSparseSgemmStorePanel<V, Rows>(Accumulators[0], C, ldc, CountN, alpha, beta);
+}
+
+template<typename V, size_t Rows>
+MLAS_FORCEINLINE
+void
+MlasSparseSgemmStructured2x4Panel(
+    const float* PackedA,
+    size_t PaddedK,
+    const uint8_t* Indices,
+    const float* Values,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies Rows rows of matrix A with a panel of a 2:4
+    structured sparse matrix B.
+
+Arguments:
+
+    PackedA - Supplies the rows of matrix A, with element (k, r) at
+        PackedA[r * PaddedK + k].
+
+    PaddedK - Supplies the number of columns of matrix A rounded up to a
+        multiple of 4. The padding columns are zero.
+
+    Indices - Supplies the positions of the values of the panel.
+
+    Values - Supplies the values of the panel.
+
+    C - Supplies the address of the panel of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of the panel in matrix C.
+
+    alpha - Supplies the scalar multiplier of the product.
+
+    beta - Supplies the scalar multiplier of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t Vectors = MLAS_SPARSE_SGEMM_PANEL_WIDTH / V::VectorLength;
+
+    //
+    // Few rows give few independent multiply-add chains, so accumulate the
+    // two values of each group into separate sets of accumulators.
+    //
+
+    constexpr size_t Sets = (Rows * Vectors <= 4) ? 2 : 1;
+
+    typename V::FloatType Accumulators[Sets][Rows][Vectors];
+
+    for (size_t s = 0; s < Sets; s++) {
+        for (size_t r = 0; r < Rows; r++) {
+            for (size_t i = 0; i < Vectors; i++) {
+                Accumulators[s][r][i] = V::Zero();
+            }
+        }
+    }
+
+    for (size_t k = 0; k < PaddedK; k += 4) {
+
+        typename V::IndexType Index0[Vectors];
+        typename V::IndexType Index1[Vectors];
+        typename V::FloatType Value0[Vectors];
+        typename V::FloatType Value1[Vectors];
+
+        for (size_t i = 0; i < Vectors; i++) {
+            V::LoadIndices(Indices + i * V::VectorLength, Index0[i], Index1[i]);
+            Value0[i] = V::Load(Values + i * V::VectorLength);
+            Value1[i] = V::Load(Values + MLAS_SPARSE_SGEMM_PANEL_WIDTH + i * V::VectorLength);
+        }
+
+        for (size_t r = 0; r < Rows; r++) {
+
+            const typename V::QuadType Quad = V::LoadQuad(PackedA + r * PaddedK + k);
+
+            for (size_t i = 0; i < Vectors; i++) {
+                Accumulators[0][r][i] = V::MultiplyAdd(V::Select(Quad, Index0[i]), Value0[i], Accumulators[0][r][i]);
+                Accumulators[Sets - 1][r][i] =
+                    V::MultiplyAdd(V::Select(Quad, Index1[i]), Value1[i], Accumulators[Sets - 1][r][i]);
+            }
+        }
+
+        Indices += MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+        Values += 2 * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+    }
+
+    if constexpr (Sets == 2) {
+        for (size_t r = 0; r < Rows; r++) {
+            for (size_t i = 0; i < Vectors; i++) {
+                Accumulators[0][r][i] = V::Add(Accumulators[0][r][i], Accumulators[1][r][i]);
+            }
+        }
+    }
+
+    MlasSparseSgemmStorePanel<V, Rows>(Accumulators[0], C, ldc, CountN, alpha, beta);
+}
+
+template<typename V, size_t BlockK, size_t Rows = V::RowTile>
+MLAS_FORCEINLINE
+void
+MlasSparseSgemmPanel(
+    size_t CountRows,
+    const float* PackedA,
+    const MLAS_SPARSE_SGEMM_PACKED_HEADER* PackedB,
+    size_t Panel,
+    float* C,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies CountRows rows of matrix A, at most RowTile, with
+    a panel of a packed sparse matrix B. BlockK is 0 for the 2:4 structured
+    format.
+
+--*/
+{
+    if constexpr (Rows > 1) {
+        if (CountRows < Rows) {
+            MlasSparseSgemmPanel<V, BlockK, Rows - 1>(CountRows, PackedA, PackedB, Panel, C, ldc, alpha, beta);
+            return;
+        }
+    }
+
+    const uint8_t* Base = reinterpret_cast<const uint8_t*>(PackedB);
+    const size_t PanelColumn = Panel * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+    const size_t CountN = std::min(PackedB->N - PanelColumn, size_t(MLAS_SPARSE_SGEMM_PANEL_WIDTH));
+
+    if constexpr (BlockK == 0) {
+
+        const size_t PaddedK = (PackedB->K + 3) & ~size_t(3);
+        const size_t GroupCount = PaddedK / 4;
+        const uint8_t* Indices = Base + PackedB->IndexOffset + Panel * GroupCount * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+        const float* Values = reinterpret_cast<const float*>(Base + PackedB->ValueOffset) +
+            Panel * GroupCount * 2 * MLAS_SPARSE_SGEMM_PANEL_WIDTH;
+
+        MlasSparseSgemmStructured2x4Panel<V, Rows>(PackedA, PaddedK, Indices, Values, C + PanelColumn, ldc,
+            CountN, alpha, beta);
+
+    } else {
+
+        const uint32_t* PanelBlockStart = reinterpret_cast<const uint32_t*>(Base + PackedB->PanelBlockStartOffset);
+        const uint32_t* BlockRow = reinterpret_cast<const uint32_t*>(Base + PackedB->BlockRowOffset);
+        const float* Values = reinterpret_cast<const float*>(Base + PackedB->ValueOffset);
+
+        const size_t BlockStart = PanelBlockStart[Panel];
+        const size_t BlockCount = PanelBlockStart[Panel + 1] - BlockStart;
+
+        MlasSparseSgemmBlockPanel<V, BlockK, Rows>(PackedA, BlockRow + BlockStart,
+            Values + BlockStart * BlockK * MLAS_SPARSE_SGEMM_PANEL_WIDTH, BlockCount, C + PanelColumn, ldc,
+            CountN, alpha, beta);
+    }
+}
+
+template<typename V, size_t BlockK>
+void
+MLASCALL
+MlasSparseSgemmKernel(
+    const float* A,
+    size_t lda,
+    const MLAS_SPARSE_SGEMM_PACKED_HEADER* PackedB,
+    size_t PanelStart,
+    size_t PanelEnd,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies the rows of matrix A with a range of panels of a
+    packed sparse matrix B.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the packed sparse matrix B.
+
+    PanelStart - Supplies the first panel of matrix B.
+
+    PanelEnd - Supplies the panel of matrix B after the last one.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountM - Supplies the number of rows of matrix A and matrix C.
+
+    alpha - Supplies the scalar multiplier of the product.
+
+    beta - Supplies the scalar multiplier of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t RowTile = V::RowTile;
+
+    const size_t K = PackedB->K;
+    const size_t PaddedK = (K + 3) & ~size_t(3);
+    const size_t TileSize = PaddedK * RowTile;
+
+    //
+    // Copy as many tiles of matrix A to the buffer as fit in the cache, so
+    // that the values of a panel of matrix B are reused by all of them.
+    //
+
+    const size_t ChunkTiles = std::max(MLAS_SPARSE_SGEMM_A_CACHE_SIZE / (TileSize * sizeof(float)), size_t(1));
+    const size_t ChunkRows = ChunkTiles * RowTile;
+
+    MlasThreadedBufAlloc(std::min(ChunkRows, (CountM + RowTile - 1) / RowTile * RowTile) * PaddedK * sizeof(float));
+    float* PackedA = reinterpret_cast<float*>(ThreadedBufHolder.get());
+
+    for (size_t m = 0; m < CountM; m += ChunkRows) {
+
+        const size_t CountChunk = std::min(CountM - m, ChunkRows);
+
+        //
+        // Transpose the tiles for the block formats so that a block reads
+        // consecutive elements of matrix A. The 2:4 format keeps the rows,
+        // padded with zeros to a multiple of 4 columns.
+        //
+
+        for (size_t r = 0; r < CountChunk; r++) {
+
+            const float* a = A + (m + r) * lda;
+            float* Tile = PackedA + (r / RowTile) * TileSize;
+
+            if constexpr (BlockK == 0) {
+                float* Row = Tile + (r % RowTile) * PaddedK;
+                std::copy_n(a, K, Row);
+                std::fill(Row + K, Row + PaddedK, 0.0f);
+            } else {
+                for (size_t k = 0; k < K; k++) {
+                    Tile[k * RowTile + r % RowTile] = a[k];
+                }
+            }
+        }
+
+        for (size_t Panel = PanelStart; Panel < PanelEnd; Panel++) {
+
+            for (size_t t = 0; t < CountChunk; t += RowTile) {
+
+                MlasSparseSgemmPanel<V, BlockK>(std::min(CountChunk - t, RowTile), PackedA + (t / RowTile) * TileSize,
+                    PackedB, Panel, C + (m + t) * ldc, ldc, alpha, beta);
+            }
+        }
+    }
+}
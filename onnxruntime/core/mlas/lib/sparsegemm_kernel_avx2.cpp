@@ -0,0 +1,61 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the sparse single precision matrix/matrix multiply
+    kernels for processors supporting AVX2 and FMA3.
+
+--*/
+
+#include "sparsegemm.h"
+
+struct MLAS_SPARSE_SGEMM_VECTOR_AVX2 {
+    typedef __m256 FloatType;
+
+    static constexpr size_t VectorLength = 8;
+    static constexpr size_t RowTile = 8;
+
+    static FloatType Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { _mm256_storeu_ps(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return _mm256_set1_ps(Value); }
+    static FloatType Zero() { return _mm256_setzero_ps(); }
+    static FloatType Add(FloatType a, FloatType b) { return _mm256_add_ps(a, b); }
+    static FloatType Multiply(FloatType a, FloatType b) { return _mm256_mul_ps(a, b); }
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c) { return _mm256_fmadd_ps(a, b, c); }
+
+    //
+    // The quad of matrix A is broadcast to both 128-bit lanes, so the in-lane
+    // permute selects the element at the 2:4 position of each column.
+    //
+
+    typedef __m256 QuadType;
+    typedef __m256i IndexType;
+
+    static QuadType LoadQuad(const float* A) { return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(A)); }
+
+    static void LoadIndices(const uint8_t* Indices, IndexType& Index0, IndexType& Index1)
+    {
+        const __m256i Packed = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Indices)));
+
+        Index0 = _mm256_and_si256(Packed, _mm256_set1_epi32(3));
+        Index1 = _mm256_srli_epi32(Packed, 2);
+    }
+
+    static FloatType Select(QuadType Quad, IndexType Index) { return _mm256_permutevar_ps(Quad, Index); }
+};
+
+using MLAS_SPARSE_SGEMM_VECTOR = MLAS_SPARSE_SGEMM_VECTOR_AVX2;
+
+const MLAS_SPARSE_SGEMM_DISPATCH MlasSparseSgemmDispatchAvx2 = {
+    MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_VECTOR, 1>,
+    MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_VECTOR, 4>,
+    MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_VECTOR, 0>,
+};
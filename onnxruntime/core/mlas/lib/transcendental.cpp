@@ -0,0 +1,371 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental.cpp
+
+Abstract:
+
+    This module implements the single precision transcendental routines
+    (sin, cos, log, pow, sqrt, reciprocal, softplus and mish).
+
+    The algorithms in transcendental.h are instantiated here with the
+    portable MLAS_FLOAT32X4 policy, which targets the base instruction set of
+    each platform (SSE2, NEON, ...). Processors with AVX2 or AVX512F use the
+    wider kernels from transcendental_kernel_avx2.cpp and
+    transcendental_kernel_avx512f.cpp.
+
+--*/
+
+#include "transcendental.h"
+
+struct MLAS_TRANSCENDENTAL_VECTOR_FLOAT32X4 {
+    typedef MLAS_FLOAT32X4 FloatType;
+    typedef MLAS_INT32X4 IntType;
+    typedef MLAS_FLOAT32X4 MaskType;
+
+    static constexpr size_t VectorLength = 4;
+
+#if defined(MLAS_NEON64_INTRINSICS) || defined(MLAS_FMA3_INTRINSICS)
+    static constexpr bool FusedMultiplyAdd = true;
+#else
+    static constexpr bool FusedMultiplyAdd = false;
+#endif
+
+    static FloatType Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { MlasStoreFloat32x4(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+    static IntType BroadcastInt(int32_t Value) { return MlasBroadcastInt32x4(Value); }
+    static FloatType Zero() { return MlasZeroFloat32x4(); }
+
+    static FloatType Add(FloatType a, FloatType b) { return MlasAddFloat32x4(a, b); }
+    static FloatType Subtract(FloatType a, FloatType b) { return MlasSubtractFloat32x4(a, b); }
+    static FloatType Multiply(FloatType a, FloatType b) { return MlasMultiplyFloat32x4(a, b); }
+    static FloatType Divide(FloatType a, FloatType b) { return MlasDivideFloat32x4(a, b); }
+    static FloatType Sqrt(FloatType a) { return MlasSqrtFloat32x4(a); }
+    static FloatType Minimum(FloatType a, FloatType b) { return MlasMinimumFloat32x4(a, b); }
+    static FloatType Maximum(FloatType a, FloatType b) { return MlasMaximumFloat32x4(a, b); }
+
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c)
+    {
+#if defined(MLAS_NEON64_INTRINSICS)
+        return vfmaq_f32(c, a, b);
+#else
+        return MlasMultiplyAddFloat32x4(a, b, c);
+#endif
+    }
+
+    static FloatType And(FloatType a, FloatType b) { return MlasAndFloat32x4(a, b); }
+    static FloatType Xor(FloatType a, FloatType b) { return MlasXorFloat32x4(a, b); }
+    static FloatType AndNot(FloatType a, FloatType b) { return MlasAndNotFloat32x4(a, b); }
+
+    static MaskType GreaterThan(FloatType a, FloatType b) { return MlasGreaterThanFloat32x4(a, b); }
+    static MaskType Equal(FloatType a, FloatType b) { return MlasEqualFloat32x4(a, b); }
+    static FloatType Blend(FloatType a, FloatType b, MaskType Mask) { return MlasBlendFloat32x4(a, b, Mask); }
+    static MaskType MaskAnd(MaskType a, MaskType b) { return MlasAndFloat32x4(a, b); }
+
+    static bool AnyLane(MaskType Mask)
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        return _mm_movemask_ps(Mask) != 0;
+#elif defined(MLAS_NEON64_INTRINSICS)
+        return vmaxvq_u32(vreinterpretq_u32_f32(Mask)) != 0;
+#else
+        int32_t Lanes[4];
+        MlasStoreInt32x4(Lanes, MlasReinterpretAsInt32x4(Mask));
+        return (Lanes[0] | Lanes[1] | Lanes[2] | Lanes[3]) != 0;
+#endif
+    }
+
+    static IntType ReinterpretAsInt(FloatType a) { return MlasReinterpretAsInt32x4(a); }
+    static FloatType ReinterpretAsFloat(IntType a) { return MlasReinterpretAsFloat32x4(a); }
+    static IntType CastToInt(FloatType a) { return MlasCastToInt32x4(a); }
+    static FloatType CastToFloat(IntType a) { return MlasCastToFloat32x4(a); }
+    static IntType AddInt(IntType a, IntType b) { return MlasAddInt32x4(a, b); }
+    static IntType SubtractInt(IntType a, IntType b) { return MlasSubtractInt32x4(a, b); }
+    static IntType AndInt(IntType a, IntType b) { return MlasAndInt32x4(a, b); }
+
+    template<unsigned ShiftCount>
+    static IntType ShiftLeftInt(IntType a) { return MlasShiftLeftInt32x4<ShiftCount>(a); }
+
+    template<unsigned ShiftCount>
+    static IntType ShiftRightInt(IntType a) { return MlasShiftRightInt32x4<ShiftCount>(a); }
+};
+
+using MLAS_TRANSCENDENTAL_VECTOR = MLAS_TRANSCENDENTAL_VECTOR_FLOAT32X4;
+
+static const MLAS_TRANSCENDENTAL_DISPATCH MlasTranscendentalDispatchDefault = {
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SIN>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_COS>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_LOG>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SQRT>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_RECIPROCAL>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SOFTPLUS>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_MISH>,
+    MlasTranscendentalPowKernel<MLAS_TRANSCENDENTAL_VECTOR>,
+};
+
+MLAS_FORCEINLINE
+const MLAS_TRANSCENDENTAL_DISPATCH&
+MlasGetTranscendentalDispatch(
+    void
+    )
+{
+    const MLAS_TRANSCENDENTAL_DISPATCH* Dispatch = GetMlasPlatform().TranscendentalDispatch;
+
+    return (Dispatch != nullptr) ? *Dispatch : MlasTranscendentalDispatchDefault;
+}
+
+void
+MLASCALL
+MlasComputeSin(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sine function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Sin(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeCos(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the cosine function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Cos(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Log(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the square root.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Sqrt(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeReciprocal(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the reciprocal.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Reciprocal(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSoftplus(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softplus function, log(1 + exp(x)).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Softplus(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeMish(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mish function, x * tanh(softplus(x)).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Mish(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool BroadcastBase,
+    bool BroadcastExponent
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the power function.
+
+Arguments:
+
+    Base - Supplies the base buffer, or a single value if BroadcastBase.
+
+    Exponent - Supplies the exponent buffer, or a single value if
+        BroadcastExponent.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    BroadcastBase - Supplies true if Base is a single value.
+
+    BroadcastExponent - Supplies true if Exponent is a single value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGetTranscendentalDispatch().Pow(Base, Exponent, Output, N, BroadcastBase, BroadcastExponent);
+}
@@ -0,0 +1,923 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental.h
+
+Abstract:
+
+    This module includes the dispatch structure and the vector algorithms
+    for the single precision transcendental routines (MlasComputeSin and
+    related routines).
+
+    The algorithms are written once against a vector policy class that
+    supplies the load/store, arithmetic, compare and integer operations of an
+    instruction set. transcendental.cpp instantiates the algorithms with the
+    portable MLAS_FLOAT32X4 policy (SSE2, NEON, ...), while the AVX2 and
+    AVX512F kernels instantiate them with 256-bit and 512-bit policies.
+
+    A vector policy provides:
+
+        FloatType, IntType, MaskType, VectorLength, FusedMultiplyAdd
+        Load, Store, Broadcast, BroadcastInt, Zero
+        Add, Subtract, Multiply, Divide, MultiplyAdd, Sqrt, Minimum, Maximum
+        And, Xor, AndNot
+        GreaterThan, Equal, Blend, MaskAnd, AnyLane
+        ReinterpretAsInt, ReinterpretAsFloat, CastToInt, CastToFloat
+        AddInt, SubtractInt, AndInt, ShiftLeftInt<N>, ShiftRightInt<N>
+
+    Minimum and Maximum are always called with the value being limited as the
+    second argument, so NaN inputs propagate on every instruction set.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <algorithm>
+#include <limits>
+
+struct MLAS_TRANSCENDENTAL_DISPATCH {
+    typedef void(UnaryKernel_Fn)(
+        const float* Input,
+        float* Output,
+        size_t N
+    );
+
+    typedef void(PowKernel_Fn)(
+        const float* Base,
+        const float* Exponent,
+        float* Output,
+        size_t N,
+        bool BroadcastBase,
+        bool BroadcastExponent
+    );
+
+    UnaryKernel_Fn* Sin = nullptr;
+    UnaryKernel_Fn* Cos = nullptr;
+    UnaryKernel_Fn* Log = nullptr;
+    UnaryKernel_Fn* Sqrt = nullptr;
+    UnaryKernel_Fn* Reciprocal = nullptr;
+    UnaryKernel_Fn* Softplus = nullptr;
+    UnaryKernel_Fn* Mish = nullptr;
+    PowKernel_Fn* Pow = nullptr;
+};
+
+struct MLAS_TRANSCENDENTAL_CONSTANTS {
+    static constexpr float Infinity = std::numeric_limits<float>::infinity();
+    static constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+    static constexpr float NegativeZero = -0.0f;
+    static constexpr float One = 1.0f;
+    static constexpr float Two = 2.0f;
+
+    //
+    // Adding and subtracting 1.5*2^23 rounds a value with magnitude below
+    // 2^22 to the nearest integer. The low bit of the biased value holds the
+    // parity of the integer.
+    //
+
+    static constexpr float RoundingBias = 12582912.0f;
+    static constexpr float RoundingLimit = 4194304.0f;
+
+    //
+    // exp(x) = 2^k * exp(f), |f| <= ln2/2.
+    //
+
+    static constexpr float ExpLowerRange = -104.0f;
+    static constexpr float ExpUpperRange = 89.0f;
+    static constexpr float Log2Reciprocal = 1.44269502f;
+    static constexpr float Ln2High = 0.693145752f;
+    static constexpr float Ln2Low = 1.42860677e-6f;
+    static constexpr float Exp_P0 = 1.38319808e-3f;
+    static constexpr float Exp_P1 = 8.37550033e-3f;
+    static constexpr float Exp_P2 = 4.16689515e-2f;
+    static constexpr float Exp_P3 = 1.66664466e-1f;
+    static constexpr float Exp_P4 = 4.99999851e-1f;
+    static constexpr float Exp_P5 = 1.0f;
+    static constexpr float Exp_P6 = 1.0f;
+
+    //
+    // log(x) = n*ln2 + log(1+r), 2/3 <= 1+r < 4/3, with
+    // log(1+r) = r + r^2 * (P1 + P2*r + ... + P7*r^6).
+    //
+
+    static constexpr float MinimumNormal = 1.17549435e-38f;
+    static constexpr float DenormalScale = 8388608.0f;
+    static constexpr float DenormalExponent = -23.0f;
+    static constexpr int32_t LogMantissaOffset = 0x3f2aaaab;
+    static constexpr int32_t MantissaMask = 0x007fffff;
+    static constexpr float Log_P1 = -0.499999166f;
+    static constexpr float Log_P2 = 0.333364427f;
+    static constexpr float Log_P3 = -0.2500934f;
+    static constexpr float Log_P4 = 0.198278964f;
+    static constexpr float Log_P5 = -0.163866431f;
+    static constexpr float Log_P6 = 0.169240251f;
+    static constexpr float Log_P7 = -0.155493706f;
+
+    //
+    // pow evaluates log(1+r) = r - r^2/2 + r^3/3 - r^4/4 + r^5 * q(r) in
+    // extended precision, q(r) = Q0 + Q1*r + ... + Q7*r^7.
+    //
+
+    static constexpr float ThirdHigh = 0.333333343f;
+    static constexpr float ThirdLow = -9.93410748e-09f;
+    static constexpr float Pow_Q0 = 0.19999741f;
+    static constexpr float Pow_Q1 = -0.16666171f;
+    static constexpr float Pow_Q2 = 0.143015906f;
+    static constexpr float Pow_Q3 = -0.125241771f;
+    static constexpr float Pow_Q4 = 0.107779406f;
+    static constexpr float Pow_Q5 = -0.0957824141f;
+    static constexpr float Pow_Q6 = 0.119374126f;
+    static constexpr float Pow_Q7 = -0.114114627f;
+
+    //
+    // sin(x) = (-1)^n * sin(r), r = x - n*pi, |r| <= pi/2, with
+    // sin(r) = r + r^3 * (S1 + S2*r^2 + S3*r^4 + S4*r^6).
+    //
+    // The three part split of pi is used with a fused multiply-add. Without
+    // one, a four part split with 12 significant bits per part keeps n*pi
+    // exact for n < 4096.
+    //
+
+    static constexpr float PiReciprocal = 0.318309873f;
+    static constexpr float Sin_S1 = -0.166666567f;
+    static constexpr float Sin_S2 = 0.00833296217f;
+    static constexpr float Sin_S3 = -0.000198012058f;
+    static constexpr float Sin_S4 = 2.58670366e-06f;
+    static constexpr float NegativePiFma1 = -3.14159274f;
+    static constexpr float NegativePiFma2 = 8.74227766e-08f;
+    static constexpr float NegativePiFma3 = 3.43024902e-15f;
+    static constexpr float SinCosFmaRange = 1048576.0f;
+    static constexpr float NegativePi1 = -3.14160156f;
+    static constexpr float NegativePi2 = 8.9071691e-06f;
+    static constexpr float NegativePi3 = 1.74122761e-09f;
+    static constexpr float NegativePi4 = -1.24467439e-13f;
+    static constexpr float SinCosRange = 8192.0f;
+
+    //
+    // Mish saturates to x once exp(x)^2 dominates the denominator.
+    //
+
+    static constexpr float MishUpperRange = 20.0f;
+};
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalRound(
+    typename V::FloatType Value
+    )
+{
+    const auto Bias = V::Broadcast(MLAS_TRANSCENDENTAL_CONSTANTS::RoundingBias);
+
+    return V::Subtract(V::Add(Value, Bias), Bias);
+}
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalAbs(
+    typename V::FloatType Value
+    )
+{
+    return V::AndNot(V::Broadcast(MLAS_TRANSCENDENTAL_CONSTANTS::NegativeZero), Value);
+}
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalPowerOf2(
+    typename V::FloatType Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes 2^Value for integral values in [-126, 127].
+
+--*/
+{
+    auto Exponent = V::AddInt(V::CastToInt(Value), V::BroadcastInt(127));
+
+    return V::ReinterpretAsFloat(V::template ShiftLeftInt<23>(Exponent));
+}
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalTwoProductError(
+    typename V::FloatType a,
+    typename V::FloatType b,
+    typename V::FloatType Product
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the rounding error of Product = a * b, such that
+    a * b == Product + Error exactly.
+
+--*/
+{
+    if constexpr (V::FusedMultiplyAdd) {
+
+        return V::MultiplyAdd(a, b, V::Xor(Product, V::Broadcast(MLAS_TRANSCENDENTAL_CONSTANTS::NegativeZero)));
+
+    } else {
+
+        //
+        // Dekker's algorithm: split both operands into 12 bit halves so that
+        // the partial products are exact.
+        //
+
+        const auto SplitFactor = V::Broadcast(4097.0f);
+
+        auto Scaled = V::Multiply(a, SplitFactor);
+        auto aHigh = V::Subtract(Scaled, V::Subtract(Scaled, a));
+        auto aLow = V::Subtract(a, aHigh);
+
+        Scaled = V::Multiply(b, SplitFactor);
+        auto bHigh = V::Subtract(Scaled, V::Subtract(Scaled, b));
+        auto bLow = V::Subtract(b, bHigh);
+
+        auto Error = V::Subtract(V::Multiply(aHigh, bHigh), Product);
+        Error = V::Add(Error, V::Multiply(aHigh, bLow));
+        Error = V::Add(Error, V::Multiply(aLow, bHigh));
+
+        return V::Add(Error, V::Multiply(aLow, bLow));
+    }
+}
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalFastTwoSum(
+    typename V::FloatType a,
+    typename V::FloatType b,
+    typename V::FloatType& Low
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a + b for |a| >= |b| and accumulates the rounding
+    error of the sum into Low.
+
+--*/
+{
+    auto Sum = V::Add(a, b);
+
+    Low = V::Add(Low, V::Subtract(b, V::Subtract(Sum, a)));
+
+    return Sum;
+}
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalExp(
+    typename V::FloatType Value,
+    typename V::FloatType ValueLow
+    )
+/*++
+
+Routine Description:
+
+    This routine computes exp(Value + ValueLow), where ValueLow is a small
+    correction term carried from an extended precision computation.
+
+    Results below the smallest denormal flush to zero and results above
+    FLT_MAX overflow to infinity. NaN inputs propagate.
+
+--*/
+{
+    using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+    Value = V::Minimum(V::Broadcast(C::ExpUpperRange), Value);
+    Value = V::Maximum(V::Broadcast(C::ExpLowerRange), Value);
+
+    //
+    // Reduce Value = k*ln2 + f. The high part of ln2 has trailing zero bits
+    // so k*Ln2High is exact.
+    //
+
+    auto k = MlasTranscendentalRound<V>(V::Multiply(Value, V::Broadcast(C::Log2Reciprocal)));
+    auto f = V::MultiplyAdd(k, V::Broadcast(-C::Ln2High), Value);
+    f = V::MultiplyAdd(k, V::Broadcast(-C::Ln2Low), f);
+    f = V::Add(f, ValueLow);
+
+    auto p = V::Broadcast(C::Exp_P0);
+    p = V::MultiplyAdd(p, f, V::Broadcast(C::Exp_P1));
+    p = V::MultiplyAdd(p, f, V::Broadcast(C::Exp_P2));
+    p = V::MultiplyAdd(p, f, V::Broadcast(C::Exp_P3));
+    p = V::MultiplyAdd(p, f, V::Broadcast(C::Exp_P4));
+    p = V::MultiplyAdd(p, f, V::Broadcast(C::Exp_P5));
+    p = V::MultiplyAdd(p, f, V::Broadcast(C::Exp_P6));
+
+    //
+    // Scale by 2^k in two steps so that both factors stay in the normal
+    // range: the final multiply then rounds once into the denormal range or
+    // overflows to infinity.
+    //
+
+    auto k1 = MlasTranscendentalRound<V>(V::Multiply(k, V::Broadcast(0.5f)));
+    auto k2 = V::Subtract(k, k1);
+
+    p = V::Multiply(p, MlasTranscendentalPowerOf2<V>(k1));
+
+    return V::Multiply(p, MlasTranscendentalPowerOf2<V>(k2));
+}
+
+template<typename V, bool ExtendedPrecision>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalLogCore(
+    typename V::FloatType Value,
+    typename V::FloatType* ValueLow
+    )
+/*++
+
+Routine Description:
+
+    This routine computes log(Value) for positive finite values.
+
+    If ExtendedPrecision is true, the result is returned as the unevaluated
+    sum of the return value and *ValueLow.
+
+--*/
+{
+    using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+    //
+    // Scale denormal inputs into the normal range.
+    //
+
+    auto IsDenormal = V::GreaterThan(V::Broadcast(C::MinimumNormal), Value);
+    Value = V::Blend(Value, V::Multiply(Value, V::Broadcast(C::DenormalScale)), IsDenormal);
+    auto ExponentAdjust = V::Blend(V::Zero(), V::Broadcast(C::DenormalExponent), IsDenormal);
+
+    //
+    // Decompose Value = 2^n * (1+r) with 2/3 <= 1+r < 4/3.
+    //
+
+    auto Bits = V::SubtractInt(V::ReinterpretAsInt(Value), V::BroadcastInt(C::LogMantissaOffset));
+    auto n = V::Add(V::CastToFloat(V::template ShiftRightInt<23>(Bits)), ExponentAdjust);
+    auto Mantissa = V::AddInt(V::AndInt(Bits, V::BroadcastInt(C::MantissaMask)), V::BroadcastInt(C::LogMantissaOffset));
+    auto r = V::Subtract(V::ReinterpretAsFloat(Mantissa), V::Broadcast(C::One));
+    auto r2 = V::Multiply(r, r);
+
+    if constexpr (ExtendedPrecision) {
+
+        //
+        // log(1+r) = r - r^2/2 + r^3/3 - r^4/4 + r^5 * q(r). The leading
+        // powers are carried with their rounding errors so that the sum is
+        // accurate to well below an ulp of the result, which keeps the error
+        // small after the exponent amplifies it in pow.
+        //
+
+        const auto NegativeHalf = V::Broadcast(-0.5f);
+        const auto NegativeQuarter = V::Broadcast(-0.25f);
+        const auto ThirdHigh = V::Broadcast(C::ThirdHigh);
+
+        auto r2Low = MlasTranscendentalTwoProductError<V>(r, r, r2);
+
+        auto r3 = V::Multiply(r2, r);
+        auto r3Low = V::MultiplyAdd(r2Low, r, MlasTranscendentalTwoProductError<V>(r2, r, r3));
+
+        auto r4 = V::Multiply(r2, r2);
+        auto r4Low = V::MultiplyAdd(V::Add(r2, r2), r2Low, MlasTranscendentalTwoProductError<V>(r2, r2, r4));
+
+        auto Third = V::Multiply(r3, ThirdHigh);
+        auto ThirdLow = MlasTranscendentalTwoProductError<V>(r3, ThirdHigh, Third);
+        ThirdLow = V::MultiplyAdd(r3Low, ThirdHigh, ThirdLow);
+        ThirdLow = V::MultiplyAdd(r3, V::Broadcast(C::ThirdLow), ThirdLow);
+
+        auto q = V::Broadcast(C::Pow_Q7);
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q6));
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q5));
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q4));
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q3));
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q2));
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q1));
+        q = V::MultiplyAdd(q, r, V::Broadcast(C::Pow_Q0));
+
+        auto Low = V::MultiplyAdd(r2Low, NegativeHalf, ThirdLow);
+        Low = V::MultiplyAdd(r4Low, NegativeQuarter, Low);
+        Low = V::MultiplyAdd(V::Multiply(r4, r), q, Low);
+        Low = V::MultiplyAdd(n, V::Broadcast(C::Ln2Low), Low);
+
+        //
+        // Each term is smaller than the running sum, so every rounding error
+        // is recovered exactly. n*Ln2High is exact and at least as large as
+        // the sum when n is nonzero.
+        //
+
+        auto Sum = r;
+        Sum = MlasTranscendentalFastTwoSum<V>(Sum, V::Multiply(r2, NegativeHalf), Low);
+        Sum = MlasTranscendentalFastTwoSum<V>(Sum, Third, Low);
+        Sum = MlasTranscendentalFastTwoSum<V>(Sum, V::Multiply(r4, NegativeQuarter), Low);
+        Sum = MlasTranscendentalFastTwoSum<V>(V::Multiply(n, V::Broadcast(C::Ln2High)), Sum, Low);
+
+        auto Result = V::Add(Sum, Low);
+        *ValueLow = V::Subtract(Low, V::Subtract(Result, Sum));
+
+        return Result;
+
+    } else {
+
+        MLAS_UNREFERENCED_PARAMETER(ValueLow);
+
+        auto p = V::Broadcast(C::Log_P7);
+        p = V::MultiplyAdd(p, r, V::Broadcast(C::Log_P6));
+        p = V::MultiplyAdd(p, r, V::Broadcast(C::Log_P5));
+        p = V::MultiplyAdd(p, r, V::Broadcast(C::Log_P4));
+        p = V::MultiplyAdd(p, r, V::Broadcast(C::Log_P3));
+        p = V::MultiplyAdd(p, r, V::Broadcast(C::Log_P2));
+        p = V::MultiplyAdd(p, r, V::Broadcast(C::Log_P1));
+
+        auto Tail = V::MultiplyAdd(n, V::Broadcast(C::Ln2Low), V::Multiply(r2, p));
+
+        return V::MultiplyAdd(n, V::Broadcast(C::Ln2High), V::Add(Tail, r));
+    }
+}
+
+template<typename V, bool IsCos>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalSinCos(
+    typename V::FloatType Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes sin(Value) or cos(Value) for inputs inside the
+    reduction range. Callers evaluate larger inputs with the C runtime.
+
+    The cosine is computed as (-1)^m * sin(|x| - (m - 1/2)*pi) with
+    m = round(|x|/pi + 1/2).
+
+--*/
+{
+    using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+    typename V::FloatType Reduced;
+    typename V::FloatType Biased;
+
+    if constexpr (IsCos) {
+        Reduced = MlasTranscendentalAbs<V>(Value);
+        Biased = V::MultiplyAdd(Reduced, V::Broadcast(C::PiReciprocal), V::Broadcast(0.5f));
+        Biased = V::Add(Biased, V::Broadcast(C::RoundingBias));
+    } else {
+        Reduced = Value;
+        Biased = V::MultiplyAdd(Reduced, V::Broadcast(C::PiReciprocal), V::Broadcast(C::RoundingBias));
+    }
+
+    auto OddSign = V::ReinterpretAsFloat(V::template ShiftLeftInt<31>(V::ReinterpretAsInt(Biased)));
+    auto n = V::Subtract(Biased, V::Broadcast(C::RoundingBias));
+
+    if constexpr (IsCos) {
+        n = V::Subtract(n, V::Broadcast(0.5f));
+    }
+
+    if constexpr (V::FusedMultiplyAdd) {
+        Reduced = V::MultiplyAdd(n, V::Broadcast(C::NegativePiFma1), Reduced);
+        Reduced = V::MultiplyAdd(n, V::Broadcast(C::NegativePiFma2), Reduced);
+        Reduced = V::MultiplyAdd(n, V::Broadcast(C::NegativePiFma3), Reduced);
+    } else {
+        Reduced = V::Add(Reduced, V::Multiply(n, V::Broadcast(C::NegativePi1)));
+        Reduced = V::Add(Reduced, V::Multiply(n, V::Broadcast(C::NegativePi2)));
+        Reduced = V::Add(Reduced, V::Multiply(n, V::Broadcast(C::NegativePi3)));
+        Reduced = V::Add(Reduced, V::Multiply(n, V::Broadcast(C::NegativePi4)));
+    }
+
+    auto r2 = V::Multiply(Reduced, Reduced);
+
+    auto p = V::Broadcast(C::Sin_S4);
+    p = V::MultiplyAdd(p, r2, V::Broadcast(C::Sin_S3));
+    p = V::MultiplyAdd(p, r2, V::Broadcast(C::Sin_S2));
+    p = V::MultiplyAdd(p, r2, V::Broadcast(C::Sin_S1));
+    p = V::MultiplyAdd(V::Multiply(p, r2), Reduced, Reduced);
+
+    return V::Xor(p, OddSign);
+}
+
+//
+// Operation classes for MlasTranscendentalUnaryKernel. Each class evaluates a
+// vector with Evaluate and may route lanes outside of the vector algorithm's
+// range to the C runtime.
+//
+
+struct MLAS_TRANSCENDENTAL_SIN {
+    static constexpr bool HasFallback = true;
+
+    template<typename V>
+    static float FallbackRange()
+    {
+        return V::FusedMultiplyAdd ? MLAS_TRANSCENDENTAL_CONSTANTS::SinCosFmaRange :
+                                     MLAS_TRANSCENDENTAL_CONSTANTS::SinCosRange;
+    }
+
+    template<typename V>
+    static typename V::MaskType NeedsFallback(typename V::FloatType Value)
+    {
+        return V::GreaterThan(MlasTranscendentalAbs<V>(Value), V::Broadcast(FallbackRange<V>()));
+    }
+
+    static float Fallback(float Value)
+    {
+        return std::sin(Value);
+    }
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        //
+        // The reduction produces +0 for a -0 input.
+        //
+
+        auto Result = MlasTranscendentalSinCos<V, false>(Value);
+
+        return V::Blend(Result, Value, V::Equal(Value, V::Zero()));
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_COS : MLAS_TRANSCENDENTAL_SIN {
+    static float Fallback(float Value)
+    {
+        return std::cos(Value);
+    }
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        return MlasTranscendentalSinCos<V, true>(Value);
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_LOG {
+    static constexpr bool HasFallback = false;
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+        auto Result = MlasTranscendentalLogCore<V, false>(Value, nullptr);
+
+        Result = V::Blend(Value, Result, V::Equal(Value, Value));
+        Result = V::Blend(Result, V::Broadcast(C::NaN), V::GreaterThan(V::Zero(), Value));
+        Result = V::Blend(Result, V::Broadcast(-C::Infinity), V::Equal(Value, V::Zero()));
+        Result = V::Blend(Result, V::Broadcast(C::Infinity), V::Equal(Value, V::Broadcast(C::Infinity)));
+
+        return Result;
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_SQRT {
+    static constexpr bool HasFallback = false;
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        return V::Sqrt(Value);
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_RECIPROCAL {
+    static constexpr bool HasFallback = false;
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        return V::Divide(V::Broadcast(MLAS_TRANSCENDENTAL_CONSTANTS::One), Value);
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_SOFTPLUS {
+    static constexpr bool HasFallback = false;
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+        //
+        // softplus(x) = max(x, 0) + log1p(exp(-|x|)), where
+        // log1p(t) = log(1+t) * t / ((1+t) - 1) recovers the rounding error of
+        // 1+t for small t.
+        //
+
+        auto t = MlasTranscendentalExp<V>(V::Xor(MlasTranscendentalAbs<V>(Value), V::Broadcast(C::NegativeZero)),
+                                          V::Zero());
+        auto u = V::Add(t, V::Broadcast(C::One));
+        auto d = V::Subtract(u, V::Broadcast(C::One));
+
+        auto Log1p = MlasTranscendentalLogCore<V, false>(u, nullptr);
+        Log1p = V::Multiply(Log1p, V::Divide(t, d));
+        Log1p = V::Blend(Log1p, t, V::Equal(d, V::Zero()));
+
+        return V::Add(V::Maximum(V::Zero(), Value), Log1p);
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_MISH {
+    static constexpr bool HasFallback = false;
+
+    template<typename V>
+    static typename V::FloatType Evaluate(typename V::FloatType Value)
+    {
+        using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+        //
+        // tanh(softplus(x)) = e*(e+2) / (e*(e+2) + 2) with e = exp(x).
+        //
+
+        auto e = MlasTranscendentalExp<V>(V::Minimum(V::Broadcast(C::MishUpperRange), Value), V::Zero());
+        auto n = V::Multiply(e, V::Add(e, V::Broadcast(C::Two)));
+        auto Result = V::Multiply(Value, V::Divide(n, V::Add(n, V::Broadcast(C::Two))));
+
+        return V::Blend(Result, V::Broadcast(C::NegativeZero), V::Equal(Value, V::Broadcast(-C::Infinity)));
+    }
+};
+
+template<typename V>
+MLAS_FORCEINLINE
+typename V::FloatType
+MlasTranscendentalPow(
+    typename V::FloatType Base,
+    typename V::FloatType Exponent
+    )
+/*++
+
+Routine Description:
+
+    This routine computes pow(Base, Exponent) as exp(Exponent * log(|Base|))
+    with the product carried in extended precision, then applies the C99
+    special cases. Exponents with magnitude above 2^22 are handled by the
+    caller.
+
+--*/
+{
+    using C = MLAS_TRANSCENDENTAL_CONSTANTS;
+
+    const auto Zero = V::Zero();
+    const auto One = V::Broadcast(C::One);
+    const auto Infinity = V::Broadcast(C::Infinity);
+
+    auto AbsBase = MlasTranscendentalAbs<V>(Base);
+
+    typename V::FloatType LogLow;
+    auto LogHigh = MlasTranscendentalLogCore<V, true>(AbsBase, &LogLow);
+
+    auto ProductHigh = V::Multiply(Exponent, LogHigh);
+    auto ProductLow = MlasTranscendentalTwoProductError<V>(Exponent, LogHigh, ProductHigh);
+    ProductLow = V::MultiplyAdd(Exponent, LogLow, ProductLow);
+
+    auto Result = MlasTranscendentalExp<V>(ProductHigh, ProductLow);
+
+    //
+    // Zero and infinite bases.
+    //
+
+    auto NegativeExponent = V::GreaterThan(Zero, Exponent);
+    Result = V::Blend(Result, V::Blend(Zero, Infinity, NegativeExponent), V::Equal(AbsBase, Zero));
+    Result = V::Blend(Result, V::Blend(Infinity, Zero, NegativeExponent), V::Equal(AbsBase, Infinity));
+    Result = V::Blend(Result, One, V::Equal(AbsBase, One));
+
+    //
+    // Negative bases: odd integral exponents flip the sign and non-integral
+    // exponents of a finite negative base produce NaN.
+    //
+
+    auto Biased = V::Add(Exponent, V::Broadcast(C::RoundingBias));
+    auto IsInteger = V::Equal(V::Subtract(Biased, V::Broadcast(C::RoundingBias)), Exponent);
+    auto OddSign = V::ReinterpretAsFloat(V::template ShiftLeftInt<31>(V::ReinterpretAsInt(Biased)));
+    auto SignFlip = V::Blend(Zero, V::And(OddSign, Base), IsInteger);
+    Result = V::Xor(Result, SignFlip);
+
+    auto IsNegativeFinite = V::MaskAnd(V::GreaterThan(Zero, Base), V::GreaterThan(Base, V::Broadcast(-C::Infinity)));
+    Result = V::Blend(Result, V::Blend(V::Broadcast(C::NaN), Result, IsInteger), IsNegativeFinite);
+
+    //
+    // NaN inputs propagate, except that pow(1, y) and pow(x, 0) are one.
+    //
+
+    Result = V::Blend(Base, Result, V::Equal(Base, Base));
+    Result = V::Blend(Exponent, Result, V::Equal(Exponent, Exponent));
+    Result = V::Blend(Result, One, V::Equal(Base, One));
+    Result = V::Blend(Result, One, V::Equal(Exponent, Zero));
+
+    return Result;
+}
+
+template<typename V, typename Op>
+void
+MlasTranscendentalUnaryKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies a transcendental operation to a buffer. The input
+    and output buffers may be the same.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = V::VectorLength;
+
+    float Buffer[VectorLength];
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, VectorLength);
+        typename V::FloatType Value;
+
+        if (CountN == VectorLength) {
+            Value = V::Load(Input);
+        } else {
+            std::fill_n(Buffer, VectorLength, 0.0f);
+            std::copy_n(Input, CountN, Buffer);
+            Value = V::Load(Buffer);
+        }
+
+        auto Result = Op::template Evaluate<V>(Value);
+
+        if constexpr (Op::HasFallback) {
+
+            if (V::AnyLane(Op::template NeedsFallback<V>(Value))) {
+
+                float Values[VectorLength];
+                float Results[VectorLength];
+
+                V::Store(Values, Value);
+                V::Store(Results, Result);
+
+                const float Range = Op::template FallbackRange<V>();
+
+                for (size_t i = 0; i < VectorLength; i++) {
+                    if (std::fabs(Values[i]) > Range) {
+                        Results[i] = Op::Fallback(Values[i]);
+                    }
+                }
+
+                Result = V::Load(Results);
+            }
+        }
+
+        if (CountN == VectorLength) {
+            V::Store(Output, Result);
+        } else {
+            V::Store(Buffer, Result);
+            std::copy_n(Buffer, CountN, Output);
+        }
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
+
+template<typename V>
+void
+MlasTranscendentalPowKernel(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool BroadcastBase,
+    bool BroadcastExponent
+    )
+/*++
+
+Routine Description:
+
+    This routine computes pow(Base, Exponent) for a buffer.
+
+Arguments:
+
+    Base - Supplies the base buffer, or a single value if BroadcastBase.
+
+    Exponent - Supplies the exponent buffer, or a single value if
+        BroadcastExponent.
+
+    Output - Supplies the output buffer. The output buffer may be the same
+        as a non-broadcast input buffer.
+
+    N - Supplies the number of elements to process.
+
+    BroadcastBase - Supplies true if Base is a single value.
+
+    BroadcastExponent - Supplies true if Exponent is a single value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = V::VectorLength;
+
+    float BaseBuffer[VectorLength];
+    float ExponentBuffer[VectorLength];
+
+    const auto BaseBroadcast = V::Broadcast(*Base);
+    const auto ExponentBroadcast = V::Broadcast(*Exponent);
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, VectorLength);
+        typename V::FloatType BaseValue = BaseBroadcast;
+        typename V::FloatType ExponentValue = ExponentBroadcast;
+
+        if (CountN == VectorLength) {
+
+            if (!BroadcastBase) {
+                BaseValue = V::Load(Base);
+            }
+
+            if (!BroadcastExponent) {
+                ExponentValue = V::Load(Exponent);
+            }
+
+        } else {
+
+            if (!BroadcastBase) {
+                std::fill_n(BaseBuffer, VectorLength, 1.0f);
+                std::copy_n(Base, CountN, BaseBuffer);
+                BaseValue = V::Load(BaseBuffer);
+            }
+
+            if (!BroadcastExponent) {
+                std::fill_n(ExponentBuffer, VectorLength, 1.0f);
+                std::copy_n(Exponent, CountN, ExponentBuffer);
+                ExponentValue = V::Load(ExponentBuffer);
+            }
+        }
+
+        auto Result = MlasTranscendentalPow<V>(BaseValue, ExponentValue);
+
+        //
+        // Exponents beyond the rounding range of the integral test are
+        // evaluated with the C runtime.
+        //
+
+        const auto LargeExponent = V::GreaterThan(MlasTranscendentalAbs<V>(ExponentValue),
+                                                  V::Broadcast(MLAS_TRANSCENDENTAL_CONSTANTS::RoundingLimit));
+
+        if (V::AnyLane(LargeExponent)) {
+
+            float Results[VectorLength];
+
+            V::Store(BaseBuffer, BaseValue);
+            V::Store(ExponentBuffer, ExponentValue);
+            V::Store(Results, Result);
+
+            for (size_t i = 0; i < VectorLength; i++) {
+                if (std::fabs(ExponentBuffer[i]) > MLAS_TRANSCENDENTAL_CONSTANTS::RoundingLimit) {
+                    Results[i] = std::pow(BaseBuffer[i], ExponentBuffer[i]);
+                }
+            }
+
+            Result = V::Load(Results);
+        }
+
+        if (CountN == VectorLength) {
+            V::Store(Output, Result);
+        } else {
+            V::Store(BaseBuffer, Result);
+            std::copy_n(BaseBuffer, CountN, Output);
+        }
+
+        if (!BroadcastBase) {
+            Base += CountN;
+        }
+
+        if (!BroadcastExponent) {
+            Exponent += CountN;
+        }
+
+        Output += CountN;
+        N -= CountN;
+    }
+}
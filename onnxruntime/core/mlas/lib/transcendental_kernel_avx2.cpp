@@ -0,0 +1,79 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the transcendental kernels for processors
+    supporting AVX2 and FMA3.
+
+--*/
+
+#include "transcendental.h"
+
+struct MLAS_TRANSCENDENTAL_VECTOR_AVX2 {
+    typedef __m256 FloatType;
+    typedef __m256i IntType;
+    typedef __m256 MaskType;
+
+    static constexpr size_t VectorLength = 8;
+    static constexpr bool FusedMultiplyAdd = true;
+
+    static FloatType Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { _mm256_storeu_ps(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return _mm256_set1_ps(Value); }
+    static IntType BroadcastInt(int32_t Value) { return _mm256_set1_epi32(Value); }
+    static FloatType Zero() { return _mm256_setzero_ps(); }
+
+    static FloatType Add(FloatType a, FloatType b) { return _mm256_add_ps(a, b); }
+    static FloatType Subtract(FloatType a, FloatType b) { return _mm256_sub_ps(a, b); }
+    static FloatType Multiply(FloatType a, FloatType b) { return _mm256_mul_ps(a, b); }
+    static FloatType Divide(FloatType a, FloatType b) { return _mm256_div_ps(a, b); }
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c) { return _mm256_fmadd_ps(a, b, c); }
+    static FloatType Sqrt(FloatType a) { return _mm256_sqrt_ps(a); }
+    static FloatType Minimum(FloatType a, FloatType b) { return _mm256_min_ps(a, b); }
+    static FloatType Maximum(FloatType a, FloatType b) { return _mm256_max_ps(a, b); }
+
+    static FloatType And(FloatType a, FloatType b) { return _mm256_and_ps(a, b); }
+    static FloatType Xor(FloatType a, FloatType b) { return _mm256_xor_ps(a, b); }
+    static FloatType AndNot(FloatType a, FloatType b) { return _mm256_andnot_ps(a, b); }
+
+    static MaskType GreaterThan(FloatType a, FloatType b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static MaskType Equal(FloatType a, FloatType b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static FloatType Blend(FloatType a, FloatType b, MaskType Mask) { return _mm256_blendv_ps(a, b, Mask); }
+    static MaskType MaskAnd(MaskType a, MaskType b) { return _mm256_and_ps(a, b); }
+    static bool AnyLane(MaskType Mask) { return _mm256_movemask_ps(Mask) != 0; }
+
+    static IntType ReinterpretAsInt(FloatType a) { return _mm256_castps_si256(a); }
+    static FloatType ReinterpretAsFloat(IntType a) { return _mm256_castsi256_ps(a); }
+    static IntType CastToInt(FloatType a) { return _mm256_cvttps_epi32(a); }
+    static FloatType CastToFloat(IntType a) { return _mm256_cvtepi32_ps(a); }
+    static IntType AddInt(IntType a, IntType b) { return _mm256_add_epi32(a, b); }
+    static IntType SubtractInt(IntType a, IntType b) { return _mm256_sub_epi32(a, b); }
+    static IntType AndInt(IntType a, IntType b) { return _mm256_and_si256(a, b); }
+
+    template<unsigned ShiftCount>
+    static IntType ShiftLeftInt(IntType a) { return _mm256_slli_epi32(a, ShiftCount); }
+
+    template<unsigned ShiftCount>
+    static IntType ShiftRightInt(IntType a) { return _mm256_srai_epi32(a, ShiftCount); }
+};
+
+using MLAS_TRANSCENDENTAL_VECTOR = MLAS_TRANSCENDENTAL_VECTOR_AVX2;
+
+const MLAS_TRANSCENDENTAL_DISPATCH MlasTranscendentalDispatchAvx2 = {
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SIN>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_COS>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_LOG>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SQRT>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_RECIPROCAL>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SOFTPLUS>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_MISH>,
+    MlasTranscendentalPowKernel<MLAS_TRANSCENDENTAL_VECTOR>,
+};
@@ -0,0 +1,95 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the transcendental kernels for processors
+    supporting AVX512F.
+
+--*/
+
+#include "transcendental.h"
+
+struct MLAS_TRANSCENDENTAL_VECTOR_AVX512F {
+    typedef __m512 FloatType;
+    typedef __m512i IntType;
+    typedef __mmask16 MaskType;
+
+    static constexpr size_t VectorLength = 16;
+    static constexpr bool FusedMultiplyAdd = true;
+
+    static FloatType Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+    static void Store(float* Buffer, FloatType Vector) { _mm512_storeu_ps(Buffer, Vector); }
+    static FloatType Broadcast(float Value) { return _mm512_set1_ps(Value); }
+    static IntType BroadcastInt(int32_t Value) { return _mm512_set1_epi32(Value); }
+    static FloatType Zero() { return _mm512_setzero_ps(); }
+
+    static FloatType Add(FloatType a, FloatType b) { return _mm512_add_ps(a, b); }
+    static FloatType Subtract(FloatType a, FloatType b) { return _mm512_sub_ps(a, b); }
+    static FloatType Multiply(FloatType a, FloatType b) { return _mm512_mul_ps(a, b); }
+    static FloatType Divide(FloatType a, FloatType b) { return _mm512_div_ps(a, b); }
+    static FloatType MultiplyAdd(FloatType a, FloatType b, FloatType c) { return _mm512_fmadd_ps(a, b, c); }
+    static FloatType Sqrt(FloatType a) { return _mm512_sqrt_ps(a); }
+    static FloatType Minimum(FloatType a, FloatType b) { return _mm512_min_ps(a, b); }
+    static FloatType Maximum(FloatType a, FloatType b) { return _mm512_max_ps(a, b); }
+
+    //
+    // The floating point logical instructions require AVX512DQ, so use the
+    // integer forms.
+    //
+
+    static FloatType And(FloatType a, FloatType b)
+    {
+        return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+    }
+
+    static FloatType Xor(FloatType a, FloatType b)
+    {
+        return _mm512_castsi512_ps(_mm512_xor_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+    }
+
+    static FloatType AndNot(FloatType a, FloatType b)
+    {
+        return _mm512_castsi512_ps(_mm512_andnot_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+    }
+
+    static MaskType GreaterThan(FloatType a, FloatType b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static MaskType Equal(FloatType a, FloatType b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static FloatType Blend(FloatType a, FloatType b, MaskType Mask) { return _mm512_mask_blend_ps(Mask, a, b); }
+    static MaskType MaskAnd(MaskType a, MaskType b) { return _mm512_kand(a, b); }
+    static bool AnyLane(MaskType Mask) { return Mask != 0; }
+
+    static IntType ReinterpretAsInt(FloatType a) { return _mm512_castps_si512(a); }
+    static FloatType ReinterpretAsFloat(IntType a) { return _mm512_castsi512_ps(a); }
+    static IntType CastToInt(FloatType a) { return _mm512_cvttps_epi32(a); }
+    static FloatType CastToFloat(IntType a) { return _mm512_cvtepi32_ps(a); }
+    static IntType AddInt(IntType a, IntType b) { return _mm512_add_epi32(a, b); }
+    static IntType SubtractInt(IntType a, IntType b) { return _mm512_sub_epi32(a, b); }
+    static IntType AndInt(IntType a, IntType b) { return _mm512_and_epi32(a, b); }
+
+    template<unsigned ShiftCount>
+    static IntType ShiftLeftInt(IntType a) { return _mm512_slli_epi32(a, ShiftCount); }
+
+    template<unsigned ShiftCount>
+    static IntType ShiftRightInt(IntType a) { return _mm512_srai_epi32(a, ShiftCount); }
+};
+
+using MLAS_TRANSCENDENTAL_VECTOR = MLAS_TRANSCENDENTAL_VECTOR_AVX512F;
+
+const MLAS_TRANSCENDENTAL_DISPATCH MlasTranscendentalDispatchAvx512F = {
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SIN>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_COS>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_LOG>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SQRT>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_RECIPROCAL>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_SOFTPLUS>,
+    MlasTranscendentalUnaryKernel<MLAS_TRANSCENDENTAL_VECTOR, MLAS_TRANSCENDENTAL_MISH>,
+    MlasTranscendentalPowKernel<MLAS_TRANSCENDENTAL_VECTOR>,
+};
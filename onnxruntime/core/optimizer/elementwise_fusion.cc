@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <algorithm>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+bool HasElemType(const NodeArg& arg, TensorProto_DataType elem_type) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() && type->tensor_type().elem_type() == elem_type;
+}
+
+bool IsFusableNode(const Node& node) {
+  const bool is_binary = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+                         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+                         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+                         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14}) ||
+                         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8, 12, 13}) ||
+                         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8, 12, 13});
+  const bool is_unary = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+                        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13});
+  const bool is_where = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Where", {9, 16});
+
+  const auto& input_defs = node.InputDefs();
+  const size_t arity = is_binary ? 2 : is_unary ? 1 : is_where ? 3 : 0;
+  if (arity == 0 || input_defs.size() != arity || node.OutputDefs().size() != 1 ||
+      !HasElemType(*node.OutputDefs()[0], TensorProto_DataType_FLOAT)) {
+    return false;
+  }
+
+  // Only the condition of Where is bool, all other values are float.
+  for (size_t i = 0; i < arity; ++i) {
+    const auto elem_type = (is_where && i == 0) ? TensorProto_DataType_BOOL : TensorProto_DataType_FLOAT;
+    if (!input_defs[i]->Exists() || !HasElemType(*input_defs[i], elem_type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if both shapes are known to be the same, either from the dim values or from the dim params.
+bool HaveSameShape(const NodeArg& arg, const NodeArg& other) {
+  const auto* shape = arg.Shape();
+  const auto* other_shape = other.Shape();
+  if (shape == nullptr || other_shape == nullptr || shape->dim_size() != other_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const auto& other_dim = other_shape->dim(i);
+    if (utils::HasDimValue(dim) && utils::HasDimValue(other_dim)) {
+      if (dim.dim_value() != other_dim.dim_value()) {
+        return false;
+      }
+    } else if (!utils::HasDimParam(dim) || !utils::HasDimParam(other_dim) ||
+               dim.dim_param() != other_dim.dim_param()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Replaces the nodes of a region, given in topological order, with one FusedElementwise node.
+void FuseRegion(Graph& graph, gsl::span<const NodeIndex> region) {
+  InlinedHashMap<const NodeArg*, int64_t> value_indices;
+  InlinedHashSet<const NodeArg*> region_outputs;
+  for (NodeIndex index : region) {
+    region_outputs.insert(graph.GetNode(index)->OutputDefs()[0]);
+  }
+
+  // The inputs of the fused node are the values that the region consumes and does not produce.
+  InlinedVector<NodeArg*> inputs;
+  for (NodeIndex index : region) {
+    for (NodeArg* input_def : graph.GetNode(index)->MutableInputDefs()) {
+      if (region_outputs.count(input_def) == 0 && value_indices.count(input_def) == 0) {
+        value_indices[input_def] = static_cast<int64_t>(inputs.size());
+        inputs.push_back(input_def);
+      }
+    }
+  }
+
+  struct InputEdge {
+    NodeIndex src_node;
+    int src_arg_index;
+    int dst_arg_index;
+  };
+  InlinedVector<InputEdge> input_edges;
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  for (NodeIndex index : region) {
+    const Node& node = *graph.GetNode(index);
+    for (const NodeArg* input_def : node.InputDefs()) {
+      operands.push_back(value_indices[input_def]);
+    }
+    ops.push_back(node.OpType());
+    value_indices[node.OutputDefs()[0]] = static_cast<int64_t>(inputs.size() + ops.size() - 1);
+
+    for (auto edge = node.InputEdgesBegin(); edge != node.InputEdgesEnd(); ++edge) {
+      const NodeArg* input_def = node.InputDefs()[edge->GetDstArgIndex()];
+      if (region_outputs.count(input_def) == 0) {
+        InputEdge input_edge{edge->GetNode().Index(), edge->GetSrcArgIndex(),
+                             static_cast<int>(value_indices[input_def])};
+        if (std::none_of(input_edges.begin(), input_edges.end(), [&input_edge](const InputEdge& e) {
+              return e.src_node == input_edge.src_node && e.dst_arg_index == input_edge.dst_arg_index;
+            })) {
+          input_edges.push_back(input_edge);
+        }
+      }
+    }
+  }
+
+  Node& sink = *graph.GetNode(region.back());
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(sink.Name() + "/ElementwiseFusion/"), "FusedElementwise",
+                                   "fused element-wise subgraph", inputs, {}, nullptr, kMSDomain);
+  fused_node.AddAttribute("ops", ops);
+  fused_node.AddAttribute("operands", operands);
+  fused_node.SetExecutionProviderType(sink.GetExecutionProviderType());
+
+  for (NodeIndex index : region.first(region.size() - 1)) {
+    Node& node = *graph.GetNode(index);
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(index);
+  }
+
+  // move the output definitions and edges of the last node of the region to the fused node and remove it.
+  graph_utils::FinalizeNodeFusion(graph, fused_node, sink);
+
+  for (const auto& input_edge : input_edges) {
+    graph.AddEdge(input_edge.src_node, fused_node.Index(), input_edge.src_arg_index, input_edge.dst_arg_index);
+  }
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node != nullptr) {
+      ORT_RETURN_IF_ERROR(Recurse(*p_node, modified, graph_level, logger));
+    }
+  }
+
+  // Visit the nodes in reverse topological order so that all the consumers of a node are assigned to a region
+  // before the node itself. A node joins the region of its consumers if they all belong to the same region and
+  // produce the same shape, else it starts a new region. Every node of a region except the last one therefore
+  // only feeds nodes of the region, so the region can be evaluated as a whole.
+  InlinedHashMap<NodeIndex, size_t> node_regions;
+  std::vector<InlinedVector<NodeIndex>> regions;
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    const Node* p_node = graph.GetNode(*it);
+    if (p_node == nullptr || !IsFusableNode(*p_node) ||
+        !graph_utils::IsSupportedProvider(*p_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node& node = *p_node;
+    size_t region = regions.size();
+    bool join_consumers = node.GetOutputEdgesCount() > 0 && !graph.NodeProducesGraphOutput(node);
+    for (auto edge = node.OutputEdgesBegin(); join_consumers && edge != node.OutputEdgesEnd(); ++edge) {
+      const Node& consumer = edge->GetNode();
+      auto consumer_region = node_regions.find(consumer.Index());
+      join_consumers = consumer_region != node_regions.end() &&
+                       (region == regions.size() || region == consumer_region->second) &&
+                       consumer.GetExecutionProviderType() == node.GetExecutionProviderType() &&
+                       HaveSameShape(*node.OutputDefs()[0], *consumer.OutputDefs()[0]);
+      if (join_consumers) {
+        region = consumer_region->second;
+      }
+    }
+
+    if (!join_consumers) {
+      region = regions.size();
+      regions.emplace_back();
+    }
+    node_regions[node.Index()] = region;
+    regions[region].push_back(node.Index());
+  }
+
+  for (auto& region : regions) {
+    if (region.size() < 2) {
+      continue;
+    }
+
+    std::reverse(region.begin(), region.end());
+    FuseRegion(graph, region);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Rewrite each maximal connected region of float element-wise operators (Add, Sub, Mul, Div, Max, Min, Relu,
+Sigmoid, Tanh, Exp, Log, Sqrt, Reciprocal, Neg, Abs and Where) to a single com.microsoft.FusedElementwise
+node that evaluates the region in one pass over memory.
+
+All the nodes of a region produce the same shape, so that no intermediate value is computed for more elements
+than in the original graph. The inputs of a region may broadcast.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -21,6 +21,23 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node, const std::string& op_t
 // If the op has multiple versions, here we require it must have a single implementation that can work across all the
 // versions. Because in the fusion, we discarded the op version information.
 bool IsFusableActivation(const Node& node) {
+  // The following activations are applied by the MLAS GEMM epilogue, see FusedGemm.
+  if (IsSupportedOptypeVersionAndDomain(node, "Gelu", {20}, kOnnxDomain)) {
+    // Only the exact (erf based) form is implemented.
+    const auto* approximate = graph_utils::GetNodeAttribute(node, "approximate");
+    return approximate == nullptr || approximate->s() == "none";
+  }
+#ifndef DISABLE_CONTRIB_OPS
+  if (IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain)) {
+    return true;
+  }
+  if (IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain)) {
+    // QuickGelu with alpha of 1 is Silu.
+    const auto* alpha = graph_utils::GetNodeAttribute(node, "alpha");
+    return alpha != nullptr && alpha->f() == 1.0f;
+  }
+#endif
+
   return IsSupportedOptypeVersionAndDomain(node, "Elu", {6}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}, kOnnxDomain) ||
@@ -85,12 +102,15 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
     // Assign provider to this new node. Provider should be same as the provider for old node.
     fused_gemm.SetExecutionProviderType(gemm_node.GetExecutionProviderType());
 
-    // Add optional attributes for activations
-    const NodeAttributes& attrs = act_node.GetAttributes();
-    for (const auto& attr : attrs) {
-      AttributeProto fused_gemm_attr(attr.second);
-      fused_gemm_attr.set_name("activation_" + attr.first);
-      fused_gemm.AddAttributeProto(std::move(fused_gemm_attr));
+    // Add optional attributes for activations. The approximate attribute of Gelu is not carried over as
+    // only the exact form is fused.
+    if (act_node.OpType() != "Gelu") {
+      const NodeAttributes& attrs = act_node.GetAttributes();
+      for (const auto& attr : attrs) {
+        AttributeProto fused_gemm_attr(attr.second);
+        fused_gemm_attr.set_name("activation_" + attr.first);
+        fused_gemm.AddAttributeProto(std::move(fused_gemm_attr));
+      }
     }
 
     // move output definitions and edges from act_node to fused_gemm. delete gemm_node and act_node.
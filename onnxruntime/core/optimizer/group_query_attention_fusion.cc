@@ -0,0 +1,943 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_query_attention_fusion.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// All the tensors of the attention are 4D (batch_size, num_heads, sequence_length, head_size) before the output
+// Transpose, so the last axis is either -1 or 3.
+constexpr std::initializer_list<int64_t> kLastAxis = {-1, 3};
+
+const Node* GetInputNodeOfType(const Node& node, int input_index, std::string_view op_type,
+                               std::initializer_list<OperatorSetVersion> versions) {
+  const Node* input_node = graph_utils::GetInputNode(node, input_index);
+  return input_node != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*input_node, op_type, versions)
+             ? input_node
+             : nullptr;
+}
+
+const Node* GetOnlyOutputNode(const Graph& graph, const Node& node) {
+  return node.GetOutputEdgesCount() == 1 && !graph.NodeProducesGraphOutput(node) ? &node.OutputEdgesBegin()->GetNode()
+                                                                                 : nullptr;
+}
+
+bool HasIntAttribute(const Node& node, const std::string& name, std::initializer_list<int64_t> values) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && utils::HasInt(*attr) && std::find(values.begin(), values.end(), attr->i()) != values.end();
+}
+
+bool HasElemType(const NodeArg& arg, std::initializer_list<int32_t> elem_types) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         std::find(elem_types.begin(), elem_types.end(), type->tensor_type().elem_type()) != elem_types.end();
+}
+
+bool HasRank(const NodeArg& arg, int rank) {
+  return arg.Shape() != nullptr && arg.Shape()->dim_size() == rank;
+}
+
+bool GetSingleInt(const Graph& graph, const NodeArg& arg, int64_t& value) {
+  InlinedVector<int64_t> values;
+  if (!optimizer_utils::AppendTensorFromInitializer(graph, arg, values, true) || values.size() != 1) {
+    return false;
+  }
+  value = values[0];
+  return true;
+}
+
+std::optional<float> GetScalarConstant(const Graph& graph, const NodeArg& arg) {
+  const auto* tensor = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor == nullptr) {
+    return std::nullopt;
+  }
+  Initializer initializer{*tensor, graph.ModelPath()};
+  if (initializer.size() != 1) {
+    return std::nullopt;
+  }
+  switch (tensor->data_type()) {
+    case TensorProto_DataType_FLOAT:
+      return *initializer.data<float>();
+    case TensorProto_DataType_FLOAT16:
+      return initializer.data<MLFloat16>()->ToFloat();
+    case TensorProto_DataType_DOUBLE:
+      return static_cast<float>(*initializer.data<double>());
+    default:
+      return std::nullopt;
+  }
+}
+
+// Gets the range of a Slice of the last axis with step 1.
+bool GetLastAxisSlice(const Graph& graph, const Node& slice, int64_t& start, int64_t& end) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(slice, "Slice", {10, 11, 13})) {
+    return false;
+  }
+  const auto& inputs = slice.InputDefs();
+  int64_t axis = 0;
+  int64_t step = 1;
+  return inputs.size() >= 4 && GetSingleInt(graph, *inputs[1], start) && GetSingleInt(graph, *inputs[2], end) &&
+         GetSingleInt(graph, *inputs[3], axis) &&
+         std::find(kLastAxis.begin(), kLastAxis.end(), axis) != kLastAxis.end() &&
+         (inputs.size() < 5 || !inputs[4]->Exists() || (GetSingleInt(graph, *inputs[4], step) && step == 1));
+}
+
+InlinedVector<int64_t> GetUnsqueezeAxes(const Graph& graph, const Node& unsqueeze) {
+  InlinedVector<int64_t> axes;
+  if (unsqueeze.SinceVersion() < 13) {
+    graph_utils::GetRepeatedNodeAttributeValues(unsqueeze, "axes", axes);
+  } else if (unsqueeze.InputDefs().size() > 1) {
+    optimizer_utils::AppendTensorFromInitializer(graph, *unsqueeze.InputDefs()[1], axes);
+  }
+  return axes;
+}
+
+bool IsUnsqueezeOfAxis(const Graph& graph, const Node& unsqueeze, std::initializer_list<int64_t> axis) {
+  const InlinedVector<int64_t> axes = GetUnsqueezeAxes(graph, unsqueeze);
+  return axes.size() == 1 && std::find(axis.begin(), axis.end(), axes[0]) != axis.end();
+}
+
+// Traces the cos or sin input of a Mul back to a constant table of shape (max_position, rotary_dim), possibly with
+// leading dims of 1, that is gathered by position_ids and unsqueezed to (batch_size, 1, sequence_length, rotary_dim).
+// Slices of the table that start at row 0, as HF models take cos_cached[:seq_len] first, do not change the rows that
+// are gathered.
+const TensorProto* GetRotaryTable(Graph& graph, const Node& mul, int input_index, int64_t rotary_dim,
+                                  NodeArg*& position_ids) {
+  const Node* unsqueeze = GetInputNodeOfType(mul, input_index, "Unsqueeze", {1, 11, 13, 21});
+  if (unsqueeze == nullptr || !IsUnsqueezeOfAxis(graph, *unsqueeze, {1, -3})) {
+    return nullptr;
+  }
+  const Node* gather = GetInputNodeOfType(*unsqueeze, 0, "Gather", {1, 11, 13});
+  if (gather == nullptr || (graph_utils::GetNodeAttribute(*gather, "axis") != nullptr &&
+                            !HasIntAttribute(*gather, "axis", {0}))) {
+    return nullptr;
+  }
+
+  const Node* table_node = gather;
+  while (const Node* producer = graph_utils::GetInputNode(*table_node, 0)) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Squeeze", {1, 11, 13, 21})) {
+      table_node = producer;
+      continue;
+    }
+    InlinedVector<int64_t> starts;
+    InlinedVector<int64_t> steps;
+    const auto& slice_inputs = producer->InputDefs();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Slice", {10, 11, 13}) ||
+        !optimizer_utils::AppendTensorFromInitializer(graph, *slice_inputs[1], starts) ||
+        std::any_of(starts.begin(), starts.end(), [](int64_t start) { return start != 0; }) ||
+        (slice_inputs.size() >= 5 && slice_inputs[4]->Exists() &&
+         (!optimizer_utils::AppendTensorFromInitializer(graph, *slice_inputs[4], steps) ||
+          std::any_of(steps.begin(), steps.end(), [](int64_t step) { return step != 1; })))) {
+      return nullptr;
+    }
+    table_node = producer;
+  }
+
+  const TensorProto* table = graph_utils::GetConstantInitializer(graph, table_node->InputDefs()[0]->Name());
+  if (table == nullptr || table->dims_size() < 2 || table->dims(table->dims_size() - 1) != rotary_dim) {
+    return nullptr;
+  }
+  for (int i = 0; i < table->dims_size() - 2; ++i) {
+    if (table->dims(i) != 1) {
+      return nullptr;
+    }
+  }
+
+  const NodeArg* indices = gather->InputDefs()[1];
+  if (!HasElemType(*indices, {TensorProto_DataType_INT64}) || (position_ids != nullptr && position_ids != indices)) {
+    return nullptr;
+  }
+  position_ids = graph.GetNodeArg(indices->Name());
+  return table;
+}
+
+struct RotaryMatch {
+  const Node* input = nullptr;  // producer of the rotated value x
+  const TensorProto* cos_table = nullptr;
+  const TensorProto* sin_table = nullptr;
+  NodeArg* position_ids = nullptr;
+  int64_t rotary_dim = 0;
+};
+
+// Matches x * cos + rotate_half(x) * sin, where rotate_half(x) = Concat(-x[..., half:], x[..., :half]).
+bool MatchRotary(Graph& graph, const Node& add, RotaryMatch& match, InlinedVector<const Node*>& nodes) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(add, "Add", {7, 13, 14})) {
+    return false;
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    const Node* cos_mul = GetInputNodeOfType(add, i, "Mul", {7, 13, 14});
+    const Node* sin_mul = GetInputNodeOfType(add, 1 - i, "Mul", {7, 13, 14});
+    if (cos_mul == nullptr || sin_mul == nullptr) {
+      continue;
+    }
+
+    for (int j = 0; j < 2; ++j) {
+      const Node* concat = GetInputNodeOfType(*sin_mul, j, "Concat", {4, 11, 13});
+      if (concat == nullptr || concat->InputDefs().size() != 2 || !HasIntAttribute(*concat, "axis", kLastAxis)) {
+        continue;
+      }
+      const Node* neg = GetInputNodeOfType(*concat, 0, "Neg", {6, 13});
+      const Node* low_slice = graph_utils::GetInputNode(*concat, 1);
+      const Node* high_slice = neg != nullptr ? graph_utils::GetInputNode(*neg, 0) : nullptr;
+      int64_t low_start = 0, low_end = 0, high_start = 0, high_end = 0;
+      if (low_slice == nullptr || high_slice == nullptr ||
+          !GetLastAxisSlice(graph, *low_slice, low_start, low_end) ||
+          !GetLastAxisSlice(graph, *high_slice, high_start, high_end) ||
+          low_start != 0 || low_end <= 0 || high_start != low_end || high_end < 2 * low_end ||
+          low_slice->InputDefs()[0] != high_slice->InputDefs()[0]) {
+        continue;
+      }
+
+      const NodeArg* x = low_slice->InputDefs()[0];
+      const int x_index = cos_mul->InputDefs()[0] == x ? 0 : (cos_mul->InputDefs()[1] == x ? 1 : -1);
+      match.input = graph_utils::GetInputNode(*low_slice, 0);
+      if (x_index < 0 || match.input == nullptr) {
+        continue;
+      }
+
+      match.rotary_dim = 2 * low_end;
+      match.position_ids = nullptr;
+      match.cos_table = GetRotaryTable(graph, *cos_mul, 1 - x_index, match.rotary_dim, match.position_ids);
+      match.sin_table = GetRotaryTable(graph, *sin_mul, 1 - j, match.rotary_dim, match.position_ids);
+      if (match.cos_table == nullptr || match.sin_table == nullptr) {
+        return false;
+      }
+
+      nodes.insert(nodes.end(), {&add, cos_mul, sin_mul, concat, neg, low_slice, high_slice});
+      return true;
+    }
+  }
+  return false;
+}
+
+struct ProjectionMatch {
+  NodeArg* projection = nullptr;  // (batch_size, sequence_length, num_heads * head_size)
+  int64_t num_heads = 0;
+  int64_t head_size = 0;
+  RotaryMatch rotary;  // set when the value is rotated
+};
+
+// Matches input input_index of consumer as Transpose(Reshape(projection), perm=(0, 2, 1, 3)), rotated by RoPE if
+// rotary is true. Phi rotates only the first rotary_dim dims: Concat(RoPE(x[..., :rotary_dim]), x[..., rotary_dim:]).
+bool MatchProjection(Graph& graph, const Node& consumer, int input_index, bool rotary, ProjectionMatch& match,
+                     InlinedVector<const Node*>& nodes) {
+  const Node* transpose = graph_utils::GetInputNode(consumer, input_index);
+  int64_t pass_end = 0;
+  if (rotary) {
+    const Node* embed = transpose;
+    const Node* pass_slice = nullptr;
+    if (embed != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*embed, "Concat", {4, 11, 13})) {
+      if (embed->InputDefs().size() != 2 || !HasIntAttribute(*embed, "axis", kLastAxis)) {
+        return false;
+      }
+      nodes.push_back(embed);
+      pass_slice = graph_utils::GetInputNode(*embed, 1);
+      embed = graph_utils::GetInputNode(*embed, 0);
+      if (pass_slice == nullptr) {
+        return false;
+      }
+    }
+
+    if (embed == nullptr || !MatchRotary(graph, *embed, match.rotary, nodes)) {
+      return false;
+    }
+    transpose = match.rotary.input;
+
+    if (pass_slice != nullptr) {
+      int64_t start = 0, end = 0, pass_start = 0;
+      if (!GetLastAxisSlice(graph, *transpose, start, end) || start != 0 || end != match.rotary.rotary_dim ||
+          !GetLastAxisSlice(graph, *pass_slice, pass_start, pass_end) || pass_start != match.rotary.rotary_dim ||
+          pass_slice->InputDefs()[0] != transpose->InputDefs()[0]) {
+        return false;
+      }
+      nodes.insert(nodes.end(), {pass_slice, transpose});
+      transpose = graph_utils::GetInputNode(*transpose, 0);
+    }
+  }
+
+  if (transpose == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*transpose, "Transpose", {1, 13, 21}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(*transpose, "perm", {0, 2, 1, 3})) {
+    return false;
+  }
+  const Node* reshape = GetInputNodeOfType(*transpose, 0, "Reshape", {5, 13, 14, 19, 21});
+  if (reshape == nullptr) {
+    return false;
+  }
+  nodes.insert(nodes.end(), {transpose, reshape});
+
+  // The number of heads and the head size come from the shape of the transposed value, or from the Reshape.
+  const auto* shape = transpose->OutputDefs()[0]->Shape();
+  InlinedVector<int64_t> reshape_shape;
+  if (shape != nullptr && shape->dim_size() == 4 && utils::HasDimValue(shape->dim(1)) &&
+      utils::HasDimValue(shape->dim(3))) {
+    match.num_heads = shape->dim(1).dim_value();
+    match.head_size = shape->dim(3).dim_value();
+  } else if (optimizer_utils::AppendTensorFromInitializer(graph, *reshape->InputDefs()[1], reshape_shape) &&
+             reshape_shape.size() == 4 && reshape_shape[2] > 0 && reshape_shape[3] > 0) {
+    match.num_heads = reshape_shape[2];
+    match.head_size = reshape_shape[3];
+  } else {
+    return false;
+  }
+
+  match.projection = graph.GetNodeArg(reshape->InputDefs()[0]->Name());
+  if (!HasRank(*match.projection, 3) || match.num_heads <= 0 || match.head_size <= 0) {
+    return false;
+  }
+  if (rotary) {
+    const bool partial = pass_end > 0;
+    return partial ? match.rotary.rotary_dim < match.head_size && pass_end >= match.head_size
+                   : match.rotary.rotary_dim == match.head_size;
+  }
+  return true;
+}
+
+// Skips repeat_kv, Reshape(Expand(Unsqueeze(x, axes=2))), that repeats the key and value heads for each group of
+// query heads, and returns the producer of x.
+const Node* SkipRepeatKv(const Graph& graph, const Node& consumer, int input_index, bool& repeated,
+                         InlinedVector<const Node*>& nodes) {
+  const Node* node = graph_utils::GetInputNode(consumer, input_index);
+  repeated = false;
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Reshape", {5, 13, 14, 19, 21})) {
+    return node;
+  }
+  const Node* expand = GetInputNodeOfType(*node, 0, "Expand", {8, 13});
+  const Node* unsqueeze = expand != nullptr ? GetInputNodeOfType(*expand, 0, "Unsqueeze", {1, 11, 13, 21}) : nullptr;
+  if (unsqueeze == nullptr || !IsUnsqueezeOfAxis(graph, *unsqueeze, {2, -3})) {
+    return nullptr;
+  }
+  repeated = true;
+  nodes.insert(nodes.end(), {node, expand, unsqueeze});
+  return graph_utils::GetInputNode(*unsqueeze, 0);
+}
+
+// Additive mask values at or below this exclude a key: their softmax weight is below the float precision of the
+// weights of the attended keys, so GroupQueryAttention, which skips the key, computes the same output.
+constexpr float kMaskedValue = -10000.0f;
+
+// Skips the Unsqueeze, Expand and Cast nodes that turn a (sequence_length, total_sequence_length) mask into a 4D
+// mask. The Unsqueeze nodes may only add leading axes.
+const NodeArg* SkipMaskExpansion(const Graph& graph, const NodeArg* mask) {
+  while (const Node* producer = graph.GetProducerNode(mask->Name())) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Unsqueeze", {1, 11, 13, 21})) {
+      const NodeArg& output = *producer->OutputDefs()[0];
+      if (output.Shape() == nullptr) {
+        break;
+      }
+      const int64_t rank = output.Shape()->dim_size();
+      const InlinedVector<int64_t> axes = GetUnsqueezeAxes(graph, *producer);
+      if (axes.empty() || std::any_of(axes.begin(), axes.end(), [rank](int64_t axis) {
+            return (axis < 0 ? axis + rank : axis) >= rank - 2;
+          })) {
+        break;
+      }
+    } else if (!graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Expand", {8, 13}) &&
+               !(graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Cast", {6, 9, 13, 19}) &&
+                 HasElemType(*producer->OutputDefs()[0],
+                             {TensorProto_DataType_FLOAT, TensorProto_DataType_FLOAT16}))) {
+      break;
+    }
+    mask = producer->InputDefs()[0];
+  }
+  return mask;
+}
+
+std::optional<float> GetFloatValue(const Initializer& initializer, size_t index) {
+  switch (initializer.data_type()) {
+    case TensorProto_DataType_FLOAT:
+      return initializer.data<float>()[index];
+    case TensorProto_DataType_FLOAT16:
+      return initializer.data<MLFloat16>()[index].ToFloat();
+    default:
+      return std::nullopt;
+  }
+}
+
+// Checks that a constant mask of shape (..., sequence_length, total_sequence_length) with leading dims of 1 is
+// causal: the query i sees exactly the keys up to past_sequence_length + i, where past_sequence_length is
+// total_sequence_length - sequence_length. Any other table, like a sliding window or a bidirectional mask, fails.
+bool IsCausalMaskTable(const Graph& graph, const TensorProto& table, int64_t sequence_length) {
+  const int rank = table.dims_size();
+  if (rank < 2 || table.dims(rank - 2) != sequence_length || table.dims(rank - 1) < sequence_length) {
+    return false;
+  }
+  for (int i = 0; i < rank - 2; ++i) {
+    if (table.dims(i) != 1) {
+      return false;
+    }
+  }
+
+  Initializer initializer{table, graph.ModelPath()};
+  const int64_t total_sequence_length = table.dims(rank - 1);
+  const int64_t past_sequence_length = total_sequence_length - sequence_length;
+  for (int64_t i = 0; i < sequence_length; ++i) {
+    for (int64_t j = 0; j < total_sequence_length; ++j) {
+      const auto value = GetFloatValue(initializer, static_cast<size_t>(i * total_sequence_length + j));
+      if (!value.has_value() || (j <= past_sequence_length + i ? *value != 0.0f : *value > kMaskedValue)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Checks whether two values are computed by the same nodes from the same inputs, or are equal constants.
+bool IsSameValue(const Graph& graph, const NodeArg& a, const NodeArg& b, int depth = 4) {
+  if (&a == &b) {
+    return true;
+  }
+
+  const TensorProto* a_tensor = graph_utils::GetConstantInitializer(graph, a.Name());
+  const TensorProto* b_tensor = graph_utils::GetConstantInitializer(graph, b.Name());
+  if (a_tensor != nullptr && b_tensor != nullptr) {
+    Initializer a_initializer{*a_tensor, graph.ModelPath()};
+    Initializer b_initializer{*b_tensor, graph.ModelPath()};
+    const auto a_bytes = a_initializer.DataAsByteSpan();
+    const auto b_bytes = b_initializer.DataAsByteSpan();
+    return a_initializer.data_type() == b_initializer.data_type() &&
+           std::equal(a_initializer.dims().begin(), a_initializer.dims().end(), b_initializer.dims().begin(),
+                      b_initializer.dims().end()) &&
+           std::equal(a_bytes.begin(), a_bytes.end(), b_bytes.begin(), b_bytes.end());
+  }
+
+  const Node* a_node = graph.GetProducerNode(a.Name());
+  const Node* b_node = graph.GetProducerNode(b.Name());
+  if (depth == 0 || a_node == nullptr || b_node == nullptr || a_node->OpType() != b_node->OpType() ||
+      a_node->Domain() != b_node->Domain() || a_node->OutputDefs().size() != 1 ||
+      b_node->OutputDefs().size() != 1 || a_node->InputDefs().size() != b_node->InputDefs().size() ||
+      a_node->GetAttributes().size() != b_node->GetAttributes().size()) {
+    return false;
+  }
+  for (const auto& [name, attr] : a_node->GetAttributes()) {
+    const auto* b_attr = graph_utils::GetNodeAttribute(*b_node, name);
+    if (b_attr == nullptr || b_attr->SerializeAsString() != attr.SerializeAsString()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < a_node->InputDefs().size(); ++i) {
+    if (!IsSameValue(graph, *a_node->InputDefs()[i], *b_node->InputDefs()[i], depth - 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Gets the value that a ConstantOfShape fills its output with, which is 0 without the value attribute.
+std::optional<float> GetConstantOfShapeValue(const Graph& graph, const Node& node) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, "value");
+  if (attr == nullptr) {
+    return 0.0f;
+  }
+  if (!utils::HasTensor(*attr)) {
+    return std::nullopt;
+  }
+  Initializer initializer{attr->t(), graph.ModelPath()};
+  return initializer.size() == 1 ? GetFloatValue(initializer, 0) : std::nullopt;
+}
+
+// Matches the causal mask that HF models compute for dynamic shapes,
+//   Concat(ConstantOfShape((s, past_sequence_length), 0), Trilu(ConstantOfShape((s, s), min), k=1), axis=-1)
+// where the Concat is absent without past. The triangle of masked keys must be square, so that the query i sees
+// exactly the keys up to past_sequence_length + i, and the Concat makes its rows match those of the zeros.
+bool IsCausalTriluMask(const Graph& graph, const NodeArg& mask) {
+  const Node* trilu = graph.GetProducerNode(mask.Name());
+  if (trilu != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*trilu, "Concat", {4, 11, 13})) {
+    const Node* concat = trilu;
+    if (concat->InputDefs().size() != 2 || !HasIntAttribute(*concat, "axis", {-1, 1})) {
+      return false;
+    }
+    const Node* zeros = graph.GetProducerNode(concat->InputDefs()[0]->Name());
+    if (zeros == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*zeros, "ConstantOfShape", {9, 20, 21}) ||
+        GetConstantOfShapeValue(graph, *zeros) != 0.0f) {
+      return false;
+    }
+    trilu = graph.GetProducerNode(concat->InputDefs()[1]->Name());
+  }
+
+  int64_t k = 0;
+  if (trilu == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*trilu, "Trilu", {14}) ||
+      (graph_utils::GetNodeAttribute(*trilu, "upper") != nullptr && !HasIntAttribute(*trilu, "upper", {1})) ||
+      trilu->InputDefs().size() < 2 || !GetSingleInt(graph, *trilu->InputDefs()[1], k) || k != 1) {
+    return false;
+  }
+
+  const Node* full = graph.GetProducerNode(trilu->InputDefs()[0]->Name());
+  if (full == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*full, "ConstantOfShape", {9, 20, 21}) ||
+      !HasRank(*full->OutputDefs()[0], 2)) {
+    return false;
+  }
+  const auto masked_value = GetConstantOfShapeValue(graph, *full);
+  if (!masked_value.has_value() || *masked_value > kMaskedValue) {
+    return false;
+  }
+
+  // The shape is a constant (s, s), or Concat(s, s) of a dynamic s.
+  const NodeArg& shape = *full->InputDefs()[0];
+  InlinedVector<int64_t> dims;
+  if (optimizer_utils::AppendTensorFromInitializer(graph, shape, dims)) {
+    return dims.size() == 2 && dims[0] == dims[1];
+  }
+  const Node* shape_concat = graph.GetProducerNode(shape.Name());
+  return shape_concat != nullptr &&
+         graph_utils::IsSupportedOptypeVersionAndDomain(*shape_concat, "Concat", {4, 11, 13}) &&
+         shape_concat->InputDefs().size() == 2 &&
+         IsSameValue(graph, *shape_concat->InputDefs()[0], *shape_concat->InputDefs()[1]);
+}
+
+// Checks that an additive mask of the attention scores is exactly the causal mask of GroupQueryAttention, possibly
+// expanded to 4D. sequence_length is the length of the query if it is known, else -1.
+bool IsCausalMask(const Graph& graph, const NodeArg& mask, int64_t sequence_length) {
+  const NodeArg* causal_mask = SkipMaskExpansion(graph, &mask);
+  if (const TensorProto* table = graph_utils::GetConstantInitializer(graph, causal_mask->Name())) {
+    // A table that is broadcast over the queries would apply its row to all of them, so its rows must match the
+    // queries, which needs a known length.
+    return sequence_length > 0 && IsCausalMaskTable(graph, *table, sequence_length);
+  }
+  return IsCausalTriluMask(graph, *causal_mask);
+}
+
+NodeArg& AddIntInitializer(Graph& graph, const std::string& name, int32_t elem_type,
+                           std::initializer_list<int64_t> values, bool is_scalar) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(name));
+  tensor.set_data_type(elem_type);
+  if (!is_scalar) {
+    tensor.add_dims(static_cast<int64_t>(values.size()));
+  }
+  for (int64_t value : values) {
+    if (elem_type == TensorProto_DataType_INT32) {
+      tensor.add_int32_data(static_cast<int32_t>(value));
+    } else {
+      tensor.add_int64_data(value);
+    }
+  }
+  return graph_utils::AddInitializer(graph, tensor);
+}
+
+NodeArg& AddNodeOutput(Graph& graph, const std::string& name, int32_t elem_type) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(name), &type);
+}
+
+struct SequenceLengths {
+  NodeArg* seqlens_k = nullptr;
+  NodeArg* total_sequence_length = nullptr;
+};
+
+// Computes the sequence lengths of GroupQueryAttention from the shapes, as all the batches have the same lengths
+// once the padding of the keys is applied by attention_bias:
+//   total_sequence_length = Shape(past_key)[2] + Shape(query)[1]
+//   seqlens_k = Expand(total_sequence_length - 1, Shape(query)[:1])
+SequenceLengths CreateSequenceLengths(Graph& graph, NodeArg& query, NodeArg& past_key, const std::string& provider) {
+  auto add_node = [&](const std::string& op_type, std::initializer_list<NodeArg*> inputs, NodeArg& output) -> Node& {
+    Node& node = graph.AddNode(graph.GenerateNodeName("GroupQueryAttention_" + op_type), op_type,
+                               "sequence lengths of GroupQueryAttention", inputs, {&output});
+    node.SetExecutionProviderType(provider);
+    return node;
+  };
+  auto gather = [&](NodeArg& shape, std::initializer_list<int64_t> index, bool is_scalar, const std::string& name)
+      -> NodeArg& {
+    NodeArg& output = AddNodeOutput(graph, name, TensorProto_DataType_INT64);
+    add_node("Gather", {&shape, &AddIntInitializer(graph, name + "_index", TensorProto_DataType_INT64, index,
+                                                   is_scalar)},
+             output)
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    return output;
+  };
+
+  NodeArg& query_shape = AddNodeOutput(graph, "query_shape", TensorProto_DataType_INT64);
+  add_node("Shape", {&query}, query_shape);
+  NodeArg& past_key_shape = AddNodeOutput(graph, "past_key_shape", TensorProto_DataType_INT64);
+  add_node("Shape", {&past_key}, past_key_shape);
+
+  NodeArg& total_length = AddNodeOutput(graph, "total_sequence_length", TensorProto_DataType_INT64);
+  add_node("Add", {&gather(past_key_shape, {2}, true, "past_sequence_length"),
+                   &gather(query_shape, {1}, true, "sequence_length")},
+           total_length);
+  NodeArg& total_length_int32 = AddNodeOutput(graph, "total_sequence_length_int32", TensorProto_DataType_INT32);
+  add_node("Cast", {&total_length}, total_length_int32)
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+
+  NodeArg& seqlen = AddNodeOutput(graph, "seqlen_k", TensorProto_DataType_INT32);
+  add_node("Sub", {&total_length_int32, &AddIntInitializer(graph, "one", TensorProto_DataType_INT32, {1}, true)},
+           seqlen);
+  NodeArg& seqlens_k = AddNodeOutput(graph, "seqlens_k", TensorProto_DataType_INT32);
+  add_node("Expand", {&seqlen, &gather(query_shape, {0}, false, "batch_size")}, seqlens_k);
+
+  return {&seqlens_k, &total_length_int32};
+}
+
+// Creates the (max_position, rotary_dim / 2) cache of RotaryEmbedding from a HF table, whose rows are the
+// concatenation of two copies of the frequencies. Returns nullptr if the halves of a row differ.
+NodeArg* CreateRotaryCache(Graph& graph, const TensorProto& table) {
+  std::vector<uint8_t> data;
+  if (!utils::UnpackInitializerData(table, graph.ModelPath(), data).IsOK()) {
+    return nullptr;
+  }
+  const size_t element_size = table.data_type() == TensorProto_DataType_FLOAT ? sizeof(float) : sizeof(MLFloat16);
+  const int64_t rotary_dim = table.dims(table.dims_size() - 1);
+  const size_t half_row_size = static_cast<size_t>(rotary_dim / 2) * element_size;
+  const size_t rows = data.size() / (2 * half_row_size);
+
+  std::vector<uint8_t> cache(rows * half_row_size);
+  for (size_t row = 0; row < rows; ++row) {
+    const uint8_t* table_row = data.data() + row * 2 * half_row_size;
+    if (std::memcmp(table_row, table_row + half_row_size, half_row_size) != 0) {
+      return nullptr;
+    }
+    std::memcpy(cache.data() + row * half_row_size, table_row, half_row_size);
+  }
+
+  TensorProto cache_tensor;
+  cache_tensor.set_name(graph.GenerateNodeArgName(table.name() + "_cache"));
+  cache_tensor.set_data_type(table.data_type());
+  cache_tensor.add_dims(static_cast<int64_t>(rows));
+  cache_tensor.add_dims(rotary_dim / 2);
+  utils::SetRawDataInTensorProto(cache_tensor, cache.data(), cache.size());
+  return &graph_utils::AddInitializer(graph, cache_tensor);
+}
+
+// State shared by the fusions of all the layers of a graph.
+struct FusionState {
+  InlinedHashMap<std::string, NodeArg*> rotary_caches;  // by table name, nullptr if not convertible
+  InlinedHashSet<std::string> fused_inputs;             // values consumed by the fused nodes
+  InlinedVector<NodeIndex> removal_candidates;          // producers of the inputs of removed nodes
+};
+
+NodeArg* GetOrCreateRotaryCache(Graph& graph, const TensorProto& table, FusionState& state) {
+  auto it = state.rotary_caches.find(table.name());
+  if (it == state.rotary_caches.end()) {
+    it = state.rotary_caches.emplace(table.name(), CreateRotaryCache(graph, table)).first;
+  }
+  return it->second;
+}
+
+bool FuseGroupQueryAttention(Graph& graph, const Node& softmax,
+                             const InlinedHashSet<std::string_view>& compatible_providers, FusionState& state) {
+  InlinedVector<const Node*> nodes{&softmax};
+  if (!(graph_utils::GetNodeAttribute(softmax, "axis") == nullptr ? softmax.SinceVersion() >= 13
+                                                                   : HasIntAttribute(softmax, "axis", kLastAxis))) {
+    return false;
+  }
+
+  // The softmax may be computed in float: Cast(Softmax(Cast(scores))).
+  const Node* scores_add = graph_utils::GetInputNode(softmax, 0);
+  if (scores_add != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*scores_add, "Cast", {6, 9, 13, 19})) {
+    nodes.push_back(scores_add);
+    scores_add = graph_utils::GetInputNode(*scores_add, 0);
+  }
+  const Node* probs = &softmax;
+  const Node* pv_matmul = GetOnlyOutputNode(graph, softmax);
+  if (pv_matmul != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*pv_matmul, "Cast", {6, 9, 13, 19})) {
+    probs = pv_matmul;
+    nodes.push_back(probs);
+    pv_matmul = GetOnlyOutputNode(graph, *probs);
+  }
+  if (scores_add == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*scores_add, "Add", {7, 13, 14}) ||
+      pv_matmul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*pv_matmul, "MatMul", {1, 9, 13}) ||
+      graph_utils::GetInputNode(*pv_matmul, 0) != probs) {
+    return false;
+  }
+  nodes.insert(nodes.end(), {scores_add, pv_matmul});
+
+  // Add(MatMul(q, Transpose(k)) * scale, mask), where the scale is a Div or a Mul by a constant, or absent.
+  const Node* qk_matmul = nullptr;
+  const Node* scale_node = nullptr;
+  float scale = 1.0f;
+  int mask_index = -1;
+  for (int i = 0; i < 2 && qk_matmul == nullptr; ++i) {
+    const Node* scores = graph_utils::GetInputNode(*scores_add, i);
+    scale_node = nullptr;
+    scale = 1.0f;
+    if (scores == nullptr) {
+      continue;
+    }
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*scores, "Div", {7, 13, 14})) {
+      const auto divisor = GetScalarConstant(graph, *scores->InputDefs()[1]);
+      if (divisor.has_value() && *divisor != 0.0f) {
+        scale = 1.0f / *divisor;
+        scale_node = scores;
+        scores = graph_utils::GetInputNode(*scores, 0);
+      }
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*scores, "Mul", {7, 13, 14})) {
+      for (int j = 0; j < 2 && scale_node == nullptr; ++j) {
+        const auto multiplier = GetScalarConstant(graph, *scores->InputDefs()[j]);
+        if (multiplier.has_value()) {
+          scale = *multiplier;
+          scale_node = scores;
+          scores = graph_utils::GetInputNode(*scores, 1 - j);
+        }
+      }
+    }
+    if (scores != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*scores, "MatMul", {1, 9, 13})) {
+      qk_matmul = scores;
+      mask_index = 1 - i;
+    }
+  }
+  if (qk_matmul == nullptr) {
+    return false;
+  }
+  if (scale_node != nullptr) {
+    nodes.push_back(scale_node);
+  }
+  nodes.push_back(qk_matmul);
+
+  const Node* k_transpose = GetInputNodeOfType(*qk_matmul, 1, "Transpose", {1, 13, 21});
+  if (k_transpose == nullptr || !optimizer_utils::IsAttributeWithExpectedValues(*k_transpose, "perm", {0, 1, 3, 2})) {
+    return false;
+  }
+  nodes.push_back(k_transpose);
+
+  // present_key = Concat(past_key, k) and present_value = Concat(past_value, v), possibly repeated for each group.
+  bool k_repeated = false;
+  bool v_repeated = false;
+  const Node* k_concat = SkipRepeatKv(graph, *k_transpose, 0, k_repeated, nodes);
+  const Node* v_concat = SkipRepeatKv(graph, *pv_matmul, 1, v_repeated, nodes);
+  for (const Node* concat : {k_concat, v_concat}) {
+    if (concat == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*concat, "Concat", {4, 11, 13}) ||
+        concat->InputDefs().size() != 2 || !HasIntAttribute(*concat, "axis", {2, -2})) {
+      return false;
+    }
+    nodes.push_back(concat);
+  }
+
+  ProjectionMatch q, k, v;
+  if (!MatchProjection(graph, *qk_matmul, 0, true, q, nodes) || !MatchProjection(graph, *k_concat, 1, true, k, nodes) ||
+      !MatchProjection(graph, *v_concat, 1, false, v, nodes)) {
+    return false;
+  }
+
+  // The head size must be a multiple of 8 for the GroupQueryAttention kernel.
+  if (q.head_size != k.head_size || q.head_size != v.head_size || q.head_size % 8 != 0 ||
+      k.num_heads != v.num_heads || q.num_heads % k.num_heads != 0 ||
+      (q.num_heads != k.num_heads && (!k_repeated || !v_repeated))) {
+    return false;
+  }
+  const int32_t elem_type = q.projection->TypeAsProto()->tensor_type().elem_type();
+  if (!HasElemType(*q.projection, {TensorProto_DataType_FLOAT, TensorProto_DataType_FLOAT16}) ||
+      q.rotary.cos_table->data_type() != elem_type || q.rotary.sin_table->data_type() != elem_type ||
+      k.rotary.cos_table->data_type() != elem_type || k.rotary.sin_table->data_type() != elem_type) {
+    return false;
+  }
+
+  // output = Reshape(Transpose(MatMul(probs, v), perm=(0, 2, 1, 3))) with shape (batch_size, sequence_length, hidden)
+  const Node* output_transpose = GetOnlyOutputNode(graph, *pv_matmul);
+  const Node* output_reshape = output_transpose != nullptr ? GetOnlyOutputNode(graph, *output_transpose) : nullptr;
+  if (output_transpose == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*output_transpose, "Transpose", {1, 13, 21}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(*output_transpose, "perm", {0, 2, 1, 3}) ||
+      output_reshape == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*output_reshape, "Reshape", {5, 13, 14, 19, 21}) ||
+      !HasRank(*output_reshape->OutputDefs()[0], 3)) {
+    return false;
+  }
+  const auto& output_hidden = output_reshape->OutputDefs()[0]->Shape()->dim(2);
+  if (utils::HasDimValue(output_hidden) && output_hidden.dim_value() != q.num_heads * q.head_size) {
+    return false;
+  }
+  nodes.insert(nodes.end(), {output_transpose, output_reshape});
+
+  // All the intermediate values must be internal to the attention. The present key and value and the output are
+  // produced by GroupQueryAttention instead.
+  const std::string& provider = softmax.GetExecutionProviderType();
+  InlinedHashSet<NodeIndex> node_indices;
+  for (const Node* node : nodes) {
+    node_indices.insert(node->Index());
+  }
+  for (const Node* node : nodes) {
+    if (!graph_utils::IsSupportedProvider(*node, compatible_providers) ||
+        node->GetExecutionProviderType() != provider) {
+      return false;
+    }
+    if (node == k_concat || node == v_concat || node == output_reshape) {
+      continue;
+    }
+    if (graph.NodeProducesGraphOutput(*node)) {
+      return false;
+    }
+    for (auto edge = node->OutputEdgesBegin(); edge != node->OutputEdgesEnd(); ++edge) {
+      if (node_indices.count(edge->GetNode().Index()) == 0) {
+        return false;
+      }
+    }
+  }
+
+  // GroupQueryAttention only accepts more than one new token with a past context for a batch of 1, which the
+  // decomposed attention does not require. Fuse only if the batch size or the sequence length is known to be 1, so
+  // that a batched prefill of a chunk or the verification of speculative tokens keep running.
+  const auto* query_shape = q.projection->Shape();
+  const int64_t sequence_length = utils::HasDimValue(query_shape->dim(1)) ? query_shape->dim(1).dim_value() : -1;
+  const int64_t batch_size = utils::HasDimValue(query_shape->dim(0)) ? query_shape->dim(0).dim_value() : -1;
+  if (batch_size != 1 && sequence_length != 1) {
+    return false;
+  }
+
+  // The mask is the causal mask, or the sum of the causal mask and a bias like the padding of the keys, which is
+  // passed to GroupQueryAttention as attention_bias. Other masks, like sliding windows, are not fused.
+  const NodeArg& mask = *scores_add->InputDefs()[mask_index];
+  NodeArg* attention_bias = nullptr;
+  if (!IsCausalMask(graph, mask, sequence_length)) {
+    const Node* mask_add = graph.GetProducerNode(mask.Name());
+    if (mask_add == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*mask_add, "Add", {7, 13, 14})) {
+      return false;
+    }
+    for (int i = 0; i < 2 && attention_bias == nullptr; ++i) {
+      if (IsCausalMask(graph, *mask_add->InputDefs()[i], sequence_length)) {
+        attention_bias = graph.GetNodeArg(mask_add->InputDefs()[1 - i]->Name());
+      }
+    }
+    if (attention_bias == nullptr || !HasRank(*attention_bias, 4) || !HasElemType(*attention_bias, {elem_type})) {
+      return false;
+    }
+
+    // The bias is (batch_size or 1, num_heads or 1, sequence_length or 1, total_sequence_length).
+    const auto& bias_dims = attention_bias->Shape()->dim();
+    auto is_dim_in = [](const TensorShapeProto_Dimension& dim, std::initializer_list<int64_t> values) {
+      return !utils::HasDimValue(dim) || std::find(values.begin(), values.end(), dim.dim_value()) != values.end();
+    };
+    if (!is_dim_in(bias_dims[1], {1, q.num_heads}) || !is_dim_in(bias_dims[2], {1, sequence_length}) ||
+        (utils::HasDimValue(bias_dims[3]) && bias_dims[3].dim_value() == 1 && sequence_length != 1)) {
+      return false;
+    }
+  }
+
+  NodeArg* q_cos_cache = GetOrCreateRotaryCache(graph, *q.rotary.cos_table, state);
+  NodeArg* q_sin_cache = GetOrCreateRotaryCache(graph, *q.rotary.sin_table, state);
+  NodeArg* k_cos_cache = GetOrCreateRotaryCache(graph, *k.rotary.cos_table, state);
+  NodeArg* k_sin_cache = GetOrCreateRotaryCache(graph, *k.rotary.sin_table, state);
+  if (q_cos_cache == nullptr || q_sin_cache == nullptr || k_cos_cache == nullptr ||
+      k_sin_cache == nullptr) {
+    return false;
+  }
+
+  auto mutable_def = [&graph](const NodeArg* arg) { return graph.GetNodeArg(arg->Name()); };
+  const SequenceLengths sequence_lengths =
+      CreateSequenceLengths(graph, *q.projection, *mutable_def(k_concat->InputDefs()[0]), provider);
+
+  auto add_rotary_embedding = [&](const ProjectionMatch& projection, NodeArg* cos_cache,
+                                  NodeArg* sin_cache) -> NodeArg* {
+    NodeArg& output = AddNodeOutput(graph, projection.projection->Name() + "_rotary", elem_type);
+    Node& node = graph.AddNode(graph.GenerateNodeName("RotaryEmbedding"), "RotaryEmbedding",
+                               "fused rotary embedding", {projection.projection, projection.rotary.position_ids,
+                                                          cos_cache, sin_cache},
+                               {&output}, nullptr, kMSDomain);
+    if (projection.rotary.rotary_dim < projection.head_size) {
+      node.AddAttribute("rotary_embedding_dim", projection.rotary.rotary_dim);
+      node.AddAttribute("num_heads", projection.num_heads);
+    }
+    node.SetExecutionProviderType(provider);
+    return &output;
+  };
+  NodeArg* q_rotary = add_rotary_embedding(q, q_cos_cache, q_sin_cache);
+  NodeArg* k_rotary = add_rotary_embedding(k, k_cos_cache, k_sin_cache);
+
+  // The optional inputs between total_sequence_length and attention_bias are absent.
+  NodeArg& empty = graph.GetOrCreateNodeArg("", nullptr);
+  InlinedVector<NodeArg*> inputs{q_rotary, k_rotary, v.projection, mutable_def(k_concat->InputDefs()[0]),
+                                 mutable_def(v_concat->InputDefs()[0]), sequence_lengths.seqlens_k,
+                                 sequence_lengths.total_sequence_length};
+  if (attention_bias != nullptr) {
+    inputs.insert(inputs.end(), {&empty, &empty, &empty, &empty, attention_bias});
+  }
+  const std::array outputs{mutable_def(output_reshape->OutputDefs()[0]), mutable_def(k_concat->OutputDefs()[0]),
+                           mutable_def(v_concat->OutputDefs()[0])};
+  Node& gqa = graph.AddNode(graph.GenerateNodeName("GroupQueryAttention"), "GroupQueryAttention",
+                            "fused decomposed attention", inputs, outputs, nullptr, kMSDomain);
+  gqa.AddAttribute("num_heads", q.num_heads);
+  gqa.AddAttribute("kv_num_heads", k.num_heads);
+  gqa.AddAttribute("scale", scale);
+  gqa.SetExecutionProviderType(provider);
+
+  for (const NodeArg* arg : inputs) {
+    if (arg->Exists()) {
+      state.fused_inputs.insert(arg->Name());
+    }
+  }
+  for (const NodeArg* arg : {q.projection, k.projection, q.rotary.position_ids, k.rotary.position_ids}) {
+    state.fused_inputs.insert(arg->Name());
+  }
+
+  for (NodeIndex index : node_indices) {
+    Node& node = *graph.GetNode(index);
+    for (auto edge = node.InputEdgesBegin(); edge != node.InputEdgesEnd(); ++edge) {
+      if (node_indices.count(edge->GetNode().Index()) == 0) {
+        state.removal_candidates.push_back(edge->GetNode().Index());
+      }
+    }
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(index);
+  }
+  return true;
+}
+
+// Removes the nodes, like the computation of the attention mask, the cos and sin values and the shapes of
+// repeat_kv, that are no longer used once all the attention layers are fused.
+void RemoveUnusedNodes(Graph& graph, FusionState& state) {
+  auto& candidates = state.removal_candidates;
+  while (!candidates.empty()) {
+    Node* node = graph.GetNode(candidates.back());
+    candidates.pop_back();
+    if (node == nullptr || node->GetOutputEdgesCount() > 0 || graph.NodeProducesGraphOutput(*node) ||
+        std::any_of(node->OutputDefs().begin(), node->OutputDefs().end(),
+                    [&state](const NodeArg* output) { return state.fused_inputs.count(output->Name()) > 0; })) {
+      continue;
+    }
+    for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+      candidates.push_back(edge->GetNode().Index());
+    }
+    graph.RemoveNode(node->Index());
+  }
+}
+
+}  // namespace
+
+Status GroupQueryAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  FusionState state;
+  int fused_count = 0;
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // we removed the node as part of an earlier fusion
+    }
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softmax", {1, 11, 13}) &&
+        graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) &&
+        FuseGroupQueryAttention(graph, node, GetCompatibleExecutionProviders(), state)) {
+      ++fused_count;
+    }
+  }
+
+  if (fused_count > 0) {
+    RemoveUnusedNodes(graph, state);
+    modified = true;
+    LOGS(logger, INFO) << "Total fused GroupQueryAttention node count: " << fused_count;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupQueryAttentionFusion
+
+Rewrite the decomposed self attention of LLaMA, Mistral, Qwen and Phi style decoders, as exported from PyTorch,
+to com.microsoft.RotaryEmbedding nodes for the query and key and a com.microsoft.GroupQueryAttention node:
+
+  q = Transpose(Reshape(q_proj)), k = Transpose(Reshape(k_proj)), v = Transpose(Reshape(v_proj))
+  q, k = q * cos + rotate_half(q) * sin, k * cos + rotate_half(k) * sin (optionally on the first dims only)
+  present_key, present_value = Concat(past_key, k), Concat(past_value, v)
+  output = Reshape(Transpose(Softmax(Q * repeat_kv(present_key)^T * scale + mask) * repeat_kv(present_value)))
+
+The cos and sin values must be gathered by position_ids from constant tables. The mask must be the causal mask, as a
+constant table or as the Trilu of HF models, possibly added to a 4D bias like the padding of the keys, which becomes
+the attention_bias input of GroupQueryAttention. Attention with any other mask, like a sliding window or a
+bidirectional mask, is left as is. The batch size or the sequence length of the query must be statically 1, as
+GroupQueryAttention rejects more than one new token with a past context in a batch of more than 1.
+*/
+class GroupQueryAttentionFusion : public GraphTransformer {
+ public:
+  GroupQueryAttentionFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupQueryAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
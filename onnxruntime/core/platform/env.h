@@ -91,6 +91,11 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // NUMA node of each thread, in the same order as affinities. -1 for a thread that isn't bound to a node.
+  // If the threads are spread over more than one node, parallel loops run on the threads of the node of the thread
+  // that starts them. If the vector is empty, the pool is not partitioned.
+  std::vector<int> numa_nodes;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -149,6 +154,23 @@ class Env {
 
   virtual int GetL2CacheSize() const = 0;
 
+  /// \brief Returns the logical processors of each NUMA node, indexed by node id.
+  /// Only the processors the process may run on are listed. Empty if the topology is unknown.
+  virtual std::vector<LogicalProcessors> GetNumaNodes() const {
+    return {};
+  }
+
+  /// \brief Returns the NUMA node of the processor the calling thread is running on, or -1 if unknown.
+  virtual int GetCurrentNumaNode() const {
+    return -1;
+  }
+
+  /// \brief Places the pages that lie entirely within [addr, addr + size) on the given NUMA node.
+  /// Pages that were already touched are moved.
+  virtual common::Status BindMemoryToNumaNode(void* /*addr*/, size_t /*size*/, int /*numa_node*/) const {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Binding memory to a NUMA node is not supported.");
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -30,9 +30,14 @@ limitations under the License.
 #include <sys/syscall.h>
 #endif
 #include <unistd.h>
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sched.h>
+#endif
 
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -124,6 +129,89 @@ struct Freer {
 
 using MallocdStringPtr = std::unique_ptr<char, Freer<char> >;
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#define ORT_HAS_NUMA_SUPPORT
+
+// Parses a sysfs list of ids such as "0-3,8-11". Returns an empty vector on malformed input.
+std::vector<int> ParseSysfsIdList(const std::string& list) {
+  std::vector<int> ids;
+  std::istringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    int first = 0;
+    int last = 0;
+    char dash = 0;
+    std::istringstream range_stream(range);
+    if (!(range_stream >> first)) {
+      return {};
+    }
+    last = first;
+    if (range_stream >> dash) {
+      if (dash != '-' || !(range_stream >> last) || last < first) {
+        return {};
+      }
+    }
+    for (int id = first; id <= last; ++id) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+std::string ReadSysfsFile(const std::string& path) {
+  std::ifstream file(path);
+  std::string content;
+  std::getline(file, content);
+  return content;
+}
+
+// Logical processors of each NUMA node that the process may run on, read once from sysfs.
+const std::vector<LogicalProcessors>& NumaNodeProcessors() {
+  static const std::vector<LogicalProcessors> nodes = []() {
+    std::vector<LogicalProcessors> result;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_allowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (int node : ParseSysfsIdList(ReadSysfsFile("/sys/devices/system/node/online"))) {
+      LogicalProcessors processors;
+      for (int cpu : ParseSysfsIdList(
+               ReadSysfsFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))) {
+        if (!have_allowed || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+          processors.push_back(cpu);
+        }
+      }
+      if (result.size() <= static_cast<size_t>(node)) {
+        result.resize(static_cast<size_t>(node) + 1);
+      }
+      result[node] = std::move(processors);
+    }
+    return result;
+  }();
+  return nodes;
+}
+
+// NUMA node of each logical processor, -1 for processors the process may not run on.
+const std::vector<int>& ProcessorNumaNodes() {
+  static const std::vector<int> processor_nodes = []() {
+    std::vector<int> result;
+    const auto& nodes = NumaNodeProcessors();
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      for (int cpu : nodes[node]) {
+        if (result.size() <= static_cast<size_t>(cpu)) {
+          result.resize(static_cast<size_t>(cpu) + 1, -1);
+        }
+        result[cpu] = static_cast<int>(node);
+      }
+    }
+    return result;
+  }();
+  return processor_nodes;
+}
+#endif  // defined(__linux__) && !defined(__ANDROID__)
+
 class PosixThread : public EnvThread {
  private:
   struct Param {
@@ -324,6 +412,47 @@ class PosixEnv : public Env {
 #endif
   }
 
+#ifdef ORT_HAS_NUMA_SUPPORT
+  std::vector<LogicalProcessors> GetNumaNodes() const override {
+    return NumaNodeProcessors();
+  }
+
+  int GetCurrentNumaNode() const override {
+    const int cpu = sched_getcpu();
+    const auto& processor_nodes = ProcessorNumaNodes();
+    if (cpu < 0 || static_cast<size_t>(cpu) >= processor_nodes.size()) {
+      return -1;
+    }
+    return processor_nodes[cpu];
+  }
+
+  common::Status BindMemoryToNumaNode(void* addr, size_t size, int numa_node) const override {
+    constexpr int kMpolBind = 2;     // MPOL_BIND from linux/mempolicy.h
+    constexpr int kMpolMfMove = 2;   // MPOL_MF_MOVE from linux/mempolicy.h
+    constexpr size_t kBitsPerWord = 8 * sizeof(unsigned long);
+    ORT_RETURN_IF_NOT(numa_node >= 0, "Invalid NUMA node: ", numa_node);
+
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+    const auto end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page_size - 1);
+    if (end <= begin) {
+      return Status::OK();
+    }
+
+    std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerWord + 1, 0);
+    node_mask[numa_node / kBitsPerWord] |= 1UL << (numa_node % kBitsPerWord);
+    // The kernel expects the number of bits in the mask plus one.
+    const unsigned long max_node = node_mask.size() * kBitsPerWord + 1;
+    if (syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, kMpolBind, node_mask.data(), max_node,
+                kMpolMfMove) != 0) {
+      auto [err_no, err_msg] = GetErrnoInfo();
+      return common::Status(common::SYSTEM, err_no, "mbind to NUMA node " + std::to_string(numa_node) +
+                                                        " failed: " + err_msg);
+    }
+    return Status::OK();
+  }
+#endif  // ORT_HAS_NUMA_SUPPORT
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -62,6 +62,8 @@ REGISTER_UNARY_ELEMENTWISE_TYPED_KERNEL(Sigmoid, 13, float);
 REGISTER_UNARY_ELEMENTWISE_TYPED_KERNEL(Sigmoid, 13, double);
 REGISTER_VERSIONED_UNARY_ELEMENTWISE_KERNEL(Softplus, 1, 21);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(Softplus, 22);
+REGISTER_VERSIONED_UNARY_ELEMENTWISE_KERNEL(Mish, 18, 21);
+REGISTER_UNARY_ELEMENTWISE_KERNEL(Mish, 22);
 REGISTER_VERSIONED_UNARY_ELEMENTWISE_KERNEL(Softsign, 1, 21);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(Softsign, 22);
 REGISTER_VERSIONED_UNARY_ELEMENTWISE_TYPED_KERNEL(Tanh, 6, 12, float);
@@ -91,6 +93,7 @@ Status ElementWiseRangedTransform<T>::Create(const std::string& type, const Node
   CREATE_ELE_KERNEL(Elu);
   CREATE_ELE_KERNEL(HardSigmoid);
   CREATE_ELE_KERNEL(LeakyRelu);
+  CREATE_ELE_KERNEL(Mish);
   CREATE_ELE_KERNEL(Softplus);
   CREATE_ELE_KERNEL(Relu);
   CREATE_ELE_KERNEL(Sigmoid);
@@ -126,6 +129,20 @@ void Tanh<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
   float* output_ptr = output + first;
   MlasComputeTanh(input + first, output_ptr, static_cast<size_t>(len));
 }
+
+template <>
+void Softplus<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeSoftplus(input + first, output_ptr, static_cast<size_t>(len));
+}
+
+template <>
+void Mish<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeMish(input + first, output_ptr, static_cast<size_t>(len));
+}
 }  // namespace functors
 
 }  // namespace onnxruntime
@@ -102,6 +102,35 @@ struct Softplus : public ElementWiseRangedTransform<T> {
   }
 };
 
+template <>
+void Softplus<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
+template <typename T>
+struct Mish : public ElementWiseRangedTransform<T> {
+  Status Init(const onnxruntime::NodeAttributes&) {
+    return Status::OK();
+  }
+  GSL_SUPPRESS(r.11)
+  ElementWiseRangedTransform<T>* Copy() const {
+    using T1 = typename std::remove_pointer<decltype(this)>::type;
+    using T2 = typename std::remove_const<T1>::type;
+    return new T2(*this);
+  }
+  float Cost() const final {
+    return 20.0f;
+  }
+  void operator()(std::ptrdiff_t first, std::ptrdiff_t last) const final {
+    ptrdiff_t len = last - first;
+    T* output_ptr = this->output + first;
+    ConstEigenVectorArrayMap<T> xm(this->input + first, len);
+    EigenVectorArrayMap<T> ym(output_ptr, len);
+    ym = xm * ((xm > 0).select(xm + ((-xm).exp()).log1p(), ((xm).exp()).log1p())).tanh();
+  }
+};
+
+template <>
+void Mish<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
 template <typename T>
 struct Relu : public ElementWiseRangedTransform<T> {
   Status Init(const onnxruntime::NodeAttributes&) {
@@ -238,6 +267,7 @@ DEFINE_ELE_KERNEL(Celu);
 DEFINE_ELE_KERNEL(Elu);
 DEFINE_ELE_KERNEL(HardSigmoid);
 DEFINE_ELE_KERNEL(LeakyRelu);
+DEFINE_ELE_KERNEL(Mish);
 DEFINE_ELE_KERNEL(Softplus);
 DEFINE_ELE_KERNEL(Relu);
 DEFINE_ELE_KERNEL(Sigmoid);
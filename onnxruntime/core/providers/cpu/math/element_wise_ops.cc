@@ -68,12 +68,22 @@ using EnabledPow12ExpTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST(kCpuExecutionPr
                                                                  Pow, 12, Input, 1);
 
 namespace functors {
-template <>
-void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
-  ptrdiff_t len = last - first;
-  float* output_ptr = output + first;
-  MlasComputeExp(input + first, output_ptr, static_cast<size_t>(len));
-}
+#define DEFINE_MLAS_FLOAT_TRANSFORM(X, MLAS_FUNCTION)                          \
+  template <>                                                                  \
+  void X<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const { \
+    ptrdiff_t len = last - first;                                              \
+    float* output_ptr = output + first;                                        \
+    MLAS_FUNCTION(input + first, output_ptr, static_cast<size_t>(len));        \
+  }
+
+DEFINE_MLAS_FLOAT_TRANSFORM(Exp, MlasComputeExp)
+DEFINE_MLAS_FLOAT_TRANSFORM(Log, MlasComputeLog)
+DEFINE_MLAS_FLOAT_TRANSFORM(Reciprocal, MlasComputeReciprocal)
+DEFINE_MLAS_FLOAT_TRANSFORM(Sqrt, MlasComputeSqrt)
+DEFINE_MLAS_FLOAT_TRANSFORM(Sin, MlasComputeSin)
+DEFINE_MLAS_FLOAT_TRANSFORM(Cos, MlasComputeCos)
+
+#undef DEFINE_MLAS_FLOAT_TRANSFORM
 }  // namespace functors
 
 #define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
@@ -628,6 +638,48 @@ void PowImpl(OpKernelContext& context) {
   UntypedBroadcastTwo(context, funcs, 1.0);
 }
 
+template <>
+void PowImpl<float, float>(OpKernelContext& context) {
+  ProcessBroadcastSpanFuncs funcs{
+      [](BroadcastHelper& per_iter_bh) {
+        const float X = per_iter_bh.ScalarInput0<float>();
+        auto Y = per_iter_bh.SpanInput1<float>();
+        auto output = per_iter_bh.OutputSpan<float>();
+
+        MlasComputePow(&X, Y.data(), output.data(), output.size(), true, false);
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        auto X = per_iter_bh.SpanInput0<float>();
+        const float Y = per_iter_bh.ScalarInput1<float>();
+        auto output = per_iter_bh.OutputSpan<float>();
+
+        // optimize for X^2 and X^3
+        if (Y == 2) {
+          std::transform(X.begin(), X.end(), output.begin(),
+                         [](float x) {
+                           return x * x;
+                         });
+
+        } else if (Y == 3) {
+          std::transform(X.begin(), X.end(), output.begin(),
+                         [](float x) {
+                           return x * x * x;
+                         });
+        } else {
+          MlasComputePow(X.data(), &Y, output.data(), output.size(), false, true);
+        }
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        auto X = per_iter_bh.SpanInput0<float>();
+        auto Y = per_iter_bh.SpanInput1<float>();
+        auto output = per_iter_bh.OutputSpan<float>();
+
+        MlasComputePow(X.data(), Y.data(), output.data(), output.size(), false, false);
+      }};
+
+  UntypedBroadcastTwo(context, funcs, 1.0);
+}
+
 template <typename B>
 Status DispatchOnBase(OpKernelContext& context, const Tensor& Y) {
   namespace on = ONNX_NAMESPACE;
@@ -1365,20 +1417,6 @@ Status BitwiseXor<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
-template <typename T>
-class Sin final : public OpKernel {
- public:
-  Sin(const OpKernelInfo& info) : OpKernel(info) {
-  }
-
-  Status Compute(OpKernelContext* context) const override {
-    auto& X = *context->Input<Tensor>(0);
-    auto& Y = *context->Output(0, X.Shape());
-    MakeEigenArrayMap<T>(Y) = MakeEigenArrayMap<T>(X).sin();
-    return Status::OK();
-  }
-};
-
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     Sin,
     7, 21,
@@ -1407,20 +1445,6 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Sin<double>);
 
-template <typename T>
-class Cos final : public OpKernel {
- public:
-  Cos(const OpKernelInfo& info) : OpKernel(info) {
-  }
-
-  Status Compute(OpKernelContext* context) const override {
-    auto& X = *context->Input<Tensor>(0);
-    auto& Y = *context->Output(0, X.Shape());
-    MakeEigenArrayMap<float>(Y) = MakeEigenArrayMap<float>(X).cos();
-    return Status::OK();
-  }
-};
-
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Cos,
     7,
@@ -201,6 +201,71 @@ struct Exp final : public ElementWiseRangedTransform<T> {
     ym = xm.exp();
   }
 };
+
+template <typename T>
+struct Sin final : public ElementWiseRangedTransform<T> {
+  Status Init(const onnxruntime::NodeAttributes) {
+    return Status::OK();
+  }
+
+  ElementWiseRangedTransform<T>* Copy() const {
+    using T1 = typename std::remove_pointer<decltype(this)>::type;
+    using T2 = typename std::remove_const<T1>::type;
+    return new T2(*this);
+  }
+
+  float Cost() const final { return 15.0f; }
+
+  void operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+    ptrdiff_t len = last - first;
+    T* output_ptr = this->output + first;
+    ConstEigenVectorArrayMap<T> xm(this->input + first, len);
+    EigenVectorArrayMap<T> ym(output_ptr, len);
+    ym = xm.sin();
+  }
+};
+
+template <typename T>
+struct Cos final : public ElementWiseRangedTransform<T> {
+  Status Init(const onnxruntime::NodeAttributes) {
+    return Status::OK();
+  }
+
+  ElementWiseRangedTransform<T>* Copy() const {
+    using T1 = typename std::remove_pointer<decltype(this)>::type;
+    using T2 = typename std::remove_const<T1>::type;
+    return new T2(*this);
+  }
+
+  float Cost() const final { return 15.0f; }
+
+  void operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+    ptrdiff_t len = last - first;
+    T* output_ptr = this->output + first;
+    ConstEigenVectorArrayMap<T> xm(this->input + first, len);
+    EigenVectorArrayMap<T> ym(output_ptr, len);
+    ym = xm.cos();
+  }
+};
+
+// The single precision transforms use the vectorized MLAS routines.
+template <>
+void Log<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
+template <>
+void Reciprocal<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
+template <>
+void Sqrt<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
+template <>
+void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
+template <>
+void Sin<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
+template <>
+void Cos<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
 }  // namespace functors
 
 DEFINE_ELE_KERNEL(Log)
@@ -211,6 +276,8 @@ DEFINE_ELE_KERNEL(Ceil)
 DEFINE_ELE_KERNEL(Reciprocal)
 DEFINE_ELE_KERNEL(Sqrt)
 DEFINE_ELE_KERNEL(Exp)
+DEFINE_ELE_KERNEL(Sin)
+DEFINE_ELE_KERNEL(Cos)
 
 template <typename T>
 class Add final : public OpKernel {
@@ -5,6 +5,7 @@
 #include "core/providers/cpu/math/gemm.h"
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/platform/env.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -246,6 +247,44 @@ template void Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE
                                        float* y_data,
                                        concurrency::ThreadPool* thread_pool);
 
+void PackedBNumaReplicas::Replicate(const void* packed_b, size_t packed_b_size) {
+  replicas_.clear();
+  const auto numa_nodes = Env::Default().GetNumaNodes();
+  if (std::count_if(numa_nodes.begin(), numa_nodes.end(),
+                    [](const LogicalProcessors& processors) { return !processors.empty(); }) <= 1) {
+    return;
+  }
+
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  replicas_.resize(numa_nodes.size());
+  for (size_t node = 0; node < numa_nodes.size(); ++node) {
+    if (numa_nodes[node].empty()) {
+      continue;
+    }
+    auto replica = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+    // Bind before copying so that the pages are allocated on the node when the copy first touches them.
+    auto status = Env::Default().BindMemoryToNumaNode(replica.get(), packed_b_size, static_cast<int>(node));
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Pre-packed weights are not replicated on NUMA nodes: " << status.ErrorMessage();
+      replicas_.clear();
+      return;
+    }
+    memcpy(replica.get(), packed_b, packed_b_size);
+    replicas_[node] = std::move(replica);
+  }
+}
+
+const void* PackedBNumaReplicas::Get(const void* packed_b) const {
+  if (replicas_.empty()) {
+    return packed_b;
+  }
+  const int node = Env::Default().GetCurrentNumaNode();
+  if (node < 0 || static_cast<size_t>(node) >= replicas_.size() || !replicas_[node]) {
+    return packed_b;
+  }
+  return replicas_[node].get();
+}
+
 template <typename T>
 Status Gemm<T>::PrePack(const Tensor& /* tensor */, int /* input_idx */, AllocatorPtr /*alloc_for_caching*/,
                         /*out*/ bool& is_packed,
@@ -264,6 +303,9 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   if (input_idx == 1) {
     size_t packed_b_size;
     is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    if (is_packed && replicate_packed_b_) {
+      packed_b_replicas_.Replicate(packed_b_.get(), packed_b_size);
+    }
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -294,6 +336,43 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::UseCachedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                          std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                          gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                          /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                              std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              gsl::span<const size_t> prepacked_buffer_sizes,
+                                              /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+  const auto& b_shape = tensor.Shape();
+  if (input_idx != 1 || b_shape.NumDimensions() != 2 || prepacked_buffers.size() != 1) {
+    return Status::OK();
+  }
+
+  const bool trans_b = trans_B_ != CblasNoTrans;
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  const size_t packed_b_size = MlasGemmPackBSize(N, K);
+
+  if (packed_b_size != 0 && prepacked_buffer_sizes[0] == packed_b_size) {
+    used_cached_buffers = true;
+    b_shape_ = b_shape;
+    packed_b_ = std::move(prepacked_buffers[0]);
+    if (replicate_packed_b_) {
+      packed_b_replicas_.Replicate(packed_b_.get(), packed_b_size);
+    }
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -418,30 +497,70 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
-    ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
-                c_data, c_shape, y_data, thread_pool);
-  } else {
+  if (K == 0) {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    if (K > 0) {
-      MlasGemm(
-          trans_A_,
-          static_cast<size_t>(M),
-          static_cast<size_t>(N),
-          static_cast<size_t>(K),
-          alpha_,
-          A->Data<float>(),
-          static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-          packed_b_.get(),
-          c_data != nullptr ? beta_ : 0.0f,
-          y_data,
-          static_cast<size_t>(N),
-          thread_pool);
-    } else if (beta_ == 0 || c_data == nullptr) {
+    if (beta_ == 0 || c_data == nullptr) {
       EigenMatrixMapRowMajor<float> dest(y_data, narrow<Eigen::Index>(M), narrow<Eigen::Index>(N));
       dest.setZero();
     }
+    if (mlas_activation_.has_value()) {
+      MlasActivation(&*mlas_activation_, y_data, nullptr, static_cast<size_t>(M), static_cast<size_t>(N),
+                     static_cast<size_t>(N));
+    }
+    ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
+    return Status::OK();
+  }
+
+  // Apply the bias, residual and activation in the MLAS GEMM epilogue while each output tile is
+  // still in the cache, instead of broadcasting C into Y before the GEMM and running the
+  // activation over Y after it.
+  MLAS_SGEMM_EPILOGUE epilogue;
+  bool use_epilogue = false;
+  float beta = c_data != nullptr ? beta_ : 0.0f;
+
+  if (beta == 1.0f) {
+    if (c_shape->Size() == N &&
+        (c_shape->NumDimensions() == 1 || (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1))) {
+      // C is (N,) or (1, N)
+      epilogue.Bias = c_data;
+      beta = 0.0f;
+      use_epilogue = true;
+    } else if (c_shape->Size() == M * N && !mlas_activation_.has_value()) {
+      // C is (M, N). It is added after the activation in the epilogue, so only without one.
+      epilogue.Residual = c_data;
+      epilogue.ldr = static_cast<size_t>(N);
+      beta = 0.0f;
+      use_epilogue = true;
+    }
+  }
+
+  if (mlas_activation_.has_value()) {
+    epilogue.Activation = *mlas_activation_;
+    use_epilogue = true;
+  }
+
+  GemmBroadcastBias(M, N, beta, c_data, c_shape, y_data);
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = A->Data<float>();
+  data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+  if (B) {
+    data.B = B->Data<float>();
+    data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+  } else {
+    data.B = static_cast<const float*>(packed_b_replicas_.Get(packed_b_.get()));
+    data.BIsPacked = true;
   }
+  data.C = y_data;
+  data.ldc = static_cast<size_t>(N);
+  data.alpha = alpha_;
+  // ideally we need to set the output buffer contents to 0 if bias is missing,
+  // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
+  data.beta = beta;
+  data.Epilogue = use_epilogue ? &epilogue : nullptr;
+
+  ORT_RETURN_IF_ERROR(cpu::tunable::SgemmBatch(tuning_ctx_, trans_A_, trans_B_, static_cast<size_t>(M),
+                                               static_cast<size_t>(N), static_cast<size_t>(K), &data, 1, thread_pool));
 
   ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
 
@@ -3,19 +3,28 @@
 
 #pragma once
 
+#include <optional>
+
 #include "gemm_base.h"
 
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/providers/cpu/tunable/gemm.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
 template <typename T>
 class Gemm : protected GemmBase, public OpKernel {
  public:
-  Gemm(const OpKernelInfo& info) : GemmBase(info), OpKernel(info) {
+  Gemm(const OpKernelInfo& info)
+      : GemmBase(info), OpKernel(info), tuning_ctx_(cpu::tunable::GetCpuTuningContext(info.GetExecutionProvider())) {
+    replicate_packed_b_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsConfigNumaReplicateWeights, "0") == "1";
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -28,6 +37,11 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   gsl::span<const size_t> prepacked_buffer_sizes,
+                                   /*out*/ bool& used_cached_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -41,9 +55,19 @@ class Gemm : protected GemmBase, public OpKernel {
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // Copies of packed_b_ on each NUMA node
+  bool replicate_packed_b_{false};
+  PackedBNumaReplicas packed_b_replicas_;
+
+  // TunableOp selection of the MLAS SGEMM slice sizes, float only
+  cpu::tunable::CpuTuningContext* tuning_ctx_;
+
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
+  // For fused gemm + activation applied by the MLAS GEMM epilogue, float only
+  std::optional<MLAS_ACTIVATION> mlas_activation_;
+
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
 };
 
@@ -14,4 +14,19 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Copies of a pre-packed B buffer on each NUMA node of the host, made when the session sets
+// kOrtSessionOptionsConfigNumaReplicateWeights so that a GEMM reads B from the memory of the node it runs on.
+class PackedBNumaReplicas {
+ public:
+  // Copies the packed_b_size bytes at packed_b to each NUMA node. Does nothing on a host with a single node.
+  void Replicate(const void* packed_b, size_t packed_b_size);
+
+  // Returns the copy on the NUMA node of the calling thread, or packed_b if there is none.
+  const void* Get(const void* packed_b) const;
+
+ private:
+  // Copy on each NUMA node, indexed by node id
+  std::vector<IAllocatorUniquePtr<void>> replicas_;
+};
+
 };  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+#include "core/common/type_list.h"
+#include "core/framework/copy.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/math.h"
@@ -9,11 +11,18 @@
 
 namespace onnxruntime {
 
+// MatMul<float> reads strided views of both inputs, e.g. of the queries and keys after a split-heads Transpose.
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_MATMUL_FLOAT_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedInput(1)
+#else
+#define CREATE_MATMUL_FLOAT_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     1, 8,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    CREATE_MATMUL_FLOAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -29,7 +38,7 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     9,
     12,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    CREATE_MATMUL_FLOAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -62,7 +71,7 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     13,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    CREATE_MATMUL_FLOAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
@@ -133,7 +142,7 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -172,6 +181,56 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+// Returns the size of the buffer of MlasSparseSgemmPackB for the 2D weight B, or 0 if no sparse format skips at
+// least minimum_sparsity of B and is estimated to run faster than the dense SGEMM.
+static size_t GemmPackBSparseFp32Size(const Tensor& tensor_b,
+                                      bool trans_b,
+                                      float minimum_sparsity,
+                                      MLAS_SPARSE_SGEMM_FORMAT& format) {
+  const auto& b_shape = tensor_b.Shape();
+  if (b_shape.NumDimensions() != 2 || minimum_sparsity >= 1.0f) {
+    return 0;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+  const size_t ldb = trans_b ? K : N;
+
+  MLAS_SPARSE_SGEMM_ANALYSIS analysis;
+  MlasSparseSgemmAnalyzeB(trans, N, K, tensor_b.Data<float>(), ldb, &analysis);
+  if (!MlasSparseSgemmSelectFormat(&analysis, minimum_sparsity, &format)) {
+    return 0;
+  }
+
+  return MlasSparseSgemmPackBSize(format, trans, N, K, tensor_b.Data<float>(), ldb);
+}
+
+static bool GemmPackBSparseFp32(AllocatorPtr& alloc,
+                                const Tensor& tensor_b,
+                                bool trans_b,
+                                float minimum_sparsity,
+                                IAllocatorUniquePtr<void>& packed_b,
+                                size_t& packed_b_size,
+                                TensorShape& b_shape) {
+  MLAS_SPARSE_SGEMM_FORMAT format;
+  packed_b_size = GemmPackBSparseFp32Size(tensor_b, trans_b, minimum_sparsity, format);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  // MlasSparseSgemmPackB initializes the padding of the buffer.
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  MlasSparseSgemmPackB(format, trans_b ? CblasTrans : CblasNoTrans, N, K, tensor_b.Data<float>(),
+                       trans_b ? K : N, packed_b.get());
+  return true;
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -180,7 +239,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
     size_t dim1 = 0;
     size_t dim2 = 0;
     TensorShape b_shape = tensor.Shape();
@@ -192,10 +251,21 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
 
     if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
       is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      if (is_packed && replicate_packed_b_) {
+        packed_b_replicas_.Replicate(packed_b_.get(), packed_b_size);
+      }
     } else
 #endif
     {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      // The sparse kernels read matrix A without transposing it.
+      packed_b_is_sparse_ = trans_a_attr_ == 0 &&
+                            GemmPackBSparseFp32(alloc, tensor, trans_b_attr_ != 0, sparse_minimum_sparsity_,
+                                                packed_b_, packed_b_size, b_shape_);
+      is_packed = packed_b_is_sparse_ ||
+                  GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      if (is_packed && replicate_packed_b_) {
+        packed_b_replicas_.Replicate(packed_b_.get(), packed_b_size);
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -220,6 +290,184 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                gsl::span<const size_t> prepacked_buffer_sizes,
+                                                /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+  const auto& b_shape = tensor.Shape();
+  if (input_idx != 1 || b_shape.NumDimensions() != 2 || prepacked_buffers.size() != 1) {
+    return Status::OK();
+  }
+
+  const bool trans_b = trans_b_attr_ != 0;
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  size_t packed_b_size;
+  bool is_sparse = false;
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
+    packed_b_size = MlasSBGemmPackBSize(N, K);
+  } else
+#endif
+  {
+    MLAS_SPARSE_SGEMM_FORMAT format;
+    packed_b_size = trans_a_attr_ == 0
+                        ? GemmPackBSparseFp32Size(tensor, trans_b, sparse_minimum_sparsity_, format)
+                        : 0;
+    is_sparse = packed_b_size != 0;
+    if (!is_sparse) {
+      packed_b_size = MlasGemmPackBSize(N, K);
+    }
+  }
+
+  if (packed_b_size != 0 && prepacked_buffer_sizes[0] == packed_b_size) {
+    used_cached_buffers = true;
+    b_shape_ = b_shape;
+    packed_b_is_sparse_ = is_sparse;
+    packed_b_ = std::move(prepacked_buffers[0]);
+    if (replicate_packed_b_) {
+      packed_b_replicas_.Replicate(packed_b_.get(), packed_b_size);
+    }
+  }
+
+  return Status::OK();
+}
+
+#ifdef ENABLE_STRIDED_TENSORS
+namespace {
+
+// A MatMul input as a batch of matrices in the layout that MLAS reads.
+struct StridedMatrices {
+  CBLAS_TRANSPOSE trans;
+  size_t ld;
+  gsl::span<const int64_t> batch_dims;
+  gsl::span<const int64_t> batch_strides;
+};
+
+// Returns false if the matrices of the input do not have a unit stride along one of their dimensions. A 1-D input is
+// a row of A or a column of B.
+bool GetStridedMatrices(const Tensor& input, bool is_left, StridedMatrices& matrices) {
+  const auto dims = input.Shape().GetDims();
+  const auto strides = input.Strides();
+  const size_t rank = dims.size();
+  const size_t batch_rank = rank > 2 ? rank - 2 : 0;
+
+  int64_t rows, cols, row_stride, col_stride;
+  if (rank == 1) {
+    rows = is_left ? 1 : dims[0];
+    cols = is_left ? dims[0] : 1;
+    row_stride = is_left ? 0 : strides[0];
+    col_stride = is_left ? strides[0] : 0;
+  } else {
+    rows = dims[rank - 2];
+    cols = dims[rank - 1];
+    row_stride = strides[rank - 2];
+    col_stride = strides[rank - 1];
+  }
+
+  // The stride of a dimension of size 1 does not matter.
+  if ((cols == 1 || col_stride == 1) && (rows == 1 || row_stride >= cols)) {
+    matrices.trans = CblasNoTrans;
+    matrices.ld = narrow<size_t>(rows == 1 ? cols : row_stride);
+  } else if ((rows == 1 || row_stride == 1) && (cols == 1 || col_stride >= rows)) {
+    matrices.trans = CblasTrans;
+    matrices.ld = narrow<size_t>(cols == 1 ? rows : col_stride);
+  } else {
+    return false;
+  }
+
+  matrices.batch_dims = dims.first(batch_rank);
+  matrices.batch_strides = strides.first(batch_rank);
+  return true;
+}
+
+// Copies a strided input to a contiguous tensor.
+Status CopyToContiguous(concurrency::ThreadPool* thread_pool, const Tensor& input, AllocatorPtr alloc,
+                        Tensor& contiguous_input) {
+  contiguous_input = Tensor(input.DataType(), input.Shape(), std::move(alloc));
+  return DispatchStridedCopy<TypeList<float>>(thread_pool, contiguous_input, 0, StridesForTensor(contiguous_input),
+                                              input.Shape(), input, 0, ToShapeVector(input.Strides()));
+}
+
+// Computes the product of inputs of which at least one is strided. The matrices are read in place when they have a
+// unit stride along a dimension, as after a split-heads Transpose, else the input is copied to a contiguous tensor.
+Status ComputeStridedMatMul(OpKernelContext* ctx, const Tensor& a, const Tensor& b, float alpha, Tensor& y,
+                            cpu::tunable::CpuTuningContext* tuning_ctx) {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+
+  Tensor a_contiguous;
+  Tensor b_contiguous;
+  const Tensor* inputs[] = {&a, &b};
+  Tensor* contiguous_inputs[] = {&a_contiguous, &b_contiguous};
+  StridedMatrices matrices[2];
+  for (size_t i = 0; i < 2; ++i) {
+    if (!GetStridedMatrices(*inputs[i], i == 0, matrices[i])) {
+      ORT_RETURN_IF_ERROR(CopyToContiguous(thread_pool, *inputs[i], alloc, *contiguous_inputs[i]));
+      inputs[i] = contiguous_inputs[i];
+      ORT_ENFORCE(GetStridedMatrices(*inputs[i], i == 0, matrices[i]));
+    }
+  }
+
+  const auto a_dims = a.Shape().GetDims();
+  const auto b_dims = b.Shape().GetDims();
+  const size_t M = a_dims.size() == 1 ? 1 : narrow<size_t>(a_dims[a_dims.size() - 2]);
+  const size_t K = narrow<size_t>(a_dims.back());
+  const size_t N = b_dims.size() == 1 ? 1 : narrow<size_t>(b_dims.back());
+  const size_t batch_count = narrow<size_t>(y.Shape().Size()) / (M * N);
+
+  const auto& a_matrices = matrices[0];
+  const auto& b_matrices = matrices[1];
+  const size_t a_batch_rank = a_matrices.batch_dims.size();
+  const size_t b_batch_rank = b_matrices.batch_dims.size();
+  const size_t batch_rank = std::max(a_batch_rank, b_batch_rank);
+
+  const auto* a_data = inputs[0]->Data<float>();
+  const auto* b_data = inputs[1]->Data<float>();
+  auto* y_data = y.MutableData<float>();
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch_count);
+  for (size_t i = 0; i < batch_count; i++) {
+    // Decompose the batch index from the innermost batch dimension, which broadcasts like the output.
+    size_t remaining = i;
+    std::ptrdiff_t a_offset = 0;
+    std::ptrdiff_t b_offset = 0;
+    for (size_t dim = 0; dim < batch_rank; dim++) {
+      const int64_t a_dim = dim < a_batch_rank ? a_matrices.batch_dims[a_batch_rank - 1 - dim] : 1;
+      const int64_t b_dim = dim < b_batch_rank ? b_matrices.batch_dims[b_batch_rank - 1 - dim] : 1;
+      const size_t output_dim = narrow<size_t>(std::max(a_dim, b_dim));
+      const auto index = narrow<std::ptrdiff_t>(remaining % output_dim);
+      remaining /= output_dim;
+      if (a_dim != 1) {
+        a_offset += index * narrow<std::ptrdiff_t>(a_matrices.batch_strides[a_batch_rank - 1 - dim]);
+      }
+      if (b_dim != 1) {
+        b_offset += index * narrow<std::ptrdiff_t>(b_matrices.batch_strides[b_batch_rank - 1 - dim]);
+      }
+    }
+
+    data[i].A = a_data + a_offset;
+    data[i].lda = a_matrices.ld;
+    data[i].B = b_data + b_offset;
+    data[i].ldb = b_matrices.ld;
+    data[i].C = y_data + i * M * N;
+    data[i].ldc = N;
+    data[i].alpha = alpha;
+    data[i].beta = 0.0f;
+  }
+
+  return cpu::tunable::SgemmBatch(tuning_ctx, a_matrices.trans, b_matrices.trans, M, N, K, data.data(), batch_count,
+                                  thread_pool);
+}
+
+}  // namespace
+#endif  // ENABLE_STRIDED_TENSORS
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -248,6 +496,22 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // Only the MatMul kernels accept strided inputs, so there are no FusedMatMul transpose attributes to apply.
+  if (b != nullptr && (!a->IsContiguous() || !b->IsContiguous())) {
+    return ComputeStridedMatMul(ctx, *a, *b, alpha_attr_, *y, tuning_ctx_);
+  }
+
+  // B is prepacked, read A from a contiguous copy.
+  Tensor a_contiguous;
+  if (!a->IsContiguous()) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    ORT_RETURN_IF_ERROR(CopyToContiguous(thread_pool, *a, std::move(alloc), a_contiguous));
+    a = &a_contiguous;
+  }
+#endif
+
   const auto* a_data = a->Data<float>();
   const auto* b_data = b ? b->Data<float>() : nullptr;
   auto* y_data = y->MutableData<float>();
@@ -258,7 +522,23 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
+
+  if (packed_b_is_sparse_) {
+    std::vector<MLAS_SPARSE_SGEMM_DATA_PARAMS> data(max_len);
+    for (size_t i = 0; i < max_len; i++) {
+      data[i].A = a_data + helper.LeftOffsets()[i];
+      data[i].lda = lda;
+      data[i].PackedB = packed_b_replicas_.Get(packed_b_.get());
+      data[i].C = y_data + helper.OutputOffsets()[i];
+      data[i].ldc = N;
+      data[i].alpha = alpha_attr_;
+      data[i].beta = 0.0f;
+    }
+    MlasSparseSgemmBatch(M, N, K, data.data(), max_len, thread_pool);
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
@@ -266,7 +546,8 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].AIsfp32 = true;
       data[i].A = a_data + helper.LeftOffsets()[i];
       data[i].lda = lda;
-      data[i].B = data[i].BIsfp32 ? b_data + helper.RightOffsets()[i] : (float*)packed_b_.get();
+      data[i].B = data[i].BIsfp32 ? b_data + helper.RightOffsets()[i]
+                                  : static_cast<const float*>(packed_b_replicas_.Get(packed_b_.get()));
       data[i].ldb = ldb;
       data[i].C = y_data + helper.OutputOffsets()[i];
       data[i].ldc = N;
@@ -277,20 +558,22 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   } else
 #endif
   {
+    const auto* packed_b = static_cast<const float*>(packed_b_replicas_.Get(packed_b_.get()));
     std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
       data[i].BIsPacked = bool(packed_b_);
       data[i].A = a_data + helper.LeftOffsets()[i];
       data[i].lda = lda;
-      data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
+      data[i].B = data[i].BIsPacked ? packed_b : b_data + helper.RightOffsets()[i];
       data[i].ldb = ldb;
       data[i].C = y_data + helper.OutputOffsets()[i];
       data[i].ldc = N;
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
-    MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+    ORT_RETURN_IF_ERROR(cpu::tunable::SgemmBatch(tuning_ctx_, trans_a ? CblasTrans : CblasNoTrans,
+                                                 trans_b ? CblasTrans : CblasNoTrans,
+                                                 M, N, K, data.data(), max_len, thread_pool));
   }
   return Status::OK();
 }
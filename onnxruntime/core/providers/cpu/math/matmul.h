@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/providers/cpu/tunable/gemm.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
@@ -20,7 +23,8 @@ class MatMul final : public OpKernel {
 template <>
 class MatMul<float> final : public OpKernel {
  public:
-  MatMul(const OpKernelInfo& info) : OpKernel(info) {
+  MatMul(const OpKernelInfo& info)
+      : OpKernel(info), tuning_ctx_(cpu::tunable::GetCpuTuningContext(info.GetExecutionProvider())) {
     info.GetAttrOrDefault<int64_t>("transA", &trans_a_attr_, 0);
     info.GetAttrOrDefault<int64_t>("transB", &trans_b_attr_, 0);
     info.GetAttrOrDefault<float>("alpha", &alpha_attr_, 1.0);
@@ -29,10 +33,19 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transBatchB", &trans_batch_b_attr, 0);
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
+    replicate_packed_b_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsConfigNumaReplicateWeights, "0") == "1";
+    // The sparse formats skip the zero blocks of B (and the unused positions of 2:4 groups), so unlike the dense
+    // SGEMM, where 0 * inf is NaN, an Inf or NaN in A that only meets skipped zero weights does not reach the output.
+    sparse_minimum_sparsity_ = ParseStringWithClassicLocale<float>(
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasSparseGemmMinimumSparsity, "0.7"));
 
-#if defined(__aarch64__) && defined(__linux__)
-    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
-    use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
+#if defined(MLAS_SBGEMM_SUPPORTED)
+    const auto& config_options = info.GetConfigOptions();
+    const bool fastmath_requested =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathBfloat16, "0") == "1" ||
+        config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0") == "1";
+    use_fastmath_mode_ = fastmath_requested && MlasBf16AccelerationSupported();
 #endif
   }
 
@@ -43,12 +56,28 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   gsl::span<const size_t> prepacked_buffer_sizes,
+                                   /*out*/ bool& used_cached_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // Copies of packed_b_ on each NUMA node
+  bool replicate_packed_b_{false};
+  PackedBNumaReplicas packed_b_replicas_;
+
+  // packed_b_ holds B in a sparse format of MlasSparseSgemmPackB instead of MlasGemmPackB
+  bool packed_b_is_sparse_{false};
+  float sparse_minimum_sparsity_;
+
+  // TunableOp selection of the MLAS SGEMM slice sizes
+  cpu::tunable::CpuTuningContext* tuning_ctx_;
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
@@ -56,7 +85,7 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
   bool use_fastmath_mode_;
   // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
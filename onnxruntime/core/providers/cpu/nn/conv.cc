@@ -153,20 +153,82 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // Only the filter is transformed. MlasConvPrepare always selects the Winograd algorithm for a filter that
+  // MlasConvWinogradPackFilterSize accepts, so the original filter is released and only its shape is kept.
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 4) {
+    return Status::OK();
+  }
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(tensor.Shape(), kernel_shape));
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+  if (kernel_shape.size() != 2 || dilations.size() != 2 || strides.size() != 2) {
+    return Status::OK();
+  }
+
+  const size_t group_count = narrow<size_t>(conv_attrs_.group);
+  const size_t input_channels = narrow<size_t>(tensor.Shape()[1]);
+  const size_t filter_count = narrow<size_t>(tensor.Shape()[0]) / group_count;
+  const size_t packed_w_size = MlasConvWinogradPackFilterSize(2, group_count, input_channels, filter_count,
+                                                              kernel_shape.data(), dilations.data(), strides.data());
+  if (packed_w_size == 0) {
+    return Status::OK();
+  }
+
+  winograd_packed_w_ = IAllocator::MakeUniquePtr<void>(alloc, packed_w_size, true);
+  MlasConvWinogradPackFilter(group_count, input_channels, filter_count, tensor.Data<float>(),
+                             static_cast<float*>(winograd_packed_w_.get()), nullptr);
+  filter_shape_ = tensor.Shape();
+  is_packed = true;
+
+  bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (share_prepacked_weights) {
+    prepacked_weights->buffers_.push_back(std::move(winograd_packed_w_));
+    prepacked_weights->buffer_sizes_.push_back(packed_w_size);
+  }
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    winograd_packed_w_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
   const Tensor* W = context->Input<Tensor>(1);
   const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
+  // W is null when PrePack transformed it for the Winograd algorithm
+  const TensorShape& W_shape = W != nullptr ? W->Shape() : filter_shape_;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -232,6 +294,9 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &WorkingBufferSize,
                     Beta,
                     thread_pool);
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd && winograd_packed_w_) {
+      Parameters.u.Winograd.PackedFilter = static_cast<const float*>(winograd_packed_w_.get());
+    }
 
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
                                                : nullptr;
@@ -239,7 +304,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
 
     MlasConv(&Parameters,
              Xdata.data(),
-             W->Data<float>(),
+             W != nullptr ? W->Data<float>() : nullptr,
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata.data(),
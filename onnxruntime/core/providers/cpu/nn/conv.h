@@ -30,10 +30,22 @@ class Conv<float> : public OpKernel {
 
   Status Compute(OpKernelContext* context) const override;
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+  // Filter transformed for the Winograd algorithm of MlasConv, if MlasConvPrepare selects it for the filter.
+  // The original filter is then released, and its shape kept in filter_shape_.
+  IAllocatorUniquePtr<void> winograd_packed_w_;
+  TensorShape filter_shape_;
 };
 
 }  // namespace onnxruntime
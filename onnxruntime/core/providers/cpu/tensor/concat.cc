@@ -263,16 +263,22 @@ Status ConcatBase::ComputeImpl(Prepare& p, OpKernelContext* ctx) const {
     if (prep.num_elements == 0)
       continue;
 
-    // parallel copy the data across
-    auto status = DispatchStridedCopy<EnabledDataTypes>(ctx->GetOperatorThreadPool(),
-                                                        *p.output_tensor,
-                                                        onnxruntime::narrow<ptrdiff_t>(initial_output_offset),
-                                                        output_strides_for_copy,
-                                                        prep.tensor->Shape(),
-                                                        *prep.tensor,
-                                                        0,  // src_offset
-                                                        StridesForTensor(*prep.tensor));
-    ORT_RETURN_IF_ERROR(status);
+    // the allocation planner may have placed the input in its slice of the output already, see
+    // ComputeBufferSlices() in allocation_planner.cc
+    const auto* output_data = static_cast<const char*>(p.output_tensor->DataRaw()) +
+                              initial_output_offset * static_cast<int64_t>(p.output_tensor->DataType()->Size());
+    if (is_stack_ || prep.tensor->DataRaw() != output_data) {
+      // parallel copy the data across
+      auto status = DispatchStridedCopy<EnabledDataTypes>(ctx->GetOperatorThreadPool(),
+                                                          *p.output_tensor,
+                                                          onnxruntime::narrow<ptrdiff_t>(initial_output_offset),
+                                                          output_strides_for_copy,
+                                                          prep.tensor->Shape(),
+                                                          *prep.tensor,
+                                                          0,  // src_offset
+                                                          StridesForTensor(*prep.tensor));
+      ORT_RETURN_IF_ERROR(status);
+    }
 
     // advance along the axis that we are concatenating on (by the size of the axis of the tensor that we just copied)
     if (is_stack_) {
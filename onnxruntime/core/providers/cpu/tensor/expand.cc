@@ -4,22 +4,30 @@
 #include "expand.h"
 #include <cmath>
 #include <core/common/safeint.h>
+#include "core/common/type_list.h"
+#include "core/framework/copy.h"
 
 namespace onnxruntime {
 
-#define REG_EXPAND_KERNEL(TYPE)                                                    \
-  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                        \
-      Expand,                                                                      \
-      8,                                                                           \
-      12,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
-      Expand<TYPE>);                                                               \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      Expand,                                                                      \
-      13,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedOutput(0, 0)
+#else
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder()
+#endif
+
+#define REG_EXPAND_KERNEL(TYPE)                                                          \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                              \
+      Expand,                                                                            \
+      8,                                                                                 \
+      12,                                                                                \
+      TYPE,                                                                              \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      Expand<TYPE>);                                                                     \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                        \
+      Expand,                                                                            \
+      13,                                                                                \
+      TYPE,                                                                              \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       Expand<TYPE>);
 
 REG_EXPAND_KERNEL(float)
@@ -35,6 +43,23 @@ REG_EXPAND_KERNEL(uint64_t)
 REG_EXPAND_KERNEL(bool)
 REG_EXPAND_KERNEL(MLFloat16)
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Strides of the input viewed with the expanded shape. The broadcast dimensions have a zero stride.
+static TensorShapeVector ComputeExpandedStrides(const TensorShape& input_shape, gsl::span<const int64_t> input_strides,
+                                                gsl::span<const int64_t> output_dims) {
+  const size_t rank = output_dims.size();
+  const size_t input_rank = input_shape.NumDimensions();
+  TensorShapeVector output_strides(rank, 0);
+  for (size_t i = 0; i < input_rank; ++i) {
+    const size_t dim = rank - input_rank + i;
+    if (input_shape[i] == output_dims[dim]) {
+      output_strides[dim] = input_strides[i];
+    }
+  }
+  return output_strides;
+}
+#endif
+
 template <typename T>
 Status Expand<T>::Compute(OpKernelContext* context) const {
   const auto* input_tensor = context->Input<Tensor>(0);
@@ -69,6 +94,17 @@ Status Expand<T>::Compute(OpKernelContext* context) const {
 
   TensorShape output_tensor_shape(output_shape);
   auto* output_tensor = context->Output(0, output_tensor_shape);
+
+#ifdef ENABLE_STRIDED_TENSORS
+  // The output is a view of the input if the allocation planner placed it in the input buffer. A strided input is
+  // expanded with a strided copy.
+  if (output_tensor->DataRaw() == input_tensor->DataRaw() || !input_tensor->IsContiguous()) {
+    return StridedViewOrCopy<TypeList<T>>(
+        context->GetOperatorThreadPool(), *input_tensor, 0,
+        ComputeExpandedStrides(input_tensor->Shape(), input_tensor->Strides(), output_shape), *output_tensor);
+  }
+#endif
+
   auto* output_data = output_tensor->MutableData<T>();
   auto* output_dims = output_shape.data();
   auto output_dims_size = static_cast<int64_t>(output_shape.size());
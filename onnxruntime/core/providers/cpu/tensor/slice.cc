@@ -7,6 +7,7 @@
 #include <unordered_map>
 
 #include "core/common/narrow.h"
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/providers/common.h"
@@ -39,16 +40,22 @@ using EnabledIndicesTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(kCpuE
                                                                            Slice, Input, 1);
 }  // namespace
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_SLICE_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedOutput(0, 0)
+#else
+#define CREATE_SLICE_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     1, 9,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    CREATE_SLICE_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
     Slice1);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     10, 10,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -57,7 +64,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     11,
     12,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -65,7 +72,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Slice,
     13,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -288,12 +295,13 @@ Status SliceBase::Compute(OpKernelContext* ctx) const {
 
   SliceOp::PrepareForComputeMetadata compute_metadata(input_dimensions);
 
+  TensorShapeVector input_starts;
+  TensorShapeVector input_ends;
+  TensorShapeVector input_axes;
+  TensorShapeVector input_steps;
+
   // Slice V10 & DynamicSlice
   if (dynamic_) {
-    TensorShapeVector input_starts;
-    TensorShapeVector input_ends;
-    TensorShapeVector input_axes;
-    TensorShapeVector input_steps;
     ORT_RETURN_IF_ERROR(FillVectorsFromInput(*ctx->Input<Tensor>(1), *ctx->Input<Tensor>(2),
                                              ctx->Input<Tensor>(3), ctx->Input<Tensor>(4),
                                              input_starts, input_ends,
@@ -306,6 +314,33 @@ Status SliceBase::Compute(OpKernelContext* ctx) const {
     ORT_RETURN_IF_ERROR(PrepareForCompute(attr_starts_, attr_ends_, attr_axes_, compute_metadata));
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // The output is a view of the input if the allocation planner placed it in the input buffer. A strided input is
+  // sliced with a strided copy. The view starts at the first sliced element and scales the input strides by the steps.
+  auto& output_tensor = *ctx->Output(0, TensorShape(compute_metadata.output_dims_));
+  if (output_tensor.DataRaw() == input_tensor.DataRaw() || !input_tensor.IsContiguous()) {
+    // PrepareForCompute coalesces the dimensions that are not sliced, the view needs the starts and steps of all.
+    SliceOp::PrepareForComputeMetadata view_metadata(input_dimensions);
+    if (dynamic_) {
+      ORT_RETURN_IF_ERROR(SliceOp::PrepareForComputeHelper(input_starts, input_ends, input_axes, input_steps,
+                                                           view_metadata));
+    } else {
+      ORT_RETURN_IF_ERROR(SliceOp::PrepareForComputeHelper(attr_starts_, attr_ends_, attr_axes_, view_metadata));
+    }
+
+    const auto input_strides = input_tensor.Strides();
+    std::ptrdiff_t view_offset = 0;
+    TensorShapeVector view_strides(input_strides.size());
+    for (size_t i = 0; i < input_strides.size(); ++i) {
+      view_offset += narrow<std::ptrdiff_t>(view_metadata.starts_[i] * input_strides[i]);
+      view_strides[i] = input_strides[i] * view_metadata.steps_[i];
+    }
+
+    return StridedViewOrCopy<EnabledDataTypes>(ctx->GetOperatorThreadPool(), input_tensor, view_offset, view_strides,
+                                               output_tensor);
+  }
+#endif
+
   Status status = Status::OK();
 
   bool supported = false;
@@ -159,12 +159,18 @@ Status SplitImpl::Compute(OpKernelContext* context) const {
     output_dimensions[narrow<size_t>(axis)] = split_size;
 
     Tensor* output = context->Output(i, TensorShape{output_dimensions});
-    const auto output_strides = StridesForTensor(*output);
 
-    ORT_RETURN_IF_ERROR(DispatchStridedCopy<EnabledSplitDataTypes>(context->GetOperatorThreadPool(),
-                                                                   *output, /* dst_offset */ 0, output_strides,
-                                                                   output->Shape(),
-                                                                   input, input_offset, input_strides));
+    // the allocation planner may have made the output a view of its slice of the input, see ComputeBufferSlices()
+    // in allocation_planner.cc
+    const auto* input_data = static_cast<const char*>(input.DataRaw()) +
+                             static_cast<ptrdiff_t>(input_offset) * static_cast<ptrdiff_t>(input.DataType()->Size());
+    if (output->DataRaw() != input_data) {
+      const auto output_strides = StridesForTensor(*output);
+      ORT_RETURN_IF_ERROR(DispatchStridedCopy<EnabledSplitDataTypes>(context->GetOperatorThreadPool(),
+                                                                     *output, /* dst_offset */ 0, output_strides,
+                                                                     output->Shape(),
+                                                                     input, input_offset, input_strides));
+    }
 
     input_offset += SafeInt<ptrdiff_t>(split_size) * after_dims_excluding_split;  // offset by the data we used in this iteration
   }
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+#include <limits>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/providers/cpu/tunable/gemm.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+std::string CpuTuningResultsValidator::GetOrtBuildConfig() const {
+  // The tuning results refer to the SGEMM blocking candidates by index, so they are only valid for the same list.
+  std::ostringstream oss;
+  oss << "SGEMM_BLOCKING=";
+  for (const auto& blocking : SgemmBlockingCandidates) {
+    oss << blocking.StrideN << "x" << blocking.StrideK << ",";
+  }
+  oss << "|";
+  return oss.str();
+}
+
+std::string CpuTuningResultsValidator::GetCpuModel() const {
+  return CPUIDInfo::GetCPUIDInfo().GetCPUModelName();
+}
+
+Status CpuTuningResultsValidator::ValidateCpuModel(const std::string& value) const {
+  auto current = GetCpuModel();
+  ORT_RETURN_IF(current != value, "CPU model mismatch: tuning results produced with CPU \"", value,
+                "\", onnxruntime currently run with CPU \"", current, "\"");
+  return Status::OK();
+}
+
+CpuTuningResultsValidator::CpuTuningResultsValidator() {
+  RegisterValidator(
+      "CPU_MODEL",
+      [this]() { return GetCpuModel(); },
+      [this](const std::string& value) { return ValidateCpuModel(value); });
+}
+
+CpuTuningContext::CpuTuningContext(CPUExecutionProvider* ep, TunableOpInfo* info)
+    : ITuningContext(ep), info_(info) {}
+
+void CpuTuningContext::EnableTunableOp() {
+#ifdef ORT_NO_RTTI
+  // TunableOp identifies the tuned ops by their type names.
+  LOGS_DEFAULT(WARNING) << "TunableOp requires RTTI, it is not enabled for CPU Execution Provider";
+#else
+  LOGS_DEFAULT(INFO) << "Enable TunableOp for CPU Execution Provider";
+  info_->enable = true;
+#endif
+}
+
+void CpuTuningContext::DisableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp for CPU Execution Provider";
+  info_->enable = false;
+}
+
+bool CpuTuningContext::IsTunableOpEnabled() const {
+  return info_->enable;
+}
+
+void CpuTuningContext::EnableTuning() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = true;
+}
+
+void CpuTuningContext::DisableTuning() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = false;
+}
+
+bool CpuTuningContext::IsTuningEnabled() const {
+  return info_->tuning_enable;
+}
+
+void CpuTuningContext::SetMaxTuningDurationMs(int max_duration_ms) {
+  info_->max_tuning_duration_ms = max_duration_ms;
+}
+
+int CpuTuningContext::GetMaxTuningDurationMs() const {
+  return info_->max_tuning_duration_ms > 0 ? info_->max_tuning_duration_ms : std::numeric_limits<int>::max();
+}
+
+TuningResultsManager& CpuTuningContext::GetTuningResultsManager() {
+  return manager_;
+}
+
+const TuningResultsManager& CpuTuningContext::GetTuningResultsManager() const {
+  return manager_;
+}
+
+const TuningResultsValidator& CpuTuningContext::GetTuningResultsValidator() const {
+  return validator_;
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/gemm.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+std::string SgemmParams::Signature() const {
+  const bool packed_b = data[0].BIsPacked;
+  return MakeString(trans_a == CblasTrans ? "T" : "N", trans_b == CblasTrans ? "T" : "N", "_", m, "_", n, "_", k,
+                    "_B", batch, packed_b ? "_P" : "", "_T", concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+}
+
+static bool AccumulatesIntoC(const SgemmParams* params) {
+  return std::any_of(params->data, params->data + params->batch,
+                     [](const MLAS_SGEMM_DATA_PARAMS& data) { return data.beta != 0.0f; });
+}
+
+static Op<SgemmParams> SgemmOp(const MLAS_SGEMM_BLOCKING* blocking) {
+  return [blocking](const SgemmParams* params) -> Status {
+    InlinedVector<MLAS_SGEMM_DATA_PARAMS> data(params->data, params->data + params->batch);
+    for (auto& d : data) {
+      d.Blocking = blocking;
+    }
+    MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k,
+                  data.data(), params->batch, params->thread_pool);
+    return Status::OK();
+  };
+}
+
+// Tuning proxy for operations that read matrix C as well as write it.
+struct SgemmProxyParams : SgemmParams {
+  std::unique_ptr<MLAS_SGEMM_DATA_PARAMS[]> proxy_data;
+  std::unique_ptr<float[]> proxy_c;
+};
+
+class SgemmTunableOp : public TunableOp<SgemmParams> {
+ public:
+  SgemmTunableOp() {
+    this->RegisterOp(SgemmOp(nullptr));
+    for (const auto& blocking : SgemmBlockingCandidates) {
+      this->RegisterOp(SgemmOp(&blocking));
+    }
+  }
+
+  const SgemmParams* PreTuning(const SgemmParams* params) override {
+    if (AccumulatesIntoC(params)) {
+      // When beta != 0, C is an input as well as the output, so each run during tuning would accumulate into it.
+      // Tune on copies of C instead.
+      auto* proxy = new SgemmProxyParams();
+      static_cast<SgemmParams&>(*proxy) = *params;
+
+      size_t c_size = 0;
+      for (size_t i = 0; i < params->batch; i++) {
+        c_size = std::max(c_size, params->m * params->data[i].ldc);
+      }
+
+      proxy->proxy_data = std::make_unique<MLAS_SGEMM_DATA_PARAMS[]>(params->batch);
+      proxy->proxy_c = std::make_unique<float[]>(params->batch * c_size);
+
+      for (size_t i = 0; i < params->batch; i++) {
+        const MLAS_SGEMM_DATA_PARAMS& data = params->data[i];
+        float* c = proxy->proxy_c.get() + i * c_size;
+        for (size_t row = 0; row < params->m; row++) {
+          std::copy_n(data.C + row * data.ldc, params->n, c + row * data.ldc);
+        }
+        proxy->proxy_data[i] = data;
+        proxy->proxy_data[i].C = c;
+      }
+
+      proxy->data = proxy->proxy_data.get();
+      return proxy;
+    }
+
+    return params;
+  }
+
+  void PostTuning(const SgemmParams* params) override {
+    if (AccumulatesIntoC(params)) {
+      delete static_cast<const SgemmProxyParams*>(params);
+    }
+  }
+};
+
+Status SgemmBatch(CpuTuningContext* tuning_ctx,
+                  CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, size_t m, size_t n, size_t k,
+                  const MLAS_SGEMM_DATA_PARAMS* data, size_t batch, concurrency::ThreadPool* thread_pool) {
+  if (tuning_ctx == nullptr || !tuning_ctx->IsTunableOpEnabled() || batch == 0) {
+    MlasGemmBatch(trans_a, trans_b, m, n, k, data, batch, thread_pool);
+    return Status::OK();
+  }
+
+  SgemmParams params;
+  params.tuning_ctx = tuning_ctx;
+  params.trans_a = trans_a;
+  params.trans_b = trans_b;
+  params.m = m;
+  params.n = n;
+  params.k = k;
+  params.data = data;
+  params.batch = batch;
+  params.thread_pool = thread_pool;
+
+  static SgemmTunableOp op;
+  return op(&params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
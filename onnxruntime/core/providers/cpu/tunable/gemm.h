@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// MLAS SGEMM slice sizes benchmarked by the SGEMM TunableOp. Kernel id 0 uses the built-in MLAS slice sizes, kernel
+// id i > 0 uses SgemmBlockingCandidates[i - 1].
+constexpr MLAS_SGEMM_BLOCKING SgemmBlockingCandidates[] = {
+    {64, 256}, {128, 128}, {128, 256}, {128, 512}, {256, 128}, {256, 256}, {256, 512}, {512, 128}, {512, 256}};
+
+struct SgemmParams : OpParams {
+  std::string Signature() const override;
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t m;
+  size_t n;
+  size_t k;
+  const MLAS_SGEMM_DATA_PARAMS* data;
+  size_t batch;
+  concurrency::ThreadPool* thread_pool;
+};
+
+// Returns the tuning context of the CPU execution provider, or nullptr if the kernel runs on another provider.
+inline CpuTuningContext* GetCpuTuningContext(const IExecutionProvider* ep) {
+  if (ep == nullptr || ep->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+  return static_cast<CpuTuningContext*>(ep->GetTuningContext());
+}
+
+// Computes a batch of SGEMM operations with MlasGemmBatch. When TunableOp is enabled in tuning_ctx, the MLAS slice
+// sizes for the shape are looked up from the tuning results, and benchmarked first if tuning is enabled as well.
+Status SgemmBatch(CpuTuningContext* tuning_ctx,
+                  CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, size_t m, size_t n, size_t k,
+                  const MLAS_SGEMM_DATA_PARAMS* data, size_t batch, concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
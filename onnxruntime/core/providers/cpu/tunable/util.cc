@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/util.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+void Timer::Start() {
+  start_ = std::chrono::steady_clock::now();
+}
+
+void Timer::End() {
+  end_ = std::chrono::steady_clock::now();
+}
+
+float Timer::Duration() {
+  return std::chrono::duration<float, std::milli>(end_ - start_).count();
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
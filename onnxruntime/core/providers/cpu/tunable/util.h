@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+
+#include "core/framework/tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// CPU kernels have no native stream. They run on the calling thread and the intra-op thread pool, and return once
+// the work is done, so the wall clock time around a call is the kernel time.
+using NativeStreamT = void*;
+
+class Timer : public ITimer<NativeStreamT> {
+ public:
+  using TimerBase = ITimer<NativeStreamT>;
+
+  explicit Timer(NativeStreamT stream) : TimerBase{stream} {}
+
+  void Start() override;
+  void End() override;
+  float Duration() override;
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+};
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
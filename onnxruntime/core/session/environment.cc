@@ -131,6 +131,8 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int64_t thread_cache_max_bytes = -1L;
+    int numa_aware = -1;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -148,10 +150,14 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      thread_cache_max_bytes = arena_cfg->thread_cache_max_bytes;
+      numa_aware = arena_cfg->numa_aware;
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
                             initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+    l_arena_cfg.thread_cache_max_bytes = thread_cache_max_bytes;
+    l_arena_cfg.numa_aware = numa_aware;
     AllocatorCreationInfo alloc_creation_info{
         [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
         0,
@@ -201,11 +207,16 @@ Status Environment::Initialize(std::unique_ptr<logging::LoggingManager> logging_
       to.name = ORT_TSTR("intra-op");
     }
     intra_op_thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
-    to = tp_options->inter_op_thread_pool_params;
-    if (to.name == nullptr) {
-      to.name = ORT_TSTR("inter-op");
+    // in the unified mode the intra-op pool also runs the inter-op work, so that the threads of the process
+    // are not oversubscribed by two pools sized for all the cores
+    use_unified_thread_pool_ = tp_options->use_unified_thread_pool;
+    if (!use_unified_thread_pool_) {
+      to = tp_options->inter_op_thread_pool_params;
+      if (to.name == nullptr) {
+        to.name = ORT_TSTR("inter-op");
+      }
+      inter_op_thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
     }
-    inter_op_thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
   }
 
   ORT_TRY {
@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -25,6 +26,7 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/kernel_def_builder.h"
+#include "core/framework/kernel_stats.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/kernel_type_str_resolver_utils.h"
@@ -72,6 +74,8 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/request_batcher.h"
+#include "core/session/shape_specializer.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -445,6 +449,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
+        to.numa_aware =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaAware, "0") == "1";
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for intra op thread pool");
@@ -455,7 +461,13 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       }
     }
     if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
-      if (!external_inter_op_thread_pool_) {
+      inter_op_uses_intra_op_thread_pool_ =
+          !external_inter_op_thread_pool_ &&
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigInterOpUseIntraOpThreadPool,
+                                                             "0") == "1";
+      if (inter_op_uses_intra_op_thread_pool_) {
+        LOGS(*session_logger_, INFO) << "Running the inter-op work on the intra-op thread pool";
+      } else if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
             session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
         OrtThreadPoolParams to = session_options_.inter_op_param;
@@ -714,6 +726,13 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // run the queued requests while the session is intact
+  request_batcher_.reset();
+#if !defined(ORT_MINIMAL_BUILD)
+  // the specialized sessions use the thread pools of this session
+  shape_specializer_.reset();
+#endif
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -1736,6 +1755,8 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.arena_per_numa_node =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaAware, "0") == "1";
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
@@ -1749,6 +1770,10 @@ common::Status InferenceSession::Initialize() {
     // re-acquire mutex
     std::lock_guard<std::mutex> l(session_mutex_);
 
+#if !defined(ORT_MINIMAL_BUILD)
+    ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelForShapeSpecialization());
+#endif
+
 #if !defined(DISABLE_EXTERNAL_INITIALIZERS) && !defined(ORT_MINIMAL_BUILD)
     if (!session_options_.external_initializers.empty()) {
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.InjectExternalInitializedTensors(session_options_.external_initializers));
@@ -1768,6 +1793,16 @@ common::Status InferenceSession::Initialize() {
     session_activity_started_ = true;
 #endif
 
+    // The kernels pre-pack their weights before the session state knows whether another session already shared
+    // them, so the NUMA copies would be made again by every session sharing the container.
+    if (prepacked_weights_container_ != nullptr &&
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaReplicateWeights, "0") == "1") {
+      LOGS(*session_logger_, WARNING) << "Pre-packed weights are not replicated on each NUMA node as the session "
+                                         "shares them with a PrepackedWeightsContainer.";
+      ORT_RETURN_IF_ERROR_SESSIONID_(
+          session_options_.config_options.AddConfigEntry(kOrtSessionOptionsConfigNumaReplicateWeights, "0"));
+    }
+
     // now that we have all the execution providers, create the session state
     session_state_ = std::make_unique<SessionState>(
         model_->MainGraph(),
@@ -1900,8 +1935,18 @@ common::Status InferenceSession::Initialize() {
 #endif
 
       // apply any transformations to the main graph and any subgraphs
+      TimePoint transform_tp;
+      if (session_profiler_.IsEnabled()) {
+        transform_tp = session_profiler_.Start();
+      }
+
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, saving_ort_format));
 
+      if (session_profiler_.IsEnabled()) {
+        // includes partitioning the graph between the execution providers
+        session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_transformation", transform_tp);
+      }
+
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
@@ -2046,6 +2091,8 @@ common::Status InferenceSession::Initialize() {
 
       // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
       ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+
+      UseInitializersOfGenericSession(graph);
 #else   // !defined(ORT_MINIMAL_BUILD)
       ORT_RETURN_IF_ERROR_SESSIONID_(
           ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -2110,6 +2157,20 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    // The CPU EP has no provider options, so its TunableOp is configured with session options.
+    if (auto* cpu_tuning_ctx = execution_providers_.Get(kCpuExecutionProvider)->GetTuningContext();
+        cpu_tuning_ctx != nullptr) {
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCpuTunableOpEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTunableOp();
+      }
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCpuTunableOpTuningEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTuning();
+      }
+      cpu_tuning_ctx->SetMaxTuningDurationMs(ParseStringWithClassicLocale<int>(
+          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCpuTunableOpMaxTuningDurationMs, "0")));
+    }
+
     std::vector<TuningResults> tuning_results;
     bool found_tuning_results = false;
     ORT_RETURN_IF_ERROR_SESSIONID_(inference_session_utils::ParseTuningResultsFromModelMetadata(
@@ -2122,6 +2183,16 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableKernelStats, "0") == "1") {
+      kernel_stats_ = std::make_unique<KernelStats>();
+      session_state_->SetKernelStats(*kernel_stats_);
+    }
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateRequestBatcher());
+#if !defined(ORT_MINIMAL_BUILD)
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateShapeSpecializer());
+#endif
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -2533,6 +2604,14 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+#if !defined(ORT_MINIMAL_BUILD)
+  if (shape_specializer_) {
+    if (InferenceSession* specialized_session = shape_specializer_->GetSession(feed_names, feeds)) {
+      return specialized_session->Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+    }
+  }
+#endif
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2824,6 +2903,10 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
   }
+  if (request_batcher_ &&
+      request_batcher_->Submit(run_options, feed_names, feeds, fetch_names, fetches, callback, user_data)) {
+    return Status::OK();
+  }
   std::function<void()> run_fn = [run_options, feed_names, feeds, fetch_names, fetches, num_fetches,
                                   callback, user_data, this]() {
     Status status = Status::OK();
@@ -2849,6 +2932,215 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   return Status::OK();
 }
 
+Status InferenceSession::CreateRequestBatcher() {
+  const auto& config_options = session_options_.config_options;
+  RequestBatcher::Options options;
+  ORT_TRY {
+    options.max_batch_size =
+        std::stoll(config_options.GetConfigOrDefault(kOrtSessionOptionsConfigBatchingMaxBatchSize, "0"));
+    options.max_wait = std::chrono::microseconds(
+        std::stoll(config_options.GetConfigOrDefault(kOrtSessionOptionsConfigBatchingMaxWaitUs, "1000")));
+    options.batch_axis =
+        static_cast<size_t>(std::stoul(config_options.GetConfigOrDefault(kOrtSessionOptionsConfigBatchingBatchAxis,
+                                                                          "0")));
+  }
+  ORT_CATCH(const std::exception& ex) {
+    Status status;
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid request batching configuration: ", ex.what());
+    });
+    return status;
+  }
+
+  if (options.max_batch_size <= 1) {
+    return Status::OK();
+  }
+  ORT_RETURN_IF(options.max_wait.count() < 0, "Invalid request batching configuration: negative max_wait_us");
+
+  auto* tp = GetIntraOpThreadPoolToUse();
+  if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
+    LOGS(*session_logger_, WARNING) << "Request batching is disabled as RunAsync requires an intra-op thread pool "
+                                       "with at least one thread.";
+    return Status::OK();
+  }
+
+  // the outputs of a batched run are split along the batch axis, which every output must have
+  auto status = RequestBatcher::CheckOutputsHaveBatchAxis(session_state_->GetGraphViewer().GetOutputs(),
+                                                          options.batch_axis);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Request batching is disabled: " << status.ErrorMessage();
+    return Status::OK();
+  }
+
+  LOGS(*session_logger_, INFO) << "Batching RunAsync requests up to a batch size of " << options.max_batch_size
+                               << " along axis " << options.batch_axis << ", waiting up to "
+                               << options.max_wait.count() << " us";
+  auto run_fn = [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> fetch_names,
+                       std::vector<OrtValue>& fetches) {
+    return Run(run_options, feed_names, feeds, fetch_names, &fetches, nullptr);
+  };
+  request_batcher_ = std::make_unique<RequestBatcher>(options, std::move(run_fn), tp,
+                                                      session_state_->GetAllocator(OrtDevice()));
+  return Status::OK();
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status InferenceSession::SaveModelForShapeSpecialization() {
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShapeSpecializationMinRuns, "0") ==
+      "0") {
+    return Status::OK();
+  }
+
+  // the specialized sessions load the ONNX model again, without the initializers given in the session options
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+  const bool has_external_initializers = !session_options_.external_initializers.empty() ||
+                                         !session_options_.external_initializer_files_mmap.empty();
+#else
+  const bool has_external_initializers = false;
+#endif
+  if (!ort_format_model_bytes_.empty() || has_external_initializers) {
+    LOGS(*session_logger_, WARNING) << "Shape specialization is disabled as it requires an ONNX model without "
+                                       "external initializers in the session options.";
+    return Status::OK();
+  }
+
+  if (model_location_.empty() && !model_->ToProto().SerializeToString(&shape_specialization_model_bytes_)) {
+    LOGS(*session_logger_, WARNING) << "Shape specialization is disabled as the model could not be serialized.";
+    return Status::OK();
+  }
+
+  can_specialize_shapes_ = true;
+  return Status::OK();
+}
+
+Status InferenceSession::CreateShapeSpecializer() {
+  const auto& config_options = session_options_.config_options;
+  ShapeSpecializer::Options options;
+  ORT_TRY {
+    options.min_runs = static_cast<size_t>(
+        std::stoull(config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShapeSpecializationMinRuns, "0")));
+    options.max_sessions = static_cast<size_t>(
+        std::stoull(config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShapeSpecializationMaxSessions, "1")));
+  }
+  ORT_CATCH(const std::exception& ex) {
+    Status status;
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid shape specialization configuration: ",
+                               ex.what());
+    });
+    return status;
+  }
+
+  if (options.min_runs == 0 || options.max_sessions == 0 || !can_specialize_shapes_) {
+    return Status::OK();
+  }
+
+  if (execution_providers_.NumProviders() != 1 || execution_providers_.Get(kCpuExecutionProvider) == nullptr) {
+    LOGS(*session_logger_, WARNING) << "Shape specialization is disabled as it is only supported with the CPU "
+                                       "execution provider alone.";
+    return Status::OK();
+  }
+  if (!custom_registries_.empty() || HasLocalSchema()) {
+    LOGS(*session_logger_, WARNING) << "Shape specialization is disabled as it does not support custom operators.";
+    return Status::OK();
+  }
+
+  auto create_session_fn = [this](const std::vector<FreeDimensionOverride>& overrides,
+                                  std::unique_ptr<InferenceSession>& session) {
+    return CreateSpecializedSession(overrides, session);
+  };
+  auto shape_specializer = std::make_unique<ShapeSpecializer>(options, model_->MainGraph().GetInputs(),
+                                                              std::move(create_session_fn), *session_logger_);
+  if (!shape_specializer->HasSymbolicDims()) {
+    LOGS(*session_logger_, INFO) << "Shape specialization is not needed as the graph inputs have no symbolic "
+                                    "dimensions.";
+    return Status::OK();
+  }
+
+  // the specialized sessions use the initializers of this session that they would load with the same values
+  const auto& ort_value_name_idx_map = session_state_->GetOrtValueNameIdxMap();
+  for (const auto& [ort_value_idx, value] : session_state_->GetConstantInitializedTensors()) {
+    std::string name;
+    if (value.IsTensor() && ort_value_name_idx_map.GetName(ort_value_idx, name).IsOK()) {
+      shape_specialization_initializers_.emplace(std::move(name), value);
+    }
+  }
+
+  LOGS(*session_logger_, INFO) << "Specializing the session to the input shapes seen in " << options.min_runs
+                               << " runs, up to " << options.max_sessions << " specialized sessions";
+  shape_specialization_max_sessions_ = options.max_sessions;
+  shape_specializer_ = std::move(shape_specializer);
+  return Status::OK();
+}
+
+Status InferenceSession::CreateSpecializedSession(const std::vector<FreeDimensionOverride>& overrides,
+                                                  std::unique_ptr<InferenceSession>& session) {
+  SessionOptions session_options = session_options_;
+  session_options.free_dimension_overrides.insert(session_options.free_dimension_overrides.end(),
+                                                  overrides.begin(), overrides.end());
+
+  // the specialized session runs the requests routed to it by this session and must not overwrite its outputs
+  auto& configurations = session_options.config_options.configurations;
+  configurations.erase(kOrtSessionOptionsConfigShapeSpecializationMinRuns);
+  configurations.erase(kOrtSessionOptionsConfigBatchingMaxBatchSize);
+  session_options.optimized_model_filepath.clear();
+
+  session = std::make_unique<InferenceSession>(session_options, environment_, GetIntraOpThreadPoolToUse(),
+                                               GetInterOpThreadPoolToUse());
+  session->generic_session_initializers_ = &shape_specialization_initializers_;
+  if (model_location_.empty()) {
+    ORT_RETURN_IF_ERROR(session->Load(shape_specialization_model_bytes_.data(),
+                                      static_cast<int>(shape_specialization_model_bytes_.size())));
+  } else {
+    ORT_RETURN_IF_ERROR(session->Load(model_location_));
+  }
+  ORT_RETURN_IF_ERROR(session->Initialize());
+
+  // the sessions are created one at a time and a failed one frees its slot, so once max_sessions of them have been
+  // created the model is not loaded again
+  if (++num_specialized_sessions_ == shape_specialization_max_sessions_) {
+    std::string().swap(shape_specialization_model_bytes_);
+  }
+  return Status::OK();
+}
+
+void InferenceSession::UseInitializersOfGenericSession(const Graph& graph) {
+  if (generic_session_initializers_ == nullptr) {
+    return;
+  }
+
+  // the transformers may have rewritten an initializer in place, e.g. transposed it, differently than in the
+  // generic session, so only the initializers with the same type, shape and data are shared
+  size_t num_shared = 0;
+  std::vector<uint8_t> unpacked_tensor;
+  for (const auto& [name, value] : *generic_session_initializers_) {
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    if (session_options_.initializers_to_share_map.count(name) != 0 ||
+        !graph.GetInitializedTensor(name, tensor_proto)) {
+      continue;
+    }
+
+    const Tensor& tensor = value.Get<Tensor>();
+    if (tensor_proto->data_type() != tensor.GetElementType() ||
+        utils::GetTensorShapeFromTensorProto(*tensor_proto) != tensor.Shape() ||
+        !utils::UnpackInitializerData(*tensor_proto, graph.ModelPath(), unpacked_tensor).IsOK() ||
+        unpacked_tensor.size() != tensor.SizeInBytes()) {
+      continue;
+    }
+    if (!unpacked_tensor.empty() &&
+        std::memcmp(unpacked_tensor.data(), tensor.DataRaw(), unpacked_tensor.size()) != 0) {
+      continue;
+    }
+
+    session_options_.initializers_to_share_map.emplace(name, &value);
+    ++num_shared;
+  }
+
+  LOGS(*session_logger_, INFO) << "Sharing " << num_shared << " of the initializers of the generic session";
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, gsl::span<const std::string> output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -2967,9 +3259,37 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
   session_profiler_.StartProfiling(logger_ptr);
 }
 
+namespace {
+// Record the utilization counters of a thread pool as a session event. The pool's busy time is measured from the
+// first kernel run with profiling enabled.
+void RecordThreadPoolUtilization(profiling::Profiler& profiler, const std::string& event_name,
+                                 const concurrency::ThreadPool* tp) {
+  if (tp == nullptr) {
+    return;
+  }
+  const auto utilization = concurrency::ThreadPool::GetUtilization(tp);
+  profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, event_name, profiler.Start(),
+                                 {{"num_threads", std::to_string(utilization.num_threads)},
+                                  {"tasks_scheduled", std::to_string(utilization.tasks_scheduled)},
+                                  {"tasks_run", std::to_string(utilization.tasks_run)},
+                                  {"tasks_stolen", std::to_string(utilization.tasks_stolen)},
+                                  {"parallel_loops", std::to_string(utilization.parallel_loops)},
+                                  {"nested_loops_run_inline", std::to_string(utilization.nested_loops_run_inline)},
+                                  {"busy_time_us", std::to_string(utilization.busy_time_us)},
+                                  {"elapsed_time_us", std::to_string(utilization.elapsed_time_us)},
+                                  {"utilization", std::to_string(utilization.Utilization())}});
+}
+}  // namespace
+
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      auto* intra_op_thread_pool = GetIntraOpThreadPoolToUse();
+      auto* inter_op_thread_pool = GetInterOpThreadPoolToUse();
+      RecordThreadPoolUtilization(session_profiler_, "intra_op_thread_pool_utilization", intra_op_thread_pool);
+      if (inter_op_thread_pool != intra_op_thread_pool) {
+        RecordThreadPoolUtilization(session_profiler_, "inter_op_thread_pool_utilization", inter_op_thread_pool);
+      }
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -2984,6 +3304,18 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+common::Status InferenceSession::GetKernelStats(bool reset, std::string& stats_json) {
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Session not initialized.");
+  }
+  if (!kernel_stats_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Kernel statistics are not enabled. Set the '",
+                           kOrtSessionOptionsConfigEnableKernelStats, "' session option to '1'.");
+  }
+  stats_json = kernel_stats_->ToJson(reset);
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
@@ -53,6 +53,9 @@ class GraphTransformer;
 class IExecutionProvider;
 class IOBinding;
 struct Notification;
+class KernelStats;
+class RequestBatcher;
+class ShapeSpecializer;
 
 #ifdef ENABLE_TRAINING
 struct PartialGraphExecutionState;
@@ -164,7 +167,7 @@ class InferenceSession {
 
   /**
     Create a new InferenceSession that accepts thread pools for intra and inter op thread execution.
-    Used by WinML only!
+    Used by WinML and by the sessions specialized to frequent input shapes only!
     @param session_options Session options.
     @param session_env This represents the context for the session and contains the logger and the global threadpools.
     @param external_intra_op_thread_pool This represents the intra op threadpool.
@@ -495,6 +498,15 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+   * Get the statistics of the kernels the session ran, as JSON: the count, total and percentile latencies and
+   * output bytes of each node and of each op type. Requires the kernel statistics to be enabled in the session options.
+   * @param reset Whether the next call only reports the kernels run after this one.
+   * @param stats_json The statistics.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status GetKernelStats(bool reset, std::string& stats_json);
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -538,6 +550,11 @@ class InferenceSession {
     return *session_state_;
   }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Returns the specializer of the session to its frequent input shapes, or nullptr if it is not enabled.
+  ShapeSpecializer* GetShapeSpecializer() const { return shape_specializer_.get(); }
+#endif
+
   /**
    * Add a PrepackedWeightsContainer instance to the session so as to store the pre-packed weights
    *  of shared initializers to be shared across sessions.
@@ -590,6 +607,8 @@ class InferenceSession {
     if (session_options_.use_per_session_threads) {
       if (external_inter_op_thread_pool_) {
         return external_inter_op_thread_pool_;
+      } else if (inter_op_uses_intra_op_thread_pool_) {
+        return GetIntraOpThreadPoolToUse();
       } else {
         return inter_op_thread_pool_.get();
       }
@@ -623,6 +642,26 @@ class InferenceSession {
   [[nodiscard]] common::Status HasInvalidCombinationOfExecutionProviders() const;
   [[nodiscard]] common::Status SaveModelMetadata(const onnxruntime::Model& model);
 
+  // Creates request_batcher_ if request batching is enabled in the session options.
+  [[nodiscard]] common::Status CreateRequestBatcher();
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Keeps the model as loaded if shape specialization is enabled in the session options.
+  // Must be called before the external initializers are injected and the graph is transformed.
+  [[nodiscard]] common::Status SaveModelForShapeSpecialization();
+
+  // Creates shape_specializer_ if shape specialization is enabled in the session options.
+  [[nodiscard]] common::Status CreateShapeSpecializer();
+
+  // Creates and initializes a copy of this session with the given free dimension overrides.
+  [[nodiscard]] common::Status CreateSpecializedSession(const std::vector<FreeDimensionOverride>& overrides,
+                                                        std::unique_ptr<InferenceSession>& session);
+
+  // Shares the initializers of the generic session that are the same in the transformed graph of this specialized
+  // session, so that they are not loaded again.
+  void UseInitializersOfGenericSession(const Graph& graph);
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD)
 
   [[nodiscard]] common::Status LoadOnnxModel(const PathString& model_uri);
@@ -769,6 +808,36 @@ class InferenceSession {
   onnxruntime::concurrency::ThreadPool* external_intra_op_thread_pool_{};
   onnxruntime::concurrency::ThreadPool* external_inter_op_thread_pool_{};
 
+  // true if the parallel execution mode schedules its work on the intra-op thread pool instead of creating
+  // inter_op_thread_pool_
+  bool inter_op_uses_intra_op_thread_pool_ = false;
+
+  // Batches the requests submitted with RunAsync. Only created if enabled in the session options.
+  std::unique_ptr<RequestBatcher> request_batcher_;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Routes the runs with frequent input shapes to specialized sessions. Only created if enabled in the session options.
+  std::unique_ptr<ShapeSpecializer> shape_specializer_;
+
+  // true if the specialized sessions can be created, from model_location_ or shape_specialization_model_bytes_
+  bool can_specialize_shapes_ = false;
+
+  // the serialized model as loaded, if it was not loaded from a file. Released once max_sessions specialized
+  // sessions have been created.
+  std::string shape_specialization_model_bytes_;
+
+  // the constant initializers of this session, shared with the specialized sessions
+  std::unordered_map<std::string, OrtValue> shape_specialization_initializers_;
+  size_t shape_specialization_max_sessions_ = 0;
+  size_t num_specialized_sessions_ = 0;
+
+  // set in a specialized session to the initializers of the generic session it was created from
+  const std::unordered_map<std::string, OrtValue>* generic_session_initializers_ = nullptr;
+#endif
+
+  // Always-on statistics of the kernels. Only created if enabled in the session options.
+  std::unique_ptr<KernelStats> kernel_stats_;
+
   // initialized from session options
   // Determines which threadpools will be intialized and used for the duration of this session.
   // If true, use the per session ones, or else the global threadpools.
@@ -0,0 +1,357 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/framework/error_code_helper.h"
+#include "core/framework/tensor.h"
+#include "core/graph/node_arg.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Appends the settings of `run_options` that affect a Run call to `key`, so that requests with different
+// RunOptions instances holding the same settings can share a batch. A null `run_options` is keyed as the default.
+void AppendRunOptionsKey(const RunOptions* run_options, std::ostringstream& key) {
+  static const RunOptions default_run_options;
+  const RunOptions& options = run_options != nullptr ? *run_options : default_run_options;
+  key << options.run_log_severity_level << ':' << options.run_log_verbosity_level << ':'
+      << options.terminate << ':' << options.only_execute_path_to_fetches;
+#ifdef ENABLE_TRAINING
+  key << ':' << options.training_mode;
+#endif
+  key << '|' << options.run_tag.size() << ':' << options.run_tag;
+
+  // the config entries are stored in an unordered map, so sort them to get the same key for the same entries
+  std::vector<std::pair<std::string, std::string>> config_entries(
+      options.config_options.configurations.begin(), options.config_options.configurations.end());
+  std::sort(config_entries.begin(), config_entries.end());
+  for (const auto& [config_key, config_value] : config_entries) {
+    key << '|' << config_key.size() << ':' << config_key << '=' << config_value.size() << ':' << config_value;
+  }
+
+  key << '|' << options.active_adapters.size();
+  for (const auto* adapter : options.active_adapters) {
+    key << ',' << static_cast<const void*>(adapter);
+  }
+}
+
+// Copies `rows` rows along `axis`, starting at row `src_row` of `src`, to the rows starting at `dst_row` of `dst`.
+// The tensors have the same element type and the same shape apart from the size of `axis`.
+void CopyRows(const Tensor& src, int64_t src_row, Tensor& dst, int64_t dst_row, int64_t rows, size_t axis) {
+  const auto& src_shape = src.Shape();
+  const int64_t outer_size = src_shape.SizeToDimension(axis);
+  const int64_t inner_size = src_shape.SizeFromDimension(axis + 1);
+  const int64_t src_rows = src_shape[axis];
+  const int64_t dst_rows = dst.Shape()[axis];
+  const int64_t count = rows * inner_size;
+
+  for (int64_t outer = 0; outer < outer_size; ++outer) {
+    const int64_t src_index = (outer * src_rows + src_row) * inner_size;
+    const int64_t dst_index = (outer * dst_rows + dst_row) * inner_size;
+    if (src.IsDataTypeString()) {
+      const std::string* src_data = src.Data<std::string>() + src_index;
+      std::copy(src_data, src_data + count, dst.MutableData<std::string>() + dst_index);
+    } else {
+      const size_t element_size = src.DataType()->Size();
+      std::memcpy(static_cast<uint8_t*>(dst.MutableDataRaw()) + dst_index * element_size,
+                  static_cast<const uint8_t*>(src.DataRaw()) + src_index * element_size,
+                  static_cast<size_t>(count) * element_size);
+    }
+  }
+}
+
+}  // namespace
+
+RequestBatcher::RequestBatcher(const Options& options, RunFn run_fn, concurrency::ThreadPool* thread_pool,
+                               AllocatorPtr allocator)
+    : options_(options),
+      run_fn_(std::move(run_fn)),
+      thread_pool_(thread_pool),
+      allocator_(std::move(allocator)),
+      dispatch_thread_([this]() { DispatchLoop(); }) {
+}
+
+Status RequestBatcher::CheckOutputsHaveBatchAxis(gsl::span<const NodeArg* const> outputs, size_t batch_axis) {
+  for (const NodeArg* output : outputs) {
+    const auto* type = output->TypeAsProto();
+    ORT_RETURN_IF(type == nullptr || type->value_case() != ONNX_NAMESPACE::TypeProto::kTensorType,
+                  "Output ", output->Name(), " is not a tensor.");
+    const auto* shape = output->Shape();
+    ORT_RETURN_IF(shape == nullptr || shape->dim_size() <= static_cast<int>(batch_axis),
+                  "Output ", output->Name(), " has no dimension along the batch axis ", batch_axis, ".");
+    ORT_RETURN_IF(shape->dim(static_cast<int>(batch_axis)).has_dim_value(),
+                  "Output ", output->Name(), " has a fixed size along the batch axis ", batch_axis, ".");
+  }
+  return Status::OK();
+}
+
+RequestBatcher::~RequestBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  dispatch_thread_.join();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  running_cv_.wait(lock, [this]() { return num_running_ == 0; });
+}
+
+bool RequestBatcher::Submit(const RunOptions* run_options,
+                            gsl::span<const char* const> feed_names,
+                            gsl::span<const OrtValue* const> feeds,
+                            gsl::span<const char* const> fetch_names,
+                            gsl::span<OrtValue*> fetches,
+                            RunAsyncCallbackFn callback,
+                            void* user_data) {
+  if (feeds.empty() || fetch_names.empty()) {
+    return false;
+  }
+  if (std::any_of(fetches.begin(), fetches.end(), [](const OrtValue* fetch) { return fetch != nullptr; })) {
+    return false;
+  }
+
+  // requests can be batched if they have the same key
+  const size_t axis = options_.batch_axis;
+  int64_t batch_size = -1;
+  std::ostringstream key;
+  AppendRunOptionsKey(run_options, key);
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const OrtValue* feed = feeds[i];
+    if (feed == nullptr || feed_names[i] == nullptr || !feed->IsTensor()) {
+      return false;
+    }
+    const Tensor& tensor = feed->Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        shape.NumDimensions() <= axis) {
+      return false;
+    }
+    if (batch_size == -1) {
+      batch_size = shape[axis];
+    } else if (shape[axis] != batch_size) {
+      return false;
+    }
+
+    key << '|' << std::strlen(feed_names[i]) << ':' << feed_names[i] << ':' << tensor.GetElementType();
+    for (size_t dim = 0; dim < shape.NumDimensions(); ++dim) {
+      key << ',';
+      if (dim == axis) {
+        key << '*';
+      } else {
+        key << shape[dim];
+      }
+    }
+  }
+  if (batch_size <= 0 || batch_size >= options_.max_batch_size) {
+    return false;
+  }
+
+  key << "->";
+  for (const char* fetch_name : fetch_names) {
+    if (fetch_name == nullptr) {
+      return false;
+    }
+    key << '|' << std::strlen(fetch_name) << ':' << fetch_name;
+  }
+
+  Request request{{}, fetches, callback, user_data, batch_size};
+  request.feeds.reserve(feeds.size());
+  for (const OrtValue* feed : feeds) {
+    request.feeds.push_back(*feed);
+  }
+
+  InlinedVector<Batch> full_batches;
+  bool new_batch = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(key.str());
+    if (it != pending_.end() && it->second.batch_size + batch_size > options_.max_batch_size) {
+      full_batches.push_back(std::move(it->second));
+      pending_.erase(it);
+      it = pending_.end();
+    }
+    if (it == pending_.end()) {
+      Batch batch;
+      batch.run_options = run_options;
+      batch.feed_names.assign(feed_names.begin(), feed_names.end());
+      batch.fetch_names.assign(fetch_names.begin(), fetch_names.end());
+      batch.deadline = std::chrono::steady_clock::now() + options_.max_wait;
+      it = pending_.emplace(key.str(), std::move(batch)).first;
+      new_batch = true;
+    }
+
+    Batch& batch = it->second;
+    batch.requests.push_back(std::move(request));
+    batch.batch_size += batch_size;
+    if (batch.batch_size == options_.max_batch_size) {
+      full_batches.push_back(std::move(batch));
+      pending_.erase(it);
+      new_batch = false;
+    }
+  }
+
+  // let the dispatcher wait for the deadline of the new batch
+  if (new_batch) {
+    cv_.notify_one();
+  }
+  for (auto& batch : full_batches) {
+    Dispatch(std::move(batch));
+  }
+
+  return true;
+}
+
+void RequestBatcher::DispatchLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (pending_.empty()) {
+      if (stop_) {
+        break;
+      }
+      cv_.wait(lock);
+      continue;
+    }
+
+    // dispatch the batches whose first request has waited long enough, or all of them when stopping
+    const auto now = std::chrono::steady_clock::now();
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    InlinedVector<Batch> expired_batches;
+    for (auto it = pending_.begin(); it != pending_.end();) {
+      if (stop_ || it->second.deadline <= now) {
+        expired_batches.push_back(std::move(it->second));
+        it = pending_.erase(it);
+      } else {
+        next_deadline = std::min(next_deadline, it->second.deadline);
+        ++it;
+      }
+    }
+
+    if (expired_batches.empty()) {
+      cv_.wait_until(lock, next_deadline);
+    } else {
+      lock.unlock();
+      for (auto& batch : expired_batches) {
+        Dispatch(std::move(batch));
+      }
+      lock.lock();
+    }
+  }
+}
+
+void RequestBatcher::Dispatch(Batch&& batch) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_running_;
+  }
+
+  auto scheduled_batch = std::make_shared<Batch>(std::move(batch));
+  concurrency::ThreadPool::Schedule(thread_pool_, [this, scheduled_batch]() {
+    RunBatch(*scheduled_batch);
+
+    // notify while holding the lock as the destructor may return as soon as it sees no running batches
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_running_ == 0) {
+      running_cv_.notify_all();
+    }
+  });
+}
+
+void RequestBatcher::RunBatch(Batch& batch) {
+  std::vector<std::vector<OrtValue>> request_fetches;
+  Status status;
+  ORT_TRY {
+    status = RunBatchAndSplitOutputs(batch, request_fetches);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+  ORT_CATCH(...) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+  }
+
+  for (size_t r = 0; r < batch.requests.size(); ++r) {
+    auto& request = batch.requests[r];
+    size_t num_fetches = 0;
+    if (status.IsOK()) {
+      num_fetches = request.fetches.size();
+      for (size_t i = 0; i < num_fetches; ++i) {
+        request.fetches[i] = new OrtValue(std::move(request_fetches[r][i]));
+      }
+    }
+    request.callback(request.user_data, request.fetches.data(), num_fetches, ToOrtStatus(status));
+  }
+}
+
+Status RequestBatcher::RunBatchAndSplitOutputs(Batch& batch,
+                                               std::vector<std::vector<OrtValue>>& request_fetches) {
+  const size_t axis = options_.batch_axis;
+  const auto& requests = batch.requests;
+  request_fetches.resize(requests.size());
+
+  RunOptions default_run_options;
+  const RunOptions& run_options = batch.run_options != nullptr ? *batch.run_options : default_run_options;
+
+  // a request that did not find others to batch with runs as is
+  if (requests.size() == 1) {
+    return run_fn_(run_options, batch.feed_names, requests[0].feeds, batch.fetch_names, request_fetches[0]);
+  }
+
+  const size_t num_feeds = batch.feed_names.size();
+  std::vector<OrtValue> feeds(num_feeds);
+  for (size_t i = 0; i < num_feeds; ++i) {
+    const Tensor& first = requests[0].feeds[i].Get<Tensor>();
+    TensorShape shape = first.Shape();
+    shape[axis] = batch.batch_size;
+    Tensor::InitOrtValue(first.DataType(), shape, allocator_, feeds[i]);
+    Tensor& batched = *feeds[i].GetMutable<Tensor>();
+
+    int64_t row = 0;
+    for (const auto& request : requests) {
+      CopyRows(request.feeds[i].Get<Tensor>(), 0, batched, row, request.batch_size, axis);
+      row += request.batch_size;
+    }
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(run_fn_(run_options, batch.feed_names, feeds, batch.fetch_names, fetches));
+
+  for (auto& fetches_of_request : request_fetches) {
+    fetches_of_request.resize(fetches.size());
+  }
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    ORT_RETURN_IF_NOT(fetches[i].IsTensor(), "Output ", batch.fetch_names[i], " of a batched run is not a tensor.");
+    const Tensor& batched = fetches[i].Get<Tensor>();
+    const auto& batched_shape = batched.Shape();
+    ORT_RETURN_IF_NOT(batched.Location().device.Type() == OrtDevice::CPU &&
+                          batched_shape.NumDimensions() > axis && batched_shape[axis] == batch.batch_size,
+                      "Output ", batch.fetch_names[i], " of a batched run with batch size ", batch.batch_size,
+                      " has shape ", batched_shape, " and cannot be split along axis ", axis, ".");
+
+    int64_t row = 0;
+    for (size_t r = 0; r < requests.size(); ++r) {
+      TensorShape shape = batched_shape;
+      shape[axis] = requests[r].batch_size;
+      Tensor::InitOrtValue(batched.DataType(), shape, allocator_, request_fetches[r][i]);
+      CopyRows(batched, row, *request_fetches[r][i].GetMutable<Tensor>(), 0, requests[r].batch_size, axis);
+      row += requests[r].batch_size;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+class NodeArg;
+
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+ * Dynamic batching of the requests submitted to InferenceSession::RunAsync.
+ *
+ * Requests with the same inputs and outputs, run options and input shapes apart from the batch axis are queued
+ * together until either the sum of their batch dimensions reaches max_batch_size or max_wait has passed since the
+ * first of them arrived. Their inputs are then concatenated along the batch axis, the model is run once on the
+ * thread pool and each output is split along the batch axis to give the outputs of the individual requests.
+ *
+ * This is only correct for models whose samples are independent along the batch axis of all inputs and outputs.
+ */
+class RequestBatcher {
+ public:
+  struct Options {
+    // maximum sum of the batch dimensions of the requests run together
+    int64_t max_batch_size = 0;
+    // maximum time a request waits for others to batch with
+    std::chrono::microseconds max_wait{1000};
+    // axis of the inputs and outputs that the requests are concatenated along
+    size_t batch_axis = 0;
+  };
+
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> fetch_names,
+                                     std::vector<OrtValue>& fetches)>;
+
+  RequestBatcher(const Options& options, RunFn run_fn, concurrency::ThreadPool* thread_pool, AllocatorPtr allocator);
+
+  // Checks that the outputs of a model can be split between the requests of a batch: each must be a tensor with a
+  // dimension along batch_axis whose size is not fixed.
+  static Status CheckOutputsHaveBatchAxis(gsl::span<const NodeArg* const> outputs, size_t batch_axis);
+
+  // Runs the queued requests and waits for all the batches to complete.
+  ~RequestBatcher();
+
+  // Queues a request, and calls `callback` with the outputs once its batch has run. Requests are batched together
+  // when their RunOptions hold the same settings, even if they are different instances, and they have the same
+  // feeds and fetches apart from the batch dimension.
+  // Returns false without taking the request if it cannot be batched, in which case the caller should run it
+  // directly. This is the case for requests with preallocated outputs, inputs that are not CPU tensors of
+  // numeric types, or inputs that disagree on the batch dimension or already fill a batch.
+  bool Submit(const RunOptions* run_options,
+              gsl::span<const char* const> feed_names,
+              gsl::span<const OrtValue* const> feeds,
+              gsl::span<const char* const> fetch_names,
+              gsl::span<OrtValue*> fetches,
+              RunAsyncCallbackFn callback,
+              void* user_data);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+ private:
+  struct Request {
+    InlinedVector<OrtValue> feeds;
+    gsl::span<OrtValue*> fetches;
+    RunAsyncCallbackFn callback;
+    void* user_data;
+    int64_t batch_size;
+  };
+
+  struct Batch {
+    // the RunOptions of the first request. all the requests in a batch have RunOptions with the same settings.
+    const RunOptions* run_options = nullptr;
+    std::vector<std::string> feed_names;
+    std::vector<std::string> fetch_names;
+    std::vector<Request> requests;
+    int64_t batch_size = 0;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  void DispatchLoop();
+
+  // Schedules the batch on the thread pool.
+  void Dispatch(Batch&& batch);
+
+  // Runs the batch and calls the callbacks of its requests.
+  void RunBatch(Batch& batch);
+
+  Status RunBatchAndSplitOutputs(Batch& batch, std::vector<std::vector<OrtValue>>& request_fetches);
+
+  const Options options_;
+  const RunFn run_fn_;
+  concurrency::ThreadPool* const thread_pool_;
+  const AllocatorPtr allocator_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // batches being filled, by the key identifying compatible requests
+  std::unordered_map<std::string, Batch> pending_;
+  bool stop_ = false;
+  // batches dispatched but not completed
+  size_t num_running_ = 0;
+  std::condition_variable running_cv_;
+
+  std::thread dispatch_thread_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/shape_specializer.h"
+
+#include <sstream>
+
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Shapes that have been seen without reaching min_runs are forgotten once that many are tracked, so that the
+// memory used by the counts stays bounded when the input shapes vary a lot.
+constexpr size_t kMaxTrackedShapes = 1024;
+
+}  // namespace
+
+ShapeSpecializer::ShapeSpecializer(const Options& options, gsl::span<const NodeArg* const> graph_inputs,
+                                   CreateSessionFn create_session_fn, const logging::Logger& logger)
+    : options_(options),
+      create_session_fn_(std::move(create_session_fn)),
+      logger_(logger) {
+  InlinedHashMap<std::string, size_t> dim_param_indices;
+  for (const NodeArg* input : graph_inputs) {
+    const auto* shape = input->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+
+    InputDims input_dims{static_cast<size_t>(shape->dim_size()), {}};
+    for (int axis = 0; axis < shape->dim_size(); ++axis) {
+      const auto& dim = shape->dim(axis);
+      if (!utils::HasDimParam(dim)) {
+        continue;
+      }
+
+      auto inserted = dim_param_indices.emplace(dim.dim_param(), dim_params_.size());
+      if (inserted.second) {
+        dim_params_.push_back(dim.dim_param());
+      }
+      input_dims.axes.emplace_back(static_cast<size_t>(axis), inserted.first->second);
+    }
+
+    if (!input_dims.axes.empty()) {
+      input_dims_.emplace(input->Name(), std::move(input_dims));
+    }
+  }
+
+  if (HasSymbolicDims()) {
+    build_thread_ = std::thread([this]() { BuildLoop(); });
+  }
+}
+
+ShapeSpecializer::~ShapeSpecializer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (build_thread_.joinable()) {
+    build_thread_.join();
+  }
+}
+
+InferenceSession* ShapeSpecializer::GetSession(gsl::span<const std::string> feed_names,
+                                               gsl::span<const OrtValue> feeds) {
+  if (!HasSymbolicDims()) {
+    return nullptr;
+  }
+
+  std::vector<int64_t> dim_values(dim_params_.size(), -1);
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    auto input_dims = input_dims_.find(feed_names[i]);
+    if (input_dims == input_dims_.end()) {
+      continue;
+    }
+
+    // leave the validation of invalid feeds to the generic session
+    if (!feeds[i].IsTensor()) {
+      return nullptr;
+    }
+    const auto& shape = feeds[i].Get<Tensor>().Shape();
+    if (shape.NumDimensions() != input_dims->second.rank) {
+      return nullptr;
+    }
+
+    for (const auto& [axis, dim_param_index] : input_dims->second.axes) {
+      int64_t& value = dim_values[dim_param_index];
+      if (value != -1 && value != shape[axis]) {
+        return nullptr;
+      }
+      value = shape[axis];
+    }
+  }
+
+  bool notify = false;
+  InferenceSession* session = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(dim_values);
+    if (entry == entries_.end()) {
+      if (entries_.size() >= kMaxTrackedShapes) {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+          it = it->second.state == State::kCounting ? entries_.erase(it) : std::next(it);
+        }
+      }
+      entry = entries_.emplace(std::move(dim_values), Entry{}).first;
+    }
+
+    Entry& value = entry->second;
+    if (value.state == State::kReady) {
+      session = value.session.get();
+    } else if (value.state == State::kCounting && ++value.num_runs >= options_.min_runs &&
+               num_sessions_ < options_.max_sessions) {
+      value.state = State::kPending;
+      ++num_sessions_;
+      pending_.push_back(entry->first);
+      notify = true;
+    }
+  }
+
+  if (notify) {
+    cv_.notify_all();
+  }
+  return session;
+}
+
+void ShapeSpecializer::WaitForPendingSessions() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this]() { return stop_ || (pending_.empty() && !building_); });
+}
+
+size_t ShapeSpecializer::NumSessions() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t num_sessions = 0;
+  for (const auto& entry : entries_) {
+    num_sessions += entry.second.state == State::kReady ? 1 : 0;
+  }
+  return num_sessions;
+}
+
+void ShapeSpecializer::BuildLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+    if (stop_) {
+      break;
+    }
+
+    std::vector<int64_t> dim_values = std::move(pending_.front());
+    pending_.pop_front();
+    building_ = true;
+
+    lock.unlock();
+    Build(dim_values);
+    lock.lock();
+
+    building_ = false;
+    done_cv_.notify_all();
+  }
+
+  done_cv_.notify_all();
+}
+
+void ShapeSpecializer::Build(const std::vector<int64_t>& dim_values) {
+  std::vector<FreeDimensionOverride> overrides;
+  std::ostringstream description;
+  for (size_t i = 0; i < dim_values.size(); ++i) {
+    if (dim_values[i] != -1) {
+      overrides.push_back(FreeDimensionOverride{dim_params_[i], FreeDimensionOverrideType::Name, dim_values[i]});
+      description << (overrides.size() > 1 ? ", " : "") << dim_params_[i] << "=" << dim_values[i];
+    }
+  }
+
+  std::unique_ptr<InferenceSession> session;
+  Status status;
+  ORT_TRY {
+    status = create_session_fn_(overrides, session);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    });
+  }
+  if (!status.IsOK()) {
+    session.reset();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entries_[dim_values];
+  if (status.IsOK()) {
+    LOGS(logger_, INFO) << "Created a session specialized to the input dimensions " << description.str();
+    entry.session = std::move(session);
+    entry.state = State::kReady;
+  } else {
+    // the generic session keeps running these shapes, and the slot can be used for other shapes
+    LOGS(logger_, WARNING) << "Failed to create a session specialized to the input dimensions " << description.str()
+                           << ": " << status.ErrorMessage();
+    entry.state = State::kFailed;
+    --num_sessions_;
+  }
+}
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/session_options.h"
+#include "core/graph/node_arg.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+
+/**
+ * Specialization of a session to the input shapes it is run with most often.
+ *
+ * Runs are counted by the values of the symbolic dimensions of the graph inputs. Once the same values have been seen
+ * in min_runs runs, a session with these dimensions overridden is created on a background thread. As all its shapes
+ * are static, its Shape nodes and the Reshape, Slice and Expand computations depending on them are constant folded
+ * and its memory is planned once for these shapes. Later runs with the same values are routed to that session while
+ * runs with other values keep using the generic one.
+ */
+class ShapeSpecializer {
+ public:
+  struct Options {
+    // number of runs with the same values of the symbolic dimensions after which a specialized session is created
+    size_t min_runs = 0;
+    // maximum number of specialized sessions
+    size_t max_sessions = 1;
+  };
+
+  // Creates and initializes a session with the given free dimension overrides.
+  using CreateSessionFn = std::function<Status(const std::vector<FreeDimensionOverride>& overrides,
+                                               std::unique_ptr<InferenceSession>& session)>;
+
+  ShapeSpecializer(const Options& options, gsl::span<const NodeArg* const> graph_inputs,
+                   CreateSessionFn create_session_fn, const logging::Logger& logger);
+
+  // Waits for the session being created, the sessions that have not been started yet are dropped.
+  ~ShapeSpecializer();
+
+  // Returns false if no graph input has symbolic dimensions, in which case there is nothing to specialize.
+  bool HasSymbolicDims() const { return !dim_params_.empty(); }
+
+  // Records a run with the given feeds. Returns the session specialized to their shapes if it has been created,
+  // or nullptr if the run should use the generic session.
+  InferenceSession* GetSession(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds);
+
+  // Waits until all the sessions requested so far have been created or have failed to be created.
+  void WaitForPendingSessions();
+
+  // Number of specialized sessions created.
+  size_t NumSessions() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ShapeSpecializer);
+
+ private:
+  enum class State {
+    kCounting,
+    kPending,
+    kReady,
+    kFailed,
+  };
+
+  struct Entry {
+    size_t num_runs = 0;
+    State state = State::kCounting;
+    std::unique_ptr<InferenceSession> session;
+  };
+
+  struct InputDims {
+    size_t rank;
+    // the symbolic axes of the input and the indices of their dim_param in dim_params_
+    InlinedVector<std::pair<size_t, size_t>> axes;
+  };
+
+  void BuildLoop();
+
+  // Creates the session specialized to `dim_values` and records it in its entry.
+  void Build(const std::vector<int64_t>& dim_values);
+
+  const Options options_;
+  const CreateSessionFn create_session_fn_;
+  const logging::Logger& logger_;
+
+  std::vector<std::string> dim_params_;
+  InlinedHashMap<std::string, InputDims> input_dims_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  // entries by the values of the symbolic dimensions in the order of dim_params_, -1 for the dimensions of the
+  // inputs that were not fed
+  std::map<std::vector<int64_t>, Entry> entries_;
+  // values of the sessions to create
+  std::deque<std::vector<int64_t>> pending_;
+  // sessions created, being created or waiting to be created
+  size_t num_sessions_ = 0;
+  bool building_ = false;
+  bool stop_ = false;
+
+  std::thread build_thread_;
+};
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -4,6 +4,7 @@
 #include "core/util/thread_utils.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -24,6 +25,7 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " affinity_str: " << params.affinity_str;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
+  os << " numa_aware: " << params.numa_aware;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
   // os << " custom_thread_creation_options: " << (params.custom_thread_creation_options ? "set" : "nullptr");
   // os << " custom_join_thread_fn: " << (params.custom_join_thread_fn ? "set" : "nullptr");
@@ -89,6 +91,44 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 }
 #endif
 
+// Binds the threads of the pool to the NUMA nodes of the host. Threads that have an affinity are bound to the node
+// of their first logical processor. Otherwise the threads are spread over the nodes, the caller thread being the
+// first one as in ThreadOptions::affinities. numa_nodes is indexed by the node id, which is what the threads record,
+// so the nodes without processors are kept and never get a thread.
+static void SetNumaNodes(const std::vector<LogicalProcessors>& numa_nodes, int thread_pool_size, ThreadOptions& to) {
+  std::unordered_map<int, int> processor_nodes;
+  size_t num_processors = 0;
+  for (size_t node = 0; node < numa_nodes.size(); ++node) {
+    for (int processor : numa_nodes[node]) {
+      processor_nodes[processor] = static_cast<int>(node);
+    }
+    num_processors += numa_nodes[node].size();
+  }
+
+  if (!to.affinities.empty()) {
+    for (const auto& affinity : to.affinities) {
+      auto it = affinity.empty() ? processor_nodes.end() : processor_nodes.find(affinity.front());
+      to.numa_nodes.push_back(it == processor_nodes.end() ? -1 : it->second);
+    }
+    return;
+  }
+
+  to.affinities.reserve(thread_pool_size);
+  to.numa_nodes.reserve(thread_pool_size);
+  size_t node = 0;
+  size_t processors_before_node = 0;
+  for (int i = 0; i < thread_pool_size; ++i) {
+    // Thread i goes to the node that holds the processor at the same relative position.
+    const size_t position = static_cast<size_t>(i) * num_processors / static_cast<size_t>(thread_pool_size);
+    while (position >= processors_before_node + numa_nodes[node].size()) {
+      processors_before_node += numa_nodes[node].size();
+      ++node;
+    }
+    to.affinities.push_back(i == 0 ? LogicalProcessors{} : numa_nodes[node]);
+    to.numa_nodes.push_back(i == 0 ? -1 : static_cast<int>(node));
+  }
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
@@ -145,6 +185,16 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
 #endif
   }
 
+  if (options.numa_aware) {
+    const auto numa_nodes = Env::Default().GetNumaNodes();
+    if (std::count_if(numa_nodes.begin(), numa_nodes.end(),
+                      [](const LogicalProcessors& processors) { return !processors.empty(); }) > 1) {
+      SetNumaNodes(numa_nodes, options.thread_pool_size, to);
+    } else {
+      LOGS_DEFAULT(INFO) << "The host has a single NUMA node, the thread pool is not partitioned";
+    }
+  }
+
   to.set_denormal_as_zero = options.set_denormal_as_zero;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
@@ -210,6 +260,18 @@ ORT_API_STATUS_IMPL(SetGlobalSpinControl, _Inout_ OrtThreadingOptions* tp_option
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(SetGlobalUnifiedThreadPool, _Inout_ OrtThreadingOptions* tp_options, int use_unified_thread_pool) {
+  if (!tp_options) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions");
+  }
+  if (!(use_unified_thread_pool == 1 || use_unified_thread_pool == 0)) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "Received invalid value for use_unified_thread_pool. Valid values are 0 or 1");
+  }
+  tp_options->use_unified_thread_pool = (use_unified_thread_pool != 0);
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* tp_options) {
   if (!tp_options) {
     return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions");
@@ -42,6 +42,12 @@ struct OrtThreadPoolParams {
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
 
+  // If it is true and the host has more than one NUMA node, the threads are bound to NUMA nodes and a parallel loop
+  // only runs on the threads of the node of the thread that starts it. Without affinity settings, the threads are
+  // spread over the nodes in proportion to their number of logical processors, each thread may run on any processor
+  // of its node.
+  bool numa_aware = false;
+
   // members to manage custom threads
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
@@ -56,6 +62,10 @@ struct OrtThreadingOptions {
 
   // Params for creating the threads that parallelizes execution across ops
   OrtThreadPoolParams inter_op_thread_pool_params;
+
+  // If true, no inter-op thread pool is created and the intra-op thread pool runs the work of both.
+  // inter_op_thread_pool_params is ignored.
+  bool use_unified_thread_pool = false;
 };
 
 namespace onnxruntime {
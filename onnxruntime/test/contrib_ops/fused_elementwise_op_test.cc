@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedElementwiseTest, BroadcastChain) {
+  // Relu((x + b) * s)
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4});
+  test.AddInput<float>("x", {2, 3}, {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f});
+  test.AddInput<float>("b", {3}, {1.0f, 1.0f, 1.0f});
+  test.AddInput<float>("s", {2, 1}, {2.0f, 0.5f});
+  test.AddOutput<float>("Y", {2, 3}, {4.0f, 0.0f, 8.0f, 0.0f, 3.0f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, WhereBroadcastCondition) {
+  // Abs(Where(condition, x, y))
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Where", "Abs"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, 3});
+  test.AddInput<bool>("condition", {2, 1}, {true, false});
+  test.AddInput<float>("x", {2, 2}, {1.0f, -2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("y", {1}, {-1.0f});
+  test.AddOutput<float>("Y", {2, 2}, {1.0f, 2.0f, 1.0f, 1.0f});
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, MaxMinPropagateNaN) {
+  // Min(Max(x, y), z), which is NaN wherever one of the inputs is NaN, like the ONNX Max and Min.
+  constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Max", "Min"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2});
+  test.AddInput<float>("x", {4}, {nan, 1.0f, 2.0f, -1.0f});
+  test.AddInput<float>("y", {4}, {0.0f, nan, 3.0f, -2.0f});
+  test.AddInput<float>("z", {}, {2.5f});
+  test.AddOutput<float>("Y", {4}, {nan, nan, 2.5f, -1.0f});
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, MultipleTiles) {
+  // Sigmoid(x - c) * x over rows longer than a tile.
+  constexpr int64_t rows = 3;
+  constexpr int64_t cols = 1500;
+  std::vector<float> x(rows * cols);
+  std::vector<float> y(rows * cols);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(static_cast<int>(i % 97) - 48) / 8.0f;
+    y[i] = x[i] / (1.0f + std::exp(0.5f - x[i]));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Sigmoid", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, 3, 0});
+  test.AddInput<float>("x", {rows, cols}, x);
+  test.AddInput<float>("c", {}, {0.5f});
+  test.AddOutput<float>("Y", {rows, cols}, y);
+  test.SetOutputAbsErr("Y", 1e-5f);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
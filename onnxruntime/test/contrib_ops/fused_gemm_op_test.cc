@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+struct FusedGemmTestCase {
+  int64_t M;
+  int64_t N;
+  int64_t K;
+  bool trans_b;
+  std::vector<int64_t> c_dims;  // empty if C is missing
+  std::string activation;
+  std::vector<std::pair<std::string, float>> activation_attrs;
+  std::function<float(float)> reference_activation;
+};
+
+void RunFusedGemmTest(const FusedGemmTestCase& test_case) {
+  const int64_t M = test_case.M;
+  const int64_t N = test_case.N;
+  const int64_t K = test_case.K;
+
+  std::vector<float> a_data(static_cast<size_t>(M * K));
+  std::vector<float> b_data(static_cast<size_t>(K * N));
+  for (size_t i = 0; i < a_data.size(); i++) {
+    a_data[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.25f;
+  }
+  for (size_t i = 0; i < b_data.size(); i++) {
+    b_data[i] = static_cast<float>(static_cast<int>(i % 5) - 2) * 0.5f;
+  }
+
+  int64_t c_size = 1;
+  for (auto dim : test_case.c_dims) {
+    c_size *= dim;
+  }
+  std::vector<float> c_data(static_cast<size_t>(test_case.c_dims.empty() ? 0 : c_size));
+  for (size_t i = 0; i < c_data.size(); i++) {
+    c_data[i] = static_cast<float>(static_cast<int>(i % 3) - 1) * 0.75f;
+  }
+
+  std::vector<float> y_data(static_cast<size_t>(M * N));
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        const float b = test_case.trans_b ? b_data[n * K + k] : b_data[k * N + n];
+        sum += a_data[m * K + k] * b;
+      }
+      if (!c_data.empty()) {
+        if (c_size == M * N) {
+          sum += c_data[m * N + n];
+        } else {
+          sum += c_data[n];
+        }
+      }
+      y_data[m * N + n] = test_case.reference_activation(sum);
+    }
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(test_case.trans_b ? 1 : 0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", test_case.activation);
+  for (const auto& attr : test_case.activation_attrs) {
+    test.AddAttribute(attr.first, attr.second);
+  }
+
+  test.AddInput<float>("A", {M, K}, a_data);
+  test.AddInput<float>("B", test_case.trans_b ? std::vector<int64_t>{N, K} : std::vector<int64_t>{K, N}, b_data,
+                       true);
+  if (!c_data.empty()) {
+    test.AddInput<float>("C", test_case.c_dims, c_data, true);
+  }
+  test.AddOutput<float>("Y", {M, N}, y_data);
+  test.SetOutputTolerance(0.0001f);
+  test.Run();
+}
+
+float Gelu(float x) {
+  return 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752440f));
+}
+
+float Silu(float x) {
+  return x / (1.0f + std::exp(-x));
+}
+
+}  // namespace
+
+TEST(FusedGemmTest, ReluWithBiasVector) {
+  RunFusedGemmTest({5, 9, 7, false, {9}, "Relu", {}, [](float x) { return std::max(x, 0.0f); }});
+}
+
+TEST(FusedGemmTest, LeakyReluWithRowBias) {
+  RunFusedGemmTest({4, 17, 3, true, {1, 17}, "LeakyRelu", {{"activation_alpha", 0.1f}},
+                    [](float x) { return x >= 0.0f ? x : 0.1f * x; }});
+}
+
+TEST(FusedGemmTest, GeluWithBiasVector) {
+  RunFusedGemmTest({6, 33, 20, false, {33}, "Gelu", {}, Gelu});
+}
+
+TEST(FusedGemmTest, GeluWithMatrixBias) {
+  RunFusedGemmTest({3, 10, 8, true, {3, 10}, "Gelu", {}, Gelu});
+}
+
+TEST(FusedGemmTest, GeluWithoutBias) {
+  RunFusedGemmTest({1, 40, 16, false, {}, "Gelu", {}, Gelu});
+}
+
+TEST(FusedGemmTest, QuickGeluAsSilu) {
+  RunFusedGemmTest({7, 12, 5, false, {12}, "QuickGelu", {{"activation_alpha", 1.0f}}, Silu});
+}
+
+TEST(FusedGemmTest, HardSigmoidWithBiasVector) {
+  RunFusedGemmTest({2, 5, 4, false, {5}, "HardSigmoid", {{"activation_alpha", 0.3f}, {"activation_beta", 0.4f}},
+                    [](float x) { return std::min(std::max(0.3f * x + 0.4f, 0.0f), 1.0f); }});
+}
+
+// Elu is not implemented by the MLAS GEMM epilogue and runs after the GEMM.
+TEST(FusedGemmTest, EluWithBiasVector) {
+  RunFusedGemmTest({3, 6, 4, false, {6}, "Elu", {{"activation_alpha", 1.0f}},
+                    [](float x) { return x >= 0.0f ? x : std::exp(x) - 1.0f; }});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
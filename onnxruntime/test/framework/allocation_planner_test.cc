@@ -22,6 +22,7 @@ using json = nlohmann::json;
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/util/thread_utils.h"
 
+#include "test/framework/test_utils.h"
 #include "test/test_environment.h"
 #include "test/util/include/asserts.h"
 #include "test/util/include/default_providers.h"
@@ -359,6 +360,18 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckBufferSlice(const std::string& name, const std::string& buffer_name, size_t offset) {
+    int id;
+    index(name, id);
+    int buffer_id;
+    index(buffer_name, buffer_id);
+    const auto& alloc_plan = plan_->allocation_plan[id];
+    EXPECT_EQ(alloc_plan.alloc_kind, AllocKind::kReuse) << "Error in allocation kind for " << name;
+    EXPECT_EQ(alloc_plan.reused_buffer, buffer_id) << "Error in reused buffer for " << name;
+    ASSERT_TRUE(alloc_plan.buffer_slice.has_value()) << name << " is not a buffer slice";
+    EXPECT_EQ(alloc_plan.buffer_slice->offset, offset) << "Error in buffer slice offset for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // TODO: add the checker for new implementation of release plan
     //// create set and check equality
@@ -578,6 +591,137 @@ TEST_F(PlannerTest, ExternalOutputsNoReuseTest) {
   CheckFreed(3, {X4});
 }
 
+TEST_F(PlannerTest, ConcatInputsInOutputBuffer) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), A("A"), B("B"), C("C"), Y("Y"), concat("concat");
+
+  // graph structure: A and B are produced directly into their slices of C
+  std::unique_ptr<KernelDef> concat_kernel =
+      KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 10).Build();
+  AddNormalNode(X1, A);
+  AddNormalNode(X2, B);
+  std::vector<onnxruntime::NodeArg*> concat_inputs{Arg(A), Arg(B)}, concat_outputs{Arg(C)};
+  AddNode(*concat_kernel, concat, concat_inputs, concat_outputs)->AddAttribute("axis", int64_t{1});
+  AddNormalNode(C, Y);
+
+  // simulate shape-inference results:
+  Shape shape_a{1, 2, 3}, shape_b{1, 4, 3}, shape_c{1, 6, 3};
+  SetShape({{X1, &shape_a.value}, {A, &shape_a.value}, {X2, &shape_b.value}, {B, &shape_b.value},
+            {C, &shape_c.value}, {Y, &shape_c.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckBufferSlice(A, C, 0);
+  CheckBufferSlice(B, C, 2 * 3 * sizeof(float));
+  CheckAllocKind(C, AllocKind::kAllocate);
+  CheckAllocKind(Y, AllocKind::kAllocateOutput);
+
+  // check each ml-value is freed at appropriate step
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {});
+  CheckFreed(3, {C});
+}
+
+#ifdef ENABLE_TRAINING
+// The lifetime of the Concat output starts when its first slice is produced, so that the memory pattern does not
+// overlap it with the values that are alive until the Concat runs.
+TEST_F(PlannerTest, ConcatOutputLifetimeStartsAtFirstSlice) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), A("A"), U("U"), B("B"), C("C"), Y("Y"), concat("concat");
+
+  // graph structure: U is alive between the producer of the slice A and Concat
+  std::unique_ptr<KernelDef> concat_kernel =
+      KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 10).Build();
+  AddNormalNode(X1, A);
+  AddNormalNode(X2, U);
+  AddNormalNode(U, B);
+  std::vector<onnxruntime::NodeArg*> concat_inputs{Arg(A), Arg(B)}, concat_outputs{Arg(C)};
+  AddNode(*concat_kernel, concat, concat_inputs, concat_outputs)->AddAttribute("axis", int64_t{1});
+  AddNormalNode(C, Y);
+
+  // simulate shape-inference results:
+  Shape shape_a{1, 2, 3}, shape_b{1, 4, 3}, shape_c{1, 6, 3};
+  SetShape({{X1, &shape_a.value}, {A, &shape_a.value}, {X2, &shape_b.value}, {U, &shape_b.value},
+            {B, &shape_b.value}, {C, &shape_c.value}, {Y, &shape_c.value}});
+
+  CreatePlan();
+
+  CheckBufferSlice(A, C, 0);
+  CheckBufferSlice(B, C, 2 * 3 * sizeof(float));
+  CheckAllocKind(U, AllocKind::kAllocate);
+  CheckAllocKind(C, AllocKind::kAllocate);
+
+  int u_id;
+  int c_id;
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(U, u_id));
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(C, c_id));
+  const auto& u_program_counter = GetPlan().allocation_plan[u_id].program_counter;
+  const auto& c_program_counter = GetPlan().allocation_plan[c_id].program_counter;
+  ASSERT_TRUE(u_program_counter.HasValidEntries());
+  ASSERT_TRUE(c_program_counter.HasValidEntries());
+  EXPECT_EQ(c_program_counter.Starts(), std::vector<size_t>{0});
+  EXPECT_EQ(c_program_counter.Ends(), std::vector<size_t>{4});
+  EXPECT_EQ(u_program_counter.Starts(), std::vector<size_t>{1});
+  EXPECT_EQ(u_program_counter.Ends(), std::vector<size_t>{2});
+}
+#endif  // ENABLE_TRAINING
+
+TEST_F(PlannerTest, ConcatInnerAxisInputsNotInOutputBuffer) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), A("A"), B("B"), C("C"), Y("Y"), concat("concat");
+
+  // graph structure: the slices of C are not contiguous
+  std::unique_ptr<KernelDef> concat_kernel =
+      KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 10).Build();
+  AddNormalNode(X1, A);
+  AddNormalNode(X2, B);
+  std::vector<onnxruntime::NodeArg*> concat_inputs{Arg(A), Arg(B)}, concat_outputs{Arg(C)};
+  AddNode(*concat_kernel, concat, concat_inputs, concat_outputs)->AddAttribute("axis", int64_t{1});
+  AddNormalNode(C, Y);
+
+  // simulate shape-inference results:
+  Shape shape_a{2, 3}, shape_c{2, 6};
+  SetShape({{X1, &shape_a.value}, {A, &shape_a.value}, {X2, &shape_a.value}, {B, &shape_a.value},
+            {C, &shape_c.value}, {Y, &shape_c.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(A, AllocKind::kAllocate);
+  CheckAllocKind(B, AllocKind::kAllocate);
+  CheckAllocKind(C, AllocKind::kAllocate);
+}
+
+TEST_F(PlannerTest, SplitOutputsInInputBuffer) {
+  // tensor variables:
+  std::string X("X"), A("A"), B("B"), C("C"), Y1("Y1"), Y2("Y2"), split("split");
+
+  // graph structure: B and C are views of their slices of A
+  std::unique_ptr<KernelDef> split_kernel =
+      KernelDefBuilder().SetName("Split").Provider(kCpuExecutionProvider).SinceVersion(2, 10).Build();
+  AddNormalNode(X, A);
+  std::vector<onnxruntime::NodeArg*> split_inputs{Arg(A)}, split_outputs{Arg(B), Arg(C)};
+  AddNode(*split_kernel, split, split_inputs, split_outputs)->AddAttribute("axis", int64_t{0});
+  AddNormalNode(B, Y1);
+  AddNormalNode(C, Y2);
+
+  // simulate shape-inference results:
+  Shape shape_a{4, 3}, shape_b{1, 3}, shape_c{3, 3};
+  SetShape({{X, &shape_a.value}, {A, &shape_a.value}, {B, &shape_b.value}, {C, &shape_c.value},
+            {Y1, &shape_b.value}, {Y2, &shape_c.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(A, AllocKind::kAllocate);
+  CheckBufferSlice(B, A, 0);
+  CheckBufferSlice(C, A, 3 * sizeof(float));
+  CheckAllocKind(Y1, AllocKind::kAllocateOutput);
+  CheckAllocKind(Y2, AllocKind::kAllocateOutput);
+}
+
 #ifdef ENABLE_STRIDED_TENSORS
 TEST_F(PlannerTest, MayStridedTest1) {
   // tensor variables:
@@ -2131,5 +2275,104 @@ TEST(AllocationPlannerTest, AvoidReuseOfBufferForNodeOutputWithNoConsumers) {
 }
 #endif
 
+// The inputs of Concat are produced directly into the Concat output and the outputs of Split are views of the
+// Split input, so neither kernel copies any data.
+TEST(AllocationPlannerTest, ConcatAndSplitInPlace) {
+  auto create_model = []() -> Model {
+    Model model("concat_split", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    auto make_type = [](std::initializer_list<int64_t> dims) {
+      TypeProto type;
+      type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+      for (auto dim : dims) {
+        type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+      }
+      return type;
+    };
+    auto type_a = make_type({1, 2, 3});
+    auto type_b = make_type({1, 4, 3});
+    auto type_c = make_type({1, 6, 3});
+    auto type_d = make_type({1, 1, 3});
+    auto type_e = make_type({1, 5, 3});
+
+    auto& x = graph.GetOrCreateNodeArg("x", &type_a);
+    auto& y = graph.GetOrCreateNodeArg("y", &type_b);
+    auto& a = graph.GetOrCreateNodeArg("a", &type_a);
+    auto& b = graph.GetOrCreateNodeArg("b", &type_b);
+    auto& c = graph.GetOrCreateNodeArg("c", &type_c);
+    auto& d = graph.GetOrCreateNodeArg("d", &type_d);
+    auto& e = graph.GetOrCreateNodeArg("e", &type_e);
+    auto& out_d = graph.GetOrCreateNodeArg("out_d", &type_d);
+    auto& out_e = graph.GetOrCreateNodeArg("out_e", &type_e);
+
+    graph.AddNode("relu", "Relu", "", {&x}, {&a});
+    graph.AddNode("neg", "Neg", "", {&y}, {&b});
+    graph.AddNode("concat", "Concat", "", {&a, &b}, {&c}).AddAttribute("axis", int64_t{1});
+    auto& split = graph.AddNode("split", "Split", "", {&c}, {&d, &e});
+    split.AddAttribute("axis", int64_t{1});
+    split.AddAttribute("split", std::vector<int64_t>{1, 5});
+    graph.AddNode("abs_d", "Abs", "", {&d}, {&out_d});
+    graph.AddNode("abs_e", "Abs", "", {&e}, {&out_e});
+
+    graph.SetInputs({&x, &y});
+    graph.SetOutputs({&out_d, &out_e});
+    EXPECT_STATUS_OK(graph.Resolve());
+    return model;
+  };
+
+  SessionOptions so;
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSession sess{so, GetEnvironment()};
+
+  std::string serialized_model;
+  ASSERT_TRUE(create_model().ToProto().SerializeToString(&serialized_model));
+  std::stringstream sstr(serialized_model);
+  ASSERT_STATUS_OK(sess.Load(sstr));
+  ASSERT_STATUS_OK(sess.Initialize());
+
+  const auto& session_state = sess.GetSessionState();
+  const auto& ort_value_index_map = session_state.GetOrtValueNameIdxMap();
+  const SequentialExecutionPlan* plan = session_state.GetExecutionPlan();
+  auto check_buffer_slice = [&](const std::string& name, size_t offset) {
+    OrtValueIndex index;
+    OrtValueIndex buffer_index;
+    ASSERT_STATUS_OK(ort_value_index_map.GetIdx(name, index));
+    ASSERT_STATUS_OK(ort_value_index_map.GetIdx("c", buffer_index));
+    const auto& alloc_plan = plan->allocation_plan[index];
+    EXPECT_EQ(alloc_plan.alloc_kind, AllocKind::kReuse) << name;
+    EXPECT_EQ(alloc_plan.reused_buffer, buffer_index) << name;
+    ASSERT_TRUE(alloc_plan.buffer_slice.has_value()) << name;
+    EXPECT_EQ(alloc_plan.buffer_slice->offset, offset) << name;
+  };
+  check_buffer_slice("a", 0);
+  check_buffer_slice("b", 6 * sizeof(float));
+  check_buffer_slice("d", 0);
+  check_buffer_slice("e", 3 * sizeof(float));
+
+  std::vector<float> x_data{1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f};
+  std::vector<float> y_data{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue x_value;
+  OrtValue y_value;
+  CreateMLValue<float>(allocator, {1, 2, 3}, x_data, &x_value);
+  CreateMLValue<float>(allocator, {1, 4, 3}, y_data, &y_value);
+  NameMLValMap feeds{{"x", x_value}, {"y", y_value}};
+
+  std::vector<std::string> output_names{"out_d", "out_e"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(sess.Run(RunOptions{}, feeds, output_names, &fetches));
+  ASSERT_EQ(fetches.size(), 2u);
+
+  const std::vector<float> expected_d{1.0f, 0.0f, 3.0f};
+  const std::vector<float> expected_e{0.0f, 5.0f, 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                                      10.0f, 11.0f, 12.0f};
+  auto d_data = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  auto e_data = fetches[1].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(d_data.begin(), d_data.end()), expected_d);
+  EXPECT_EQ(std::vector<float>(e_data.begin(), e_data.end()), expected_e);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
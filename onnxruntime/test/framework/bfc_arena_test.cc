@@ -4,9 +4,14 @@
 #include <absl/base/config.h>
 #include "core/framework/bfc_arena.h"
 #include "core/framework/allocator_utils.h"
+#include "core/framework/numa_arena.h"
+#include "core/mlas/inc/mlas.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +312,108 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, ThreadCacheReusesFreedChunk) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 1 << 20);
+
+  void* p = a.Alloc(1000);
+  ASSERT_NE(p, nullptr);
+  a.Free(p);
+
+  // same size class is served from the thread cache without going back to the bins
+  void* q = a.Alloc(1024);
+  EXPECT_EQ(p, q);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 1);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // different size class
+  void* r = a.Alloc(4000);
+  EXPECT_NE(r, q);
+  a.Free(q);
+  a.Free(r);
+
+  // cached chunks are returned to the bins by Shrink
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // large allocations bypass the thread cache
+  void* big = a.Alloc(1 << 20);
+  a.Free(big);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheOverflowReturnsChunks) {
+  constexpr size_t kThreadCacheMaxBytes = 16 * 1024;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             kThreadCacheMaxBytes);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // no more than kThreadCacheMaxBytes is held by the cache of this thread
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_LE(stats.bytes_in_use, static_cast<int64_t>(kThreadCacheMaxBytes));
+}
+
+TEST(BFCArenaTest, ThreadCacheCrossThreadFree) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 1 << 20);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumIterations = 1000;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<void*>> allocated(kNumThreads);
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, &allocated, t]() {
+      for (int i = 0; i < kNumIterations; ++i) {
+        const size_t size = 256 + (i % 16) * 512;
+        void* p = a.Alloc(size);
+        memset(p, t, size);
+        if (i % 2 == 0) {
+          a.Free(p);
+        } else {
+          allocated[t].push_back(p);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // free on a different thread than the one that allocated
+  for (auto& ptrs : allocated) {
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+  }
+
+  // the exited threads returned their cached chunks, and Shrink returns the chunks cached by this thread
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -481,5 +588,45 @@ TEST(BFCArenaTest, TestExtendStrategy) {
   ASSERT_EQ(extend_delta_bytes, extend_limit);
 }
 
+TEST(NumaArenaTest, AllocFreeAcrossNodes) {
+  // Node ids that the host most likely doesn't have, in which case allocations come from the first node's arena.
+  NumaArena a(
+      {2, 3},
+      []() { return std::make_unique<CPUAllocator>(); },
+      [](std::unique_ptr<IAllocator> node_allocator) {
+        return std::make_unique<BFCArena>(std::move(node_allocator), 1 << 30);
+      });
+  EXPECT_EQ(a.Info().alloc_type, OrtAllocatorType::OrtDeviceAllocator);
+
+  void* p1 = a.Alloc(1024);
+  void* p2 = a.Reserve(4096);
+  ASSERT_NE(p1, nullptr);
+  ASSERT_NE(p2, nullptr);
+  // the buffers follow the tag with their node, and keep the alignment of the CPU allocator
+  const size_t tag_size = std::max(sizeof(int), MlasGetPreferredBufferAlignment());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p1) % tag_size, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p2) % tag_size, 0u);
+  const int node1 = a.NumaNodeOf(p1);
+  EXPECT_TRUE(node1 == 2 || node1 == 3);
+  EXPECT_TRUE(a.NumaNodeOf(p2) == 2 || a.NumaNodeOf(p2) == 3);
+  EXPECT_EQ(a.NumaNodeOf(static_cast<char*>(p1) + 1023), node1);
+  int on_stack = 0;
+  EXPECT_EQ(a.NumaNodeOf(&on_stack), -1);
+
+  // Free from another thread returns the buffer to the arena of its node
+  std::thread t([&]() { a.Free(p1); });
+  t.join();
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.num_reserves, 1);
+  EXPECT_EQ(stats.bytes_in_use, static_cast<int64_t>(4096 + tag_size));
+
+  a.Free(p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
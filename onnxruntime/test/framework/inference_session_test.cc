@@ -58,6 +58,7 @@
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include "nlohmann/json.hpp"
 
 using namespace std;
 using namespace ONNX_NAMESPACE;
@@ -746,6 +747,48 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions2) {
 #endif
 }
 
+TEST(InferenceSessionTests, CheckKernelStats) {
+  {
+    SessionOptions so;
+    InferenceSession session_object(so, GetEnvironment());
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    std::string stats;
+    ASSERT_FALSE(session_object.GetKernelStats(false, stats).IsOK()) << "Kernel statistics are disabled by default";
+  }
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableKernelStats, "1"));
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  std::string stats;
+  ASSERT_STATUS_OK(session_object.GetKernelStats(true, stats));
+  auto json_stats = nlohmann::json::parse(stats);
+  ASSERT_EQ(json_stats["nodes"].size(), 1u);
+  const auto& node = json_stats["nodes"][0];
+  EXPECT_EQ(node["op_type"], "Mul");
+  EXPECT_EQ(node["count"], 2);
+  // 3x2 float output
+  EXPECT_EQ(node["output_bytes"], 2 * 6 * sizeof(float));
+  EXPECT_LE(node["p50_us"].get<double>(), node["p99_us"].get<double>());
+  ASSERT_EQ(json_stats["op_types"].size(), 1u);
+  EXPECT_EQ(json_stats["op_types"][0]["name"], "Mul");
+  EXPECT_EQ(json_stats["op_types"][0]["count"], 2);
+
+  // only the runs after the reset are reported
+  ASSERT_STATUS_OK(session_object.GetKernelStats(false, stats));
+  EXPECT_EQ(nlohmann::json::parse(stats)["nodes"].size(), 0u);
+  RunModel(session_object, run_options);
+  ASSERT_STATUS_OK(session_object.GetKernelStats(false, stats));
+  EXPECT_EQ(nlohmann::json::parse(stats)["nodes"][0]["count"], 1);
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
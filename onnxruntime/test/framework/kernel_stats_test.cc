@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_stats.h"
+
+#include <thread>
+#include <vector>
+
+#include "core/graph/model.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(KernelStatsTest, Buckets) {
+  EXPECT_EQ(KernelStats::BucketIndex(0), 0);
+  EXPECT_EQ(KernelStats::BucketIndex(255), 0);
+  EXPECT_EQ(KernelStats::BucketIndex(256), 1);
+  EXPECT_EQ(KernelStats::BucketIndex(uint64_t{1} << 40), KernelStats::kNumBuckets - 1);
+
+  for (int b = 1; b < KernelStats::kNumBuckets; ++b) {
+    const uint64_t lower = KernelStats::BucketLowerBound(b);
+    EXPECT_GT(lower, KernelStats::BucketLowerBound(b - 1));
+    EXPECT_EQ(KernelStats::BucketIndex(lower), b);
+    EXPECT_EQ(KernelStats::BucketIndex(lower - 1), b - 1);
+  }
+}
+
+TEST(KernelStatsTest, Percentile) {
+  std::array<uint64_t, KernelStats::kNumBuckets> buckets{};
+  EXPECT_EQ(KernelStats::Percentile(buckets, 0, 0.5), 0u);
+
+  // 98 runs of ~1 us and 2 runs of ~1 ms
+  buckets[KernelStats::BucketIndex(1000)] = 98;
+  buckets[KernelStats::BucketIndex(1000000)] = 2;
+  const uint64_t p50 = KernelStats::Percentile(buckets, 100, 0.5);
+  const uint64_t p99 = KernelStats::Percentile(buckets, 100, 0.99);
+  EXPECT_GE(p50, KernelStats::BucketLowerBound(KernelStats::BucketIndex(1000)));
+  EXPECT_LE(p50, 1200u);
+  EXPECT_GE(p99, KernelStats::BucketLowerBound(KernelStats::BucketIndex(1000000)));
+  EXPECT_LE(p99, 1200000u);
+}
+
+TEST(KernelStatsTest, RecordFromMultipleThreads) {
+  Model model("test", true, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("y", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("z", &float_tensor);
+  graph.AddNode("relu", "Relu", "", {&x}, {&y});
+  graph.AddNode("", "Relu", "", {&y}, {&z});
+  ASSERT_STATUS_OK(graph.Resolve());
+  GraphViewer graph_viewer(graph);
+
+  KernelStats stats;
+  const size_t first_slot = stats.AddGraph(graph_viewer, "prefix/");
+
+  constexpr int num_threads = 4;
+  constexpr int num_runs = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < num_runs; ++i) {
+        stats.Record(first_slot + 0, 1000, 16);
+        stats.Record(first_slot + 1, 2000, 32);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // the counters of the exited threads were folded into the totals and released
+  EXPECT_EQ(stats.NumThreadCounters(), 0u);
+
+  std::vector<KernelStats::Summary> nodes;
+  std::vector<KernelStats::Summary> op_types;
+  stats.GetSummaries(nodes, op_types, true);
+  ASSERT_EQ(nodes.size(), 2u);
+  EXPECT_EQ(nodes[0].name, "prefix/relu");
+  EXPECT_EQ(nodes[1].name, "prefix/Relu_1");
+  EXPECT_EQ(nodes[0].count, uint64_t{num_threads * num_runs});
+  EXPECT_EQ(nodes[0].total_ns, uint64_t{num_threads * num_runs} * 1000);
+  EXPECT_EQ(nodes[1].output_bytes, uint64_t{num_threads * num_runs} * 32);
+  ASSERT_EQ(op_types.size(), 1u);
+  EXPECT_EQ(op_types[0].name, "Relu");
+  EXPECT_EQ(op_types[0].count, uint64_t{2 * num_threads * num_runs});
+
+  stats.GetSummaries(nodes, op_types, false);
+  EXPECT_TRUE(nodes.empty());
+  EXPECT_TRUE(op_types.empty());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_pattern_cache.h"
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::vector<OrtValue> MakeFeeds(const std::vector<TensorShape>& shapes) {
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(shapes.size());
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), shapes[i], cpu_allocator, feeds[i]);
+  }
+  return feeds;
+}
+
+std::shared_ptr<const CachedMemoryPattern> MakePattern(int ort_value_idx, const TensorShape& shape) {
+  auto pattern = std::make_shared<CachedMemoryPattern>();
+  pattern->inferred_shapes.emplace(ort_value_idx, shape);
+  return pattern;
+}
+}  // namespace
+
+TEST(MemoryPatternCacheTest, KeyDistinguishesShapesWithSameDims) {
+  const auto key_2x3 = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({2, 3})}));
+  const auto key_3x2 = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({3, 2})}));
+  const auto key_6 = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({6})}));
+  const auto key_2_3 = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({2}), TensorShape({3})}));
+
+  EXPECT_NE(key_2x3, key_3x2);
+  EXPECT_NE(key_2x3, key_6);
+  EXPECT_NE(key_2x3, key_2_3);
+  EXPECT_EQ(key_2x3, MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({2, 3})})));
+}
+
+TEST(MemoryPatternCacheTest, FindAndInsert) {
+  MemoryPatternCache cache(4);
+  const auto key = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({1, 128})}));
+
+  EXPECT_EQ(cache.Find(key), nullptr);
+
+  auto pattern = MakePattern(1, TensorShape({1, 128, 768}));
+  EXPECT_EQ(cache.Insert(key, pattern), pattern);
+  EXPECT_EQ(cache.Find(key), pattern);
+
+  // the first pattern inserted for a key wins
+  auto other_pattern = MakePattern(1, TensorShape({1, 128, 1024}));
+  EXPECT_EQ(cache.Insert(key, other_pattern), pattern);
+  EXPECT_EQ(cache.Size(), 1u);
+
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.evictions, 0u);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  MemoryPatternCache cache(2);
+  const auto key_a = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({1, 16})}));
+  const auto key_b = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({1, 32})}));
+  const auto key_c = MemoryPatternCache::MakeKey(MakeFeeds({TensorShape({1, 64})}));
+
+  auto pattern_a = cache.Insert(key_a, MakePattern(1, TensorShape({1, 16})));
+  cache.Insert(key_b, MakePattern(1, TensorShape({1, 32})));
+
+  // touch 'a' so 'b' becomes the least recently used entry
+  ASSERT_NE(cache.Find(key_a), nullptr);
+  cache.Insert(key_c, MakePattern(1, TensorShape({1, 64})));
+
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_EQ(cache.Find(key_b), nullptr);
+  EXPECT_NE(cache.Find(key_c), nullptr);
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+
+  // a pattern that is evicted while in use stays valid for the holder
+  cache.Insert(key_b, MakePattern(1, TensorShape({1, 32})));
+  cache.Insert(key_c, MakePattern(1, TensorShape({1, 64})));
+  EXPECT_EQ(cache.Find(key_a), nullptr);
+  EXPECT_EQ(pattern_a->inferred_shapes.at(1), TensorShape({1, 16}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,7 +3,11 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
 
@@ -145,5 +149,93 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+struct WideGraphTestParam {
+  const char* dataflow_execution;
+  const char* use_intra_op_thread_pool;
+};
+
+class ParallelExecutorWideGraphTest : public testing::TestWithParam<WideGraphTestParam> {
+};
+
+// Branch b of the graph adds X to itself b + 1 times, and the branches of different lengths are summed,
+// so nodes from several branches are ready at the same time.
+TEST_P(ParallelExecutorWideGraphTest, IndependentBranches) {
+  constexpr int kNumBranches = 6;
+
+  Model model("wide_graph", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> branch_outputs;
+  for (int branch = 0; branch < kNumBranches; ++branch) {
+    NodeArg* input = &x;
+    for (int i = 0; i <= branch; ++i) {
+      const std::string name = "branch_" + std::to_string(branch) + "_" + std::to_string(i);
+      auto& output = graph.GetOrCreateNodeArg(name, &float_tensor);
+      graph.AddNode(name, "Add", name, {input, &x}, {&output});
+      input = &output;
+    }
+    branch_outputs.push_back(input);
+  }
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum", "Sum", "sum", branch_outputs, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  const WideGraphTestParam param = GetParam();
+  SessionOptions so;
+  so.session_logid = "ParallelExecutorWideGraphTest";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.intra_op_param.thread_pool_size = 2;
+  so.inter_op_param.thread_pool_size = 3;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDataflowExecution,
+                                                    param.dataflow_execution));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigInterOpUseIntraOpThreadPool,
+                                                    param.use_intra_op_thread_pool));
+
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2}, {1.0f, -0.5f}, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+
+  // sum over the branches of (b + 2) * X
+  const float multiplier = static_cast<float>(kNumBranches * (kNumBranches + 3) / 2);
+  for (int run = 0; run < 3; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    auto y_values = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(y_values.size(), 2u);
+    EXPECT_EQ(y_values[0], multiplier * 1.0f);
+    EXPECT_EQ(y_values[1], multiplier * -0.5f);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(ParallelExecutorWideGraphTests, ParallelExecutorWideGraphTest,
+                         testing::Values(WideGraphTestParam{"1", "0"},
+                                         WideGraphTestParam{"1", "1"},
+                                         WideGraphTestParam{"0", "0"},
+                                         WideGraphTestParam{"0", "1"}));
+
+TEST(ParallelExecutor, DataflowExecutionIsOptIn) {
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.DataflowExecutionIsOptIn";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/mul_1.onnx")));
+  ASSERT_STATUS_OK(session.Initialize());
+  EXPECT_EQ(session.GetSessionState().GetDataflowExecutionPlan(), nullptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include "core/framework/prepack_cache.h"
+#include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Creates weights that refer to the given buffers.
+PrePackedWeights MakeWeights(std::vector<std::vector<uint8_t>>& buffers) {
+  PrePackedWeights weights;
+  for (auto& buffer : buffers) {
+    weights.buffers_.emplace_back(buffer.data(), [](void*) {});
+    weights.buffer_sizes_.push_back(buffer.size());
+  }
+  return weights;
+}
+
+std::vector<uint8_t> MakeBuffer(size_t size, uint8_t first_value) {
+  std::vector<uint8_t> buffer(size);
+  std::iota(buffer.begin(), buffer.end(), first_value);
+  return buffer;
+}
+
+void ExpectWeightsEqual(const PrePackedWeights& actual, const std::vector<std::vector<uint8_t>>& expected) {
+  ASSERT_EQ(actual.buffers_.size(), expected.size());
+  ASSERT_EQ(actual.buffer_sizes_.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(actual.buffer_sizes_[i], expected[i].size());
+    ASSERT_NE(actual.buffers_[i].get(), nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(actual.buffers_[i].get()) % PrepackCache::kBufferAlignment, 0u);
+    EXPECT_EQ(memcmp(actual.buffers_[i].get(), expected[i].data(), expected[i].size()), 0);
+  }
+}
+
+}  // namespace
+
+TEST(PrepackCacheTest, SaveAndReload) {
+  TemporaryDirectory cache_dir(ORT_TSTR("prepack_cache_test_save_and_reload"));
+  const uint64_t model_hash = 0x1234;
+
+  std::vector<std::vector<uint8_t>> buffers_a{MakeBuffer(1000, 1)};
+  std::vector<std::vector<uint8_t>> buffers_b{MakeBuffer(3, 7), MakeBuffer(129, 11)};
+
+  {
+    std::unique_ptr<PrepackCache> cache;
+    ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+    EXPECT_EQ(cache->NumCachedEntries(), 0u);
+    EXPECT_EQ(cache->Find("a"), nullptr);
+
+    cache->Add("a", MakeWeights(buffers_a));
+    cache->Add("b", MakeWeights(buffers_b));
+    EXPECT_EQ(cache->NumAddedEntries(), 2u);
+    ASSERT_STATUS_OK(cache->Save());
+  }
+
+  std::unique_ptr<PrepackCache> cache;
+  ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+  ASSERT_EQ(cache->NumCachedEntries(), 2u);
+  EXPECT_EQ(cache->Find("c"), nullptr);
+
+  const auto* weights_a = cache->Find("a");
+  ASSERT_NE(weights_a, nullptr);
+  ExpectWeightsEqual(*weights_a, buffers_a);
+
+  const auto* weights_b = cache->Find("b");
+  ASSERT_NE(weights_b, nullptr);
+  ExpectWeightsEqual(*weights_b, buffers_b);
+
+  // entries that are already cached are not added again
+  cache->Add("a", MakeWeights(buffers_a));
+  EXPECT_EQ(cache->NumAddedEntries(), 0u);
+}
+
+TEST(PrepackCacheTest, ExistingEntriesAreKeptOnSave) {
+  TemporaryDirectory cache_dir(ORT_TSTR("prepack_cache_test_existing_entries"));
+  const uint64_t model_hash = 42;
+
+  std::vector<std::vector<uint8_t>> buffers_a{MakeBuffer(64, 0)};
+  std::vector<std::vector<uint8_t>> buffers_b{MakeBuffer(65, 100)};
+
+  {
+    std::unique_ptr<PrepackCache> cache;
+    ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+    cache->Add("a", MakeWeights(buffers_a));
+    ASSERT_STATUS_OK(cache->Save());
+  }
+
+  {
+    std::unique_ptr<PrepackCache> cache;
+    ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+    ASSERT_EQ(cache->NumCachedEntries(), 1u);
+    cache->Add("b", MakeWeights(buffers_b));
+    ASSERT_STATUS_OK(cache->Save());
+  }
+
+  std::unique_ptr<PrepackCache> cache;
+  ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+  ASSERT_EQ(cache->NumCachedEntries(), 2u);
+  ExpectWeightsEqual(*cache->Find("a"), buffers_a);
+  ExpectWeightsEqual(*cache->Find("b"), buffers_b);
+}
+
+TEST(PrepackCacheTest, DifferentModelHashMisses) {
+  TemporaryDirectory cache_dir(ORT_TSTR("prepack_cache_test_different_model"));
+
+  std::vector<std::vector<uint8_t>> buffers{MakeBuffer(16, 0)};
+  {
+    std::unique_ptr<PrepackCache> cache;
+    ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), 1, cache));
+    cache->Add("a", MakeWeights(buffers));
+    ASSERT_STATUS_OK(cache->Save());
+  }
+
+  std::unique_ptr<PrepackCache> cache;
+  ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), 2, cache));
+  EXPECT_EQ(cache->NumCachedEntries(), 0u);
+  EXPECT_EQ(cache->Find("a"), nullptr);
+}
+
+TEST(PrepackCacheTest, CorruptFileIsIgnored) {
+  TemporaryDirectory cache_dir(ORT_TSTR("prepack_cache_test_corrupt_file"));
+  const uint64_t model_hash = 7;
+
+  std::vector<std::vector<uint8_t>> buffers{MakeBuffer(256, 3)};
+  std::filesystem::path file_path;
+  {
+    std::unique_ptr<PrepackCache> cache;
+    ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+    cache->Add("a", MakeWeights(buffers));
+    ASSERT_STATUS_OK(cache->Save());
+    file_path = cache->FilePath();
+  }
+
+  // truncate the index
+  const auto file_size = std::filesystem::file_size(file_path);
+  std::filesystem::resize_file(file_path, file_size - 4);
+
+  {
+    std::unique_ptr<PrepackCache> cache;
+    ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+    EXPECT_EQ(cache->NumCachedEntries(), 0u);
+
+    // the next save replaces the invalid file
+    cache->Add("a", MakeWeights(buffers));
+    ASSERT_STATUS_OK(cache->Save());
+  }
+
+  std::unique_ptr<PrepackCache> cache;
+  ASSERT_STATUS_OK(PrepackCache::Open(Env::Default(), cache_dir.Path(), model_hash, cache));
+  ASSERT_EQ(cache->NumCachedEntries(), 1u);
+  ExpectWeightsEqual(*cache->Find("a"), buffers);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
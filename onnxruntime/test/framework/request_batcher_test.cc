@@ -0,0 +1,255 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/framework/allocator.h"
+#include "core/framework/error_code_helper.h"
+#include "core/graph/node_arg.h"
+#include "core/platform/threadpool.h"
+#include "core/session/ort_apis.h"
+#include "core/session/request_batcher.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+struct RequestResult {
+  OrtValue* outputs[1] = {nullptr};
+  std::unique_ptr<OrtValue> output;
+  Status status;
+  std::promise<void> done;
+};
+
+void RequestCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+  auto* result = static_cast<RequestResult*>(user_data);
+  result->status = ToStatus(status);
+  OrtApis::ReleaseStatus(status);
+  if (num_outputs == 1) {
+    result->output.reset(outputs[0]);
+  }
+  result->done.set_value();
+}
+
+// Runs a "model" computing Y = 2 * X, recording the batch sizes it was run with.
+class BatchingTest : public testing::Test {
+ protected:
+  BatchingTest()
+      : thread_pool_(&Env::Default(), ThreadOptions(), ORT_TSTR("request_batcher_test"), 2, true),
+        allocator_(std::make_shared<CPUAllocator>()) {}
+
+  std::unique_ptr<RequestBatcher> CreateBatcher(int64_t max_batch_size, std::chrono::microseconds max_wait) {
+    RequestBatcher::Options options;
+    options.max_batch_size = max_batch_size;
+    options.max_wait = max_wait;
+    options.batch_axis = 0;
+    auto run_fn = [this](const RunOptions&, gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                         gsl::span<const std::string> fetch_names, std::vector<OrtValue>& fetches) {
+      EXPECT_EQ(feed_names.size(), 1u);
+      EXPECT_EQ(fetch_names.size(), 1u);
+      const Tensor& x = feeds[0].Get<Tensor>();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        run_batch_sizes_.push_back(x.Shape()[0]);
+      }
+      fetches.resize(1);
+      Tensor::InitOrtValue(x.DataType(), x.Shape(), allocator_, fetches[0]);
+      auto y = fetches[0].GetMutable<Tensor>()->MutableDataAsSpan<float>();
+      auto x_data = x.DataAsSpan<float>();
+      for (size_t i = 0; i < y.size(); ++i) {
+        y[i] = 2 * x_data[i];
+      }
+      return Status::OK();
+    };
+    return std::make_unique<RequestBatcher>(options, run_fn, &thread_pool_, allocator_);
+  }
+
+  // Submits a request with a [batch_size, 2] input whose values start at `first_value`.
+  bool Submit(RequestBatcher& batcher, int64_t batch_size, float first_value, RequestResult& result,
+              OrtValue& input, const RunOptions* run_options = nullptr) {
+    std::vector<float> values(static_cast<size_t>(batch_size * 2));
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = first_value + static_cast<float>(i);
+    }
+    CreateMLValue<float>(allocator_, {batch_size, 2}, values, &input);
+    const char* input_name = "X";
+    const char* output_name = "Y";
+    const OrtValue* feeds[] = {&input};
+    return batcher.Submit(run_options, gsl::make_span(&input_name, 1), feeds, gsl::make_span(&output_name, 1),
+                          result.outputs, RequestCallback, &result);
+  }
+
+  static void CheckResult(RequestResult& result, int64_t batch_size, float first_value) {
+    result.done.get_future().wait();
+    ASSERT_STATUS_OK(result.status);
+    ASSERT_NE(result.output, nullptr);
+    const Tensor& y = result.output->Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({batch_size, 2}));
+    auto y_data = y.DataAsSpan<float>();
+    for (size_t i = 0; i < y_data.size(); ++i) {
+      EXPECT_EQ(y_data[i], 2 * (first_value + static_cast<float>(i)));
+    }
+  }
+
+  std::vector<int64_t> RunBatchSizes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return run_batch_sizes_;
+  }
+
+  concurrency::ThreadPool thread_pool_;
+  AllocatorPtr allocator_;
+  std::mutex mutex_;
+  std::vector<int64_t> run_batch_sizes_;
+};
+
+}  // namespace
+
+TEST_F(BatchingTest, FullBatchRunsWithoutWaiting) {
+  // the wait is long enough for the test to time out if the batch was not dispatched when full
+  auto batcher = CreateBatcher(4, std::chrono::hours(1));
+  RequestResult results[3];
+  OrtValue inputs[3];
+  ASSERT_TRUE(Submit(*batcher, 1, 0.f, results[0], inputs[0]));
+  ASSERT_TRUE(Submit(*batcher, 2, 10.f, results[1], inputs[1]));
+  ASSERT_TRUE(Submit(*batcher, 1, 20.f, results[2], inputs[2]));
+
+  CheckResult(results[0], 1, 0.f);
+  CheckResult(results[1], 2, 10.f);
+  CheckResult(results[2], 1, 20.f);
+  EXPECT_EQ(RunBatchSizes(), std::vector<int64_t>{4});
+}
+
+TEST_F(BatchingTest, PartialBatchRunsAfterMaxWait) {
+  auto batcher = CreateBatcher(8, std::chrono::milliseconds(10));
+  RequestResult results[2];
+  OrtValue inputs[2];
+  ASSERT_TRUE(Submit(*batcher, 1, 0.f, results[0], inputs[0]));
+  ASSERT_TRUE(Submit(*batcher, 3, 5.f, results[1], inputs[1]));
+
+  CheckResult(results[0], 1, 0.f);
+  CheckResult(results[1], 3, 5.f);
+  EXPECT_EQ(RunBatchSizes(), std::vector<int64_t>{4});
+}
+
+TEST_F(BatchingTest, BatchIsDispatchedBeforeOverflowing) {
+  auto batcher = CreateBatcher(4, std::chrono::hours(1));
+  RequestResult results[3];
+  OrtValue inputs[3];
+  ASSERT_TRUE(Submit(*batcher, 3, 0.f, results[0], inputs[0]));
+  ASSERT_TRUE(Submit(*batcher, 2, 10.f, results[1], inputs[1]));
+  ASSERT_TRUE(Submit(*batcher, 2, 20.f, results[2], inputs[2]));
+
+  CheckResult(results[0], 3, 0.f);
+  CheckResult(results[1], 2, 10.f);
+  CheckResult(results[2], 2, 20.f);
+  auto batch_sizes = RunBatchSizes();
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  EXPECT_EQ(batch_sizes, (std::vector<int64_t>{3, 4}));
+}
+
+TEST_F(BatchingTest, RequestsAreBatchedByRunOptionsSettings) {
+  RunOptions run_options;
+  run_options.run_tag = "batched";
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry("test.key", "1"));
+  RunOptions equal_run_options = run_options;
+  RunOptions other_run_options;
+  other_run_options.run_tag = "batched";
+  ASSERT_STATUS_OK(other_run_options.config_options.AddConfigEntry("test.key", "2"));
+
+  auto batcher = CreateBatcher(4, std::chrono::milliseconds(10));
+  RequestResult results[3];
+  OrtValue inputs[3];
+  ASSERT_TRUE(Submit(*batcher, 1, 0.f, results[0], inputs[0], &run_options));
+  ASSERT_TRUE(Submit(*batcher, 1, 10.f, results[1], inputs[1], &other_run_options));
+  ASSERT_TRUE(Submit(*batcher, 3, 20.f, results[2], inputs[2], &equal_run_options));
+
+  CheckResult(results[0], 1, 0.f);
+  CheckResult(results[1], 1, 10.f);
+  CheckResult(results[2], 3, 20.f);
+  auto batch_sizes = RunBatchSizes();
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  EXPECT_EQ(batch_sizes, (std::vector<int64_t>{1, 4}));
+}
+
+TEST_F(BatchingTest, PendingRequestsRunOnDestruction) {
+  auto batcher = CreateBatcher(8, std::chrono::hours(1));
+  RequestResult result;
+  OrtValue input;
+  ASSERT_TRUE(Submit(*batcher, 2, 1.f, result, input));
+  batcher.reset();
+
+  CheckResult(result, 2, 1.f);
+}
+
+TEST_F(BatchingTest, UnbatchableRequestsAreRejected) {
+  auto batcher = CreateBatcher(4, std::chrono::milliseconds(1));
+
+  // the request fills a batch on its own
+  RequestResult full_result;
+  OrtValue full_input;
+  EXPECT_FALSE(Submit(*batcher, 4, 0.f, full_result, full_input));
+
+  // preallocated output
+  RequestResult preallocated_result;
+  OrtValue preallocated_output;
+  preallocated_result.outputs[0] = &preallocated_output;
+  OrtValue input;
+  EXPECT_FALSE(Submit(*batcher, 1, 0.f, preallocated_result, input));
+
+  // string input
+  OrtValue string_input;
+  CreateMLValue<std::string>(allocator_, {1, 2}, {"a", "b"}, &string_input);
+  const char* input_name = "X";
+  const char* output_name = "Y";
+  const OrtValue* feeds[] = {&string_input};
+  RequestResult string_result;
+  EXPECT_FALSE(batcher->Submit(nullptr, gsl::make_span(&input_name, 1), feeds, gsl::make_span(&output_name, 1),
+                               string_result.outputs, RequestCallback, &string_result));
+
+  batcher.reset();
+  EXPECT_TRUE(RunBatchSizes().empty());
+}
+
+TEST(RequestBatcherTest, OutputsMustHaveBatchAxis) {
+  // Creates a float tensor output with the given dimensions, where -1 is a symbolic dimension.
+  auto make_output = [](const std::string& name, const std::vector<int64_t>& dims) {
+    ONNX_NAMESPACE::TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    auto* shape = type.mutable_tensor_type()->mutable_shape();
+    for (int64_t dim : dims) {
+      if (dim == -1) {
+        shape->add_dim()->set_dim_param("batch");
+      } else {
+        shape->add_dim()->set_dim_value(dim);
+      }
+    }
+    return std::make_unique<NodeArg>(name, &type);
+  };
+
+  auto batched = make_output("batched", {-1, 2});
+  auto fixed = make_output("fixed", {1, 2});
+  auto scalar = make_output("scalar", {});
+
+  const NodeArg* batched_outputs[] = {batched.get()};
+  EXPECT_STATUS_OK(RequestBatcher::CheckOutputsHaveBatchAxis(batched_outputs, 0));
+
+  const NodeArg* fixed_outputs[] = {batched.get(), fixed.get()};
+  EXPECT_STATUS_NOT_OK_AND_HAS_SUBSTR(RequestBatcher::CheckOutputsHaveBatchAxis(fixed_outputs, 0),
+                                      "fixed size along the batch axis");
+
+  const NodeArg* scalar_outputs[] = {scalar.get()};
+  EXPECT_STATUS_NOT_OK_AND_HAS_SUBSTR(RequestBatcher::CheckOutputsHaveBatchAxis(scalar_outputs, 0),
+                                      "no dimension along the batch axis");
+  EXPECT_STATUS_NOT_OK(RequestBatcher::CheckOutputsHaveBatchAxis(batched_outputs, 2));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
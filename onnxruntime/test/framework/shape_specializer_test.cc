@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/framework/allocator.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/shape_specializer.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Computes the Abs of an input "x" of shape [Dim1, Dim2, 5].
+constexpr const ORTCHAR_T* kModelUri = ORT_TSTR("testdata/abs_free_dimensions.onnx");
+
+class ShapeSpecializerTest : public testing::Test {
+ protected:
+  ShapeSpecializerTest()
+      : session_(SessionOptions(), GetEnvironment()),
+        allocator_(std::make_shared<CPUAllocator>()) {}
+
+  void SetUp() override {
+    ASSERT_STATUS_OK(session_.Load(kModelUri));
+    ASSERT_STATUS_OK(session_.Initialize());
+  }
+
+  // Creates a specializer whose sessions are created from the model, or that fails to create them.
+  std::unique_ptr<ShapeSpecializer> CreateSpecializer(size_t min_runs, size_t max_sessions, bool fail = false) {
+    ShapeSpecializer::Options options;
+    options.min_runs = min_runs;
+    options.max_sessions = max_sessions;
+    auto create_session_fn = [this, fail](const std::vector<FreeDimensionOverride>& overrides,
+                                          std::unique_ptr<InferenceSession>& session) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        created_overrides_.push_back(overrides);
+      }
+      ORT_RETURN_IF(fail, "failed to create the session");
+
+      SessionOptions session_options;
+      session_options.free_dimension_overrides = overrides;
+      session = std::make_unique<InferenceSession>(session_options, GetEnvironment());
+      ORT_RETURN_IF_ERROR(session->Load(kModelUri));
+      return session->Initialize();
+    };
+    return std::make_unique<ShapeSpecializer>(options, *session_.GetModelInputs().second, create_session_fn,
+                                              DefaultLoggingManager().DefaultLogger());
+  }
+
+  // Records a run with an input of shape [dim1, dim2, 5].
+  InferenceSession* GetSession(ShapeSpecializer& specializer, int64_t dim1, int64_t dim2) {
+    OrtValue input;
+    CreateMLValue<float>(allocator_, {dim1, dim2, 5}, std::vector<float>(static_cast<size_t>(dim1 * dim2 * 5), -1.f),
+                         &input);
+    const std::vector<std::string> feed_names{"x"};
+    const std::vector<OrtValue> feeds{input};
+    return specializer.GetSession(feed_names, feeds);
+  }
+
+  std::vector<std::vector<FreeDimensionOverride>> CreatedOverrides() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_overrides_;
+  }
+
+  InferenceSession session_;
+  AllocatorPtr allocator_;
+  std::mutex mutex_;
+  std::vector<std::vector<FreeDimensionOverride>> created_overrides_;
+};
+
+// Creates a model computing Reshape(x + B, Shape(x)) for an input "x" of shape [N, 4] and an initializer "B".
+void CreateShapeChainModel(std::string* model_bytes, const PathString* model_file) {
+  Model model("shape_chain", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 17}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  ONNX_NAMESPACE::TypeProto b_type;
+  b_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  ONNX_NAMESPACE::TypeProto shape_type;
+  shape_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  shape_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  ONNX_NAMESPACE::TensorProto b;
+  b.set_name("B");
+  b.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b.add_dims(4);
+  for (float value : {1.f, 2.f, 3.f, 4.f}) {
+    b.add_float_data(value);
+  }
+  graph.AddInitializedTensor(b);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &x_type);
+  auto& b_arg = graph.GetOrCreateNodeArg("B", &b_type);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &x_type);
+  auto& shape = graph.GetOrCreateNodeArg("shape", &shape_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &x_type);
+  graph.AddNode("add", "Add", "", {&x, &b_arg}, {&sum});
+  graph.AddNode("shape", "Shape", "", {&x}, {&shape});
+  graph.AddNode("reshape", "Reshape", "", {&sum, &shape}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  if (model_bytes != nullptr) {
+    ASSERT_TRUE(model.ToProto().SerializeToString(model_bytes));
+  }
+  if (model_file != nullptr) {
+    ASSERT_STATUS_OK(Model::Save(model, *model_file));
+  }
+}
+
+size_t CountNodes(const InferenceSession& session, const std::string& op_type) {
+  size_t count = 0;
+  for (const auto& node : session.GetSessionState().GetGraphViewer().Nodes()) {
+    count += node.OpType() == op_type ? 1 : 0;
+  }
+  return count;
+}
+
+const void* InitializerData(const InferenceSession& session, const std::string& name) {
+  const SessionState& session_state = session.GetSessionState();
+  int ort_value_idx;
+  if (!session_state.GetOrtValueNameIdxMap().GetIdx(name, ort_value_idx).IsOK()) {
+    return nullptr;
+  }
+  const auto& initializers = session_state.GetConstantInitializedTensors();
+  auto it = initializers.find(ort_value_idx);
+  return it == initializers.end() ? nullptr : it->second.Get<Tensor>().DataRaw();
+}
+
+// Runs the generic session of the shape chain model with the given number of rows until a session specialized to
+// them has been created, and checks that it is used with the same results.
+void TestSpecializedSession(bool load_from_file) {
+  TemporaryDirectory temp_dir(ORT_TSTR("shape_specializer_test"));
+  const PathString model_file = temp_dir.Path() + ORT_TSTR("/shape_chain.onnx");
+  std::string model_bytes;
+  CreateShapeChainModel(load_from_file ? nullptr : &model_bytes, load_from_file ? &model_file : nullptr);
+
+  SessionOptions session_options;
+  ASSERT_STATUS_OK(
+      session_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigShapeSpecializationMinRuns, "2"));
+  InferenceSession session(session_options, GetEnvironment());
+  if (load_from_file) {
+    ASSERT_STATUS_OK(session.Load(model_file));
+  } else {
+    ASSERT_STATUS_OK(session.Load(model_bytes.data(), static_cast<int>(model_bytes.size())));
+  }
+  ASSERT_STATUS_OK(session.Initialize());
+  ShapeSpecializer* specializer = session.GetShapeSpecializer();
+  ASSERT_NE(specializer, nullptr);
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  const std::vector<std::string> feed_names{"x"};
+  const std::vector<std::string> fetch_names{"y"};
+  auto make_feeds = [&](int64_t rows) {
+    std::vector<float> x(static_cast<size_t>(rows * 4));
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = static_cast<float>(i) - 10.f;
+    }
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(allocator, {rows, 4}, x, &feeds[0]);
+    return feeds;
+  };
+  auto run = [&](int64_t rows) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions(), feed_names, make_feeds(rows), fetch_names, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    const Tensor& y = fetches[0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({rows, 4}));
+    auto y_data = y.DataAsSpan<float>();
+    for (size_t i = 0; i < y_data.size(); ++i) {
+      EXPECT_EQ(y_data[i], static_cast<float>(i) - 10.f + static_cast<float>(i % 4 + 1));
+    }
+  };
+
+  run(2);
+  run(3);
+  run(2);
+  specializer->WaitForPendingSessions();
+  EXPECT_EQ(specializer->NumSessions(), 1u);
+
+  // a single specialized session is created by default
+  run(3);
+  specializer->WaitForPendingSessions();
+  EXPECT_EQ(specializer->NumSessions(), 1u);
+
+  // the runs with 2 rows are routed to the specialized session, and the others keep using the generic one
+  run(2);
+  run(3);
+  InferenceSession* specialized_session = specializer->GetSession(feed_names, make_feeds(2));
+  ASSERT_NE(specialized_session, nullptr);
+  EXPECT_EQ(specializer->GetSession(feed_names, make_feeds(3)), nullptr);
+
+  // the Shape node is constant folded in the specialized session only
+  EXPECT_EQ(CountNodes(session, "Shape"), 1u);
+  EXPECT_EQ(CountNodes(*specialized_session, "Shape"), 0u);
+
+  // the specialized session uses the initializer of the generic session
+  const void* b_data = InitializerData(session, "B");
+  ASSERT_NE(b_data, nullptr);
+  EXPECT_EQ(InitializerData(*specialized_session, "B"), b_data);
+}
+}  // namespace
+
+TEST_F(ShapeSpecializerTest, FrequentShapeIsSpecialized) {
+  auto specializer = CreateSpecializer(2, 4);
+  ASSERT_TRUE(specializer->HasSymbolicDims());
+
+  EXPECT_EQ(GetSession(*specializer, 1, 3), nullptr);
+  EXPECT_EQ(GetSession(*specializer, 2, 3), nullptr);
+  EXPECT_EQ(GetSession(*specializer, 1, 3), nullptr);
+  specializer->WaitForPendingSessions();
+  EXPECT_EQ(specializer->NumSessions(), 1u);
+
+  auto created_overrides = CreatedOverrides();
+  ASSERT_EQ(created_overrides.size(), 1u);
+  ASSERT_EQ(created_overrides[0].size(), 2u);
+  EXPECT_EQ(created_overrides[0][0].dim_identifier, "Dim1");
+  EXPECT_EQ(created_overrides[0][0].dim_value, 1);
+  EXPECT_EQ(created_overrides[0][1].dim_identifier, "Dim2");
+  EXPECT_EQ(created_overrides[0][1].dim_value, 3);
+
+  // the runs with the specialized shape use a session whose input shape is static
+  InferenceSession* specialized_session = GetSession(*specializer, 1, 3);
+  ASSERT_NE(specialized_session, nullptr);
+  const auto* input_shape = (*specialized_session->GetModelInputs().second)[0]->Shape();
+  ASSERT_NE(input_shape, nullptr);
+  ASSERT_EQ(input_shape->dim_size(), 3);
+  EXPECT_EQ(input_shape->dim(0).dim_value(), 1);
+  EXPECT_EQ(input_shape->dim(1).dim_value(), 3);
+  EXPECT_EQ(input_shape->dim(2).dim_value(), 5);
+
+  OrtValue input;
+  CreateMLValue<float>(allocator_, {1, 3, 5}, std::vector<float>(15, -2.f), &input);
+  const std::vector<std::string> feed_names{"x"};
+  const std::vector<std::string> fetch_names{(*specialized_session->GetModelOutputs().second)[0]->Name()};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(specialized_session->Run(RunOptions(), feed_names, std::vector<OrtValue>{input}, fetch_names,
+                                            &fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  for (float value : fetches[0].Get<Tensor>().DataAsSpan<float>()) {
+    EXPECT_EQ(value, 2.f);
+  }
+
+  // other shapes keep using the generic session
+  EXPECT_EQ(GetSession(*specializer, 2, 3), nullptr);
+  EXPECT_EQ(GetSession(*specializer, 1, 4), nullptr);
+}
+
+TEST_F(ShapeSpecializerTest, MaxSessionsIsRespected) {
+  auto specializer = CreateSpecializer(1, 1);
+  EXPECT_EQ(GetSession(*specializer, 1, 3), nullptr);
+  EXPECT_EQ(GetSession(*specializer, 2, 3), nullptr);
+  specializer->WaitForPendingSessions();
+
+  EXPECT_EQ(specializer->NumSessions(), 1u);
+  EXPECT_EQ(CreatedOverrides().size(), 1u);
+  EXPECT_NE(GetSession(*specializer, 1, 3), nullptr);
+  EXPECT_EQ(GetSession(*specializer, 2, 3), nullptr);
+}
+
+TEST_F(ShapeSpecializerTest, FailedSessionFallsBackToGenericSession) {
+  auto specializer = CreateSpecializer(1, 1, /*fail*/ true);
+  EXPECT_EQ(GetSession(*specializer, 1, 3), nullptr);
+  specializer->WaitForPendingSessions();
+  EXPECT_EQ(specializer->NumSessions(), 0u);
+  EXPECT_EQ(GetSession(*specializer, 1, 3), nullptr);
+
+  // the failed session does not count towards the maximum, and is not retried
+  EXPECT_EQ(GetSession(*specializer, 2, 3), nullptr);
+  specializer->WaitForPendingSessions();
+  EXPECT_EQ(GetSession(*specializer, 1, 3), nullptr);
+  specializer->WaitForPendingSessions();
+  EXPECT_EQ(CreatedOverrides().size(), 2u);
+}
+
+TEST(InferenceSessionShapeSpecializationTest, ModelLoadedFromFile) {
+  TestSpecializedSession(/*load_from_file*/ true);
+}
+
+TEST(InferenceSessionShapeSpecializationTest, ModelLoadedFromBytes) {
+  TestSpecializedSession(/*load_from_file*/ false);
+}
+
+TEST(InferenceSessionShapeSpecializationTest, InvalidConfigurationIsRejected) {
+  std::string model_bytes;
+  CreateShapeChainModel(&model_bytes, nullptr);
+
+  SessionOptions session_options;
+  ASSERT_STATUS_OK(
+      session_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigShapeSpecializationMinRuns, "many"));
+  InferenceSession session(session_options, GetEnvironment());
+  ASSERT_STATUS_OK(session.Load(model_bytes.data(), static_cast<int>(model_bytes.size())));
+  EXPECT_STATUS_NOT_OK_AND_HAS_SUBSTR(session.Initialize(), "Invalid shape specialization configuration");
+}
+
+TEST(InferenceSessionShapeSpecializationTest, DisabledByDefault) {
+  std::string model_bytes;
+  CreateShapeChainModel(&model_bytes, nullptr);
+
+  InferenceSession session(SessionOptions(), GetEnvironment());
+  ASSERT_STATUS_OK(session.Load(model_bytes.data(), static_cast<int>(model_bytes.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+  EXPECT_EQ(session.GetShapeSpecializer(), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -3,14 +3,17 @@
 
 #include "core/common/inlined_containers.h"
 #include "core/common/parse_string.h"
+#include "core/framework/callback.h"
 #include "core/framework/prepacked_weights.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
 #include "test/util/include/asserts.h"
 #include "file_util.h"
 
 #include <cstdint>
+#include <cstring>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -356,6 +359,44 @@ TEST(TensorProtoUtilsTest, UnpackTensorWithExternalData) {
   TestUnpackExternalTensor<bool>(TensorProto_DataType_BOOL, model_path);
 }
 
+#if !defined(__wasm__)
+TEST(TensorProtoUtilsTest, GetExtDataFromTensorProtoMapsFile) {
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("tensor_XXXXXX"));
+  TensorProto tensor_proto;
+  auto test_data = CreateValues<float>();
+  CreateTensorWithExternalData<float>(TensorProto_DataType_FLOAT, test_data, filename, tensor_proto);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+  EXPECT_FALSE(utils::HasExternalDataInMemory(tensor_proto));
+
+  void* ext_data_buf = nullptr;
+  SafeInt<size_t> ext_data_len = 0;
+  OrtCallback ext_data_deleter{nullptr, nullptr};
+  utils::ExternalDataSource ext_data_source = utils::ExternalDataSource::kMemoryAddress;
+  ASSERT_STATUS_OK(utils::GetExtDataFromTensorProto(Env::Default(), std::filesystem::path(), tensor_proto,
+                                                    ext_data_buf, ext_data_len, ext_data_deleter,
+                                                    nullptr, nullptr, &ext_data_source));
+  ScopedOrtCallbackInvoker ext_data_releaser(ext_data_deleter);
+
+  EXPECT_EQ(ext_data_source, utils::ExternalDataSource::kMappedFile);
+  ASSERT_EQ(static_cast<size_t>(ext_data_len), test_data.size() * sizeof(float));
+  if constexpr (endian::native == endian::little) {
+    EXPECT_EQ(0, memcmp(ext_data_buf, test_data.data(), ext_data_len));
+  }
+}
+#endif
+
+TEST(TensorProtoUtilsTest, HasExternalDataInMemory) {
+  TensorProto tensor_proto;
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(4);
+  static float data[4] = {1.f, 2.f, 3.f, 4.f};
+  ExternalDataInfo::SetExternalLocationToProto(utils::kTensorProtoMemoryAddressTag,
+                                               static_cast<int64_t>(reinterpret_cast<intptr_t>(data)), sizeof(data),
+                                               tensor_proto);
+  EXPECT_TRUE(utils::HasExternalDataInMemory(tensor_proto));
+}
+
 template <typename T>
 static NodeProto CreateConstantNode(const std::string& attrib_name, AttributeProto_AttributeType type,
                                     std::function<void(AttributeProto&)> add_data) {
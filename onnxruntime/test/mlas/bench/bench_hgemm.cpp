@@ -84,3 +84,63 @@ static void GemmLLMSizeProducts(benchmark::internal::Benchmark* b) {
   b->ArgsProduct({{1, 1024, 2048}, {4096, 11008}, {4096, 11008}});
 }
 BENCHMARK_CAPTURE(HGEMM, LLM, false, true)->Apply(GemmLLMSizeProducts)->UseRealTime();
+
+void HALFGEMM(benchmark::State& state, bool packB, bool AIsfp32) {
+  if (!MlasHalfGemmAccelerated()) {
+    state.SkipWithMessage("MlasHalfGemmBatch is not accelerated on the current machine.");
+    return;
+  }
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  std::vector<MLAS_FP16> A;
+  std::vector<float> A32;
+  if (AIsfp32) {
+    A32 = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  } else {
+    A = RandomVectorUniform(static_cast<size_t>(M * K), MLAS_FP16(-1.0f), MLAS_FP16(1.0f));
+  }
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), MLAS_FP16(-1.0f), MLAS_FP16(1.0f));
+  std::vector<MLAS_FP16> C(static_cast<size_t>(M * N));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  std::vector<uint8_t> PackedB;
+  MLAS_HALF_GEMM_DATA_PARAMS params;
+  params.A = AIsfp32 ? static_cast<const void*>(A32.data()) : static_cast<const void*>(A.data());
+  params.lda = K;
+  params.AIsfp32 = AIsfp32;
+  params.C = C.data();
+  params.ldc = N;
+  if (packB) {
+    PackedB.resize(MlasHalfGemmPackBSize(N, K, false));
+    MlasHalfGemmPackB(N, K, B.data(), N, PackedB.data());
+    params.B = PackedB.data();
+    params.ldb = 0;
+  } else {
+    params.B = B.data();
+    params.ldb = N;
+  }
+
+  MlasHalfGemmBatch(M, N, K, 1, &params, tp.get());
+
+  for (auto _ : state) {
+    MlasHalfGemmBatch(M, N, K, 1, &params, tp.get());
+  }
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, GEMV, false, false)->Apply(GemmSizeWithOne)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL, false, false)->Apply(GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL_PackB, true, false)->Apply(GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL_Afp32, false, true)->Apply(GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, LLM, false, false)->Apply(GemmLLMSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, LLM_PackB, true, false)->Apply(GemmLLMSizeProducts)->UseRealTime();
@@ -3,6 +3,7 @@
 
 #include "mlas.h"
 #include "bench_util.h"
+#include "core/util/thread_utils.h"
 
 #include <stdexcept>
 #include <numeric>
@@ -245,3 +246,90 @@ static void General_Conv2d(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SCONV_NCHW, 2d, "")->Apply(General_Conv2d)->UseRealTime();
+
+// Compares the Winograd algorithm of the 3x3 stride 1 convolutions with the im2col+SGEMM algorithm.
+enum class SConv3x3Mode {
+  Im2Col,
+  Winograd,
+  WinogradPrepacked,
+};
+
+void SCONV_NCHW_3x3(benchmark::State& state, SConv3x3Mode mode) {
+  const int64_t batch_size = state.range(0);
+  const int64_t input_channels = state.range(1);
+  const int64_t output_channels = state.range(2);
+  const int64_t height = state.range(3);
+  const int64_t width = state.range(4);
+  if (batch_size <= 0 || input_channels <= 0 || output_channels <= 0 || height <= 0 || width <= 0) {
+    throw std::invalid_argument("all args must greater than 0!");
+  }
+
+  const int64_t input_shape[] = {height, width};
+  const int64_t kernel_shape[] = {3, 3};
+  const int64_t paddings[] = {1, 1, 1, 1};
+  const int64_t strides[] = {1, 1};
+  const int64_t dilations[] = {1, 1};
+  const int64_t output_shape[] = {height, width};
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+  MLAS_CONV_PARAMETERS Parameters;
+  size_t WorkingBufferSize = 0;
+  MlasConvPrepare(&Parameters, 2, static_cast<size_t>(batch_size), 1, static_cast<size_t>(input_channels),
+                  input_shape, kernel_shape, dilations, paddings, strides, output_shape,
+                  static_cast<size_t>(output_channels), &activation, &WorkingBufferSize, 0.0f, tp.get());
+
+  auto X = RandomVectorUniform({batch_size, input_channels, height, width}, -2.0, 2.0);
+  auto F = RandomVectorUniform({output_channels, input_channels, 3, 3}, -1.0, 1.0);
+  std::vector<float> Y(static_cast<size_t>(batch_size * output_channels * height * width));
+
+  std::vector<float> packed_filter;
+  if (mode == SConv3x3Mode::Im2Col) {
+    Parameters.Algorithm = MlasConvAlgorithmExpandThenGemm;
+    WorkingBufferSize = Parameters.OutputSize * Parameters.K;
+  } else {
+    if (Parameters.Algorithm != MlasConvAlgorithmWinograd) {
+      state.SkipWithError("Winograd is not selected for this shape");
+      return;
+    }
+    if (mode == SConv3x3Mode::WinogradPrepacked) {
+      packed_filter.resize(MlasConvWinogradPackFilterSize(2, 1, static_cast<size_t>(input_channels),
+                                                          static_cast<size_t>(output_channels), kernel_shape,
+                                                          dilations, strides) /
+                           sizeof(float));
+      MlasConvWinogradPackFilter(1, static_cast<size_t>(input_channels), static_cast<size_t>(output_channels),
+                                 F.data(), packed_filter.data(), tp.get());
+      Parameters.u.Winograd.PackedFilter = packed_filter.data();
+    }
+  }
+  std::vector<float> working_buffer(WorkingBufferSize);
+
+  // warm up first round.
+  MlasConv(&Parameters, X.data(), F.data(), nullptr, working_buffer.data(), Y.data(), tp.get());
+
+  for (auto _ : state) {
+    MlasConv(&Parameters, X.data(), F.data(), nullptr, working_buffer.data(), Y.data(), tp.get());
+  }
+}
+
+static void ResNet50_3x3(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "F", "H", "W"});
+  b->Args({1, 64, 64, 56, 56});
+  b->Args({1, 128, 128, 28, 28});
+  b->Args({1, 256, 256, 14, 14});
+  b->Args({1, 512, 512, 7, 7});
+  b->Args({4, 64, 64, 56, 56});
+}
+
+BENCHMARK_CAPTURE(SCONV_NCHW_3x3, Im2Col, SConv3x3Mode::Im2Col)->Apply(ResNet50_3x3)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW_3x3, Winograd, SConv3x3Mode::Winograd)->Apply(ResNet50_3x3)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW_3x3, WinogradPrepacked, SConv3x3Mode::WinogradPrepacked)
+    ->Apply(ResNet50_3x3)
+    ->UseRealTime();
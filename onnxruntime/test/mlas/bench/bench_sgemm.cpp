@@ -5,6 +5,7 @@
 #include "bench_util.h"
 #include "core/util/thread_utils.h"
 
+#include <cmath>
 #include <stdexcept>
 #include <numeric>
 
@@ -99,6 +100,8 @@ void SGEMM(benchmark::State& state, bool pack_b, bool trans_a, bool trans_b, flo
           tp.get());
     }
   }
+
+  state.counters["FLOPS"] = benchmark::Counter(2.0 * M * N * K, benchmark::Counter::kIsIterationInvariantRate);
 }
 
 static void GemmSizeWithOne(benchmark::internal::Benchmark* b) {
@@ -126,9 +129,128 @@ BENCHMARK_CAPTURE(SGEMM, GEMV_ABTrans, false, true, true)->Apply(GemmSizeWithOne
 BENCHMARK_CAPTURE(SGEMM, PACKB_NoTransA, true, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, PACKB_TransA, true, true, false)->Apply(GemmSizeProducts)->UseRealTime();
 
+// Batches of small matrices, as produced by Einsum and by attention with small heads.
+void SGEMM_SMALL_BATCH(benchmark::State& state, bool trans_b) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const size_t batch_size = static_cast<size_t>(state.range(3));
+
+  auto A = RandomVectorUniform(M * K * batch_size, -1.0f, 1.0f);
+  auto B = RandomVectorUniform(N * K * batch_size, -1.0f, 1.0f);
+  std::vector<float> C(M * N * batch_size);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch_size);
+  for (size_t i = 0; i < batch_size; i++) {
+    data[i].A = A.data() + i * M * K;
+    data[i].lda = K;
+    data[i].B = B.data() + i * N * K;
+    data[i].ldb = trans_b ? K : N;
+    data[i].C = C.data() + i * M * N;
+    data[i].ldc = N;
+  }
+
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+  MlasGemmBatch(CblasNoTrans, trans, M, N, K, data.data(), batch_size, tp.get());
+
+  for (auto _ : state) {
+    MlasGemmBatch(CblasNoTrans, trans, M, N, K, data.data(), batch_size, tp.get());
+  }
+
+  state.counters["FLOPS"] = benchmark::Counter(2.0 * M * N * K * batch_size,
+                                               benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void GemmSmallBatchSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "Batch"});
+  b->ArgsProduct({{1, 8, 32, 64}, {8, 32, 64}, {8, 32, 64}, {1, 64, 512}});
+}
+
+BENCHMARK_CAPTURE(SGEMM_SMALL_BATCH, NoTrans, false)->Apply(GemmSmallBatchSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM_SMALL_BATCH, TransB, true)->Apply(GemmSmallBatchSizes)->UseRealTime();
+
 static void GemmLLMSizeProducts(benchmark::internal::Benchmark* b) {
   b->ArgNames(sgemm_bench_arg_names);
   b->ArgsProduct({{1, 1024, 2048}, {4096, 11008}, {4096, 11008}});
 }
 
 BENCHMARK_CAPTURE(SGEMM, LLM, false, false, true)->Apply(GemmLLMSizeProducts)->UseRealTime();
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+void SBGEMM(benchmark::State& state, bool pack_b) {
+  if (!MlasBf16AccelerationSupported()) {
+    state.SkipWithMessage("SBGEMM is not available on the current machine.");
+    return;
+  }
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+  std::vector<float> CReference(static_cast<size_t>(M * N));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  std::vector<uint8_t> B_packed;
+  MLAS_SBGEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.lda = K;
+  params.AIsfp32 = true;
+  params.C = C.data();
+  params.ldc = N;
+  if (pack_b) {
+    B_packed.resize(MlasSBGemmPackBSize(N, K));
+    MlasSBGemmConvertPackB(N, K, B.data(), N, B_packed.data());
+    params.B = B_packed.data();
+    params.ldb = 0;
+    params.BIsfp32 = false;
+  } else {
+    params.B = B.data();
+    params.ldb = N;
+    params.BIsfp32 = true;
+  }
+
+  MlasSBGemmBatch(M, N, K, 1, &params, tp.get());
+
+  // Report the accuracy of the bf16 product against the fp32 product.
+  MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A.data(), K, B.data(), N, 0.0f, CReference.data(), N, tp.get());
+  float max_error = 0.0f;
+  float max_reference = 0.0f;
+  for (size_t i = 0; i < C.size(); i++) {
+    max_error = std::max(max_error, std::fabs(C[i] - CReference[i]));
+    max_reference = std::max(max_reference, std::fabs(CReference[i]));
+  }
+  state.counters["MaxAbsError"] = max_error;
+  state.counters["MaxRelError"] = (max_reference > 0.0f) ? max_error / max_reference : 0.0f;
+
+  for (auto _ : state) {
+    MlasSBGemmBatch(M, N, K, 1, &params, tp.get());
+  }
+
+  state.counters["FLOPS"] = benchmark::Counter(2.0 * M * N * K, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_CAPTURE(SBGEMM, NORMAL_NoTrans, false)->Apply(GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, PACKB_NoTrans, true)->Apply(GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, GEMV_NoTrans, false)->Apply(GemmSizeWithOne)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, LLM, true)->Apply(GemmLLMSizeProducts)->UseRealTime();
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
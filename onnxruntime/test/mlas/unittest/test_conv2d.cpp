@@ -14,8 +14,10 @@ static size_t Conv2dRegistLongExecute() {
 
 static size_t Conv2dRegistShortExecute() {
   size_t count = Conv2dShortExecuteTest<MlasConv2DTest<false>>::RegisterShortExecuteTests();
+  count += Conv2dShortExecuteTest<MlasConv2DTest<false>>::RegisterWinogradShortExecuteTests();
   if (GetMlasThreadPool() != nullptr) {
     count += Conv2dShortExecuteTest<MlasConv2DTest<true>>::RegisterShortExecuteTests();
+    count += Conv2dShortExecuteTest<MlasConv2DTest<true>>::RegisterWinogradShortExecuteTests();
   }
   return count;
 }
@@ -60,6 +60,9 @@ class MlasConv2DTest : public MlasTestBase {
                     0.0f,
                     threadpool_);
 
+    // The Winograd algorithm rounds differently than the reference.
+    ResultIsApproximate = Parameters.Algorithm == MlasConvAlgorithmWinograd;
+
     MlasConv(&Parameters,
              Input,
              Filter,
@@ -156,6 +159,7 @@ class MlasConv2DTest : public MlasTestBase {
   MatrixGuardBuffer<float> BufferIm2Col;
 
   MLAS_THREADPOOL* threadpool_;
+  bool ResultIsApproximate = false;
 
  public:
   static const char* GetTestSuiteName() {
@@ -215,6 +219,7 @@ class MlasConv2DTest : public MlasTestBase {
     float* Output = BufferOutput.GetBuffer(OutputElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
 
+    ResultIsApproximate = false;
     MlasConv2D(BatchCount,
                GroupCount,
                InputChannels,
@@ -246,6 +251,18 @@ class MlasConv2DTest : public MlasTestBase {
                     Bias,
                     OutputReference);
 
+    if (ResultIsApproximate) {
+      constexpr float AbsoluteTolerance = 1e-3f;
+      constexpr float RelativeTolerance = 1e-4f;
+      for (size_t i = 0; i < OutputElements; i++) {
+        float diff = std::fabs(Output[i] - OutputReference[i]);
+        ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+            << "Cpg" << InputChannels << "/Fpg" << FilterCount << "/H" << InputHeight << "/W" << InputWidth
+            << " @" << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+      }
+      return;
+    }
+
     ASSERT_EQ(memcmp(Output, OutputReference, OutputElements * sizeof(float)), 0)
         << "B" << BatchCount << "/"
         << "G" << GroupCount << "/"
@@ -143,6 +143,16 @@ class Conv2dShortExecuteTest : public MlasTestFixture<Conv2dTester> {
     return test_registered;
   }
 
+  // Shapes that select the Winograd algorithm of MlasConv. Only registered for the NCHW tester, which compares
+  // approximate results with a tolerance; the NCHWc tester compares exactly.
+  static size_t RegisterWinogradShortExecuteTests() {
+    size_t test_registered = 0;
+    for (unsigned i = 1; i < 256; i <<= 1) {
+      test_registered += RegisterSingleTest(2, 2, 32, i, i + 3, 40, 3, 3, 1, 0, 1, 2, 1, 1, 1, 1);
+    }
+    return test_registered;
+  }
+
  private:
   size_t BatchCount_;
   size_t GroupCount_;
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferWorkspace;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(int BatchSize, int NumHeads, int KvNumHeads, int QSequenceLength, int KvSequenceLength, int HeadSize,
+            int QBlockSize, int KvBlockSize, bool PadKeys, bool IsCausal, int LocalWindowSize) {
+    const size_t QueryElements = size_t(BatchSize) * NumHeads * QSequenceLength * HeadSize;
+    const size_t KvElements = size_t(BatchSize) * KvNumHeads * KvSequenceLength * HeadSize;
+    float* Query = BufferQuery.GetBuffer(QueryElements);
+    float* Key = BufferKey.GetBuffer(KvElements);
+    float* Value = BufferValue.GetBuffer(KvElements);
+    float* Output = BufferOutput.GetBuffer(QueryElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(QueryElements);
+
+    std::default_random_engine generator(static_cast<unsigned>(QueryElements + KvElements));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < QueryElements; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < KvElements; i++) {
+      Key[i] = distribution(generator);
+      Value[i] = distribution(generator);
+    }
+
+    // Batch b has KvSequenceLength - b valid keys, at least one.
+    std::vector<int> KvSequenceLengths(BatchSize);
+    for (int b = 0; b < BatchSize; b++) {
+      KvSequenceLengths[b] = PadKeys ? std::max(KvSequenceLength - b, 1) : KvSequenceLength;
+    }
+
+    constexpr int ThreadCount = 3;
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = BatchSize;
+    args.num_heads = NumHeads;
+    args.q_sequence_length = QSequenceLength;
+    args.kv_sequence_length = KvSequenceLength;
+    args.qk_head_size = HeadSize;
+    args.v_head_size = HeadSize;
+    args.q_block_size = QBlockSize;
+    args.kv_block_size = KvBlockSize;
+    args.scale = 1.0f / std::sqrt(float(HeadSize));
+    args.thread_count = ThreadCount;
+    args.buffer_size_per_thread =
+        (size_t(QBlockSize) * 2 + size_t(QBlockSize) * KvBlockSize + size_t(QBlockSize) * HeadSize) * sizeof(float);
+    args.buffer = BufferWorkspace.GetBuffer(args.buffer_size_per_thread * ThreadCount / sizeof(float));
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+    args.kv_num_heads = KvNumHeads;
+    args.kv_sequence_lengths = PadKeys ? KvSequenceLengths.data() : nullptr;
+    args.is_causal = IsCausal;
+    args.local_window_size = LocalWindowSize;
+
+    MlasFlashAttention(&args, threadpool_);
+    ReferenceAttention(args, KvSequenceLengths.data(), OutputReference);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+    for (size_t i = 0; i < QueryElements; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "B/N/Nkv/S/L/H " << BatchSize << "/" << NumHeads << "/" << KvNumHeads << "/" << QSequenceLength << "/"
+          << KvSequenceLength << "/" << HeadSize << " blocks " << QBlockSize << "/" << KvBlockSize
+          << " padded:" << PadKeys << " causal:" << IsCausal << " window:" << LocalWindowSize
+          << " @" << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  // Materializes the masked scores of each query and takes their softmax.
+  void ReferenceAttention(const MlasFlashAttentionThreadedArgs& args, const int* KvSequenceLengths, float* Output) {
+    const int H = args.qk_head_size;
+    const int GroupSize = args.num_heads / args.kv_num_heads;
+    std::vector<double> Scores(args.kv_sequence_length);
+
+    for (int b = 0; b < args.batch_size; b++) {
+      const int KvLength = KvSequenceLengths[b];
+      const int Offset = std::max(0, KvLength - args.q_sequence_length);
+      for (int n = 0; n < args.num_heads; n++) {
+        const int kvh = b * args.kv_num_heads + n / GroupSize;
+        const float* K = args.key + size_t(kvh) * args.kv_sequence_length * H;
+        const float* V = args.value + size_t(kvh) * args.kv_sequence_length * H;
+        for (int s = 0; s < args.q_sequence_length; s++) {
+          const float* Q = args.query + ((size_t(b) * args.num_heads + n) * args.q_sequence_length + s) * H;
+          float* O = Output + ((size_t(b) * args.q_sequence_length + s) * args.num_heads + n) * H;
+
+          int Begin = 0;
+          int End = KvLength;
+          if (args.is_causal) {
+            End = std::min(End, s + Offset + 1);
+            if (args.local_window_size >= 0) {
+              Begin = std::max(Begin, s + Offset - args.local_window_size);
+            }
+          }
+
+          double MaximumValue = std::numeric_limits<double>::lowest();
+          for (int t = Begin; t < End; t++) {
+            double Dot = 0.0;
+            for (int h = 0; h < H; h++) {
+              Dot += double(Q[h]) * double(K[size_t(t) * H + h]);
+            }
+            Scores[t] = Dot * args.scale;
+            MaximumValue = std::max(MaximumValue, Scores[t]);
+          }
+
+          double Sum = 0.0;
+          for (int t = Begin; t < End; t++) {
+            Scores[t] = std::exp(Scores[t] - MaximumValue);
+            Sum += Scores[t];
+          }
+
+          for (int h = 0; h < H; h++) {
+            double Accumulator = 0.0;
+            for (int t = Begin; t < End; t++) {
+              Accumulator += Scores[t] * double(V[size_t(t) * H + h]);
+            }
+            O[h] = Sum > 0.0 ? float(Accumulator / Sum) : 0.0f;
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    // Dense, with a single block and with several blocks along each sequence.
+    Test(2, 4, 4, 17, 17, 16, 17, 17, false, false, -1);
+    Test(2, 4, 4, 17, 33, 16, 5, 7, false, false, -1);
+
+    // Causal prompt, then causal queries that are the last tokens of a longer sequence.
+    Test(2, 4, 4, 37, 37, 8, 8, 8, false, true, -1);
+    Test(1, 2, 2, 5, 64, 8, 4, 16, false, true, -1);
+
+    // Key padding, alone and with the causal mask.
+    Test(3, 2, 2, 9, 23, 8, 4, 8, true, false, -1);
+    Test(3, 2, 2, 23, 23, 8, 4, 8, true, true, -1);
+
+    // Grouped-query attention.
+    Test(2, 8, 2, 19, 19, 16, 8, 4, false, true, -1);
+    Test(2, 6, 1, 1, 40, 16, 1, 16, true, true, -1);
+
+    // Local window, smaller and larger than a block of keys.
+    Test(2, 4, 2, 31, 31, 8, 8, 8, true, true, 3);
+    Test(1, 4, 4, 3, 50, 8, 2, 4, false, true, 20);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSgemmBlockingTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  void Test(const MLAS_SGEMM_BLOCKING& Blocking, bool Packed, bool Threaded,
+            CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, float beta) {
+    const float* A = BufferA.GetBuffer(M * K);
+    const float* B = BufferB.GetBuffer(K * N);
+    float* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    MLAS_THREADPOOL* ThreadPool = Threaded ? GetMlasThreadPool() : nullptr;
+
+    std::fill_n(CReference, M * N, -0.5f);
+    MlasGemm(TransA, TransB, M, N, K, 1.0f, A, lda, B, ldb, beta, CReference, N, nullptr);
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = N;
+    Data.beta = beta;
+    Data.Blocking = &Blocking;
+
+    if (Packed) {
+      const size_t PackedBSize = MlasGemmPackBSize(N, K);
+      void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = ldb;
+    }
+
+    std::fill_n(C, M * N, -0.5f);
+    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, ThreadPool);
+
+    for (size_t f = 0; f < M * N; f++) {
+      ASSERT_TRUE(CloseEnough(C[f], CReference[f]))
+          << " Diff @[" << f / N << ", " << f % N << "] " << C[f] << " vs " << CReference[f]
+          << ", StrideN" << Blocking.StrideN << "xStrideK" << Blocking.StrideK
+          << (Packed ? "/Packed" : "/NoPack") << (Threaded ? "/Threaded" : "/SingleThread")
+          << (TransA == CblasTrans ? "/TransA" : "/A") << (TransB == CblasTrans ? "/TransB" : "/B")
+          << "/M" << M << "xN" << N << "xK" << K << "/Beta" << beta;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SGemmBlocking");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const MLAS_SGEMM_BLOCKING Blockings[] = {
+        {16, 1}, {16, 64}, {64, 256}, {128, 128}, {256, 256}, {512, 512}};
+
+    static const size_t Shapes[][3] = {
+        {1, 35, 17}, {7, 1, 19}, {13, 21, 3}, {16, 64, 128}, {33, 129, 257}, {130, 600, 47}, {70, 300, 700}};
+
+    for (const auto& Blocking : Blockings) {
+      for (const auto& Shape : Shapes) {
+        const size_t M = Shape[0];
+        const size_t N = Shape[1];
+        const size_t K = Shape[2];
+        Test(Blocking, false, false, CblasNoTrans, CblasNoTrans, M, N, K, 0.0f);
+        Test(Blocking, false, true, CblasTrans, CblasNoTrans, M, N, K, 1.0f);
+        Test(Blocking, false, true, CblasNoTrans, CblasTrans, M, N, K, 0.5f);
+        Test(Blocking, false, false, CblasTrans, CblasTrans, M, N, K, 0.0f);
+        Test(Blocking, true, false, CblasNoTrans, CblasNoTrans, M, N, K, 0.0f);
+        Test(Blocking, true, true, CblasTrans, CblasTrans, M, N, K, 1.0f);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSgemmBlockingTest>::RegisterShortExecute() : 0;
+});
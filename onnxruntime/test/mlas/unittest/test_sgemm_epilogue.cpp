@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <cmath>
+
+class MlasSgemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float Value) {
+    const double x = Value;
+    switch (Activation.ActivationKind) {
+      case MlasReluActivation:
+        return std::max(Value, 0.0f);
+      case MlasLeakyReluActivation:
+        return (Value >= 0.0f) ? Value : Value * Activation.Parameters.LeakyRelu.alpha;
+      case MlasTanhActivation:
+        return static_cast<float>(std::tanh(x));
+      case MlasLogisticActivation:
+        return static_cast<float>(1.0 / (1.0 + std::exp(-x)));
+      case MlasClipActivation:
+        return std::min(std::max(Value, Activation.Parameters.Clip.minimum), Activation.Parameters.Clip.maximum);
+      case MlasHardSigmoidActivation:
+        return std::min(std::max(Value * Activation.Parameters.HardSigmoid.alpha + Activation.Parameters.HardSigmoid.beta,
+                                 0.0f),
+                        1.0f);
+      case MlasGeluActivation:
+        return static_cast<float>(0.5 * x * (1.0 + std::erf(x * 0.70710678118654752440)));
+      case MlasSiluActivation:
+        return static_cast<float>(x / (1.0 + std::exp(-x)));
+      default:
+        return Value;
+    }
+  }
+
+  void Test(MLAS_ACTIVATION_KIND ActivationKind, bool HasBias, bool HasResidual, bool Packed, bool Threaded,
+            CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, float beta) {
+    const float* A = BufferA.GetBuffer(M * K);
+    const float* B = BufferB.GetBuffer(K * N);
+    const float* Bias = HasBias ? BufferBias.GetBuffer(N) : nullptr;
+    const size_t ldr = N + 3;
+    const float* Residual = HasResidual ? BufferResidual.GetBuffer(M * ldr) : nullptr;
+    float* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    MLAS_THREADPOOL* ThreadPool = Threaded ? GetMlasThreadPool() : nullptr;
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = Bias;
+    Epilogue.Residual = Residual;
+    Epilogue.ldr = ldr;
+    Epilogue.Activation.ActivationKind = ActivationKind;
+    if (ActivationKind == MlasLeakyReluActivation) {
+      Epilogue.Activation.Parameters.LeakyRelu.alpha = 0.2f;
+    } else if (ActivationKind == MlasClipActivation) {
+      Epilogue.Activation.Parameters.Clip.minimum = -0.5f;
+      Epilogue.Activation.Parameters.Clip.maximum = 0.75f;
+    } else if (ActivationKind == MlasHardSigmoidActivation) {
+      Epilogue.Activation.Parameters.HardSigmoid.alpha = 0.2f;
+      Epilogue.Activation.Parameters.HardSigmoid.beta = 0.5f;
+    }
+
+    //
+    // Compute the reference output with a plain GEMM and a scalar epilogue.
+    //
+
+    std::fill_n(CReference, M * N, -0.25f);
+    MlasGemm(TransA, TransB, M, N, K, 1.0f, A, lda, B, ldb, beta, CReference, N, nullptr);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float Value = CReference[m * N + n];
+        if (Bias != nullptr) {
+          Value += Bias[n];
+        }
+        Value = ReferenceActivation(Epilogue.Activation, Value);
+        if (Residual != nullptr) {
+          Value += Residual[m * ldr + n];
+        }
+        CReference[m * N + n] = Value;
+      }
+    }
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = N;
+    Data.beta = beta;
+    Data.Epilogue = &Epilogue;
+
+    if (Packed) {
+      const size_t PackedBSize = MlasGemmPackBSize(N, K);
+      void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = ldb;
+    }
+
+    std::fill_n(C, M * N, -0.25f);
+    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, ThreadPool);
+
+    for (size_t f = 0; f < M * N; f++) {
+      ASSERT_TRUE(CloseEnough(C[f], CReference[f]))
+          << " Diff @[" << f / N << ", " << f % N << "] " << C[f] << " vs " << CReference[f]
+          << ", Activation" << int(ActivationKind) << (HasBias ? "/Bias" : "") << (HasResidual ? "/Residual" : "")
+          << (Packed ? "/Packed" : "/NoPack") << (Threaded ? "/Threaded" : "/SingleThread")
+          << (TransA == CblasTrans ? "/TransA" : "/A") << (TransB == CblasTrans ? "/TransB" : "/B")
+          << "/M" << M << "xN" << N << "xK" << K << "/Beta" << beta;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SGemmEpilogue");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 35, 17}, {1, 300, 64}, {7, 1, 19}, {13, 21, 3},
+        {16, 64, 128}, {33, 129, 257}, {64, 300, 8}, {130, 47, 600}, {5, 17, 0}};
+
+    for (unsigned kind = 0; kind < unsigned(MlasActivationKindCount); kind++) {
+      for (const auto& Shape : Shapes) {
+        const size_t M = Shape[0];
+        const size_t N = Shape[1];
+        const size_t K = Shape[2];
+        for (int mode = 0; mode < 4; mode++) {
+          const bool HasBias = (mode & 1) != 0;
+          const bool HasResidual = (mode & 2) != 0;
+          const auto Kind = MLAS_ACTIVATION_KIND(kind);
+          Test(Kind, HasBias, HasResidual, false, false, CblasNoTrans, CblasNoTrans, M, N, K, 0.0f);
+          Test(Kind, HasBias, HasResidual, false, true, CblasTrans, CblasNoTrans, M, N, K, 1.0f);
+          Test(Kind, HasBias, HasResidual, false, true, CblasNoTrans, CblasTrans, M, N, K, 0.5f);
+          if (K != 0) {
+            Test(Kind, HasBias, HasResidual, true, false, CblasNoTrans, CblasNoTrans, M, N, K, 0.0f);
+            Test(Kind, HasBias, HasResidual, true, true, CblasTrans, CblasTrans, M, N, K, 1.0f);
+          }
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSgemmEpilogueTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSgemmSmallTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  void ReferenceSgemm(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, float alpha,
+                      const float* A, size_t lda, const float* B, size_t ldb, float beta, float* C, size_t ldc) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const float a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+          const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+          sum += double(a) * double(b);
+        }
+        float& c = C[m * ldc + n];
+        c = float(alpha * sum) + ((beta != 0.0f) ? beta * c : 0.0f);
+      }
+    }
+  }
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t BatchSize, size_t M, size_t N, size_t K,
+            float alpha, float beta, bool Threaded) {
+    // Matrices without padding check that no element after the end of a matrix is read.
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K + 1;
+    const size_t ldc = N + 3;
+    const size_t SizeA = M * K;
+    const size_t SizeB = (TransB == CblasNoTrans) ? K * N : N * ldb;
+    const size_t SizeC = M * ldc;
+
+    const float* A = BufferA.GetBuffer(BatchSize * SizeA);
+    const float* B = BufferB.GetBuffer(BatchSize * SizeB);
+    float* C = BufferC.GetBuffer(BatchSize * SizeC, true);
+    float* CReference = BufferCReference.GetBuffer(BatchSize * SizeC, true);
+
+    std::fill_n(C, BatchSize * SizeC, -0.5f);
+    std::fill_n(CReference, BatchSize * SizeC, -0.5f);
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t b = 0; b < BatchSize; b++) {
+      Data[b].A = A + b * SizeA;
+      Data[b].lda = lda;
+      Data[b].B = B + b * SizeB;
+      Data[b].ldb = ldb;
+      Data[b].C = C + b * SizeC;
+      Data[b].ldc = ldc;
+      Data[b].alpha = alpha;
+      Data[b].beta = beta;
+
+      ReferenceSgemm(TransA, TransB, M, N, K, alpha, A + b * SizeA, lda, B + b * SizeB, ldb, beta,
+                     CReference + b * SizeC, ldc);
+    }
+
+    MlasGemmBatch(TransA, TransB, M, N, K, Data.data(), BatchSize, Threaded ? GetMlasThreadPool() : nullptr);
+
+    for (size_t f = 0; f < BatchSize * SizeC; f++) {
+      ASSERT_TRUE(CloseEnough(C[f], CReference[f]))
+          << " Diff @[" << f / SizeC << ", " << (f % SizeC) / ldc << ", " << f % ldc << "] " << C[f] << " vs "
+          << CReference[f] << (TransA == CblasTrans ? ", TransA" : ", A") << (TransB == CblasTrans ? "/TransB" : "/B")
+          << "/Batch" << BatchSize << "/M" << M << "xN" << N << "xK" << K << "/Alpha" << alpha << "/Beta" << beta
+          << (Threaded ? "/Threaded" : "/SingleThread");
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SGemmSmall");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 64, 64}, {7, 17, 9}, {2, 32, 32}, {3, 31, 32}, {5, 17, 30}, {13, 29, 31}, {7, 40, 33},
+        {13, 33, 31}, {16, 16, 16}, {32, 20, 24}, {32, 32, 32}, {64, 1, 64}, {64, 64, 64}};
+
+    for (const auto& Shape : Shapes) {
+      const size_t M = Shape[0];
+      const size_t N = Shape[1];
+      const size_t K = Shape[2];
+      Test(CblasNoTrans, CblasNoTrans, 1, M, N, K, 1.0f, 0.0f, false);
+      Test(CblasNoTrans, CblasTrans, 5, M, N, K, 1.0f, 0.0f, true);
+      Test(CblasTrans, CblasNoTrans, 3, M, N, K, 0.5f, 1.0f, true);
+      Test(CblasTrans, CblasTrans, 2, M, N, K, -1.0f, 0.25f, false);
+      Test(CblasNoTrans, CblasNoTrans, 67, M, N, K, 2.0f, -1.0f, true);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSgemmSmallTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSparseSgemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  std::default_random_engine generator_{42};
+
+  // Fills the K x N matrix B, stored transposed if TransB, with zero 1x8 blocks
+  // (BlockK 1) or zero 4x8 blocks (BlockK 4) at a rate of ZeroFraction, or with
+  // a 2:4 pattern (BlockK 0).
+  void FillSparseB(float* B, CBLAS_TRANSPOSE TransB, size_t N, size_t K, size_t BlockK, float ZeroFraction) {
+    std::uniform_real_distribution<float> value_distribution(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> zero_distribution(0.0f, 1.0f);
+
+    std::vector<float> Dense(K * N);
+    for (auto& v : Dense) {
+      v = value_distribution(generator_);
+    }
+
+    if (BlockK == 0) {
+      for (size_t n = 0; n < N; n++) {
+        for (size_t k = 0; k < K; k += 4) {
+          // Keep 0, 1 or 2 elements of each group.
+          const size_t keep = std::uniform_int_distribution<size_t>(0, 2)(generator_);
+          std::vector<size_t> positions{0, 1, 2, 3};
+          std::shuffle(positions.begin(), positions.end(), generator_);
+          for (size_t q = keep; q < 4; q++) {
+            if (k + positions[q] < K) {
+              Dense[(k + positions[q]) * N + n] = 0.0f;
+            }
+          }
+        }
+      }
+    } else {
+      for (size_t n = 0; n < N; n += 8) {
+        for (size_t k = 0; k < K; k += BlockK) {
+          if (zero_distribution(generator_) < ZeroFraction) {
+            for (size_t kk = k; kk < std::min(k + BlockK, K); kk++) {
+              for (size_t nn = n; nn < std::min(n + 8, N); nn++) {
+                Dense[kk * N + nn] = 0.0f;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    for (size_t k = 0; k < K; k++) {
+      for (size_t n = 0; n < N; n++) {
+        if (TransB == CblasNoTrans) {
+          B[k * N + n] = Dense[k * N + n];
+        } else {
+          B[n * K + k] = Dense[k * N + n];
+        }
+      }
+    }
+  }
+
+  void Test(MLAS_SPARSE_SGEMM_FORMAT Format, CBLAS_TRANSPOSE TransB, size_t BatchSize, size_t M, size_t N, size_t K,
+            float alpha, float beta, bool Threaded) {
+    // Rows of A without padding check that no element after the end of a row is read.
+    const size_t lda = (TransB == CblasNoTrans) ? K : K + 3;
+    const size_t ldc = N + 5;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+    const size_t BlockK = (Format == MlasSparseSgemmBlock1x8) ? 1 : (Format == MlasSparseSgemmBlock4x8) ? 4 : 0;
+
+    const float* A = BufferA.GetBuffer(BatchSize * M * lda);
+    float* B = BufferB.GetBuffer(K * N, true);
+    float* C = BufferC.GetBuffer(BatchSize * M * ldc, true);
+    float* CReference = BufferCReference.GetBuffer(BatchSize * M * ldc, true);
+
+    FillSparseB(B, TransB, N, K, BlockK, 0.7f);
+
+    const size_t PackedBSize = MlasSparseSgemmPackBSize(Format, TransB, N, K, B, ldb);
+    ASSERT_GT(PackedBSize, 0u);
+    void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+    MlasSparseSgemmPackB(Format, TransB, N, K, B, ldb, PackedB);
+
+    std::fill_n(C, BatchSize * M * ldc, -0.5f);
+    std::fill_n(CReference, BatchSize * M * ldc, -0.5f);
+
+    std::vector<MLAS_SPARSE_SGEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t b = 0; b < BatchSize; b++) {
+      Data[b].A = A + b * M * lda;
+      Data[b].lda = lda;
+      Data[b].PackedB = PackedB;
+      Data[b].C = C + b * M * ldc;
+      Data[b].ldc = ldc;
+      Data[b].alpha = alpha;
+      Data[b].beta = beta;
+
+      MlasGemm(CblasNoTrans, TransB, M, N, K, alpha, A + b * M * lda, lda, B, ldb, beta,
+               CReference + b * M * ldc, ldc, nullptr);
+    }
+
+    MlasSparseSgemmBatch(M, N, K, Data.data(), BatchSize, Threaded ? GetMlasThreadPool() : nullptr);
+
+    for (size_t f = 0; f < BatchSize * M * ldc; f++) {
+      ASSERT_TRUE(CloseEnough(C[f], CReference[f]))
+          << " Diff @[" << f / ldc << ", " << f % ldc << "] " << C[f] << " vs " << CReference[f]
+          << ", Format" << int(Format) << (TransB == CblasTrans ? "/TransB" : "/B") << "/Batch" << BatchSize
+          << "/M" << M << "xN" << N << "xK" << K << "/Alpha" << alpha << "/Beta" << beta
+          << (Threaded ? "/Threaded" : "/SingleThread");
+    }
+  }
+
+  void TestAnalysis() {
+    constexpr size_t N = 20;
+    constexpr size_t K = 10;
+    float* B = BufferB.GetBuffer(K * N, true);
+
+    // Only B[1][3] and B[6][17] are non-zero.
+    B[1 * N + 3] = 1.0f;
+    B[6 * N + 17] = -2.0f;
+
+    MLAS_SPARSE_SGEMM_ANALYSIS Analysis;
+    MlasSparseSgemmAnalyzeB(CblasNoTrans, N, K, B, N, &Analysis);
+
+    EXPECT_FLOAT_EQ(Analysis.ZeroFraction, 1.0f - 2.0f / (N * K));
+    EXPECT_FLOAT_EQ(Analysis.ZeroBlockFraction1x8, 1.0f - 2.0f / (3 * K));
+    EXPECT_FLOAT_EQ(Analysis.ZeroBlockFraction4x8, 1.0f - 2.0f / (3 * 3));
+    EXPECT_TRUE(Analysis.Structured2x4);
+
+    MLAS_SPARSE_SGEMM_FORMAT Format;
+    EXPECT_TRUE(MlasSparseSgemmSelectFormat(&Analysis, 0.5f, &Format));
+    EXPECT_FALSE(MlasSparseSgemmSelectFormat(&Analysis, 1.0f, &Format));
+
+    // Three non-zero elements in the group of rows 4 to 7 of column 17.
+    B[4 * N + 17] = 1.0f;
+    B[5 * N + 17] = 1.0f;
+    MlasSparseSgemmAnalyzeB(CblasNoTrans, N, K, B, N, &Analysis);
+    EXPECT_FALSE(Analysis.Structured2x4);
+    EXPECT_EQ(MlasSparseSgemmPackBSize(MlasSparseSgemmStructured2x4, CblasNoTrans, N, K, B, N), 0u);
+
+    // A dense matrix is not selected.
+    std::fill_n(B, K * N, 1.0f);
+    MlasSparseSgemmAnalyzeB(CblasNoTrans, N, K, B, N, &Analysis);
+    EXPECT_FLOAT_EQ(Analysis.ZeroFraction, 0.0f);
+    EXPECT_FALSE(MlasSparseSgemmSelectFormat(&Analysis, 0.0f, &Format));
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SparseSgemm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    TestAnalysis();
+
+    static const MLAS_SPARSE_SGEMM_FORMAT Formats[] = {
+        MlasSparseSgemmBlock1x8, MlasSparseSgemmBlock4x8, MlasSparseSgemmStructured2x4};
+
+    static const size_t Shapes[][3] = {
+        {1, 1, 4}, {1, 8, 16}, {3, 13, 7}, {5, 16, 35}, {8, 24, 64}, {9, 31, 129}, {17, 64, 33}, {37, 100, 250}};
+
+    for (const auto Format : Formats) {
+      for (const auto& Shape : Shapes) {
+        const size_t M = Shape[0];
+        const size_t N = Shape[1];
+        const size_t K = Shape[2];
+        Test(Format, CblasNoTrans, 1, M, N, K, 1.0f, 0.0f, false);
+        Test(Format, CblasTrans, 1, M, N, K, 1.0f, 0.0f, true);
+        Test(Format, CblasNoTrans, 3, M, N, K, 0.5f, 1.0f, true);
+        Test(Format, CblasTrans, 2, M, N, K, -1.0f, 0.25f, false);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSparseSgemmTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+
+class MlasTranscendentalTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferInput2;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  using UnaryFunction = void(MLASCALL*)(const float*, float*, size_t);
+  using ReferenceFunction = std::function<double(double)>;
+
+  static constexpr float Infinity = std::numeric_limits<float>::infinity();
+  static constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+
+  // Returns the error of Output in units of the last place of the single
+  // precision Reference. Denormal results are measured in units of the
+  // smallest denormal.
+  static double UlpError(float Output, double Reference) {
+    if (std::isnan(Reference)) {
+      return std::isnan(Output) ? 0.0 : Infinity;
+    }
+
+    if (std::isinf(static_cast<float>(Reference))) {
+      return (Output == static_cast<float>(Reference)) ? 0.0 : Infinity;
+    }
+
+    int Exponent;
+    std::frexp(Reference, &Exponent);
+    double Ulp = std::ldexp(1.0, std::max(Exponent - 24, -149));
+
+    return std::fabs(static_cast<double>(Output) - Reference) / Ulp;
+  }
+
+  void TestUnary(const char* Name, UnaryFunction Function, const ReferenceFunction& Reference, double MaximumUlp,
+                 size_t N, float MinimumValue, float MaximumValue) {
+    float* Input = BufferInput.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = distribution(generator);
+    }
+
+    Function(Input, Output, N);
+
+    for (size_t n = 0; n < N; n++) {
+      double Error = UlpError(Output[n], Reference(Input[n]));
+      ASSERT_LE(Error, MaximumUlp) << Name << " @" << n << " of " << N << ", input: " << Input[n]
+                                   << ", got: " << Output[n] << ", expecting: " << Reference(Input[n]);
+    }
+  }
+
+  void TestSpecialValues(const char* Name, UnaryFunction Function, const ReferenceFunction& Reference,
+                         std::vector<float> Values) {
+    std::vector<float> Output(Values.size());
+
+    Function(Values.data(), Output.data(), Values.size());
+
+    for (size_t n = 0; n < Values.size(); n++) {
+      const float Expected = static_cast<float>(Reference(Values[n]));
+      if (std::isnan(Expected)) {
+        ASSERT_TRUE(std::isnan(Output[n])) << Name << " input: " << Values[n] << ", got: " << Output[n];
+      } else {
+        ASSERT_LE(UlpError(Output[n], Reference(Values[n])), 8.0)
+            << Name << " input: " << Values[n] << ", got: " << Output[n] << ", expecting: " << Expected;
+        ASSERT_EQ(std::signbit(Output[n]), std::signbit(Expected)) << Name << " input: " << Values[n];
+      }
+    }
+  }
+
+  void TestPow(size_t N, bool BroadcastBase, bool BroadcastExponent) {
+    float* Base = BufferInput.GetBuffer(N);
+    float* Exponent = BufferInput2.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> base_distribution(0.01f, 100.0f);
+    std::uniform_real_distribution<float> exponent_distribution(-15.0f, 15.0f);
+
+    for (size_t n = 0; n < N; n++) {
+      Base[n] = base_distribution(generator);
+      Exponent[n] = exponent_distribution(generator);
+    }
+
+    MlasComputePow(Base, Exponent, Output, N, BroadcastBase, BroadcastExponent);
+
+    for (size_t n = 0; n < N; n++) {
+      const double b = BroadcastBase ? Base[0] : Base[n];
+      const double e = BroadcastExponent ? Exponent[0] : Exponent[n];
+      ASSERT_LE(UlpError(Output[n], std::pow(b, e)), 2.0)
+          << "Pow @" << n << " of " << N << ", base: " << b << ", exponent: " << e << ", got: " << Output[n];
+    }
+  }
+
+  void TestPowSpecialValues() {
+    const std::vector<float> Values{0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.0f, -2.0f, 3.0f, -3.0f,
+                                    2.5f, -2.5f, 1e30f, -1e30f, 1e-30f, Infinity, -Infinity, NaN, 1e7f};
+
+    std::vector<float> Base;
+    std::vector<float> Exponent;
+
+    for (float b : Values) {
+      for (float e : Values) {
+        Base.push_back(b);
+        Exponent.push_back(e);
+      }
+    }
+
+    std::vector<float> Output(Base.size());
+    MlasComputePow(Base.data(), Exponent.data(), Output.data(), Base.size(), false, false);
+
+    for (size_t n = 0; n < Base.size(); n++) {
+      const float Expected = std::pow(Base[n], Exponent[n]);
+      if (std::isnan(Expected)) {
+        ASSERT_TRUE(std::isnan(Output[n])) << "Pow(" << Base[n] << ", " << Exponent[n] << "), got: " << Output[n];
+      } else {
+        ASSERT_LE(UlpError(Output[n], std::pow(static_cast<double>(Base[n]), static_cast<double>(Exponent[n]))), 2.0)
+            << "Pow(" << Base[n] << ", " << Exponent[n] << "), got: " << Output[n] << ", expecting: " << Expected;
+        ASSERT_EQ(std::signbit(Output[n]), std::signbit(Expected)) << "Pow(" << Base[n] << ", " << Exponent[n] << ")";
+      }
+    }
+  }
+
+  static double Softplus(double x) {
+    return std::max(x, 0.0) + std::log1p(std::exp(-std::fabs(x)));
+  }
+
+  static double Mish(double x) {
+    return std::isinf(x) ? (x > 0 ? x : -0.0) : x * std::tanh(Softplus(x));
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Transcendental");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    const ReferenceFunction Sin = [](double x) { return std::sin(x); };
+    const ReferenceFunction Cos = [](double x) { return std::cos(x); };
+    const ReferenceFunction Log = [](double x) { return std::log(x); };
+    const ReferenceFunction Sqrt = [](double x) { return std::sqrt(x); };
+    const ReferenceFunction Reciprocal = [](double x) { return 1.0 / x; };
+
+    for (size_t n = 1; n < 72; n++) {
+      TestUnary("Sin", MlasComputeSin, Sin, 2.5, n, -10.f, 10.f);
+      TestUnary("Cos", MlasComputeCos, Cos, 2.5, n, -10.f, 10.f);
+      TestUnary("Log", MlasComputeLog, Log, 3.5, n, 0.f, 10.f);
+      TestUnary("Sqrt", MlasComputeSqrt, Sqrt, 0.5, n, 0.f, 1000.f);
+      TestUnary("Reciprocal", MlasComputeReciprocal, Reciprocal, 0.5, n, -100.f, 100.f);
+      TestUnary("Softplus", MlasComputeSoftplus, Softplus, 5.5, n, -20.f, 20.f);
+      TestUnary("Mish", MlasComputeMish, Mish, 5.0, n, -20.f, 20.f);
+      TestPow(n, false, false);
+      TestPow(n, true, false);
+      TestPow(n, false, true);
+    }
+
+    // Large arguments exercise the reduction ranges and the C runtime fallback.
+    TestUnary("Sin", MlasComputeSin, Sin, 2.5, 1000, -1e6f, 1e6f);
+    TestUnary("Cos", MlasComputeCos, Cos, 2.5, 1000, -1e6f, 1e6f);
+    TestUnary("Sin", MlasComputeSin, Sin, 2.5, 1000, -1e30f, 1e30f);
+    TestUnary("Log", MlasComputeLog, Log, 3.5, 1000, 0.f, 1e38f);
+    TestUnary("Log", MlasComputeLog, Log, 3.5, 1000, 0.f, 1e-37f);
+    TestUnary("Softplus", MlasComputeSoftplus, Softplus, 5.5, 1000, -100.f, 100.f);
+    TestUnary("Mish", MlasComputeMish, Mish, 5.0, 1000, -80.f, 100.f);
+
+    TestSpecialValues("Sin", MlasComputeSin, Sin, {0.0f, -0.0f, Infinity, -Infinity, NaN});
+    TestSpecialValues("Cos", MlasComputeCos, Cos, {0.0f, -0.0f, Infinity, -Infinity, NaN});
+    TestSpecialValues("Log", MlasComputeLog, Log, {0.0f, -0.0f, 1.0f, -1.0f, 1e-45f, Infinity, -Infinity, NaN});
+    TestSpecialValues("Sqrt", MlasComputeSqrt, Sqrt, {0.0f, -0.0f, -1.0f, Infinity, -Infinity, NaN});
+    TestSpecialValues("Reciprocal", MlasComputeReciprocal, Reciprocal, {0.0f, -0.0f, Infinity, -Infinity, NaN});
+    TestSpecialValues("Softplus", MlasComputeSoftplus, Softplus, {0.0f, -200.0f, 200.0f, Infinity, -Infinity, NaN});
+    TestSpecialValues("Mish", MlasComputeMish, Mish, {0.0f, -0.0f, -200.0f, 200.0f, Infinity, -Infinity, NaN});
+    TestPowSpecialValues();
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  // no long execute needed
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasTranscendentalTest>::RegisterShortExecute() : 0;
+});
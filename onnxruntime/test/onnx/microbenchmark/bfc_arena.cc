@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+#include <core/framework/allocator.h>
+#include <core/framework/bfc_arena.h>
+
+#include <vector>
+
+using namespace onnxruntime;
+
+// Measures the cost of the small allocations that kernels make for temporary buffers when several threads share one
+// arena, with and without the per-thread cache of freed chunks.
+//
+// Arg 0: thread_cache_max_bytes of the arena, 0 disables the per-thread cache.
+// Arg 1: allocation size in bytes.
+// Arg 2: number of allocations each thread keeps live before freeing them.
+
+static BFCArena& GetSharedArena(size_t thread_cache_max_bytes) {
+  // Shared by all the threads of a benchmark run so that they contend on it. Intentionally leaked.
+  static BFCArena* arena_without_cache =
+      new BFCArena(std::make_unique<CPUAllocator>(), BFCArena::DEFAULT_MAX_MEM);
+  static BFCArena* arena_with_cache =
+      new BFCArena(std::make_unique<CPUAllocator>(), BFCArena::DEFAULT_MAX_MEM,
+                   BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+                   BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                   BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                   BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                   BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+                   1024 * 1024);
+  return thread_cache_max_bytes == 0 ? *arena_without_cache : *arena_with_cache;
+}
+
+static void BM_BFCArenaAllocFree(benchmark::State& state) {
+  BFCArena& arena = GetSharedArena(static_cast<size_t>(state.range(0)));
+  const size_t size = static_cast<size_t>(state.range(1));
+  const size_t live = static_cast<size_t>(state.range(2));
+
+  std::vector<void*> ptrs(live);
+  for (auto _ : state) {
+    for (size_t i = 0; i < live; ++i) {
+      ptrs[i] = arena.Alloc(size);
+    }
+    benchmark::DoNotOptimize(ptrs.data());
+    for (size_t i = 0; i < live; ++i) {
+      arena.Free(ptrs[i]);
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * live));
+}
+
+BENCHMARK(BM_BFCArenaAllocFree)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kNanosecond)
+    ->ArgNames({"thread_cache", "size", "live"})
+    ->ArgsProduct({{0, 1024 * 1024}, {256, 4096, 65536}, {1, 8}})
+    ->ThreadRange(1, 8);
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <core/framework/allocator.h>
+#include <core/platform/env.h>
+#include <core/platform/threadpool.h>
+#include <core/util/thread_utils.h>
+#include <mlas.h>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <pthread.h>
+#endif
+
+#include <vector>
+
+using namespace onnxruntime;
+using namespace onnxruntime::concurrency;
+
+// Measures the cross-socket memory traffic that NUMA-aware execution saves on a large, memory bound GEMM: the
+// pre-packed weights are read by the threads of node 0 from the memory of node 0 (local) or of another node (remote),
+// as happens without, respectively with, session.numa_replicate_weights when the weights were packed on the other
+// node. The loop runs on a NUMA-aware intra-op thread pool, so all the threads that compute it belong to node 0.
+//
+// Arg 0: M, the number of rows of A. Small values make the GEMM bound by the bandwidth of reading B.
+// Arg 1: N and K.
+// Arg 2: 0 to place B on node 0, 1 to place it on another node.
+
+static void BM_NumaSgemmPackedB(benchmark::State& state) {
+  const auto numa_nodes = Env::Default().GetNumaNodes();
+  std::vector<int> nodes_with_processors;
+  for (size_t node = 0; node < numa_nodes.size(); ++node) {
+    if (!numa_nodes[node].empty()) {
+      nodes_with_processors.push_back(static_cast<int>(node));
+    }
+  }
+  if (nodes_with_processors.size() < 2) {
+    state.SkipWithError("The host has a single NUMA node");
+    return;
+  }
+
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = N;
+  const int local_node = nodes_with_processors[0];
+  const int b_node = state.range(2) == 0 ? local_node : nodes_with_processors[1];
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  // Start the loops from node 0, so that they run on its threads.
+  cpu_set_t original_cpuset;
+  pthread_getaffinity_np(pthread_self(), sizeof(original_cpuset), &original_cpuset);
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int cpu : numa_nodes[local_node]) {
+    CPU_SET(cpu, &cpuset);
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+#endif
+
+  OrtThreadPoolParams tpo;
+  tpo.numa_aware = true;
+  std::unique_ptr<ThreadPool> tp(CreateThreadPool(&Env::Default(), tpo, ThreadPoolType::INTRA_OP));
+
+  CPUAllocator allocator;
+  std::vector<float> A(M * K, 0.5f);
+  std::vector<float> B(N * K, 0.25f);
+  std::vector<float> C(M * N);
+
+  const size_t packed_b_size = MlasGemmPackBSize(N, K);
+  void* packed_b = allocator.Alloc(packed_b_size);
+  // Bind before packing touches the pages, so that they are allocated on the requested node.
+  auto status = Env::Default().BindMemoryToNumaNode(packed_b, packed_b_size, b_node);
+  if (!status.IsOK()) {
+    allocator.Free(packed_b);
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+  MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, packed_b);
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.BIsPacked = true;
+  data.A = A.data();
+  data.lda = K;
+  data.B = static_cast<const float*>(packed_b);
+  data.ldb = 0;
+  data.C = C.data();
+  data.ldc = N;
+  data.alpha = 1.0f;
+  data.beta = 0.0f;
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, data, tp.get());
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packed_b_size));
+  allocator.Free(packed_b);
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  pthread_setaffinity_np(pthread_self(), sizeof(original_cpuset), &original_cpuset);
+#endif
+}
+
+BENCHMARK(BM_NumaSgemmPackedB)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->ArgNames({"M", "NK", "remote"})
+    ->ArgsProduct({{1, 16, 128}, {2048, 4096}, {0, 1}});
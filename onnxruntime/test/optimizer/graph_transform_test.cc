@@ -5,6 +5,9 @@
 #pragma warning(disable : 4244)
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <random>
 
 #include "gtest/gtest.h"
@@ -38,6 +41,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gather_fusion.h"
@@ -50,6 +54,7 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/isinf_reducesum_fusion.h"
@@ -5528,6 +5533,413 @@ TEST_F(GraphTransformationTests, QuickGelu) {
   }
 }
 
+static void BuildElementwiseRegionsTestCase(ModelTestBuilder& builder) {
+  auto* x_arg = builder.MakeInput<float>({2, 3, 8}, -1.0f, 1.0f);
+  auto* bias_arg = builder.MakeInitializer<float>({8}, -1.0f, 1.0f);
+  auto* condition_arg = builder.MakeInputBool({2, 3, 1});
+  auto* add_out = builder.MakeIntermediate();
+  auto* relu_out = builder.MakeIntermediate();
+  auto* mul_out = builder.MakeIntermediate();
+  auto* sigmoid_out = builder.MakeIntermediate();
+  auto* where_out = builder.MakeOutput();
+  auto* exp_out = builder.MakeOutput();
+
+  // Add, Relu and Mul form one region. Mul feeds two regions: Sigmoid and Where, and Exp alone.
+  builder.AddNode("Add", {x_arg, bias_arg}, {add_out});
+  builder.AddNode("Relu", {add_out}, {relu_out});
+  builder.AddNode("Mul", {add_out, relu_out}, {mul_out});
+  builder.AddNode("Sigmoid", {mul_out}, {sigmoid_out});
+  builder.AddNode("Where", {condition_arg, sigmoid_out, x_arg}, {where_out});
+  builder.AddNode("Exp", {mul_out}, {exp_out});
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion) {
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Where"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Exp"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Where"] == 0);
+
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() != "FusedElementwise") {
+        continue;
+      }
+      const auto& attrs = node.GetAttributes();
+      const auto& ops = attrs.at("ops").strings();
+      const auto& operands = attrs.at("operands").ints();
+      if (ops.size() == 3) {
+        // x, bias -> Add(0, 1) = 2, Relu(2) = 3, Mul(2, 3)
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 2);
+        TEST_RETURN_IF_NOT(ops[0] == "Add" && ops[1] == "Relu" && ops[2] == "Mul");
+        TEST_RETURN_IF_NOT((std::vector<int64_t>(operands.begin(), operands.end()) ==
+                            std::vector<int64_t>{0, 1, 2, 2, 3}));
+      } else {
+        // mul_out, condition, x -> Sigmoid(0) = 3, Where(1, 3, 2)
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 3);
+        TEST_RETURN_IF_NOT(ops.size() == 2 && ops[0] == "Sigmoid" && ops[1] == "Where");
+        TEST_RETURN_IF_NOT((std::vector<int64_t>(operands.begin(), operands.end()) ==
+                            std::vector<int64_t>{0, 1, 3, 2}));
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(BuildElementwiseRegionsTestCase, 14, *logger_, std::move(transformer),
+                                        TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion_BroadcastProducer) {
+  // Exp produces a smaller shape than its consumer and would be recomputed for every row, so it is not fused.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({4, 16}, -1.0f, 1.0f);
+    auto* bias_arg = builder.MakeInput<float>({16}, -1.0f, 1.0f);
+    auto* exp_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeOutput();
+
+    builder.AddNode("Exp", {bias_arg}, {exp_out});
+    builder.AddNode("Mul", {x_arg, exp_out}, {mul_out});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Exp"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 1);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                        TransformerLevel::Level3, 1, nullptr, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion_ResultsMatch) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 2);
+  };
+  auto add_session_options = [](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsEnableElementwiseFusion, "1"));
+  };
+
+  TransformerTester(BuildElementwiseRegionsTestCase, check_graph, TransformerLevel::Level2, TransformerLevel::Level3,
+                    14, 1e-5, 1e-5, nullptr, add_session_options);
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion_DisabledByDefault) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 0);
+  };
+
+  TransformerTester(BuildElementwiseRegionsTestCase, check_graph, TransformerLevel::Level2, TransformerLevel::Level3,
+                    14, 1e-5, 1e-5);
+}
+
+enum class DecomposedAttentionMask {
+  kCausal,         // constant causal table
+  kCausalTrilu,    // causal mask computed by Trilu from the dynamic shapes
+  kSlidingWindow,  // constant table of a causal sliding window of 2 keys
+  kBidirectional,  // constant table that masks no key
+};
+
+// Builds the attention of a decoder layer as exported from a HF model, with 3 new tokens and 2 past tokens by default.
+// The first rotary_dim dims of each head of the query and key are rotated, like in Phi if rotary_dim < head_size.
+// The mask is the sum of the mask of mask_kind and the padding mask computed from attention_mask, which is all ones
+// if empty.
+static void BuildDecomposedAttentionTestCase(ModelTestBuilder& builder, int64_t num_heads, int64_t kv_num_heads,
+                                             int64_t head_size, int64_t rotary_dim, bool scale_by_div,
+                                             DecomposedAttentionMask mask_kind = DecomposedAttentionMask::kCausal,
+                                             int64_t batch_size = 1, int64_t sequence_length = 3,
+                                             int64_t past_sequence_length = 2,
+                                             std::vector<int64_t> attention_mask = {}) {
+  const int64_t total_sequence_length = sequence_length + past_sequence_length;
+  constexpr int64_t max_position = 8;
+  constexpr int64_t input_hidden_size = 16;
+  if (attention_mask.empty()) {
+    attention_mask.resize(static_cast<size_t>(batch_size * total_sequence_length), 1);
+  }
+
+  // The positions of the tokens count the keys that are not padding, like the position_ids of HF generation.
+  std::vector<int64_t> position_ids;
+  for (int64_t b = 0; b < batch_size; ++b) {
+    for (int64_t i = 0; i < sequence_length; ++i) {
+      const auto mask_row = attention_mask.begin() + b * total_sequence_length;
+      const int64_t position = std::accumulate(mask_row, mask_row + past_sequence_length + i + 1, int64_t{0}) - 1;
+      position_ids.push_back(std::max<int64_t>(position, 0));
+    }
+  }
+
+  auto* input_arg = builder.MakeInput<float>({batch_size, sequence_length, input_hidden_size}, -1.0f, 1.0f);
+  auto* position_ids_arg = builder.MakeInput<int64_t>({batch_size, sequence_length}, position_ids);
+  auto* attention_mask_arg = builder.MakeInput<int64_t>({batch_size, total_sequence_length}, attention_mask);
+  auto* past_key_arg = builder.MakeInput<float>({batch_size, kv_num_heads, past_sequence_length, head_size},
+                                                -1.0f, 1.0f);
+  auto* past_value_arg = builder.MakeInput<float>({batch_size, kv_num_heads, past_sequence_length, head_size},
+                                                  -1.0f, 1.0f);
+  auto* output_arg = builder.MakeOutput();
+  auto* present_key_arg = builder.MakeOutput();
+  auto* present_value_arg = builder.MakeOutput();
+
+  auto make_int64 = [&builder](std::vector<int64_t> values) {
+    return builder.MakeInitializer<int64_t>({static_cast<int64_t>(values.size())}, values);
+  };
+  auto add_node = [&builder](const std::string& op_type, const std::vector<NodeArg*>& inputs) {
+    auto* output = builder.MakeIntermediate();
+    return std::make_pair(&builder.AddNode(op_type, inputs, {output}), output);
+  };
+  auto add = [&add_node](const std::string& op_type, const std::vector<NodeArg*>& inputs) {
+    return add_node(op_type, inputs).second;
+  };
+  auto slice = [&](NodeArg* x, int64_t start, int64_t end) {
+    return add("Slice", {x, make_int64({start}), make_int64({end}), make_int64({-1})});
+  };
+
+  // cos_cached and sin_cached are the concatenation of two copies of the frequencies.
+  std::vector<float> cos_table;
+  std::vector<float> sin_table;
+  for (int64_t position = 0; position < max_position; ++position) {
+    for (int64_t i = 0; i < rotary_dim; ++i) {
+      const float frequency = std::pow(10000.0f, -2.0f * static_cast<float>(i % (rotary_dim / 2)) / rotary_dim);
+      cos_table.push_back(std::cos(position * frequency));
+      sin_table.push_back(std::sin(position * frequency));
+    }
+  }
+  auto gather_table = [&](const std::vector<float>& table) {
+    auto* values = add("Gather", {builder.MakeInitializer<float>({max_position, rotary_dim}, table),
+                                  position_ids_arg});
+    return add("Unsqueeze", {values, make_int64({1})});
+  };
+  auto* cos_arg = gather_table(cos_table);
+  auto* sin_arg = gather_table(sin_table);
+
+  auto project = [&](int64_t heads) {
+    auto* weight = builder.MakeInitializer<float>({input_hidden_size, heads * head_size}, -0.5f, 0.5f);
+    auto* reshape = add("Reshape", {add("MatMul", {input_arg, weight}),
+                                    make_int64({batch_size, sequence_length, heads, head_size})});
+    auto [transpose, output] = add_node("Transpose", {reshape});
+    transpose->AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    return output;
+  };
+  auto rotate = [&](NodeArg* x) {
+    auto* rotated = rotary_dim < head_size ? slice(x, 0, rotary_dim) : x;
+    auto [concat, rotated_half] = add_node("Concat", {add("Neg", {slice(rotated, rotary_dim / 2, INT64_MAX)}),
+                                                      slice(rotated, 0, rotary_dim / 2)});
+    concat->AddAttribute("axis", static_cast<int64_t>(-1));
+    auto* embed = add("Add", {add("Mul", {rotated, cos_arg}), add("Mul", {rotated_half, sin_arg})});
+    if (rotary_dim < head_size) {
+      auto [pass_concat, output] = add_node("Concat", {embed, slice(x, rotary_dim, INT64_MAX)});
+      pass_concat->AddAttribute("axis", static_cast<int64_t>(-1));
+      embed = output;
+    }
+    return embed;
+  };
+  auto concat_past = [&](NodeArg* past, NodeArg* value, NodeArg* present) {
+    builder.AddNode("Concat", {past, value}, {present}).AddAttribute("axis", static_cast<int64_t>(2));
+    if (num_heads == kv_num_heads) {
+      return present;
+    }
+    const int64_t groups = num_heads / kv_num_heads;
+    auto* repeated = add("Expand", {add("Unsqueeze", {present, make_int64({2})}),
+                                    make_int64({batch_size, kv_num_heads, groups, total_sequence_length, head_size})});
+    return add("Reshape", {repeated, make_int64({batch_size, num_heads, total_sequence_length, head_size})});
+  };
+
+  auto* query = rotate(project(num_heads));
+  auto* key = concat_past(past_key_arg, rotate(project(kv_num_heads)), present_key_arg);
+  auto* value = concat_past(past_value_arg, project(kv_num_heads), present_value_arg);
+
+  auto [key_transpose, key_transposed] = add_node("Transpose", {key});
+  key_transpose->AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+  auto* scores = add("MatMul", {query, key_transposed});
+  const float sqrt_head_size = std::sqrt(static_cast<float>(head_size));
+  scores = scale_by_div ? add("Div", {scores, builder.MakeScalarInitializer<float>(sqrt_head_size)})
+                        : add("Mul", {builder.MakeScalarInitializer<float>(1.0f / sqrt_head_size), scores});
+
+  // The causal mask is added to the padding mask computed from attention_mask.
+  NodeArg* causal_mask = nullptr;
+  if (mask_kind == DecomposedAttentionMask::kCausalTrilu) {
+    // Concat(zeros(s, past), Trilu(full((s, s), min), k=1)), with s and past from the shapes of the inputs.
+    auto dim = [&](NodeArg* x, int64_t axis) {
+      auto [gather, value] = add_node("Gather", {add("Shape", {x}), builder.MakeScalarInitializer<int64_t>(axis)});
+      gather->AddAttribute("axis", static_cast<int64_t>(0));
+      return add("Unsqueeze", {value, make_int64({0})});
+    };
+    auto constant_of_shape = [&](NodeArg* shape, float value) {
+      auto [node, output] = add_node("ConstantOfShape", {shape});
+      ONNX_NAMESPACE::TensorProto value_tensor;
+      value_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      value_tensor.add_dims(1);
+      value_tensor.add_float_data(value);
+      node->AddAttribute("value", value_tensor);
+      return output;
+    };
+    auto [square_concat, square] = add_node("Concat", {dim(position_ids_arg, 1), dim(position_ids_arg, 1)});
+    square_concat->AddAttribute("axis", static_cast<int64_t>(0));
+    auto [zeros_concat, zeros_shape] = add_node("Concat", {dim(position_ids_arg, 1), dim(past_key_arg, 2)});
+    zeros_concat->AddAttribute("axis", static_cast<int64_t>(0));
+    auto* triangle = add("Trilu", {constant_of_shape(square, -10000.0f), builder.MakeScalarInitializer<int64_t>(1)});
+    auto [concat, output] = add_node("Concat", {constant_of_shape(zeros_shape, 0.0f), triangle});
+    concat->AddAttribute("axis", static_cast<int64_t>(-1));
+    causal_mask = add("Unsqueeze", {output, make_int64({0, 1})});
+  } else {
+    std::vector<float> table;
+    for (int64_t i = 0; i < sequence_length; ++i) {
+      for (int64_t j = 0; j < total_sequence_length; ++j) {
+        const bool causal = j <= past_sequence_length + i;
+        const bool in_window = j > past_sequence_length + i - 2;
+        const bool attended = mask_kind == DecomposedAttentionMask::kBidirectional ||
+                              (causal && (mask_kind != DecomposedAttentionMask::kSlidingWindow || in_window));
+        table.push_back(attended ? 0.0f : -10000.0f);
+      }
+    }
+    causal_mask = builder.MakeInitializer<float>({1, 1, sequence_length, total_sequence_length}, table);
+  }
+
+  auto [cast, mask] = add_node("Cast", {attention_mask_arg});
+  cast->AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  mask = add("Mul", {add("Sub", {builder.MakeScalarInitializer<float>(1.0f), mask}),
+                     builder.MakeScalarInitializer<float>(-10000.0f)});
+  mask = add("Add", {add("Unsqueeze", {mask, make_int64({1, 2})}), causal_mask});
+
+  auto [softmax, probs] = add_node("Softmax", {add("Add", {scores, mask})});
+  softmax->AddAttribute("axis", static_cast<int64_t>(-1));
+  auto [output_transpose, output] = add_node("Transpose", {add("MatMul", {probs, value})});
+  output_transpose->AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  builder.AddNode("Reshape", {output, make_int64({batch_size, sequence_length, num_heads * head_size})}, {output_arg});
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 2);
+    EXPECT_EQ(op_to_count["Softmax"], 0);
+    EXPECT_EQ(op_to_count["Neg"], 0);
+    EXPECT_EQ(op_to_count["MatMul"], 3);
+
+    // Only the padding mask, which is passed as attention_bias, is left of the mask.
+    EXPECT_EQ(op_to_count["Unsqueeze"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 1);
+  };
+
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    BuildDecomposedAttentionTestCase(builder, 4, 2, 8, 8, true);
+  };
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-4, 1e-4);
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion_PartialRotary) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 2);
+    EXPECT_EQ(op_to_count["Softmax"], 0);
+    EXPECT_EQ(op_to_count["Concat"], 0);
+
+    for (const Node& node : session.GetGraph().Nodes()) {
+      if (node.OpType() == "RotaryEmbedding") {
+        EXPECT_EQ(node.GetAttributes().at("rotary_embedding_dim").i(), 8);
+      }
+    }
+  };
+
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    BuildDecomposedAttentionTestCase(builder, 2, 2, 16, 8, false);
+  };
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-4, 1e-4);
+}
+
+// The causal mask that HF models compute from the dynamic shapes, which constant folding would otherwise turn into
+// a constant table.
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion_TriluCausalMask) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 1);
+    EXPECT_EQ(op_to_count["Softmax"], 0);
+    EXPECT_EQ(op_to_count["Trilu"], 0);
+    EXPECT_EQ(op_to_count["ConstantOfShape"], 0);
+  };
+
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    BuildDecomposedAttentionTestCase(builder, 4, 2, 8, 8, true, DecomposedAttentionMask::kCausalTrilu);
+  };
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-4, 1e-4, nullptr, {}, {"ConstantFolding"});
+}
+
+// GroupQueryAttention applies a full causal mask, so attention with any other mask is not fused.
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion_NonCausalMask) {
+  for (auto mask_kind : {DecomposedAttentionMask::kSlidingWindow, DecomposedAttentionMask::kBidirectional}) {
+    auto check_graph = [](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 0);
+      EXPECT_EQ(op_to_count["Softmax"], 1);
+    };
+
+    auto build_test_case = [mask_kind](ModelTestBuilder& builder) {
+      BuildDecomposedAttentionTestCase(builder, 4, 2, 8, 8, true, mask_kind);
+    };
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                      1e-4, 1e-4);
+  }
+}
+
+// Decoding a batch of 2 sequences where the first is left-padded by 2 tokens. The padding reaches
+// GroupQueryAttention through attention_bias, and all the batches have the same sequence lengths.
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion_LeftPaddedBatch) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 1);
+    EXPECT_EQ(op_to_count["Softmax"], 0);
+
+    for (const Node& node : session.GetGraph().Nodes()) {
+      if (node.OpType() == "GroupQueryAttention") {
+        ASSERT_EQ(node.InputDefs().size(), 12u);
+        EXPECT_TRUE(node.InputDefs()[11]->Exists());
+      }
+    }
+  };
+
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    BuildDecomposedAttentionTestCase(builder, 4, 2, 8, 8, true, DecomposedAttentionMask::kCausal, 2, 1, 4,
+                                     {0, 0, 1, 1, 1, 1, 1, 1, 1, 1});
+  };
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-4, 1e-4);
+}
+
+// GroupQueryAttention rejects more than one new token with a past context unless the batch size is 1, so the
+// attention of a batch of 2 sequences of 3 tokens with 2 past tokens, like a batched chunked prefill, is not fused.
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion_BatchedPromptWithPast) {
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 0);
+    EXPECT_EQ(op_to_count["Softmax"], 1);
+  };
+
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    BuildDecomposedAttentionTestCase(builder, 4, 2, 8, 8, true, DecomposedAttentionMask::kCausal, 2, 3, 2);
+  };
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-4, 1e-4);
+}
+
 struct BiasSoftmaxFusionTester {
   std::shared_ptr<Model> p_model_;
   Status model_load_;
@@ -157,6 +157,12 @@ namespace perftest {
       "\t-D [Disable thread spinning]: disable spinning entirely for thread owned by onnxruntime intra-op thread pool.\n"
       "\t-Z [Force thread to stop spinning between runs]: disallow thread from spinning during runs to reduce cpu usage.\n"
       "\t-n [Exit after session creation]: allow user to measure session creation time to measure impact of enabling any initialization optimizations.\n"
+      "\t-N [session_creation_repeats]: Benchmark session creation: create the session the given number of times, report the time spent in each\n"
+      "\t\t initialization phase and exit. Profiling is enabled to collect the phase times, -p sets the profile file prefix.\n"
+      "\t-B [max_batch_size]: Submit the requests with RunAsync and let the session batch concurrent requests up to the\n"
+      "\t\t given batch size along axis 0 of the inputs and outputs. Use with -c to set the number of concurrent requests.\n"
+      "\t\t Requires an intra-op thread pool with at least one thread.\n"
+      "\t-W [max_wait_us]: Maximum time in microseconds a request waits for others to batch with when -B is set. Default:1000.\n"
       "\t-l Provide file as binary in memory by using fopen before session creation.\n"
       "\t-R [Register custom op]: allow user to register custom op by .so or .dll file.\n"
       "\t-h: help\n");
@@ -188,7 +194,7 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznlR:"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:N:B:W:AMPIDZvhsqznlR:"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -380,6 +386,30 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
       case 'n':
         test_config.run_config.exit_after_session_creation = true;
         break;
+      case 'N': {
+        const long repeats = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (repeats <= 0) {
+          return false;
+        }
+        test_config.run_config.session_creation_repeats = static_cast<size_t>(repeats);
+        break;
+      }
+      case 'B': {
+        const long max_batch_size = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (max_batch_size <= 1) {
+          return false;
+        }
+        test_config.run_config.batching_max_batch_size = static_cast<int64_t>(max_batch_size);
+        break;
+      }
+      case 'W': {
+        const long max_wait_us = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (max_wait_us < 0) {
+          return false;
+        }
+        test_config.run_config.batching_max_wait_us = static_cast<int64_t>(max_wait_us);
+        break;
+      }
       case 'l':
         test_config.model_info.load_via_path = true;
         break;
@@ -42,6 +42,16 @@ int real_main(int argc, char* argv[]) {
       return -1;
   }
   std::random_device rd;
+
+  if (test_config.run_config.session_creation_repeats > 0) {
+    auto status = perftest::BenchmarkSessionCreation(env, test_config, rd);
+    if (!status.IsOK()) {
+      printf("Session creation benchmark failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+    return 0;
+  }
+
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
 
   // Exit if user enabled -n option so that user can measure session creation time
@@ -31,6 +31,12 @@ class OnnxRuntimeTestSession : public TestSession {
 
   std::chrono::duration<double> Run() override;
 
+  // Ends profiling and returns the path of the profile file.
+  std::string EndProfiling() {
+    Ort::AllocatorWithDefaultOptions allocator;
+    return session_.EndProfilingAllocated(allocator).get();
+  }
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
  private:
@@ -50,6 +56,8 @@ class OnnxRuntimeTestSession : public TestSession {
   const int input_length_;
   std::string provider_name_;
   std::string device_memory_name_;  // Device memory type name to use from the list in allocator.h
+  // submit the requests with RunAsync so that the session can batch them
+  bool use_run_async_ = false;
 };
 
 }  // namespace perftest
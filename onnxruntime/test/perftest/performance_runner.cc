@@ -7,11 +7,17 @@
 #endif
 
 #include "performance_runner.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <numeric>
 
 #include "TestCase.h"
 #include "utils.h"
 #include "ort_test_session.h"
+#include "nlohmann/json.hpp"
 using onnxruntime::Status;
 
 // TODO: Temporary, while we bring up the threadpool impl...
@@ -330,6 +336,73 @@ bool PerformanceRunner::Initialize() {
   return true;
 }
 
+Status BenchmarkSessionCreation(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd) {
+  PerformanceTestConfig config = test_config;
+  if (config.run_config.profile_file.empty()) {
+    config.run_config.profile_file = ORT_TSTR("onnxruntime_perf_test_session_creation");
+  }
+  std::unique_ptr<TestModelInfo> test_model_info = CreateModelInfo(config);
+
+  const size_t repeats = config.run_config.session_creation_repeats;
+  std::vector<double> total_times;
+  // session events of the profile by name, in the order they were first recorded, with their durations in ms in
+  // each run. A run without the event counts as 0 ms, so that every phase has one entry per run.
+  std::vector<std::pair<std::string, std::vector<double>>> phase_times;
+
+  for (size_t i = 0; i < repeats; ++i) {
+    auto start = std::chrono::high_resolution_clock::now();
+    OnnxRuntimeTestSession session(env, rd, config, *test_model_info);
+    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+    total_times.push_back(duration.count());
+
+    const std::string profile_file = session.EndProfiling();
+    std::ifstream profile_stream(profile_file);
+    auto events = nlohmann::json::parse(profile_stream, nullptr, /*allow_exceptions*/ false);
+    profile_stream.close();
+    std::remove(profile_file.c_str());
+    if (events.is_discarded() || !events.is_array()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to parse the profile file ", profile_file);
+    }
+
+    // events with the same name, e.g. from subgraphs, are summed
+    std::map<std::string, double> session_phase_times;
+    for (const auto& event : events) {
+      if (event.value("cat", "") != "Session") {
+        continue;
+      }
+      const std::string name = event.value("name", "");
+      const double duration_ms = event.value("dur", 0.0) / 1000.0;
+      auto it = std::find_if(phase_times.begin(), phase_times.end(),
+                             [&name](const auto& phase) { return phase.first == name; });
+      if (it == phase_times.end()) {
+        phase_times.emplace_back(name, std::vector<double>(i, 0.0));
+      }
+      session_phase_times[name] += duration_ms;
+    }
+
+    for (auto& [name, times] : phase_times) {
+      auto it = session_phase_times.find(name);
+      times.push_back(it != session_phase_times.end() ? it->second : 0.0);
+    }
+  }
+
+  auto print_times = [](const std::string& name, const std::vector<double>& times) {
+    const double average = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    const double min = *std::min_element(times.begin(), times.end());
+    const double max = *std::max_element(times.begin(), times.end());
+    printf("%-32s %12.3f %12.3f %12.3f\n", name.c_str(), average, min, max);
+  };
+
+  printf("\nSession creation time over %zu runs (ms):\n", repeats);
+  printf("%-32s %12s %12s %12s\n", "phase", "average", "min", "max");
+  for (const auto& [name, times] : phase_times) {
+    print_times(name, times);
+  }
+  print_times("total", total_times);
+
+  return Status::OK();
+}
+
 }  // namespace perftest
 
 }  // namespace onnxruntime
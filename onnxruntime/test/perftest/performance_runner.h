@@ -118,5 +118,9 @@ class PerformanceRunner {
 
   std::mutex results_mutex_;
 };
+
+// Creates the session run_config.session_creation_repeats times with profiling enabled and prints the average time
+// spent in each initialization phase recorded in the profiles.
+Status BenchmarkSessionCreation(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
 }  // namespace perftest
 }  // namespace onnxruntime
@@ -65,6 +65,9 @@ struct RunConfig {
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
   bool exit_after_session_creation = false;
+  size_t session_creation_repeats = 0;
+  int64_t batching_max_batch_size = 0;
+  int64_t batching_max_wait_us = 1000;
   std::basic_string<ORTCHAR_T> register_custom_op_path;
 };
 
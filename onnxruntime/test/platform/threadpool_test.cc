@@ -12,8 +12,10 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -229,6 +231,31 @@ void TestStagedMultiLoopSections(const std::string& name, int num_threads, int n
   }
 }
 
+// Test parallel loops started from tasks running on the threads of the same pool, as is
+// the case for kernels when the intra-op pool also runs the inter-op work.
+void TestNestedParallelFor(const std::string& name, int num_threads, int num_outer_tasks) {
+  constexpr int num_tasks = 64;
+  std::vector<std::unique_ptr<TestData>> test_data;
+  for (int i = 0; i < num_outer_tasks; i++) {
+    test_data.push_back(CreateTestData(num_tasks));
+  }
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    onnxruntime::Barrier b(num_outer_tasks);
+    for (int i = 0; i < num_outer_tasks; i++) {
+      ThreadPool::Schedule(tp, [&, i, tp]() {
+        ThreadPool::TrySimpleParallelFor(tp, num_tasks, [&](std::ptrdiff_t j) {
+          IncrementElement(*test_data[i], j);
+        });
+        b.Notify();
+      });
+    }
+    b.Wait();
+  });
+  for (auto& data : test_data) {
+    ValidateTestData(*data);
+  }
+}
+
 }  // namespace
 
 namespace onnxruntime {
@@ -510,6 +537,130 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestNestedParallelFor_2Thread_4Tasks) {
+  TestNestedParallelFor("TestNestedParallelFor_2Thread_4Tasks", 2, 4);
+}
+
+TEST(ThreadPoolTest, TestNestedParallelFor_4Thread_1Task) {
+  TestNestedParallelFor("TestNestedParallelFor_4Thread_1Task", 4, 1);
+}
+
+TEST(ThreadPoolTest, TestNestedParallelFor_4Thread_8Tasks) {
+  TestNestedParallelFor("TestNestedParallelFor_4Thread_8Tasks", 4, 8);
+}
+
+TEST(ThreadPoolTest, TestNestedParallelForRunsInlineWhenNoWorkerIsIdle) {
+  // two worker threads: keep one busy, and start a loop from the other
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 3, true);
+  std::atomic<bool> busy_task_started{false};
+  std::atomic<bool> release_busy_task{false};
+  std::atomic<bool> loop_done{false};
+  auto test_data = CreateTestData(16);
+
+  ThreadPool::Schedule(tp.get(), [&]() {
+    busy_task_started = true;
+    while (!release_busy_task) {
+      std::this_thread::yield();
+    }
+  });
+  ThreadPool::Schedule(tp.get(), [&]() {
+    while (!busy_task_started) {
+      std::this_thread::yield();
+    }
+    ThreadPool::TrySimpleParallelFor(tp.get(), 16, [&](std::ptrdiff_t i) {
+      IncrementElement(*test_data, i);
+    });
+    loop_done = true;
+  });
+
+  while (!loop_done) {
+    std::this_thread::yield();
+  }
+  release_busy_task = true;
+  ValidateTestData(*test_data);
+
+  auto utilization = ThreadPool::GetUtilization(tp.get());
+  ASSERT_EQ(utilization.num_threads, 2);
+  ASSERT_EQ(utilization.tasks_scheduled, 2u);
+  ASSERT_EQ(utilization.parallel_loops, 0u);
+  ASSERT_EQ(utilization.nested_loops_run_inline, 1u);
+}
+
+TEST(ThreadPoolTest, TestUtilization) {
+  ASSERT_EQ(ThreadPool::GetUtilization(nullptr).num_threads, 0);
+
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 3, true);
+
+  // the busy time is not measured until the profiling of the pool is started
+  {
+    onnxruntime::Barrier b(1);
+    ThreadPool::Schedule(tp.get(), [&]() { b.Notify(); });
+    b.Wait();
+  }
+  auto unprofiled_utilization = ThreadPool::GetUtilization(tp.get());
+  ASSERT_EQ(unprofiled_utilization.busy_time_us, 0u);
+  ASSERT_EQ(unprofiled_utilization.elapsed_time_us, 0u);
+  ASSERT_EQ(unprofiled_utilization.Utilization(), 0.0);
+  ThreadPool::StartProfiling(tp.get());
+
+  constexpr int num_tasks = 10;
+  onnxruntime::Barrier b(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    ThreadPool::Schedule(tp.get(), [&]() { b.Notify(); });
+  }
+  b.Wait();
+  ThreadPool::TrySimpleParallelFor(tp.get(), 100, [](std::ptrdiff_t) {});
+
+  // the counters of a task are updated after the task returns
+  auto utilization = ThreadPool::GetUtilization(tp.get());
+  while (utilization.tasks_run < num_tasks + 1) {
+    std::this_thread::yield();
+    utilization = ThreadPool::GetUtilization(tp.get());
+  }
+  ASSERT_EQ(utilization.num_threads, 2);
+  ASSERT_EQ(utilization.tasks_scheduled, static_cast<uint64_t>(num_tasks + 1));
+  ASSERT_EQ(utilization.parallel_loops, 1u);
+  ASSERT_EQ(utilization.nested_loops_run_inline, 0u);
+  ASSERT_LE(utilization.tasks_stolen, utilization.tasks_run);
+  ASSERT_LE(utilization.busy_time_us, utilization.elapsed_time_us * utilization.num_threads);
+  ASSERT_GE(utilization.Utilization(), 0.0);
+  ASSERT_LE(utilization.Utilization(), 1.0);
+}
+
+TEST(ThreadPoolTest, TestNumaPartitionedLoopsStayOnNode) {
+  // two workers on node 0 and four on node 1
+  onnxruntime::ThreadOptions to;
+  to.numa_nodes = {0, 0, 1, 1, 1, 1};
+  ThreadPoolTempl<onnxruntime::Env> tp(ORT_TSTR("numa_test"), 6, true, onnxruntime::Env::Default(), to);
+  auto worker_node = [](int thread_id) { return thread_id < 2 ? 0 : 1; };
+
+  for (int i = 0; i < 20; i++) {
+    std::atomic<int> caller_node{-1};
+    std::atomic<unsigned> max_dop{0};
+    std::atomic<int> remote_work_items{0};
+    std::atomic<unsigned> work_items_run{0};
+    onnxruntime::Barrier done(1);
+    tp.Schedule([&]() {
+      const int node = worker_node(tp.CurrentThreadId());
+      caller_node = node;
+      max_dop = tp.MaxLoopDegreeOfParallelism();
+      tp.RunInParallel(
+          [&](unsigned) {
+            if (worker_node(tp.CurrentThreadId()) != node) {
+              remote_work_items++;
+            }
+            work_items_run++;
+          },
+          max_dop, 1);
+      done.Notify();
+    });
+    done.Wait();
+    ASSERT_EQ(max_dop, caller_node == 0 ? 2u : 4u);
+    ASSERT_EQ(work_items_run, max_dop.load());
+    ASSERT_EQ(remote_work_items, 0);
+  }
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
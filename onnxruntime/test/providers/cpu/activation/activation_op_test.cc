@@ -587,6 +587,17 @@ TEST_F(ActivationOpTest, Softplus) {
                           });
 }
 
+TEST_F(ActivationOpTest, Mish) {
+  TestActivationOp<float>(
+      "Mish",
+      input_values,
+      [](float x) {
+        double softplus = std::log1p(std::exp(static_cast<double>(x)));
+        return static_cast<float>(x * std::tanh(softplus));
+      },
+      {}, {}, false, 18);
+}
+
 TEST_F(ActivationOpNoInfTest, Softsign) {
   if constexpr (!SessionOptions::DEFAULT_USE_PER_SESSION_THREADS) {
     GTEST_SKIP() << "Skipping the test";
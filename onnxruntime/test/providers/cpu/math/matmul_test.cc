@@ -1,14 +1,20 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+
 #include "gtest/gtest.h"
 
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
 
 namespace onnxruntime {
 namespace test {
@@ -354,6 +360,92 @@ TEST(MathOpTest, MatMul_bfloat16) {
 
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
+namespace {
+constexpr int64_t kSparseM = 5;
+constexpr int64_t kSparseK = 32;
+constexpr int64_t kSparseN = 24;
+
+// Keeps one row of 8 columns out of five, so that the weight is 80% sparse in 1x8 blocks. Rows k with k % 5 equal
+// to 1 or 2 are all zero.
+std::vector<float> MakeSparseWeight() {
+  std::vector<float> b_values(kSparseK * kSparseN, 0.0f);
+  for (int64_t k = 0; k < kSparseK; k++) {
+    for (int64_t n = 0; n < kSparseN; n++) {
+      if ((k + n / 8) % 5 == 0) {
+        b_values[k * kSparseN + n] = static_cast<float>((k * 7 + n * 3) % 11) - 5.0f;
+      }
+    }
+  }
+  return b_values;
+}
+
+// Runs MatMul with a constant B, packed in a sparse format for "0.5" and for the dense SGEMM for "1".
+void RunMatMulSparseConstantWeight(const std::vector<float>& a_values, const std::vector<float>& b_values,
+                                   const std::vector<float>& y_values, const char* minimum_sparsity) {
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {kSparseM, kSparseK}, a_values);
+  test.AddInput<float>("B", {kSparseK, kSparseN}, b_values, true);
+  test.AddOutput<float>("Y", {kSparseM, kSparseN}, y_values);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasSparseGemmMinimumSparsity,
+                                                    minimum_sparsity));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+}  // namespace
+
+TEST(MathOpTest, MatMulSparseConstantWeight) {
+  const std::vector<float> b_values = MakeSparseWeight();
+
+  std::vector<float> a_values(kSparseM * kSparseK);
+  for (int64_t i = 0; i < kSparseM * kSparseK; i++) {
+    a_values[i] = static_cast<float>(i % 13) * 0.25f - 1.5f;
+  }
+
+  std::vector<float> y_values(kSparseM * kSparseN, 0.0f);
+  for (int64_t m = 0; m < kSparseM; m++) {
+    for (int64_t n = 0; n < kSparseN; n++) {
+      for (int64_t k = 0; k < kSparseK; k++) {
+        y_values[m * kSparseN + n] += a_values[m * kSparseK + k] * b_values[k * kSparseN + n];
+      }
+    }
+  }
+
+  for (const char* minimum_sparsity : {"0.5", "1"}) {
+    RunMatMulSparseConstantWeight(a_values, b_values, y_values, minimum_sparsity);
+  }
+}
+
+// The sparse formats skip the zero blocks of B, so an infinite input that only meets zero weights does not turn the
+// output into NaN as it does with the dense SGEMM, where 0 * inf is NaN.
+TEST(MathOpTest, MatMulSparseConstantWeightSkipsNonFiniteInputs) {
+  const std::vector<float> b_values = MakeSparseWeight();
+
+  // Row 1 of B is all zero.
+  std::vector<float> a_values(kSparseM * kSparseK, 1.0f);
+  a_values[1] = std::numeric_limits<float>::infinity();
+
+  std::vector<float> y_values(kSparseM * kSparseN, 0.0f);
+  for (int64_t m = 0; m < kSparseM; m++) {
+    for (int64_t n = 0; n < kSparseN; n++) {
+      for (int64_t k = 0; k < kSparseK; k++) {
+        y_values[m * kSparseN + n] += b_values[k * kSparseN + n];
+      }
+    }
+  }
+  RunMatMulSparseConstantWeight(a_values, b_values, y_values, "0.5");
+
+  for (int64_t n = 0; n < kSparseN; n++) {
+    y_values[n] = std::numeric_limits<float>::quiet_NaN();
+  }
+  RunMatMulSparseConstantWeight(a_values, b_values, y_values, "1");
+}
+
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   OpTester test("MatMul");
 
@@ -432,5 +524,28 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
 
 #endif
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(MathOpTest, MatMulStridedInputs) {
+  // The queries and keys of 2 heads after split-heads transposes of [2, 2, 3] inputs, read in place.
+  {
+    KernelComputeTester test("MatMul");
+    std::vector<float> values{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f};
+    test.AddInput<float>("A", {2, 2, 3}, values, {3, 6, 1});
+    test.AddInput<float>("B", {2, 3, 2}, values, {3, 1, 6});
+    test.AddOutput<float>("Y", {2, 2, 2}, {14.f, 50.f, 50.f, 194.f, 77.f, 167.f, 167.f, 365.f});
+    test.Run();
+  }
+
+  // A broadcast input that is copied to a contiguous tensor.
+  {
+    KernelComputeTester test("MatMul");
+    test.AddInput<float>("A", {2, 3}, {1.f, 2.f, 3.f}, {0, 1});
+    test.AddInput<float>("B", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddOutput<float>("Y", {2, 2}, {22.f, 28.f, 22.f, 28.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 #include "core/graph/constants.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 using namespace std;
 namespace onnxruntime {
@@ -673,6 +674,126 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// 3x3 convolution with enough channels for the Winograd algorithm of MLAS. With the filter as an initializer the
+// CPU EP transforms it in PrePack and releases the original filter.
+// A 3x3 convolution with enough channels for MlasConv to select the Winograd algorithm, with pads of 1 so the
+// output has the shape of the input.
+struct WinogradConvTestData {
+  static constexpr int64_t C = 32, M = 32, H = 6, W = 7;
+
+  WinogradConvTestData() : X(C * H * W), filter(M * C * 9), B(M), expected(M * H * W) {
+    for (size_t i = 0; i < X.size(); ++i) {
+      X[i] = static_cast<float>(static_cast<int64_t>(i % 13) - 6) / 8.0f;
+    }
+    for (size_t i = 0; i < filter.size(); ++i) {
+      filter[i] = static_cast<float>(static_cast<int64_t>(i % 7) - 3) / 16.0f;
+    }
+    for (size_t i = 0; i < B.size(); ++i) {
+      B[i] = static_cast<float>(i) / 32.0f;
+    }
+
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t y = 0; y < H; ++y) {
+        for (int64_t x = 0; x < W; ++x) {
+          float sum = B[m];
+          for (int64_t c = 0; c < C; ++c) {
+            for (int64_t ky = 0; ky < 3; ++ky) {
+              for (int64_t kx = 0; kx < 3; ++kx) {
+                const int64_t iy = y + ky - 1;
+                const int64_t ix = x + kx - 1;
+                if (iy >= 0 && iy < H && ix >= 0 && ix < W) {
+                  sum += X[(c * H + iy) * W + ix] * filter[((m * C + c) * 3 + ky) * 3 + kx];
+                }
+              }
+            }
+          }
+          expected[(m * H + y) * W + x] = sum;
+        }
+      }
+    }
+  }
+
+  void AddToTest(OpTester& test, bool weight_is_initializer) const {
+    test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+    test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+    test.AddInput<float>("X", {1, C, H, W}, X);
+    test.AddInput<float>("W", {M, C, 3, 3}, filter, weight_is_initializer);
+    test.AddInput<float>("B", {M}, B);
+    test.AddOutput<float>("Y", {1, M, H, W}, expected);
+    test.SetOutputTolerance(1e-4f);
+  }
+
+  vector<float> X;
+  vector<float> filter;
+  vector<float> B;
+  vector<float> expected;
+};
+
+TEST(ConvTest, Conv2D_Winograd) {
+  const WinogradConvTestData data;
+  for (bool weight_is_initializer : {false, true}) {
+    OpTester test("Conv", 11);
+    data.AddToTest(test, weight_is_initializer);
+    test.ConfigEp(DefaultCpuExecutionProvider()).RunWithConfig();
+  }
+}
+
+#ifndef ENABLE_TRAINING
+// Prepacking is disabled in training builds so no need to test the feature in a training build.
+TEST(ConvTest, Conv2D_Winograd_SharedPrepackedWeights) {
+  WinogradConvTestData data;
+  OpTester test("Conv", 11);
+  data.AddToTest(test, true);
+
+  OrtValue w;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({data.M, data.C, 3, 3}), data.filter.data(),
+                       OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), w);
+
+  SessionOptions so;
+  // Set up W as a shared initializer to be shared between sessions
+  ASSERT_EQ(so.AddInitializer("W", &w), Status::OK());
+
+  // We want all sessions running using this OpTester to be able to share pre-packed weights if applicable
+  test.EnableSharingOfPrePackedWeightsAcrossSessions();
+
+  size_t number_of_pre_packed_weights_counter_session_1 = 0;
+  size_t number_of_shared_pre_packed_weights_counter = 0;
+
+  // Session 1
+  {
+    test.Config(so)
+        .ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig(&number_of_pre_packed_weights_counter_session_1, &number_of_shared_pre_packed_weights_counter);
+    // Assert that no pre-packed weights have been shared thus far
+    ASSERT_EQ(number_of_shared_pre_packed_weights_counter, static_cast<size_t>(0));
+  }
+
+  // Assert that the number of elements in the shared container
+  // is the same as the number of weights that have been pre-packed
+  ASSERT_EQ(number_of_pre_packed_weights_counter_session_1, test.GetNumPrePackedWeightsShared());
+
+  // MLAS may not select the Winograd algorithm on some platforms, in which case nothing is pre-packed
+  if (number_of_pre_packed_weights_counter_session_1 == 0)
+    return;
+
+  // Session 2
+  {
+    size_t number_of_pre_packed_weights_counter_session_2 = 0;
+    test.Config(so)
+        .ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig(&number_of_pre_packed_weights_counter_session_2, &number_of_shared_pre_packed_weights_counter);
+
+    // Assert that the same number of weights were pre-packed in both sessions
+    ASSERT_EQ(number_of_pre_packed_weights_counter_session_1, number_of_pre_packed_weights_counter_session_2);
+
+    // Assert that the number of pre-packed weights that were shared equals
+    // the number of pre-packed weights in the second session
+    ASSERT_EQ(number_of_pre_packed_weights_counter_session_2,
+              static_cast<size_t>(number_of_shared_pre_packed_weights_counter));
+  }
+}
+#endif
+
 TEST(ConvTest, Depthwise2D_Bias_Group1_Issue18992) {
   ConvOpAndTestAttributes attrs = {
       "",                           // auto_pad
@@ -6,6 +6,9 @@
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
 #include "test/common/tensor_op_test_utils.h"
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
 
 namespace onnxruntime {
 namespace test {
@@ -806,5 +809,33 @@ TEST(SliceTest, CoalesceDims) {
   RunSliceTest<float>({1, 1, 1}, {1.f}, {0}, {std::numeric_limits<int64_t>::max()}, {1}, {}, {1, 1, 1}, {1.f}, true);
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(SliceTest, Strided) {
+  // Strided output.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 4}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f});
+    test.AddInput<int64_t>("starts", {1}, {0});
+    test.AddInput<int64_t>("ends", {1}, {4});
+    test.AddInput<int64_t>("axes", {1}, {1});
+    test.AddInput<int64_t>("steps", {1}, {2});
+    test.AddOutput<float>("output", {2, 2}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, {4, 2});
+    test.Run({0});
+  }
+
+  // Strided input.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 3}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f}, {1, 2});
+    test.AddInput<int64_t>("starts", {1}, {2});
+    test.AddInput<int64_t>("ends", {1}, {-4});
+    test.AddInput<int64_t>("axes", {1}, {1});
+    test.AddInput<int64_t>("steps", {1}, {-1});
+    test.AddOutput<float>("output", {2, 3}, {3.f, 2.f, 1.f, 6.f, 5.f, 4.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
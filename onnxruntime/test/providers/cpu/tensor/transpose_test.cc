@@ -8,6 +8,9 @@
 #include "core/providers/cpu/tensor/transpose.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/asserts.h"
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
 
 namespace onnxruntime {
 namespace test {
@@ -869,5 +872,27 @@ TEST(TransposeOpTest, TransposeBigMLFloat16) {  // Exercises CanUse_cublasTransp
 }
 #endif  // defined(USE_CUDA) || defined(USE_ROCM)
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(TransposeOpTest, Strided) {
+  // Strided output of a split-heads transpose.
+  {
+    KernelComputeTester test("Transpose");
+    test.AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    std::vector<float> values{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f};
+    test.AddInput<float>("X", {1, 2, 2, 3}, values);
+    test.AddOutput<float>("Y", {1, 2, 2, 3}, values, {12, 3, 6, 1});
+    test.Run({0});
+  }
+
+  // Strided input.
+  {
+    KernelComputeTester test("Transpose");
+    test.AddInput<float>("X", {2, 3}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f}, {1, 2});
+    test.AddOutput<float>("Y", {3, 2}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
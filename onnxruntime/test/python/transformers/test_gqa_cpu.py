@@ -1896,6 +1896,153 @@ def parity_check_gqa_past_no_buff(
     return all_close
 
 
+def create_group_query_attention_graph_quantized_kv_cache(config, share_buffer=True, kv_cache_bit_width=8):
+    past_kv_seqlen = config.kv_sequence_length
+    present_kv_seqlen = (
+        config.kv_sequence_length if share_buffer else config.kv_sequence_length + config.sequence_length
+    )
+    nodes = [
+        helper.make_node(
+            "GroupQueryAttention",
+            [
+                "query",
+                "key",
+                "value",
+                "past_key",
+                "past_value",
+                "seqlens_k",
+                "total_sequence_length",
+                "",
+                "",
+                "k_scale",
+                "v_scale",
+            ],
+            ["output", "present_key", "present_value"],
+            "GroupQueryAttention_0",
+            num_heads=config.num_heads,
+            kv_num_heads=config.kv_num_heads,
+            kv_cache_bit_width=kv_cache_bit_width,
+            domain="com.microsoft",
+        ),
+    ]
+
+    past_shape = [config.batch_size, config.kv_num_heads, past_kv_seqlen, config.head_size]
+    present_shape = [config.batch_size, config.kv_num_heads, present_kv_seqlen, config.head_size]
+    kv_shape = [config.batch_size, config.sequence_length, config.kv_num_heads * config.head_size]
+    graph_input = [
+        helper.make_tensor_value_info(
+            "query", ORT_TYPE, [config.batch_size, config.sequence_length, config.num_heads * config.head_size]
+        ),
+        helper.make_tensor_value_info("key", ORT_TYPE, kv_shape),
+        helper.make_tensor_value_info("value", ORT_TYPE, kv_shape),
+        helper.make_tensor_value_info("past_key", TensorProto.UINT8, past_shape),
+        helper.make_tensor_value_info("past_value", TensorProto.UINT8, past_shape),
+        helper.make_tensor_value_info("seqlens_k", TensorProto.INT32, [config.batch_size]),
+        helper.make_tensor_value_info("total_sequence_length", TensorProto.INT32, [1]),
+        helper.make_tensor_value_info("k_scale", TensorProto.FLOAT, [config.kv_num_heads]),
+        helper.make_tensor_value_info("v_scale", TensorProto.FLOAT, [config.kv_num_heads]),
+    ]
+    graph_output = [
+        helper.make_tensor_value_info(
+            "output", ORT_TYPE, [config.batch_size, config.sequence_length, config.num_heads * config.head_size]
+        ),
+        helper.make_tensor_value_info("present_key", TensorProto.UINT8, present_shape),
+        helper.make_tensor_value_info("present_value", TensorProto.UINT8, present_shape),
+    ]
+
+    graph = helper.make_graph(nodes, "GroupQueryAttention_Graph", graph_input, graph_output)
+    model = helper.make_model(graph)
+    return model.SerializeToString()
+
+
+def quantize_kv_cache_ref(x, scale):
+    # x has shape (batch_size, kv_num_heads, sequence_length, head_size) and scale has shape (kv_num_heads)
+    return numpy.clip(numpy.rint(x / scale[None, :, None, None]) + 128, 0, 255).astype(numpy.uint8)
+
+
+def dequantize_kv_cache_ref(x, scale):
+    return (x.astype(numpy.float32) - 128) * scale[None, :, None, None]
+
+
+def parity_check_gqa_quantized_kv_cache(config, share_buffer=True, rtol=5e-2, atol=5e-2):
+    b, s, n, n2, h = config.batch_size, config.sequence_length, config.num_heads, config.kv_num_heads, config.head_size
+    past_seqlen = config.past_sequence_length
+    rng = numpy.random.default_rng(1)
+
+    q = rng.standard_normal((b, s, n, h)).astype(NUMPY_TYPE)
+    k = rng.standard_normal((b, s, n2, h)).astype(NUMPY_TYPE)
+    v = rng.standard_normal((b, s, n2, h)).astype(NUMPY_TYPE)
+    k_scale = rng.uniform(0.02, 0.04, n2).astype(numpy.float32)
+    v_scale = rng.uniform(0.02, 0.04, n2).astype(numpy.float32)
+
+    # The past key and value, right padded to kv_sequence_length.
+    past_k = quantize_kv_cache_ref(rng.standard_normal((b, n2, config.kv_sequence_length, h)), k_scale)
+    past_v = quantize_kv_cache_ref(rng.standard_normal((b, n2, config.kv_sequence_length, h)), v_scale)
+    seqlens_k = numpy.full((b,), past_seqlen + s - 1, dtype=numpy.int32)
+
+    onnx_model_str = create_group_query_attention_graph_quantized_kv_cache(config, share_buffer)
+    ort_session = InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+    ort_inputs = {
+        "query": q.reshape(b, s, -1),
+        "key": k.reshape(b, s, -1),
+        "value": v.reshape(b, s, -1),
+        "past_key": past_k if share_buffer else past_k[:, :, :past_seqlen, :].copy(),
+        "past_value": past_v if share_buffer else past_v[:, :, :past_seqlen, :].copy(),
+        "seqlens_k": seqlens_k,
+        "total_sequence_length": numpy.array([past_seqlen + s], dtype=numpy.int32),
+        "k_scale": k_scale,
+        "v_scale": v_scale,
+    }
+    out, present_k, present_v = ort_session.run(None, ort_inputs)
+
+    # The new keys and values are quantized as they are appended.
+    new_k = quantize_kv_cache_ref(k.transpose(0, 2, 1, 3).astype(numpy.float32), k_scale)
+    new_v = quantize_kv_cache_ref(v.transpose(0, 2, 1, 3).astype(numpy.float32), v_scale)
+    total_seqlen = past_seqlen + s
+    if not numpy.array_equal(present_k[:, :, :past_seqlen, :], past_k[:, :, :past_seqlen, :]) or not (
+        numpy.abs(present_k[:, :, past_seqlen:total_seqlen, :].astype(numpy.int32) - new_k).max() <= 1
+        and numpy.abs(present_v[:, :, past_seqlen:total_seqlen, :].astype(numpy.int32) - new_v).max() <= 1
+    ):
+        print(f"{RED}Quantized KV Cache Present Mismatch: {config}{RESET}")
+        return False
+
+    # Reference attention on the dequantized cache.
+    k_ref = dequantize_kv_cache_ref(present_k[:, :, :total_seqlen, :], k_scale)
+    v_ref = dequantize_kv_cache_ref(present_v[:, :, :total_seqlen, :], v_scale)
+    k_ref = numpy.repeat(k_ref, n // n2, axis=1)
+    v_ref = numpy.repeat(v_ref, n // n2, axis=1)
+    q_ref = q.transpose(0, 2, 1, 3).astype(numpy.float32)
+    scores = numpy.matmul(q_ref, k_ref.transpose(0, 1, 3, 2)) / math.sqrt(h)
+    causal = numpy.arange(total_seqlen)[None, :] > (past_seqlen + numpy.arange(s))[:, None]
+    scores = numpy.where(causal[None, None, :, :], -numpy.inf, scores)
+    probs = numpy.exp(scores - scores.max(axis=-1, keepdims=True))
+    probs /= probs.sum(axis=-1, keepdims=True)
+    out_ref = numpy.matmul(probs, v_ref).transpose(0, 2, 1, 3).reshape(b, s, -1)
+
+    all_close = numpy.allclose(out, out_ref, rtol=rtol, atol=atol, equal_nan=True)
+    correct = GREEN + "True" + RESET if all_close else RED + "False" + RESET
+    print(
+        "KV cache quantized to 8 bits. Share buffer:",
+        share_buffer,
+        " B:",
+        b,
+        " S:",
+        s,
+        " Past:",
+        past_seqlen,
+        " N:",
+        n,
+        " kvN:",
+        n2,
+        " h:",
+        h,
+        " Mean Error:",
+        numpy.mean(numpy.abs(out - out_ref)),
+        correct,
+    )
+    return all_close
+
+
 class TestGQA(unittest.TestCase):
     def test_gqa_no_past(self):
         torch.manual_seed(69)
@@ -2069,6 +2216,43 @@ class TestGQA(unittest.TestCase):
                                     )
                                     self.assertTrue(all_close)
 
+    def test_gqa_quantized_kv_cache(self):
+        print("-------- TEST GQA QUANTIZED KV CACHE ---------")
+        # (sequence_length, past_sequence_length)
+        seqs = (
+            [(1, 127), (1, 2048), (3, 0), (1, 0)]
+            if pipeline_mode
+            else [(1, 127), (1, 2048), (1, 8191), (3, 0), (1, 0), (5, 37)]
+        )
+        for b in [1, 3]:
+            for s, sp in seqs:
+                for n, n2 in [(8, 2), (6, 6)]:
+                    for h in [64, 128]:
+                        for share_buffer in [True, False]:
+                            config = Config(b, s, sp + s + 8 if share_buffer else sp, sp, n, n2, h)
+                            all_close = parity_check_gqa_quantized_kv_cache(config, share_buffer=share_buffer)
+                            self.assertTrue(all_close)
+
+    def test_gqa_uint8_kv_cache_requires_bit_width(self):
+        # A uint8 cache is only accepted with kv_cache_bit_width 8
+        b, s, sp, n, n2, h = 1, 1, 4, 8, 2, 64
+        config = Config(b, s, sp + s, sp, n, n2, h)
+        onnx_model_str = create_group_query_attention_graph_quantized_kv_cache(config, kv_cache_bit_width=0)
+        ort_session = InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+        ort_inputs = {
+            "query": numpy.zeros((b, s, n * h), dtype=NUMPY_TYPE),
+            "key": numpy.zeros((b, s, n2 * h), dtype=NUMPY_TYPE),
+            "value": numpy.zeros((b, s, n2 * h), dtype=NUMPY_TYPE),
+            "past_key": numpy.full((b, n2, sp + s, h), 128, dtype=numpy.uint8),
+            "past_value": numpy.full((b, n2, sp + s, h), 128, dtype=numpy.uint8),
+            "seqlens_k": numpy.full((b,), sp + s - 1, dtype=numpy.int32),
+            "total_sequence_length": numpy.array([sp + s], dtype=numpy.int32),
+            "k_scale": numpy.ones((n2,), dtype=numpy.float32),
+            "v_scale": numpy.ones((n2,), dtype=numpy.float32),
+        }
+        with self.assertRaisesRegex(Exception, "shall have the type of 'query'"):
+            ort_session.run(None, ort_inputs)
+
 
 if __name__ == "__main__":
     unittest.main()